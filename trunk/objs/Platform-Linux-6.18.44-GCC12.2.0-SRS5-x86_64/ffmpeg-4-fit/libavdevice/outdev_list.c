@@ -0,0 +1,2 @@
+static const AVOutputFormat * const outdev_list[] = {
+    NULL };
@@ -0,0 +1,2 @@
+static const URLProtocol * const url_protocols[] = {
+    NULL };
@@ -0,0 +1 @@
+#include "libavutil/log2_tab.c"
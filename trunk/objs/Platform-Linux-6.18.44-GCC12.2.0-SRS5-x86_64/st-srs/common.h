@@ -0,0 +1 @@
+./.src/common.h
\ No newline at end of file
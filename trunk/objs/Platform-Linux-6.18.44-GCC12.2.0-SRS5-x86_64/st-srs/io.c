@@ -0,0 +1 @@
+./.src/io.c
\ No newline at end of file
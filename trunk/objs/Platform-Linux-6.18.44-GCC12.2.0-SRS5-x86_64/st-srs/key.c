@@ -0,0 +1 @@
+./.src/key.c
\ No newline at end of file
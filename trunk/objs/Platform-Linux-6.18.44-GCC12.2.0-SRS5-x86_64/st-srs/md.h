@@ -0,0 +1 @@
+./.src/md.h
\ No newline at end of file
@@ -0,0 +1 @@
+./.src/public.h
\ No newline at end of file
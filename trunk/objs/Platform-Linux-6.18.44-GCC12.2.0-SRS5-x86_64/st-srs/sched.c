@@ -0,0 +1 @@
+./.src/sched.c
\ No newline at end of file
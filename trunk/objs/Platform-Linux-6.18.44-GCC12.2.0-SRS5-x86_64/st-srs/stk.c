@@ -0,0 +1 @@
+./.src/stk.c
\ No newline at end of file
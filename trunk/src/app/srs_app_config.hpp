@@ -450,6 +450,8 @@ public:
 // Thread pool section.
 public:
     virtual srs_utime_t get_threads_interval();
+    // Get the number of audio transcode threads, 0 to transcode in hybrid thread.
+    virtual int get_threads_audio_transcoders();
     virtual bool get_circuit_breaker();
     virtual int get_high_threshold();
     virtual int get_high_pulse();
@@ -457,6 +459,23 @@ public:
     virtual int get_critical_pulse();
     virtual int get_dying_threshold();
     virtual int get_dying_pulse();
+// The global hooks section.
+public:
+    // Whether reuse the keep-alive connections to callback server.
+    virtual bool get_hooks_keepalive();
+    // The max concurrent requests to each callback server.
+    virtual int get_hooks_concurrency();
+    // The TTL to cache the verdict of on_play, 0 to disable it.
+    virtual srs_utime_t get_hooks_play_cache();
+// The exporter section, for Prometheus metrics.
+public:
+    // Whether exporter metrics at /metrics of HTTP API.
+    virtual bool get_exporter_enabled();
+    // The label and tag for all metrics, for example, the region and role of server.
+    virtual std::string get_exporter_label();
+    virtual std::string get_exporter_tag();
+    // The max number of series for each metric, to limit the cardinality of labels.
+    virtual int get_exporter_max_series();
 // stream_caster section
 public:
     // Get all stream_caster in config file.
@@ -488,6 +507,8 @@ public:
     virtual bool get_rtc_server_encrypt();
     virtual int get_rtc_server_reuseport();
     virtual bool get_rtc_server_merge_nalus();
+    // Get the max number of new DTLS handshakes per second, 0 for no limit.
+    virtual int get_rtc_server_dtls_handshake_rate();
 public:
     virtual bool get_rtc_server_black_hole();
     virtual std::string get_rtc_server_black_hole_addr();
@@ -499,6 +520,8 @@ public:
     bool get_rtc_enabled(std::string vhost);
     bool get_rtc_keep_bframe(std::string vhost);
     bool get_rtc_from_rtmp(std::string vhost);
+    // Whether only transmux RTMP to RTC when there is any RTC player.
+    bool get_rtc_from_rtmp_lazy(std::string vhost);
     srs_utime_t get_rtc_stun_timeout(std::string vhost);
     bool get_rtc_stun_strict_check(std::string vhost);
     std::string get_rtc_dtls_role(std::string vhost);
@@ -506,9 +529,19 @@ public:
     int get_rtc_drop_for_pt(std::string vhost);
     bool get_rtc_to_rtmp(std::string vhost);
     srs_utime_t get_rtc_pli_for_rtmp(std::string vhost);
+    // The max delay of jitter buffer, to transmux RTC to RTMP.
+    srs_utime_t get_rtc_jitter_for_rtmp(std::string vhost);
     bool get_rtc_nack_enabled(std::string vhost);
     bool get_rtc_nack_no_copy(std::string vhost);
+    // Whether retransmit the lost packets in RTX stream for players.
+    bool get_rtc_rtx_enabled(std::string vhost);
+    // Whether generate the ULPFEC in RED for players, adaptive to the loss rate of player.
+    bool get_rtc_fec_enabled(std::string vhost);
     bool get_rtc_twcc_enabled(std::string vhost);
+    // Whether enable the send-side BWE and pacing for players, by TWCC feedback.
+    bool get_rtc_bwe_enabled(std::string vhost);
+    // The max bitrate in kbps of BWE.
+    int get_rtc_bwe_max_bitrate(std::string vhost);
 
 // vhost specified section
 public:
@@ -977,6 +1010,16 @@ public:
     virtual bool get_dvr_wait_keyframe(std::string vhost);
     // Get the time_jitter algorithm for dvr.
     virtual int get_dvr_time_jitter(std::string vhost);
+    // Get the size of userspace buffer for dvr file writer, in bytes, 0 to disable it.
+    virtual int get_dvr_buffer(std::string vhost);
+    // Get the size to preallocate for each dvr file, in bytes, 0 to disable it.
+    virtual int64_t get_dvr_fallocate(std::string vhost);
+    // Whether write dvr file with O_DIRECT, requires dvr_buffer.
+    virtual bool get_dvr_direct_io(std::string vhost);
+    // Get the duration of fMP4 fragment for dvr, 0 to use progressive MP4.
+    virtual srs_utime_t get_dvr_fragment(std::string vhost);
+    // Whether finalize the fMP4 to progressive MP4 when segment closed.
+    virtual bool get_dvr_finalize(std::string vhost);
 // http api section
 private:
     // Whether http api enabled
@@ -1075,6 +1118,8 @@ public:
     // The device name configed in args of directive.
     // @return the disk device name to stat. NULL if not configed.
     virtual SrsConfDirective* get_stats_disk_device();
+    // Whether stat the latency of messages from ingress to consumers.
+    virtual bool get_stats_latency();
 };
 
 #endif
@@ -578,6 +578,11 @@ srs_error_t SrsTcpConnection::writev(const iovec *iov, int iov_size, ssize_t* nw
     return skt->writev(iov, iov_size, nwrite);
 }
 
+srs_error_t SrsTcpConnection::sendfile(int fd, int64_t offset, int64_t size, ssize_t* nwrite)
+{
+    return skt->sendfile(fd, offset, size, nwrite);
+}
+
 SrsSslConnection::SrsSslConnection(ISrsProtocolReadWriter* c)
 {
     transport = c;
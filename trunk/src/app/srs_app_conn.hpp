@@ -147,7 +147,7 @@ public:
 // The basic connection of SRS, for TCP based protocols,
 // all connections accept from listener must extends from this base class,
 // server will add the connection to manager, and delete it when remove.
-class SrsTcpConnection : public ISrsProtocolReadWriter
+class SrsTcpConnection : public ISrsProtocolReadWriter, public ISrsFileSender
 {
 private:
     // The underlayer st fd handler.
@@ -176,6 +176,9 @@ public:
     virtual srs_utime_t get_send_timeout();
     virtual srs_error_t write(void* buf, size_t size, ssize_t* nwrite);
     virtual srs_error_t writev(const iovec *iov, int iov_size, ssize_t* nwrite);
+// Interface ISrsFileSender
+public:
+    virtual srs_error_t sendfile(int fd, int64_t offset, int64_t size, ssize_t* nwrite);
 };
 
 // The SSL connection over TCP transport, in server mode.
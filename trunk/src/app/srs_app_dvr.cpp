@@ -89,6 +89,13 @@ srs_error_t SrsDvrSegmenter::open()
     srs_freep(jitter);
     jitter = new SrsRtmpJitter();
     
+    // Setup the file writer, to coalesce writes and reduce fragmentation of disk.
+    if ((err = fs->set_iobuf_size(_srs_config->get_dvr_buffer(req->vhost))) != srs_success) {
+        return srs_error_wrap(err, "set iobuf");
+    }
+    fs->set_preallocate(_srs_config->get_dvr_fallocate(req->vhost));
+    fs->set_direct_io(_srs_config->get_dvr_direct_io(req->vhost));
+    
     // open file writer, in append or create mode.
     string tmp_dvr_file = fragment->tmppath();
     if ((err = fs->open(tmp_dvr_file)) != srs_success) {
@@ -164,10 +171,18 @@ srs_error_t SrsDvrSegmenter::close()
     
     // Close the encoder, then close the fs object.
     err = close_encoder();
-    fs->close(); // Always close the file.
     if (err != srs_success) {
+        fs->close(); // Always close the file.
         return srs_error_wrap(err, "close encoder");
     }
+
+    // Flush the userspace buffer before close, because close never returns the error, and we should
+    // never reap the truncated segment, for example, no space left on device.
+    err = fs->flush();
+    fs->close(); // Always close the file.
+    if (err != srs_success) {
+        return srs_error_wrap(err, "flush file");
+    }
     
     // when tmp flv file exists, reap it.
     if ((err = fragment->rename()) != srs_success) {
@@ -517,6 +532,100 @@ srs_error_t SrsDvrMp4Segmenter::close_encoder()
     return err;
 }
 
+SrsDvrFmp4Segmenter::SrsDvrFmp4Segmenter()
+{
+    enc = new SrsMp4FragmentedEncoder();
+}
+
+SrsDvrFmp4Segmenter::~SrsDvrFmp4Segmenter()
+{
+    srs_freep(enc);
+}
+
+srs_error_t SrsDvrFmp4Segmenter::refresh_metadata()
+{
+    return srs_success;
+}
+
+srs_error_t SrsDvrFmp4Segmenter::open_encoder()
+{
+    srs_error_t err = srs_success;
+    
+    srs_freep(enc);
+    enc = new SrsMp4FragmentedEncoder();
+    
+    srs_utime_t duration = _srs_config->get_dvr_fragment(req->vhost);
+    bool finalize = _srs_config->get_dvr_finalize(req->vhost);
+    if ((err = enc->initialize(fs, duration, finalize)) != srs_success) {
+        return srs_error_wrap(err, "init encoder");
+    }
+    
+    return err;
+}
+
+srs_error_t SrsDvrFmp4Segmenter::encode_metadata(SrsSharedPtrMessage* /*metadata*/)
+{
+    return srs_success;
+}
+
+srs_error_t SrsDvrFmp4Segmenter::encode_audio(SrsSharedPtrMessage* audio, SrsFormat* format)
+{
+    srs_error_t err = srs_success;
+    
+    SrsAudioAacFrameTrait ct = format->audio->aac_packet_type;
+    if (ct == SrsAudioAacFrameTraitSequenceHeader || ct == SrsAudioMp3FrameTrait) {
+        enc->acodec = format->acodec->id;
+        enc->sample_rate = format->acodec->sound_rate;
+        enc->sound_bits = format->acodec->sound_size;
+        enc->channels = format->acodec->sound_type;
+    }
+    
+    uint8_t* sample = (uint8_t*)format->raw;
+    uint32_t nb_sample = (uint32_t)format->nb_raw;
+    
+    uint32_t dts = (uint32_t)audio->timestamp;
+    if ((err = enc->write_sample(format, SrsMp4HandlerTypeSOUN, 0x00, ct, dts, dts, sample, nb_sample)) != srs_success) {
+        return srs_error_wrap(err, "write sample");
+    }
+    
+    return err;
+}
+
+srs_error_t SrsDvrFmp4Segmenter::encode_video(SrsSharedPtrMessage* video, SrsFormat* format)
+{
+    srs_error_t err = srs_success;
+    
+    SrsVideoAvcFrameType frame_type = format->video->frame_type;
+    SrsVideoAvcFrameTrait ct = format->video->avc_packet_type;
+    uint32_t cts = (uint32_t)format->video->cts;
+    
+    if (ct == SrsVideoAvcFrameTraitSequenceHeader) {
+        enc->vcodec = format->vcodec->id;
+    }
+    
+    uint32_t dts = (uint32_t)video->timestamp;
+    uint32_t pts = dts + cts;
+    
+    uint8_t* sample = (uint8_t*)format->raw;
+    uint32_t nb_sample = (uint32_t)format->nb_raw;
+    if ((err = enc->write_sample(format, SrsMp4HandlerTypeVIDE, frame_type, ct, dts, pts, sample, nb_sample)) != srs_success) {
+        return srs_error_wrap(err, "write sample");
+    }
+    
+    return err;
+}
+
+srs_error_t SrsDvrFmp4Segmenter::close_encoder()
+{
+    srs_error_t err = srs_success;
+    
+    if ((err = enc->flush()) != srs_success) {
+        return srs_error_wrap(err, "flush encoder");
+    }
+    
+    return err;
+}
+
 SrsDvrAsyncCallOnDvr::SrsDvrAsyncCallOnDvr(SrsContextId c, SrsRequest* r, string p)
 {
     cid = c;
@@ -945,7 +1054,9 @@ srs_error_t SrsDvr::initialize(SrsOriginHub* h, SrsRequest* r)
     
     std::string path = _srs_config->get_dvr_path(r->vhost);
     SrsDvrSegmenter* segmenter = NULL;
-    if (srs_string_ends_with(path, ".mp4")) {
+    if (srs_string_ends_with(path, ".mp4") && _srs_config->get_dvr_fragment(r->vhost) > 0) {
+        segmenter = new SrsDvrFmp4Segmenter();
+    } else if (srs_string_ends_with(path, ".mp4")) {
         segmenter = new SrsDvrMp4Segmenter();
     } else {
         segmenter = new SrsDvrFlvSegmenter();
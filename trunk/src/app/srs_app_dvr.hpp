@@ -25,6 +25,7 @@ class SrsJsonAny;
 class SrsJsonObject;
 class SrsThread;
 class SrsMp4Encoder;
+class SrsMp4FragmentedEncoder;
 class SrsFragment;
 class SrsFormat;
 
@@ -42,8 +43,8 @@ protected:
     bool wait_keyframe;
     // The FLV/MP4 fragment file.
     SrsFragment* fragment;
-private:
     SrsRequest* req;
+private:
     SrsDvrPlan* plan;
 private:
     SrsRtmpJitter* jitter;
@@ -138,6 +139,25 @@ protected:
     virtual srs_error_t close_encoder();
 };
 
+// The fragmented MP4 segmenter, which writes fMP4 with bounded memory.
+class SrsDvrFmp4Segmenter : public SrsDvrSegmenter
+{
+private:
+    // The fMP4 encoder, for MP4 target.
+    SrsMp4FragmentedEncoder* enc;
+public:
+    SrsDvrFmp4Segmenter();
+    virtual ~SrsDvrFmp4Segmenter();
+public:
+    virtual srs_error_t refresh_metadata();
+protected:
+    virtual srs_error_t open_encoder();
+    virtual srs_error_t encode_metadata(SrsSharedPtrMessage* metadata);
+    virtual srs_error_t encode_audio(SrsSharedPtrMessage* audio, SrsFormat* format);
+    virtual srs_error_t encode_video(SrsSharedPtrMessage* video, SrsFormat* format);
+    virtual srs_error_t close_encoder();
+};
+
 // the dvr async call.
 class SrsDvrAsyncCallOnDvr : public ISrsAsyncCallTask
 {
@@ -150,6 +150,11 @@ void SrsEncoder::clear_engines()
     ffmpegs.clear();
 }
 
+bool SrsEncoder::has_engines()
+{
+    return !ffmpegs.empty();
+}
+
 SrsFFMPEG* SrsEncoder::at(int index)
 {
     return ffmpegs[index];
@@ -35,6 +35,8 @@ public:
 public:
     virtual srs_error_t on_publish(SrsRequest* req);
     virtual void on_unpublish();
+    // Whether there is any transcoding engine.
+    virtual bool has_engines();
 // Interface ISrsReusableThreadHandler.
 public:
     virtual srs_error_t cycle();
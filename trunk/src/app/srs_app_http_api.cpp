@@ -30,8 +30,11 @@ using namespace std;
 #include <srs_protocol_amf0.hpp>
 #include <srs_protocol_utility.hpp>
 #include <srs_app_coworkers.hpp>
+#include <srs_app_http_hooks.hpp>
+#include <srs_app_metrics.hpp>
+#include <srs_app_profiler.hpp>
 
-srs_error_t srs_api_response_jsonp(ISrsHttpResponseWriter* w, string callback, string data)
+srs_error_t srs_api_response_jsonp(ISrsHttpResponseWriter* w, const string& callback, const string& data)
 {
     srs_error_t err = srs_success;
     
@@ -80,7 +83,7 @@ srs_error_t srs_api_response_jsonp_code(ISrsHttpResponseWriter* w, string callba
     return srs_api_response_jsonp(w, callback, obj->dumps());
 }
 
-srs_error_t srs_api_response_json(ISrsHttpResponseWriter* w, string data)
+srs_error_t srs_api_response_json(ISrsHttpResponseWriter* w, const string& data)
 {
     srs_error_t err = srs_success;
     
@@ -116,7 +119,7 @@ srs_error_t srs_api_response_json_code(ISrsHttpResponseWriter* w, srs_error_t co
     return srs_api_response_json(w, obj->dumps());
 }
 
-srs_error_t srs_api_response(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, std::string json)
+srs_error_t srs_api_response(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, const std::string& json)
 {
     // no jsonp, directly response.
     if (!r->is_jsonp()) {
@@ -260,6 +263,7 @@ srs_error_t SrsGoApiV1::serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r
     urls->set("clients", SrsJsonAny::str("manage all clients or specified client, default query top 10 clients"));
     urls->set("raw", SrsJsonAny::str("raw api for srs, support CUID srs for instance the config"));
     urls->set("clusters", SrsJsonAny::str("origin cluster server API"));
+    urls->set("hooks", SrsJsonAny::str("the statistic of HTTP hooks, latency histogram in ms of [0,5,10,25,50,100,250,500,1000,+inf)"));
     urls->set("perf", SrsJsonAny::str("System performance stat"));
     urls->set("tcmalloc", SrsJsonAny::str("tcmalloc api with params ?page=summary|api"));
 
@@ -722,6 +726,21 @@ srs_error_t SrsGoApiVhosts::serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessag
     return srs_api_response(w, r, obj->dumps());
 }
 
+// Parse the page of stats from query, for example:
+//      ?start=0&count=10, page by index, the start is from 0.
+//      ?cursor=0&count=10, page by cursor, the cursor is the next of previous page.
+void srs_api_parse_page(ISrsHttpMessage* r, SrsStatisticPage* page)
+{
+    std::string rcursor = r->query_get("cursor");
+    std::string rstart = r->query_get("start");
+    std::string rcount = r->query_get("count");
+
+    page->by_cursor = !rcursor.empty();
+    page->cursor = (uint64_t)::strtoull(rcursor.c_str(), NULL, 10);
+    page->start = srs_max(0, atoi(rstart.c_str()));
+    page->count = srs_max(10, atoi(rcount.c_str()));
+}
+
 SrsGoApiStreams::SrsGoApiStreams()
 {
 }
@@ -732,8 +751,6 @@ SrsGoApiStreams::~SrsGoApiStreams()
 
 srs_error_t SrsGoApiStreams::serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r)
 {
-    srs_error_t err = srs_success;
-    
     SrsStatistic* stat = SrsStatistic::instance();
     
     // path: {pattern}{stream_id}
@@ -744,42 +761,36 @@ srs_error_t SrsGoApiStreams::serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessa
     if (!sid.empty() && (stream = stat->find_stream(sid)) == NULL) {
         return srs_api_response_code(w, r, ERROR_RTMP_STREAM_NOT_FOUND);
     }
-    
-    SrsJsonObject* obj = SrsJsonAny::object();
-    SrsAutoFree(SrsJsonObject, obj);
-    
-    obj->set("code", SrsJsonAny::integer(ERROR_SUCCESS));
-    obj->set("server", SrsJsonAny::str(stat->server_id().c_str()));
-    
-    if (r->is_http_get()) {
-        if (!stream) {
-            SrsJsonArray* data = SrsJsonAny::array();
-            obj->set("streams", data);
 
-            std::string rstart = r->query_get("start");
-            std::string rcount = r->query_get("count");
-            int start = srs_max(0, atoi(rstart.c_str()));
-            int count = srs_max(10, atoi(rcount.c_str()));
-            if ((err = stat->dumps_streams(data, start, count)) != srs_success) {
-                int code = srs_error_code(err);
-                srs_error_reset(err);
-                return srs_api_response_code(w, r, code);
-            }
-        } else {
-            SrsJsonObject* data = SrsJsonAny::object();
-            obj->set("stream", data);;
-            
-            if ((err = stream->dumps(data)) != srs_success) {
-                int code = srs_error_code(err);
-                srs_error_reset(err);
-                return srs_api_response_code(w, r, code);
-            }
-        }
-    } else {
+    if (!r->is_http_get()) {
         return srs_go_http_error(w, SRS_CONSTS_HTTP_MethodNotAllowed);
     }
+
+    // Write the response by streaming writer, never build the tree of JSON objects,
+    // because there might be lots of streams.
+    SrsJsonWriter jw;
+    jw.begin_object();
+    jw.key("code")->integer(ERROR_SUCCESS);
+    jw.key("server")->str(stat->server_id());
+
+    SrsStatisticPage page;
+    srs_api_parse_page(r, &page);
+    page.fields = srs_stat_stream_fields(r->query_get("fields"));
+
+    if (!stream) {
+        jw.key("streams");
+        stat->dumps_streams(&jw, &page);
+
+        jw.key("total")->integer(stat->nb_streams());
+        jw.key("next")->integer(page.next);
+    } else {
+        jw.key("stream");
+        stream->dumps(&jw, page.fields, srs_get_system_time());
+    }
+
+    jw.end_object();
     
-    return srs_api_response(w, r, obj->dumps());
+    return srs_api_response(w, r, jw.data());
 }
 
 SrsGoApiClients::SrsGoApiClients()
@@ -792,8 +803,6 @@ SrsGoApiClients::~SrsGoApiClients()
 
 srs_error_t SrsGoApiClients::serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r)
 {
-    srs_error_t err = srs_success;
-    
     SrsStatistic* stat = SrsStatistic::instance();
     
     // path: {pattern}{client_id}
@@ -804,36 +813,28 @@ srs_error_t SrsGoApiClients::serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessa
     if (!client_id.empty() && (client = stat->find_client(client_id)) == NULL) {
         return srs_api_response_code(w, r, ERROR_RTMP_CLIENT_NOT_FOUND);
     }
-    
-    SrsJsonObject* obj = SrsJsonAny::object();
-    SrsAutoFree(SrsJsonObject, obj);
-    
-    obj->set("code", SrsJsonAny::integer(ERROR_SUCCESS));
-    obj->set("server", SrsJsonAny::str(stat->server_id().c_str()));
+
+    // Write the response by streaming writer, never build the tree of JSON objects,
+    // because there might be lots of clients.
+    SrsJsonWriter jw;
+    jw.begin_object();
+    jw.key("code")->integer(ERROR_SUCCESS);
+    jw.key("server")->str(stat->server_id());
     
     if (r->is_http_get()) {
+        SrsStatisticPage page;
+        srs_api_parse_page(r, &page);
+        page.fields = srs_stat_client_fields(r->query_get("fields"));
+
         if (!client) {
-            SrsJsonArray* data = SrsJsonAny::array();
-            obj->set("clients", data);
-            
-            std::string rstart = r->query_get("start");
-            std::string rcount = r->query_get("count");
-            int start = srs_max(0, atoi(rstart.c_str()));
-            int count = srs_max(10, atoi(rcount.c_str()));
-            if ((err = stat->dumps_clients(data, start, count)) != srs_success) {
-                int code = srs_error_code(err);
-                srs_error_reset(err);
-                return srs_api_response_code(w, r, code);
-            }
+            jw.key("clients");
+            stat->dumps_clients(&jw, &page);
+
+            jw.key("total")->integer(stat->nb_clients());
+            jw.key("next")->integer(page.next);
         } else {
-            SrsJsonObject* data = SrsJsonAny::object();
-            obj->set("client", data);;
-            
-            if ((err = client->dumps(data)) != srs_success) {
-                int code = srs_error_code(err);
-                srs_error_reset(err);
-                return srs_api_response_code(w, r, code);
-            }
+            jw.key("client");
+            client->dumps(&jw, page.fields, srs_get_system_time());
         }
     } else if (r->is_http_delete()) {
         if (!client) {
@@ -850,8 +851,10 @@ srs_error_t SrsGoApiClients::serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessa
     } else {
         return srs_go_http_error(w, SRS_CONSTS_HTTP_MethodNotAllowed);
     }
+
+    jw.end_object();
     
-    return srs_api_response(w, r, obj->dumps());
+    return srs_api_response(w, r, jw.data());
 }
 
 SrsGoApiRaw::SrsGoApiRaw(SrsServer* svr)
@@ -963,6 +966,99 @@ srs_error_t SrsGoApiClusters::serve_http(ISrsHttpResponseWriter* w, ISrsHttpMess
     return srs_api_response(w, r, obj->dumps());
 }
 
+SrsGoApiHooks::SrsGoApiHooks()
+{
+}
+
+SrsGoApiHooks::~SrsGoApiHooks()
+{
+}
+
+srs_error_t SrsGoApiHooks::serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r)
+{
+    SrsJsonObject* obj = SrsJsonAny::object();
+    SrsAutoFree(SrsJsonObject, obj);
+    
+    obj->set("code", SrsJsonAny::integer(ERROR_SUCCESS));
+    obj->set("data", _srs_hooks->dumps());
+    
+    return srs_api_response(w, r, obj->dumps());
+}
+
+SrsGoApiMetrics::SrsGoApiMetrics()
+{
+}
+
+SrsGoApiMetrics::~SrsGoApiMetrics()
+{
+}
+
+srs_error_t SrsGoApiMetrics::serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r)
+{
+    srs_error_t err = srs_success;
+
+    std::string data = _srs_metrics->dumps();
+
+    SrsHttpHeader* h = w->header();
+    h->set_content_length(data.length());
+    h->set_content_type("text/plain; version=0.0.4");
+
+    if ((err = w->write((char*)data.data(), (int)data.length())) != srs_success) {
+        return srs_error_wrap(err, "write metrics");
+    }
+
+    return err;
+}
+
+SrsGoApiProfiler::SrsGoApiProfiler()
+{
+}
+
+SrsGoApiProfiler::~SrsGoApiProfiler()
+{
+}
+
+srs_error_t SrsGoApiProfiler::serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r)
+{
+    srs_error_t err = srs_success;
+
+    int seconds = 10;
+    if (!r->query_get("seconds").empty()) {
+        seconds = ::atoi(r->query_get("seconds").c_str());
+    }
+
+    int hz = SRS_PROFILER_DEFAULT_HZ;
+    if (!r->query_get("hz").empty()) {
+        hz = ::atoi(r->query_get("hz").c_str());
+    }
+
+    // Whether use the context id as root frame, to find out the hot coroutines.
+    bool by_cid = r->query_get("by") == "cid";
+
+    if ((err = _srs_cpu_profiler->start(hz, seconds * SRS_UTIME_SECONDS)) != srs_success) {
+        return srs_api_response_code(w, r, srs_error_wrap(err, "start profiler"));
+    }
+
+    // Sampling in this coroutine, other coroutines are running, and stop even if client closed.
+    srs_usleep(seconds * SRS_UTIME_SECONDS);
+    _srs_cpu_profiler->stop();
+
+    std::string data;
+    _srs_cpu_profiler->dumps(data, by_cid);
+
+    SrsHttpHeader* h = w->header();
+    h->set_content_length(data.length());
+    h->set_content_type("text/plain");
+    h->set("X-Samples", srs_int2str(_srs_cpu_profiler->nn_samples()));
+    h->set("X-Dropped", srs_int2str(_srs_cpu_profiler->nn_dropped()));
+
+    if ((err = w->write((char*)data.data(), (int)data.length())) != srs_success) {
+        return srs_error_wrap(err, "write profiler");
+    }
+
+    return err;
+}
+
 SrsGoApiError::SrsGoApiError()
 {
 }
@@ -1098,6 +1194,11 @@ srs_error_t SrsHttpApi::on_start()
         return srs_error_wrap(err, "set jsonp");
     }
 
+    // Send the response immediately, or the pipelined responses are delayed by Nagle and delayed ACK.
+    if ((err = skt->set_tcp_nodelay(true)) != srs_success) {
+        return srs_error_wrap(err, "set nodelay");
+    }
+
     if (ssl) {
         srs_utime_t starttime = srs_update_system_time();
         string crt_file = _srs_config->get_https_api_ssl_cert();
@@ -28,7 +28,7 @@ class SrsHttpConn;
 #include <srs_app_reload.hpp>
 #include <srs_app_http_conn.hpp>
 
-extern srs_error_t srs_api_response(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, std::string json);
+extern srs_error_t srs_api_response(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, const std::string& json);
 extern srs_error_t srs_api_response_code(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, int code);
 extern srs_error_t srs_api_response_code(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, srs_error_t code);
 
@@ -196,6 +196,36 @@ public:
     virtual srs_error_t serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r);
 };
 
+class SrsGoApiHooks : public ISrsHttpHandler
+{
+public:
+    SrsGoApiHooks();
+    virtual ~SrsGoApiHooks();
+public:
+    virtual srs_error_t serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r);
+};
+
+class SrsGoApiMetrics : public ISrsHttpHandler
+{
+public:
+    SrsGoApiMetrics();
+    virtual ~SrsGoApiMetrics();
+public:
+    virtual srs_error_t serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r);
+};
+
+// Sample the CPU for some seconds, response the folded stacks for flame graph, for example:
+//      curl 'http://127.0.0.1:1985/api/v1/profiler?seconds=30&hz=99' > srs.folded
+//      ./flamegraph.pl srs.folded > srs.svg
+class SrsGoApiProfiler : public ISrsHttpHandler
+{
+public:
+    SrsGoApiProfiler();
+    virtual ~SrsGoApiProfiler();
+public:
+    virtual srs_error_t serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r);
+};
+
 class SrsGoApiError : public ISrsHttpHandler
 {
 public:
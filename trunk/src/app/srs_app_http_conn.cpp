@@ -6,6 +6,9 @@
 
 #include <srs_app_http_conn.hpp>
 
+// The max bytes of body to drop for keep-alive, disconnect the client if body is larger.
+#define SRS_HTTP_DROP_BODY_MAX (256 * 1024)
+
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -217,8 +220,42 @@ srs_error_t SrsHttpConn::process_requests(SrsRequest** preq)
         if (!req->is_keep_alive()) {
             break;
         }
+
+        // For keep-alive and pipelined requests, the next request follows the body.
+        bool dropped = false;
+        if ((err = drop_body(req, &dropped)) != srs_success) {
+            return srs_error_wrap(err, "drop body");
+        }
+        if (!dropped) {
+            break;
+        }
+    }
+
+    return err;
+}
+
+srs_error_t SrsHttpConn::drop_body(ISrsHttpMessage* r, bool* pdropped)
+{
+    srs_error_t err = srs_success;
+
+    ISrsHttpResponseReader* br = r->body_reader();
+
+    char buf[SRS_HTTP_READ_CACHE_BYTES];
+    for (int nn_dropped = 0; !br->eof(); ) {
+        if (nn_dropped >= SRS_HTTP_DROP_BODY_MAX) {
+            srs_warn("HTTP: disconnect for body too large, dropped=%d", nn_dropped);
+            *pdropped = false;
+            return err;
+        }
+
+        ssize_t nb_read = 0;
+        if ((err = br->read(buf, sizeof(buf), &nb_read)) != srs_success) {
+            return srs_error_wrap(err, "read body");
+        }
+        nn_dropped += (int)nb_read;
     }
 
+    *pdropped = true;
     return err;
 }
 
@@ -359,6 +396,11 @@ srs_error_t SrsResponseOnlyHttpConn::on_start()
 {
     srs_error_t err = srs_success;
 
+    // Send the response immediately, or the pipelined responses are delayed by Nagle and delayed ACK.
+    if ((err = skt->set_tcp_nodelay(true)) != srs_success) {
+        return srs_error_wrap(err, "set nodelay");
+    }
+
     if (ssl)  {
         srs_utime_t starttime = srs_update_system_time();
         string crt_file = _srs_config->get_https_stream_ssl_cert();
@@ -103,6 +103,9 @@ private:
     virtual srs_error_t do_cycle();
     virtual srs_error_t process_requests(SrsRequest** preq);
     virtual srs_error_t process_request(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, int rid);
+    // Drop the body which is not read by handler, or it's parsed as the next pipelined request.
+    // @param pdropped Whether body is dropped, false if body is too large, so we should disconnect.
+    virtual srs_error_t drop_body(ISrsHttpMessage* r, bool* pdropped);
     // When the connection disconnect, call this method.
     // e.g. log msg of connection and report to other system.
     // @param request: request which is converted by the last http message.
@@ -32,6 +32,366 @@ using namespace std;
 // the timeout for hls notify, in srs_utime_t.
 #define SRS_HLS_NOTIFY_TIMEOUT (10 * SRS_UTIME_SECONDS)
 
+// The max number of cached verdicts of on_play.
+#define SRS_HOOK_VERDICTS_MAX 10000
+
+SrsHttpHooksDispatcher* _srs_hooks = NULL;
+
+SrsHttpHookPool::SrsHttpHookPool(string schema, string host, int port)
+{
+    schema_ = schema;
+    host_ = host;
+    port_ = port;
+    nn_busy_ = 0;
+    cond_ = srs_cond_new();
+}
+
+SrsHttpHookPool::~SrsHttpHookPool()
+{
+    reset();
+    srs_cond_destroy(cond_);
+}
+
+srs_error_t SrsHttpHookPool::acquire(int concurrency, SrsHttpClient** pclient, bool* preused)
+{
+    srs_error_t err = srs_success;
+
+    // Wait for a free client, rather than connect to the server for each callback.
+    while (nn_busy_ >= concurrency) {
+        if (srs_cond_timedwait(cond_, SRS_HTTP_CLIENT_TIMEOUT) != 0) {
+            return srs_error_new(ERROR_SOCKET_TIMEOUT, "http: pool %s://%s:%d timeout, busy=%d, concurrency=%d",
+                schema_.c_str(), host_.c_str(), port_, nn_busy_, concurrency);
+        }
+    }
+
+    nn_busy_++;
+
+    if (!idles_.empty()) {
+        *pclient = idles_.back();
+        idles_.pop_back();
+        *preused = true;
+        return err;
+    }
+
+    SrsHttpClient* client = new SrsHttpClient();
+    if ((err = client->initialize(schema_, host_, port_)) != srs_success) {
+        srs_freep(client);
+        release(NULL, false);
+        return srs_error_wrap(err, "http: init client");
+    }
+
+    *pclient = client;
+    *preused = false;
+
+    return err;
+}
+
+void SrsHttpHookPool::release(SrsHttpClient* client, bool keepalive)
+{
+    nn_busy_--;
+
+    if (client && keepalive) {
+        idles_.push_back(client);
+    } else {
+        srs_freep(client);
+    }
+
+    srs_cond_signal(cond_);
+}
+
+void SrsHttpHookPool::reset()
+{
+    for (int i = 0; i < (int)idles_.size(); i++) {
+        SrsHttpClient* client = idles_.at(i);
+        srs_freep(client);
+    }
+    idles_.clear();
+}
+
+int SrsHttpHookPool::idles()
+{
+    return (int)idles_.size();
+}
+
+int SrsHttpHookPool::busy()
+{
+    return nn_busy_;
+}
+
+SrsHttpHookStat::SrsHttpHookStat()
+{
+    nn_requests = nn_errors = nn_reused = nn_cached = 0;
+    memset(latency, 0, sizeof(latency));
+    total_latency = 0;
+}
+
+SrsHttpHookStat::~SrsHttpHookStat()
+{
+}
+
+void SrsHttpHookStat::update(srs_utime_t cost, bool ok)
+{
+    static int buckets[SRS_HOOK_LATENCY_BUCKETS - 1] = {5, 10, 25, 50, 100, 250, 500, 1000};
+
+    nn_requests++;
+    if (!ok) {
+        nn_errors++;
+    }
+    total_latency += cost;
+
+    int i = 0;
+    int ms = srsu2msi(cost);
+    while (i < SRS_HOOK_LATENCY_BUCKETS - 1 && ms >= buckets[i]) {
+        i++;
+    }
+    latency[i]++;
+}
+
+SrsJsonObject* SrsHttpHookStat::dumps()
+{
+    SrsJsonObject* obj = SrsJsonAny::object();
+
+    obj->set("requests", SrsJsonAny::integer(nn_requests));
+    obj->set("errors", SrsJsonAny::integer(nn_errors));
+    obj->set("reused", SrsJsonAny::integer(nn_reused));
+    obj->set("cached", SrsJsonAny::integer(nn_cached));
+    obj->set("avg_ms", SrsJsonAny::number(nn_requests? srsu2ms(total_latency) / (double)nn_requests : 0));
+
+    SrsJsonArray* arr = SrsJsonAny::array();
+    obj->set("latency", arr);
+    for (int i = 0; i < SRS_HOOK_LATENCY_BUCKETS; i++) {
+        arr->append(SrsJsonAny::integer(latency[i]));
+    }
+
+    return obj;
+}
+
+SrsHttpHooksDispatcher::SrsHttpHooksDispatcher()
+{
+}
+
+SrsHttpHooksDispatcher::~SrsHttpHooksDispatcher()
+{
+    std::map<std::string, SrsHttpHookPool*>::iterator it;
+    for (it = pools_.begin(); it != pools_.end(); ++it) {
+        SrsHttpHookPool* pool = it->second;
+        srs_freep(pool);
+    }
+    pools_.clear();
+
+    std::map<std::string, SrsHttpHookStat*>::iterator it2;
+    for (it2 = stats_.begin(); it2 != stats_.end(); ++it2) {
+        SrsHttpHookStat* stat = it2->second;
+        srs_freep(stat);
+    }
+    stats_.clear();
+}
+
+srs_error_t SrsHttpHooksDispatcher::post(string url, string req, int& code, string& res, bool* preused)
+{
+    srs_error_t err = srs_success;
+
+    SrsHttpUri uri;
+    if ((err = uri.initialize(url)) != srs_success) {
+        return srs_error_wrap(err, "http: post failed. url=%s", url.c_str());
+    }
+
+    string path = uri.get_path();
+    if (!uri.get_query().empty()) {
+        path += "?" + uri.get_query();
+    }
+
+    string key = uri.get_schema() + "://" + uri.get_host() + ":" + srs_int2str(uri.get_port());
+    SrsHttpHookPool* pool = NULL;
+    if (pools_.find(key) == pools_.end()) {
+        pool = pools_[key] = new SrsHttpHookPool(uri.get_schema(), uri.get_host(), uri.get_port());
+    } else {
+        pool = pools_[key];
+    }
+
+    bool stale = false;
+    if ((err = do_post(pool, path, req, code, res, preused, &stale)) == srs_success || !stale) {
+        return err;
+    }
+
+    // The server might close the idle connections, so we drop them and retry with a new connection.
+    srs_warn("http: retry for idle connection of %s, %s", key.c_str(), srs_error_summary(err).c_str());
+    srs_freep(err);
+    pool->reset();
+
+    if ((err = do_post(pool, path, req, code, res, preused, &stale)) != srs_success) {
+        return srs_error_wrap(err, "http: retry");
+    }
+
+    return err;
+}
+
+srs_error_t SrsHttpHooksDispatcher::do_post(SrsHttpHookPool* pool, string path, string req, int& code, string& res, bool* preused, bool* pstale)
+{
+    srs_error_t err = srs_success;
+
+    // Reuse the idle connection only if keepalive, however we always limit the concurrency.
+    bool keepalive = _srs_config->get_hooks_keepalive();
+    int concurrency = _srs_config->get_hooks_concurrency();
+
+    SrsHttpClient* client = NULL;
+    if ((err = pool->acquire(concurrency, &client, preused)) != srs_success) {
+        return srs_error_wrap(err, "http: acquire");
+    }
+
+    ISrsHttpMessage* msg = NULL;
+    int64_t nn_recv = client->get_recv_bytes();
+    if ((err = client->post(path, req, &msg)) != srs_success) {
+        *pstale = srs_http_hooks_is_stale(err, *preused, client->get_recv_bytes() != nn_recv);
+        pool->release(client, false);
+        return srs_error_wrap(err, "http: client post");
+    }
+
+    code = msg->status_code();
+    err = msg->body_read_all(res);
+
+    // Keep the connection only when the body is completely read.
+    keepalive = keepalive && err == srs_success && msg->is_keep_alive();
+    srs_freep(msg);
+    pool->release(client, keepalive);
+
+    if (err != srs_success) {
+        return srs_error_wrap(err, "http: body read");
+    }
+
+    return err;
+}
+
+SrsHttpHookStat* SrsHttpHooksDispatcher::stat(string action)
+{
+    std::map<std::string, SrsHttpHookStat*>::iterator it = stats_.find(action);
+    if (it != stats_.end()) {
+        return it->second;
+    }
+
+    SrsHttpHookStat* stat = new SrsHttpHookStat();
+    stats_[action] = stat;
+    return stat;
+}
+
+bool SrsHttpHooksDispatcher::verdict(string key, srs_error_t* perr)
+{
+    std::map<std::string, SrsHttpHookVerdict>::iterator it = verdicts_.find(key);
+    if (it == verdicts_.end()) {
+        return false;
+    }
+
+    SrsHttpHookVerdict& v = it->second;
+    if (v.expired < srs_get_system_time()) {
+        verdicts_.erase(it);
+        return false;
+    }
+
+    if (v.code != ERROR_SUCCESS) {
+        *perr = srs_error_new(v.code, "%s", v.desc.c_str());
+    }
+    return true;
+}
+
+void SrsHttpHooksDispatcher::update_verdict(string key, srs_error_t err, srs_utime_t ttl)
+{
+    srs_utime_t now = srs_get_system_time();
+
+    // Remove the expired verdicts, or all if still too many.
+    if (verdicts_.size() >= SRS_HOOK_VERDICTS_MAX) {
+        std::map<std::string, SrsHttpHookVerdict>::iterator it;
+        for (it = verdicts_.begin(); it != verdicts_.end();) {
+            if (it->second.expired < now) {
+                verdicts_.erase(it++);
+            } else {
+                ++it;
+            }
+        }
+    }
+    if (verdicts_.size() >= SRS_HOOK_VERDICTS_MAX) {
+        verdicts_.clear();
+    }
+
+    SrsHttpHookVerdict& v = verdicts_[key];
+    v.expired = now + ttl;
+    v.code = srs_error_code(err);
+    v.desc = err? srs_error_summary(err) : "";
+}
+
+SrsJsonObject* SrsHttpHooksDispatcher::dumps()
+{
+    SrsJsonObject* obj = SrsJsonAny::object();
+
+    SrsJsonObject* hooks = SrsJsonAny::object();
+    obj->set("hooks", hooks);
+
+    std::map<std::string, SrsHttpHookStat*>::iterator it;
+    for (it = stats_.begin(); it != stats_.end(); ++it) {
+        hooks->set(it->first, it->second->dumps());
+    }
+
+    SrsJsonObject* pools = SrsJsonAny::object();
+    obj->set("pools", pools);
+
+    std::map<std::string, SrsHttpHookPool*>::iterator it2;
+    for (it2 = pools_.begin(); it2 != pools_.end(); ++it2) {
+        SrsHttpHookPool* pool = it2->second;
+        pools->set(it2->first, SrsJsonAny::object()
+            ->set("busy", SrsJsonAny::integer(pool->busy()))
+            ->set("idle", SrsJsonAny::integer(pool->idles())));
+    }
+
+    obj->set("verdicts", SrsJsonAny::integer(verdicts_.size()));
+
+    return obj;
+}
+
+void SrsHttpHooksDispatcher::collect(SrsMetrics* metrics)
+{
+    // The upper bounds in seconds, see SRS_HOOK_LATENCY_BUCKETS.
+    static double bounds[SRS_HOOK_LATENCY_BUCKETS - 1] = {0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1};
+    std::vector<double> b(bounds, bounds + SRS_HOOK_LATENCY_BUCKETS - 1);
+
+    SrsMetric* latency = metrics->histogram("srs_hook_latency_seconds", "The latency of HTTP hooks.", b);
+    SrsMetric* errors = metrics->counter("srs_hook_errors_total", "The number of failed HTTP hooks.");
+    SrsMetric* reused = metrics->counter("srs_hook_reused_total", "The number of HTTP hooks by keep-alive connection.");
+    SrsMetric* cached = metrics->counter("srs_hook_cached_total", "The number of on_play hit the verdict cache.");
+    latency->reset();
+
+    std::map<std::string, SrsHttpHookStat*>::iterator it;
+    for (it = stats_.begin(); it != stats_.end(); ++it) {
+        SrsHttpHookStat* stat = it->second;
+        std::string labels = srs_metrics_label("action", it->first);
+
+        SrsMetricSeries* s = latency->with(labels);
+        for (int i = 0; i < SRS_HOOK_LATENCY_BUCKETS; i++) {
+            s->observe_bucket(i, stat->latency[i], 0);
+        }
+        s->sum = stat->total_latency / (double)SRS_UTIME_SECONDS;
+
+        errors->with(labels)->set((double)stat->nn_errors);
+        reused->with(labels)->set((double)stat->nn_reused);
+        cached->with(labels)->set((double)stat->nn_cached);
+    }
+}
+
+bool srs_http_hooks_is_stale(srs_error_t err, bool reused, bool received)
+{
+    if (!reused) {
+        return false;
+    }
+
+    // Failed to send the request, the server never got it.
+    int code = srs_error_code(err);
+    if (code == ERROR_SOCKET_WRITE || code == ERROR_HTTPS_WRITE) {
+        return true;
+    }
+
+    // The connection is closed before any response, the server closed the idle connection. Note that
+    // we never retry for read timeout, because the server might be handling the request.
+    return code == ERROR_SOCKET_READ && !received;
+}
+
 SrsHttpHooks::SrsHttpHooks()
 {
 }
@@ -66,8 +426,7 @@ srs_error_t SrsHttpHooks::on_connect(string url, SrsRequest* req)
     std::string res;
     int status_code;
     
-    SrsHttpClient http;
-    if ((err = do_post(&http, url, data, status_code, res)) != srs_success) {
+    if ((err = do_post("on_connect", url, data, status_code, res)) != srs_success) {
         return srs_error_wrap(err, "http: on_connect failed, client_id=%s, url=%s, request=%s, response=%s, code=%d",
             cid.c_str(), url.c_str(), data.c_str(), res.c_str(), status_code);
     }
@@ -102,8 +461,7 @@ void SrsHttpHooks::on_close(string url, SrsRequest* req, int64_t send_bytes, int
     std::string res;
     int status_code;
     
-    SrsHttpClient http;
-    if ((err = do_post(&http, url, data, status_code, res)) != srs_success) {
+    if ((err = do_post("on_close", url, data, status_code, res)) != srs_success) {
         int ret = srs_error_code(err);
         srs_freep(err);
         srs_warn("http: ignore on_close failed, client_id=%s, url=%s, request=%s, response=%s, code=%d, ret=%d",
@@ -142,8 +500,7 @@ srs_error_t SrsHttpHooks::on_publish(string url, SrsRequest* req)
     std::string res;
     int status_code;
     
-    SrsHttpClient http;
-    if ((err = do_post(&http, url, data, status_code, res)) != srs_success) {
+    if ((err = do_post("on_publish", url, data, status_code, res)) != srs_success) {
         return srs_error_wrap(err, "http: on_publish failed, client_id=%s, url=%s, request=%s, response=%s, code=%d",
             cid.c_str(), url.c_str(), data.c_str(), res.c_str(), status_code);
     }
@@ -178,8 +535,7 @@ void SrsHttpHooks::on_unpublish(string url, SrsRequest* req)
     std::string res;
     int status_code;
     
-    SrsHttpClient http;
-    if ((err = do_post(&http, url, data, status_code, res)) != srs_success) {
+    if ((err = do_post("on_unpublish", url, data, status_code, res)) != srs_success) {
         int ret = srs_error_code(err);
         srs_freep(err);
         srs_warn("http: ignore on_unpublish failed, client_id=%s, url=%s, request=%s, response=%s, status=%d, ret=%d",
@@ -216,10 +572,28 @@ srs_error_t SrsHttpHooks::on_play(string url, SrsRequest* req)
     
     std::string data = obj->dumps();
     std::string res;
-    int status_code;
+    int status_code = 0;
+    
+    // Use the cached verdict for the same player, which is identified by the request except the client_id.
+    srs_utime_t ttl = _srs_config->get_hooks_play_cache();
+    std::string key = url + " " + req->ip + " " + req->vhost + "/" + req->app + "/" + req->stream + " " + req->param + " " + req->pageUrl;
+    if (ttl > 0 && _srs_hooks->verdict(key, &err)) {
+        _srs_hooks->stat("on_play")->nn_cached++;
+        if (err != srs_success) {
+            return srs_error_wrap(err, "http: on_play cached, client_id=%s, url=%s", cid.c_str(), url.c_str());
+        }
+        srs_trace("http: on_play ok by cache, client_id=%s, url=%s, request=%s", cid.c_str(), url.c_str(), data.c_str());
+        return err;
+    }
     
-    SrsHttpClient http;
-    if ((err = do_post(&http, url, data, status_code, res)) != srs_success) {
+    err = do_post("on_play", url, data, status_code, res);
+    
+    // Only cache the verdict of callback server, never cache the failure of network or server.
+    if (ttl > 0 && (err == srs_success || srs_error_code(err) == ERROR_RESPONSE_CODE || (status_code >= 400 && status_code < 500))) {
+        _srs_hooks->update_verdict(key, err, ttl);
+    }
+    
+    if (err != srs_success) {
         return srs_error_wrap(err, "http: on_play failed, client_id=%s, url=%s, request=%s, response=%s, status=%d",
             cid.c_str(), url.c_str(), data.c_str(), res.c_str(), status_code);
     }
@@ -254,8 +628,7 @@ void SrsHttpHooks::on_stop(string url, SrsRequest* req)
     std::string res;
     int status_code;
     
-    SrsHttpClient http;
-    if ((err = do_post(&http, url, data, status_code, res)) != srs_success) {
+    if ((err = do_post("on_stop", url, data, status_code, res)) != srs_success) {
         int ret = srs_error_code(err);
         srs_freep(err);
         srs_warn("http: ignore on_stop failed, client_id=%s, url=%s, request=%s, response=%s, code=%d, ret=%d",
@@ -296,8 +669,7 @@ srs_error_t SrsHttpHooks::on_dvr(SrsContextId c, string url, SrsRequest* req, st
     std::string res;
     int status_code;
     
-    SrsHttpClient http;
-    if ((err = do_post(&http, url, data, status_code, res)) != srs_success) {
+    if ((err = do_post("on_dvr", url, data, status_code, res)) != srs_success) {
         return srs_error_wrap(err, "http post on_dvr uri failed, client_id=%s, url=%s, request=%s, response=%s, code=%d",
             cid.c_str(), url.c_str(), data.c_str(), res.c_str(), status_code);
     }
@@ -346,8 +718,7 @@ srs_error_t SrsHttpHooks::on_hls(SrsContextId c, string url, SrsRequest* req, st
     std::string res;
     int status_code;
     
-    SrsHttpClient http;
-    if ((err = do_post(&http, url, data, status_code, res)) != srs_success) {
+    if ((err = do_post("on_hls", url, data, status_code, res)) != srs_success) {
         return srs_error_wrap(err, "http: post %s with %s, status=%d, res=%s", url.c_str(), data.c_str(), status_code, res.c_str());
     }
     
@@ -434,8 +805,7 @@ srs_error_t SrsHttpHooks::discover_co_workers(string url, string& host, int& por
     std::string res;
     int status_code;
     
-    SrsHttpClient http;
-    if ((err = do_post(&http, url, "", status_code, res)) != srs_success) {
+    if ((err = do_post("discover_co_workers", url, "", status_code, res)) != srs_success) {
         return srs_error_wrap(err, "http: post %s, status=%d, res=%s", url.c_str(), status_code, res.c_str());
     }
     
@@ -507,8 +877,7 @@ srs_error_t SrsHttpHooks::on_forward_backend(string url, SrsRequest* req, std::v
     std::string res;
     int status_code;
 
-    SrsHttpClient http;
-    if ((err = do_post(&http, url, data, status_code, res)) != srs_success) {
+    if ((err = do_post("on_forward_backend", url, data, status_code, res)) != srs_success) {
         return srs_error_wrap(err, "http: on_forward_backend failed, client_id=%s, url=%s, request=%s, response=%s, code=%d",
             cid.c_str(), url.c_str(), data.c_str(), res.c_str(), status_code);
     }
@@ -552,34 +921,30 @@ srs_error_t SrsHttpHooks::on_forward_backend(string url, SrsRequest* req, std::v
     return err;
 }
 
-srs_error_t SrsHttpHooks::do_post(SrsHttpClient* hc, std::string url, std::string req, int& code, string& res)
+srs_error_t SrsHttpHooks::do_post(std::string action, std::string url, std::string req, int& code, string& res)
 {
     srs_error_t err = srs_success;
     
-    SrsHttpUri uri;
-    if ((err = uri.initialize(url)) != srs_success) {
-        return srs_error_wrap(err, "http: post failed. url=%s", url.c_str());
-    }
-    
-    if ((err = hc->initialize(uri.get_schema(), uri.get_host(), uri.get_port())) != srs_success) {
-        return srs_error_wrap(err, "http: init client");
-    }
+    SrsHttpHookStat* stat = _srs_hooks->stat(action);
+    srs_utime_t starttime = srs_update_system_time();
     
-    string path = uri.get_path();
-    if (!uri.get_query().empty()) {
-        path += "?" + uri.get_query();
+    bool reused = false;
+    err = _srs_hooks->post(url, req, code, res, &reused);
+    if (err == srs_success) {
+        err = verify_response(code, res);
     }
     
-    ISrsHttpMessage* msg = NULL;
-    if ((err = hc->post(path, req, &msg)) != srs_success) {
-        return srs_error_wrap(err, "http: client post");
+    stat->update(srs_update_system_time() - starttime, err == srs_success);
+    if (reused) {
+        stat->nn_reused++;
     }
-    SrsAutoFree(ISrsHttpMessage, msg);
     
-    code = msg->status_code();
-    if ((err = msg->body_read_all(res)) != srs_success) {
-        return srs_error_wrap(err, "http: body read");
-    }
+    return err;
+}
+
+srs_error_t SrsHttpHooks::verify_response(int code, string& res)
+{
+    srs_error_t err = srs_success;
     
     // ensure the http status is ok.
     if (code != SRS_CONSTS_HTTP_OK && code != SRS_CONSTS_HTTP_Created) {
@@ -11,12 +11,120 @@
 
 #include <string>
 #include <vector>
+#include <map>
+
+#include <srs_protocol_st.hpp>
+#include <srs_app_metrics.hpp>
 
 class SrsHttpUri;
 class SrsStSocket;
 class SrsRequest;
 class SrsHttpParser;
 class SrsHttpClient;
+class SrsJsonObject;
+
+// The pool of keep-alive connections to a callback server, identified by the schema, host and port.
+class SrsHttpHookPool
+{
+private:
+    std::string schema_;
+    std::string host_;
+    int port_;
+    // The idle clients, whose connections are kept alive.
+    std::vector<SrsHttpClient*> idles_;
+    // The number of clients in use, which is limited by concurrency.
+    int nn_busy_;
+    srs_cond_t cond_;
+public:
+    SrsHttpHookPool(std::string schema, std::string host, int port);
+    virtual ~SrsHttpHookPool();
+public:
+    // Fetch a client, or wait for a free one if exceed the max concurrency.
+    // @param preused Whether the client is an idle one, whose connection might be closed by server.
+    virtual srs_error_t acquire(int concurrency, SrsHttpClient** pclient, bool* preused);
+    // Return the client to pool, and keep it alive if keepalive, or close and free it.
+    virtual void release(SrsHttpClient* client, bool keepalive);
+    // Close all idle connections, for example, the server closed the idle connections.
+    virtual void reset();
+    virtual int idles();
+    virtual int busy();
+};
+
+// The number of buckets of hook latency, in ms:
+//      [0,5), [5,10), [10,25), [25,50), [50,100), [100,250), [250,500), [500,1000), [1000,+inf)
+#define SRS_HOOK_LATENCY_BUCKETS 9
+
+// The statistic of hook, to find out the slow callback server.
+class SrsHttpHookStat
+{
+public:
+    int64_t nn_requests;
+    int64_t nn_errors;
+    // The number of requests which reuse the keep-alive connection.
+    int64_t nn_reused;
+    // The number of on_play requests which hit the verdict cache.
+    int64_t nn_cached;
+    // The histogram of latency, see SRS_HOOK_LATENCY_BUCKETS.
+    int64_t latency[SRS_HOOK_LATENCY_BUCKETS];
+    srs_utime_t total_latency;
+public:
+    SrsHttpHookStat();
+    virtual ~SrsHttpHookStat();
+public:
+    virtual void update(srs_utime_t cost, bool ok);
+    virtual SrsJsonObject* dumps();
+};
+
+// The verdict of on_play, cached for players with the same ip, stream and param.
+struct SrsHttpHookVerdict
+{
+    srs_utime_t expired;
+    // The error code and description, ERROR_SUCCESS if allowed.
+    int code;
+    std::string desc;
+};
+
+// The dispatcher of HTTP hooks, which reuses the keep-alive connections to callback servers,
+// limits the concurrency, caches the verdict of on_play, and collects the latency of hooks.
+class SrsHttpHooksDispatcher : public ISrsMetricsCollector
+{
+private:
+    // The pools, key is schema://host:port.
+    std::map<std::string, SrsHttpHookPool*> pools_;
+    // The statistic of hooks, key is the action, such as on_play.
+    std::map<std::string, SrsHttpHookStat*> stats_;
+    // The verdicts of on_play, key is the url and request.
+    std::map<std::string, SrsHttpHookVerdict> verdicts_;
+public:
+    SrsHttpHooksDispatcher();
+    virtual ~SrsHttpHooksDispatcher();
+public:
+    // Post the request to url, by a pooled keep-alive connection.
+    // @param code The HTTP status code.
+    // @param res The HTTP body of response.
+    // @param preused Whether reuse the keep-alive connection.
+    virtual srs_error_t post(std::string url, std::string req, int& code, std::string& res, bool* preused);
+    // Fetch the statistic of action, create if not exists.
+    virtual SrsHttpHookStat* stat(std::string action);
+    // Load the cached verdict, return false if not found or expired.
+    virtual bool verdict(std::string key, srs_error_t* perr);
+    // Cache the verdict, which is an error or success.
+    virtual void update_verdict(std::string key, srs_error_t err, srs_utime_t ttl);
+    virtual SrsJsonObject* dumps();
+// Interface ISrsMetricsCollector
+public:
+    virtual void collect(SrsMetrics* metrics);
+private:
+    // @param pstale Whether the reused connection is closed by server, and the request is never handled.
+    virtual srs_error_t do_post(SrsHttpHookPool* pool, std::string path, std::string req, int& code, std::string& res, bool* preused, bool* pstale);
+};
+
+// Whether the reused connection is closed by server before handling the request, so it's safe to retry.
+// @param received Whether got any bytes of response.
+// @remark Never retry when the request might be handled, for example, read timeout, for duplicated callbacks.
+extern bool srs_http_hooks_is_stale(srs_error_t err, bool reused, bool received);
+
+extern SrsHttpHooksDispatcher* _srs_hooks;
 
 // the http hooks, http callback api,
 // for some event, such as on_connect, call
@@ -85,7 +193,8 @@ public:
     //         ignore if empty.
     static srs_error_t on_forward_backend(std::string url, SrsRequest* req, std::vector<std::string>& rtmp_urls);
 private:
-    static srs_error_t do_post(SrsHttpClient* hc, std::string url, std::string req, int& code, std::string& res);
+    static srs_error_t do_post(std::string action, std::string url, std::string req, int& code, std::string& res);
+    static srs_error_t verify_response(int code, std::string& res);
 };
 
 #endif
@@ -10,6 +10,7 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <sstream>
 using namespace std;
@@ -24,6 +25,7 @@ using namespace std;
 #include <srs_kernel_utility.hpp>
 #include <srs_kernel_file.hpp>
 #include <srs_kernel_flv.hpp>
+#include <srs_kernel_mp4.hpp>
 #include <srs_protocol_rtmp_stack.hpp>
 #include <srs_app_source.hpp>
 #include <srs_protocol_rtmp_msg_array.hpp>
@@ -41,14 +43,23 @@ using namespace std;
 
 #define SRS_CONTEXT_IN_HLS "hls_ctx"
 
+// The max number of cached index of mp4 or flv files, for each vhost.
+#define SRS_VOD_INDEX_CACHE_SIZE 128
+// The size of each write to send samples or tags from mmap.
+#define SRS_VOD_SEND_SIZE 65536
+
 SrsVodStream::SrsVodStream(string root_dir) : SrsHttpFileServer(root_dir)
 {
+    mp4_cache_ = new SrsVodIndexCache<SrsMp4VodIndex>(SRS_VOD_INDEX_CACHE_SIZE);
+    flv_cache_ = new SrsVodIndexCache<SrsFlvVodIndex>(SRS_VOD_INDEX_CACHE_SIZE);
     _srs_hybrid->timer5s()->subscribe(this);
 }
 
 SrsVodStream::~SrsVodStream()
 {
     _srs_hybrid->timer5s()->unsubscribe(this);
+    srs_freep(mp4_cache_);
+    srs_freep(flv_cache_);
     std::map<std::string, SrsM3u8CtxInfo>::iterator it;
     for (it = map_ctx_info_.begin(); it != map_ctx_info_.end(); ++it) {
         srs_freep(it->second.req);
@@ -73,65 +84,114 @@ srs_error_t SrsVodStream::serve_flv_stream(ISrsHttpResponseWriter* w, ISrsHttpMe
             fullpath.c_str(), fs->filesize(), offset);
     }
     
-    SrsFlvVodStreamDecoder ffd;
+    SrsFlvVodIndex* index = NULL;
+    if ((err = fetch_flv_index(fullpath, fs, &index)) != srs_success) {
+        return srs_error_wrap(err, "flv index");
+    }
+    
+    // Snap to the keyframe, because the offset from client maybe not a tag start.
+    return serve_flv_from(w, r, fs, index, index->snap(srs_max(offset, (int64_t)13)));
+}
+
+srs_error_t SrsVodStream::serve_flv_seek(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, string fullpath, srs_utime_t start)
+{
+    srs_error_t err = srs_success;
+    
+    SrsFileReader* fs = fs_factory->create_file_reader();
+    SrsAutoFree(SrsFileReader, fs);
     
-    // open fast decoder
-    if ((err = ffd.initialize(fs)) != srs_success) {
-        return srs_error_wrap(err, "init ffd");
+    if ((err = fs->open(fullpath)) != srs_success) {
+        return srs_error_wrap(err, "open file");
     }
     
-    // save header, send later.
-    char flv_header[13];
+    // Rollback to serve whole file, for example, the corrupt file.
+    SrsFlvVodIndex* index = NULL;
+    if ((err = fetch_flv_index(fullpath, fs, &index)) != srs_success) {
+        srs_warn("flv seek ignored, err %s", srs_error_desc(err).c_str());
+        srs_freep(err);
+        return serve_file(w, r, fullpath);
+    }
     
-    // send flv header
-    if ((err = ffd.read_header_ext(flv_header)) != srs_success) {
-        return srs_error_wrap(err, "ffd read header");
+    int64_t offset = 0;
+    if ((err = index->seek(srsu2ms(start), &offset)) != srs_success) {
+        return srs_error_wrap(err, "seek flv=%s to %" PRId64 "ms", fullpath.c_str(), srsu2ms(start));
     }
     
-    // save sequence header, send later
-    char* sh_data = NULL;
-    int sh_size = 0;
+    return serve_flv_from(w, r, fs, index, offset);
+}
+
+srs_error_t SrsVodStream::fetch_flv_index(string fullpath, SrsFileReader* fs, SrsFlvVodIndex** pindex)
+{
+    srs_error_t err = srs_success;
     
-    if (true) {
-        // send sequence header
-        int64_t start = 0;
-        if ((err = ffd.read_sequence_header_summary(&start, &sh_size)) != srs_success) {
-            return srs_error_wrap(err, "ffd read sps");
-        }
-        if (sh_size <= 0) {
-            return srs_error_new(ERROR_HTTP_REMUX_SEQUENCE_HEADER, "no sequence, size=%d", sh_size);
-        }
+    // The index is validated by size, modify time and inode, so it's rebuilt when file is
+    // changed or replaced. Only validated by size if stat failed, for example, the mock file.
+    int64_t size = fs->filesize();
+    int64_t mtime = 0;
+    uint64_t inode = 0;
+    
+    struct stat st;
+    if (::stat(fullpath.c_str(), &st) == 0) {
+        mtime = (int64_t)st.st_mtime;
+        inode = (uint64_t)st.st_ino;
     }
-    sh_data = new char[sh_size];
-    SrsAutoFreeA(char, sh_data);
-    if ((err = fs->read(sh_data, sh_size, NULL)) != srs_success) {
-        return srs_error_wrap(err, "fs read");
+    
+    SrsFlvVodIndex* index = flv_cache_->fetch(fullpath, size, mtime, inode);
+    if (!index) {
+        index = new SrsFlvVodIndex();
+        if ((err = index->initialize(fs, this)) != srs_success) {
+            srs_freep(index);
+            return srs_error_wrap(err, "build index of %s", fullpath.c_str());
+        }
+        
+        flv_cache_->update(fullpath, index, size, mtime, inode);
     }
     
+    *pindex = index;
+    return err;
+}
+
+srs_error_t SrsVodStream::on_scan_tags(int64_t pos)
+{
+    // Sleep to poll the IO of other connections, because yield only switches to the runnable ones.
+    srs_usleep(0);
+    return srs_success;
+}
+
+srs_error_t SrsVodStream::serve_flv_from(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, SrsFileReader* fs, SrsFlvVodIndex* index, int64_t offset)
+{
+    srs_error_t err = srs_success;
+    
+    // Copy the flv header and sequence header, because the index in cache might be freed by other
+    // connections, when writing to client which yields the coroutine.
+    char header[13];
+    memcpy(header, index->header(), sizeof(header));
+    std::vector<char> sh = index->sequence_header();
+    
     // seek to data offset
     int64_t left = fs->filesize() - offset;
     
-    // write http header for ts.
-    w->header()->set_content_length(sizeof(flv_header) + sh_size + left);
+    // write http header for flv.
+    w->header()->set_content_length(13 + (int64_t)sh.size() + left);
     w->header()->set_content_type("video/x-flv");
     w->write_header(SRS_CONSTS_HTTP_OK);
     
-    // write flv header and sequence header.
-    if ((err = w->write(flv_header, sizeof(flv_header))) != srs_success) {
+    // write flv header and sequence header, from the cached index.
+    if ((err = w->write(header, sizeof(header))) != srs_success) {
         return srs_error_wrap(err, "write flv header");
     }
-    if (sh_size > 0 && (err = w->write(sh_data, sh_size)) != srs_success) {
+    if (!sh.empty() && (err = w->write(&sh[0], (int)sh.size())) != srs_success) {
         return srs_error_wrap(err, "write sequence");
     }
     
     // write body.
-    if ((err = ffd.seek2(offset)) != srs_success) {
-        return srs_error_wrap(err, "ffd seek");
+    if (fs->seek2(offset) != offset) {
+        return srs_error_new(ERROR_SYSTEM_FILE_SEEK, "seek flv to %" PRId64, offset);
     }
     
     // send data
     if ((err = copy(w, fs, r, left)) != srs_success) {
-        return srs_error_wrap(err, "read flv=%s size=%" PRId64, fullpath.c_str(), left);
+        return srs_error_wrap(err, "read flv size=%" PRId64, left);
     }
     
     return err;
@@ -187,6 +247,62 @@ srs_error_t SrsVodStream::serve_mp4_stream(ISrsHttpResponseWriter* w, ISrsHttpMe
     return err;
 }
 
+srs_error_t SrsVodStream::serve_mp4_seek(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, string fullpath, srs_utime_t start)
+{
+    srs_error_t err = srs_success;
+    
+    // Map the file, to build index and send samples without read syscall.
+    SrsFileMmap* file = new SrsFileMmap();
+    SrsAutoFree(SrsFileMmap, file);
+    
+    if ((err = file->open(fullpath)) != srs_success) {
+        return srs_error_wrap(err, "mmap file");
+    }
+    
+    SrsMp4VodIndex* index = mp4_cache_->fetch(fullpath, file->size(), file->mtime(), file->inode());
+    if (!index) {
+        index = new SrsMp4VodIndex();
+        
+        // Rollback to serve whole file, for example, the fMP4 file which is not supported.
+        if ((err = index->initialize(file->data(), file->size())) != srs_success) {
+            srs_freep(index);
+            srs_warn("mp4 seek ignored, err %s", srs_error_desc(err).c_str());
+            srs_freep(err);
+            return serve_file(w, r, fullpath);
+        }
+        
+        mp4_cache_->update(fullpath, index, file->size(), file->mtime(), file->inode());
+    }
+    
+    std::vector<char> header;
+    uint64_t begin = 0, end = 0;
+    if ((err = index->seek(srsu2ms(start), header, &begin, &end)) != srs_success) {
+        return srs_error_wrap(err, "seek mp4=%s to %" PRId64 "ms", fullpath.c_str(), srsu2ms(start));
+    }
+    
+    w->header()->set_content_length((int64_t)(header.size() + end - begin));
+    w->header()->set_content_type("video/mp4");
+    w->write_header(SRS_CONSTS_HTTP_OK);
+    
+    if ((err = w->write(&header[0], (int)header.size())) != srs_success) {
+        return srs_error_wrap(err, "write header");
+    }
+    
+    // Send the samples in mmap directly.
+    char* p = file->data() + begin;
+    for (int64_t left = (int64_t)(end - begin); left > 0;) {
+        int size = (int)srs_min(left, SRS_VOD_SEND_SIZE);
+        if ((err = w->write(p, size)) != srs_success) {
+            return srs_error_wrap(err, "write samples size=%d, left=%" PRId64, size, left);
+        }
+        
+        p += size;
+        left -= size;
+    }
+    
+    return err;
+}
+
 srs_error_t SrsVodStream::serve_m3u8_ctx(ISrsHttpResponseWriter * w, ISrsHttpMessage * r, std::string fullpath)
 {
     srs_error_t err = srs_success;
@@ -10,6 +10,12 @@
 #include <srs_core.hpp>
 
 #include <srs_app_http_conn.hpp>
+#include <srs_kernel_utility.hpp>
+#include <srs_kernel_flv.hpp>
+
+class SrsFileMmap;
+class SrsFileReader;
+class SrsMp4VodIndex;
 
 struct SrsM3u8CtxInfo
 {
@@ -17,30 +23,128 @@ struct SrsM3u8CtxInfo
     SrsRequest* req;
 };
 
+// The cached index of vod file, validated by the size, modify time and inode of file.
+template<typename T>
+struct SrsVodIndexCacheItem
+{
+    T* index;
+    int64_t size;
+    int64_t mtime;
+    uint64_t inode;
+    // The last access time, to evict the least recently used item.
+    srs_utime_t atime;
+};
+
+// The LRU cache for index of vod files, to avoid parsing the file for each seeking.
+// @remark The T is the index, for example, SrsMp4VodIndex or SrsFlvVodIndex.
+template<typename T>
+class SrsVodIndexCache
+{
+private:
+    int max_items;
+    std::map<std::string, SrsVodIndexCacheItem<T> > items;
+public:
+    SrsVodIndexCache(int max) {
+        max_items = max;
+    }
+    virtual ~SrsVodIndexCache() {
+        typename std::map<std::string, SrsVodIndexCacheItem<T> >::iterator it;
+        for (it = items.begin(); it != items.end(); ++it) {
+            srs_freep(it->second.index);
+        }
+        items.clear();
+    }
+public:
+    // Fetch the index of file, NULL if not cached or file changed.
+    // @remark The index is owned by cache, and only valid before next update.
+    virtual T* fetch(std::string fullpath, int64_t size, int64_t mtime, uint64_t inode) {
+        typename std::map<std::string, SrsVodIndexCacheItem<T> >::iterator it = items.find(fullpath);
+        if (it == items.end()) {
+            return NULL;
+        }
+
+        SrsVodIndexCacheItem<T>& item = it->second;
+        if (item.size == size && item.mtime == mtime && item.inode == inode) {
+            item.atime = srs_get_system_time();
+            return item.index;
+        }
+
+        // The file is changed, drop the index to rebuild it.
+        srs_freep(item.index);
+        items.erase(it);
+        return NULL;
+    }
+    // Cache the index of file, evict the least recently used one if full.
+    // @remark The index is owned by cache.
+    virtual void update(std::string fullpath, T* index, int64_t size, int64_t mtime, uint64_t inode) {
+        // The index might be built by other connection, when we are building it.
+        typename std::map<std::string, SrsVodIndexCacheItem<T> >::iterator prev = items.find(fullpath);
+        if (prev != items.end()) {
+            srs_freep(prev->second.index);
+            items.erase(prev);
+        }
+
+        while (!items.empty() && (int)items.size() >= max_items) {
+            typename std::map<std::string, SrsVodIndexCacheItem<T> >::iterator it, lru = items.begin();
+            for (it = items.begin(); it != items.end(); ++it) {
+                if (it->second.atime < lru->second.atime) {
+                    lru = it;
+                }
+            }
+
+            srs_freep(lru->second.index);
+            items.erase(lru);
+        }
+
+        SrsVodIndexCacheItem<T> item;
+        item.index = index;
+        item.size = size;
+        item.mtime = mtime;
+        item.inode = inode;
+        item.atime = srs_get_system_time();
+        items[fullpath] = item;
+    }
+};
+
 // The flv vod stream supports flv?start=offset-bytes.
 // For example, http://server/file.flv?start=10240
 // server will write flv header and sequence header,
 // then seek(10240) and response flv tag data.
-class SrsVodStream : public SrsHttpFileServer, public ISrsFastTimer
+// The flv vod stream also supports flv?starttime=seconds, by the cached keyframe index,
+// and the offset in bytes is snapped to the keyframe before it.
+// For example, http://server/file.flv?starttime=10.5
+// The mp4 vod stream supports mp4?start=seconds, by remuxing from the keyframe.
+// For example, http://server/file.mp4?start=10.5
+class SrsVodStream : public SrsHttpFileServer, public ISrsFastTimer, public ISrsFlvVodIndexHandler
 {
 private:
     // The period of validity of the ctx
     std::map<std::string, SrsM3u8CtxInfo> map_ctx_info_;
+    // The index of mp4 and flv files for seeking.
+    SrsVodIndexCache<SrsMp4VodIndex>* mp4_cache_;
+    SrsVodIndexCache<SrsFlvVodIndex>* flv_cache_;
 public:
     SrsVodStream(std::string root_dir);
     virtual ~SrsVodStream();
 protected:
     virtual srs_error_t serve_flv_stream(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, std::string fullpath, int64_t offset);
+    virtual srs_error_t serve_flv_seek(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, std::string fullpath, srs_utime_t start);
     virtual srs_error_t serve_mp4_stream(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, std::string fullpath, int64_t start, int64_t end);
+    virtual srs_error_t serve_mp4_seek(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, std::string fullpath, srs_utime_t start);
     virtual srs_error_t serve_m3u8_ctx(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, std::string fullpath);
 private:
     virtual bool ctx_is_exist(std::string ctx);
     virtual void alive(std::string ctx, SrsRequest* req);
     virtual srs_error_t http_hooks_on_play(SrsRequest* req);
     virtual void http_hooks_on_stop(SrsRequest* req);
+    virtual srs_error_t fetch_flv_index(std::string fullpath, SrsFileReader* fs, SrsFlvVodIndex** pindex);
+    virtual srs_error_t serve_flv_from(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, SrsFileReader* fs, SrsFlvVodIndex* index, int64_t offset);
 // interface ISrsFastTimer
 private:
     srs_error_t on_timer(srs_utime_t interval);
+// interface ISrsFlvVodIndexHandler
+public:
+    virtual srs_error_t on_scan_tags(int64_t pos);
 };
 
 // The http static server instance,
@@ -8,11 +8,18 @@
 
 #define SRS_STREAM_CACHE_CYCLE (30 * SRS_UTIME_SECONDS)
 
+// The min duration of chunks for slow viewers, and the max number of chunks of stream.
+#define SRS_BUFFER_CHUNKS_WINDOW (3 * SRS_UTIME_SECONDS)
+#define SRS_BUFFER_CHUNKS_MAX 1024
+// The shared encoder stops if no viewer in this duration, to keep it for the reconnecting viewer.
+#define SRS_BUFFER_SHARED_IDLE_TIMEOUT (3 * SRS_UTIME_SECONDS)
+
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <string.h>
 
 #include <sstream>
 using namespace std;
@@ -234,6 +241,11 @@ srs_error_t SrsTsStreamEncoder::dump_cache(SrsLiveConsumer* /*consumer*/, SrsRtm
     return srs_success;
 }
 
+void SrsTsStreamEncoder::reset_pat_pmt()
+{
+    enc->reset_pat_pmt();
+}
+
 SrsFlvStreamEncoder::SrsFlvStreamEncoder()
 {
     header_written = false;
@@ -498,26 +510,542 @@ srs_error_t SrsBufferWriter::writev(const iovec* iov, int iovcnt, ssize_t* pnwri
     return writer->writev(iov, iovcnt, pnwrite);
 }
 
+SrsBufferChunkWriter::SrsBufferChunkWriter()
+{
+    buffer = new SrsSimpleStream();
+}
+
+SrsBufferChunkWriter::~SrsBufferChunkWriter()
+{
+    srs_freep(buffer);
+}
+
+srs_error_t SrsBufferChunkWriter::open(std::string /*file*/)
+{
+    return srs_success;
+}
+
+void SrsBufferChunkWriter::close()
+{
+}
+
+bool SrsBufferChunkWriter::is_open()
+{
+    return true;
+}
+
+int64_t SrsBufferChunkWriter::tellg()
+{
+    return buffer->length();
+}
+
+srs_error_t SrsBufferChunkWriter::write(void* buf, size_t count, ssize_t* pnwrite)
+{
+    buffer->append((const char*)buf, (int)count);
+    
+    if (pnwrite) {
+        *pnwrite = count;
+    }
+    return srs_success;
+}
+
+srs_error_t SrsBufferChunkWriter::writev(const iovec* iov, int iovcnt, ssize_t* pnwrite)
+{
+    ssize_t nwrite = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        buffer->append((const char*)iov[i].iov_base, (int)iov[i].iov_len);
+        nwrite += iov[i].iov_len;
+    }
+    
+    if (pnwrite) {
+        *pnwrite = nwrite;
+    }
+    return srs_success;
+}
+
+char* SrsBufferChunkWriter::bytes()
+{
+    return buffer->bytes();
+}
+
+int SrsBufferChunkWriter::length()
+{
+    return buffer->length();
+}
+
+void SrsBufferChunkWriter::reset()
+{
+    buffer->erase(buffer->length());
+}
+
+SrsBufferChunk::SrsBufferChunkPayload::SrsBufferChunkPayload()
+{
+    data = NULL;
+    size = 0;
+    shared_count = 0;
+}
+
+SrsBufferChunk::SrsBufferChunkPayload::~SrsBufferChunkPayload()
+{
+    srs_freepa(data);
+}
+
+SrsBufferChunk::SrsBufferChunk()
+{
+    ptr = NULL;
+    seq = 0;
+    timestamp = 0;
+    sync = false;
+}
+
+SrsBufferChunk::~SrsBufferChunk()
+{
+    if (ptr) {
+        if (ptr->shared_count == 0) {
+            srs_freep(ptr);
+        } else {
+            ptr->shared_count--;
+        }
+    }
+}
+
+void SrsBufferChunk::create(char* data, int size)
+{
+    srs_assert(!ptr);
+    
+    ptr = new SrsBufferChunkPayload();
+    ptr->size = size;
+    if (size > 0) {
+        ptr->data = new char[size];
+        memcpy(ptr->data, data, size);
+    }
+}
+
+char* SrsBufferChunk::data()
+{
+    return ptr? ptr->data : NULL;
+}
+
+int SrsBufferChunk::size()
+{
+    return ptr? ptr->size : 0;
+}
+
+SrsBufferChunk* SrsBufferChunk::copy()
+{
+    srs_assert(ptr);
+    
+    SrsBufferChunk* copy = new SrsBufferChunk();
+    
+    copy->ptr = ptr;
+    ptr->shared_count++;
+    
+    copy->seq = seq;
+    copy->timestamp = timestamp;
+    copy->sync = sync;
+    
+    return copy;
+}
+
+SrsBufferChunkQueue::SrsBufferChunkQueue(srs_utime_t jw)
+{
+    join_window = jw;
+    window = srs_max(jw, SRS_BUFFER_CHUNKS_WINDOW);
+    next_seq = 0;
+    latest_sync = -1;
+}
+
+SrsBufferChunkQueue::~SrsBufferChunkQueue()
+{
+    std::deque<SrsBufferChunk*>::iterator it;
+    for (it = chunks.begin(); it != chunks.end(); ++it) {
+        SrsBufferChunk* chunk = *it;
+        srs_freep(chunk);
+    }
+    chunks.clear();
+}
+
+int SrsBufferChunkQueue::size()
+{
+    return (int)chunks.size();
+}
+
+void SrsBufferChunkQueue::append(SrsBufferChunk* chunk)
+{
+    chunk->seq = next_seq++;
+    if (chunk->sync) {
+        latest_sync = chunk->seq;
+    }
+    
+    chunks.push_back(chunk);
+    
+    shrink();
+}
+
+void SrsBufferChunkQueue::fetch(int64_t* pseq, int max, std::vector<SrsBufferChunk*>& out)
+{
+    if (chunks.empty()) {
+        return;
+    }
+    
+    int64_t first = chunks.front()->seq;
+    
+    // Join from a sync chunk, for new viewer or the chunks of viewer are dropped, or the viewer
+    // is ahead of the queue, for example, the encoder is restarted.
+    if (*pseq < 0 || *pseq < first || *pseq > chunks.back()->seq + 1) {
+        int64_t start = -1;
+        if (join_window <= 0) {
+            start = latest_sync;
+        } else {
+            int64_t since = chunks.back()->timestamp - srsu2ms(join_window);
+            for (int i = 0; i < (int)chunks.size(); i++) {
+                SrsBufferChunk* chunk = chunks.at(i);
+                if (chunk->sync && chunk->timestamp >= since) {
+                    start = chunk->seq;
+                    break;
+                }
+            }
+            // Use the latest sync chunk if timestamp jumps.
+            if (start < 0) {
+                start = latest_sync;
+            }
+        }
+        
+        // Wait for sync chunk.
+        if (start < first) {
+            return;
+        }
+        
+        if (*pseq >= 0) {
+            srs_warn("http: viewer is too slow, skip chunks [%" PRId64 ", %" PRId64 ")", *pseq, start);
+        }
+        *pseq = start;
+    }
+    
+    for (int64_t i = *pseq - first; i < (int64_t)chunks.size() && (int)out.size() < max; i++) {
+        SrsBufferChunk* chunk = chunks.at(i);
+        out.push_back(chunk->copy());
+        *pseq = chunk->seq + 1;
+    }
+}
+
+void SrsBufferChunkQueue::shrink()
+{
+    while (chunks.size() > 1) {
+        SrsBufferChunk* front = chunks.front();
+        SrsBufferChunk* back = chunks.back();
+        
+        if ((int)chunks.size() <= SRS_BUFFER_CHUNKS_MAX) {
+            // Always keep the chunks from latest sync chunk, for new viewer to join.
+            if (latest_sync >= 0 && front->seq >= latest_sync) {
+                break;
+            }
+            
+            // Keep the chunks in window, unless timestamp jumps.
+            int64_t duration = back->timestamp - front->timestamp;
+            if (duration >= 0 && duration < srsu2ms(window)) {
+                break;
+            }
+        }
+        
+        chunks.pop_front();
+        srs_freep(front);
+    }
+}
+
+SrsBufferSharedEncoder::SrsBufferSharedEncoder(string p, SrsLiveSource* s, SrsRequest* r, SrsBufferCache* c)
+{
+    pattern = p;
+    source = s;
+    cache = c;
+    req = r->copy()->as_http();
+    trd = NULL;
+    enc = NULL;
+    writer = new SrsBufferChunkWriter();
+    chunks = NULL;
+    has_video = false;
+    timestamp = 0;
+    sync = false;
+    nn_viewers = 0;
+}
+
+SrsBufferSharedEncoder::~SrsBufferSharedEncoder()
+{
+    srs_freep(trd);
+    
+    srs_freep(enc);
+    srs_freep(writer);
+    srs_freep(chunks);
+    srs_freep(req);
+}
+
+srs_error_t SrsBufferSharedEncoder::update_auth(SrsLiveSource* s, SrsRequest* r)
+{
+    source = s;
+    
+    srs_freep(req);
+    req = r->copy()->as_http();
+    
+    return srs_success;
+}
+
+srs_error_t SrsBufferSharedEncoder::start()
+{
+    srs_error_t err = srs_success;
+    
+    // Restart the encoder if it failed, for example, the source error, so the viewers after
+    // the failure never wait for a dead encoder. Or it's stopped because there was no viewer.
+    if (trd && (err = trd->pull()) != srs_success) {
+        if (srs_error_code(err) == ERROR_HTTP_STREAM_EOF) {
+            srs_trace("http: restart shared encoder for %s, err %s", pattern.c_str(), srs_error_desc(err).c_str());
+        } else {
+            srs_warn("http: restart shared encoder for %s, err %s", pattern.c_str(), srs_error_desc(err).c_str());
+        }
+        srs_freep(err);
+        srs_freep(trd);
+    }
+    
+    // Started by the first viewer.
+    if (!trd) {
+        if ((err = initialize()) != srs_success) {
+            return srs_error_wrap(err, "init");
+        }
+        
+        trd = new SrsSTCoroutine("http-shared", this);
+        if ((err = trd->start()) != srs_success) {
+            srs_freep(trd);
+            return srs_error_wrap(err, "coroutine");
+        }
+    }
+    
+    nn_viewers++;
+    
+    return err;
+}
+
+void SrsBufferSharedEncoder::stop()
+{
+    // The coroutine quits by itself when no viewer for a while, which releases the consumer of source.
+    nn_viewers--;
+}
+
+srs_error_t SrsBufferSharedEncoder::fetch(int64_t* pseq, int max, std::vector<SrsBufferChunk*>& out)
+{
+    srs_error_t err = srs_success;
+    
+    // Quit all viewers if encoder failed.
+    if (trd && (err = trd->pull()) != srs_success) {
+        return srs_error_wrap(err, "shared encoder");
+    }
+    
+    if (chunks) {
+        chunks->fetch(pseq, max, out);
+    }
+    
+    return err;
+}
+
+string SrsBufferSharedEncoder::header()
+{
+    return header_;
+}
+
+srs_error_t SrsBufferSharedEncoder::initialize()
+{
+    srs_error_t err = srs_success;
+    
+    // For audio stream, viewer starts from the fast cache, like SrsBufferCache.
+    srs_utime_t join_window = 0;
+    
+    srs_freep(enc);
+    if (srs_string_ends_with(pattern, ".aac")) {
+        enc = new SrsAacStreamEncoder();
+        join_window = _srs_config->get_vhost_http_remux_fast_cache(req->vhost);
+    } else if (srs_string_ends_with(pattern, ".mp3")) {
+        enc = new SrsMp3StreamEncoder();
+        join_window = _srs_config->get_vhost_http_remux_fast_cache(req->vhost);
+    } else if (srs_string_ends_with(pattern, ".ts")) {
+        enc = new SrsTsStreamEncoder();
+    } else {
+        return srs_error_new(ERROR_HTTP_LIVE_STREAM_EXT, "invalid pattern=%s", pattern.c_str());
+    }
+    
+    srs_freep(chunks);
+    chunks = new SrsBufferChunkQueue(join_window);
+    
+    writer->reset();
+    if ((err = enc->initialize(writer, cache)) != srs_success) {
+        return srs_error_wrap(err, "init encoder");
+    }
+    
+    // The bytes written by initialize is the header, for example, the ID3 of MP3.
+    header_ = string(writer->bytes(), writer->length());
+    writer->reset();
+    
+    return err;
+}
+
+srs_error_t SrsBufferSharedEncoder::encode(SrsSharedPtrMessage** msgs, int count)
+{
+    srs_error_t err = srs_success;
+    
+    SrsTsStreamEncoder* tse = dynamic_cast<SrsTsStreamEncoder*>(enc);
+    
+    for (int i = 0; i < count; i++) {
+        SrsSharedPtrMessage* msg = msgs[i];
+        
+        if (!tse) {
+            // Each AAC/MP3 frame is able to be decoded.
+            sync = true;
+        } else {
+            if (msg->is_video()) {
+                has_video = true;
+            }
+            
+            // Cut chunk at keyframe, which starts with PAT/PMT. For pure audio, each chunk starts with PAT/PMT.
+            bool keyframe = msg->is_video() && SrsFlvVideo::keyframe(msg->payload, msg->size)
+                && !SrsFlvVideo::sh(msg->payload, msg->size);
+            bool pure_audio = !has_video && msg->is_audio() && !writer->length();
+            if (keyframe || pure_audio) {
+                cut();
+                tse->reset_pat_pmt();
+                sync = true;
+            }
+        }
+        
+        if (!writer->length()) {
+            timestamp = msg->timestamp;
+        }
+        
+        if (msg->is_audio()) {
+            err = enc->write_audio(msg->timestamp, msg->payload, msg->size);
+        } else if (msg->is_video()) {
+            err = enc->write_video(msg->timestamp, msg->payload, msg->size);
+        } else {
+            err = enc->write_metadata(msg->timestamp, msg->payload, msg->size);
+        }
+        
+        if (err != srs_success) {
+            return srs_error_wrap(err, "encode");
+        }
+    }
+    
+    cut();
+    
+    return err;
+}
+
+void SrsBufferSharedEncoder::cut()
+{
+    if (!writer->length()) {
+        return;
+    }
+    
+    SrsBufferChunk* chunk = new SrsBufferChunk();
+    chunk->create(writer->bytes(), writer->length());
+    chunk->timestamp = timestamp;
+    chunk->sync = sync;
+    
+    chunks->append(chunk);
+    
+    writer->reset();
+    sync = false;
+}
+
+srs_error_t SrsBufferSharedEncoder::cycle()
+{
+    srs_error_t err = srs_success;
+    
+    // Create consumer of source, use the audio gop cache for AAC/MP3.
+    SrsLiveConsumer* consumer = NULL;
+    SrsAutoFree(SrsLiveConsumer, consumer);
+    if ((err = source->create_consumer(consumer)) != srs_success) {
+        return srs_error_wrap(err, "create consumer");
+    }
+    if ((err = source->consumer_dumps(consumer, true, true, !enc->has_cache())) != srs_success) {
+        return srs_error_wrap(err, "dumps consumer");
+    }
+    if (enc->has_cache()) {
+        if ((err = enc->dump_cache(consumer, source->jitter())) != srs_success) {
+            return srs_error_wrap(err, "encoder dump cache");
+        }
+    }
+    
+    SrsMessageArray msgs(SRS_PERF_MW_MSGS);
+    srs_utime_t mw_sleep = _srs_config->get_mw_sleep(req->vhost);
+    srs_utime_t idle_at = 0;
+    
+    srs_trace("http: start shared encoder for %s, mw_sleep=%dms", pattern.c_str(), srsu2msi(mw_sleep));
+    
+    while (true) {
+        if ((err = trd->pull()) != srs_success) {
+            return srs_error_wrap(err, "shared encoder");
+        }
+        
+        // Stop if no viewer for a while, then the next viewer restarts it.
+        if (nn_viewers > 0) {
+            idle_at = 0;
+        } else if (!idle_at) {
+            idle_at = srs_get_system_time();
+        } else if (srs_get_system_time() - idle_at >= SRS_BUFFER_SHARED_IDLE_TIMEOUT) {
+            srs_freep(chunks);
+            return srs_error_new(ERROR_HTTP_STREAM_EOF, "no viewer of %s", pattern.c_str());
+        }
+        
+        // each msg in msgs.msgs must be free, for the SrsMessageArray never free them.
+        int count = 0;
+        if ((err = consumer->dump_packets(&msgs, count)) != srs_success) {
+            return srs_error_wrap(err, "consumer dump packets");
+        }
+        
+        if (count <= 0) {
+            srs_usleep(mw_sleep);
+            continue;
+        }
+        
+        err = encode(msgs.msgs, count);
+        
+        for (int i = 0; i < count; i++) {
+            SrsSharedPtrMessage* msg = msgs.msgs[i];
+            srs_freep(msg);
+        }
+        
+        if (err != srs_success) {
+            return srs_error_wrap(err, "encode messages");
+        }
+    }
+    
+    return err;
+}
+
 SrsLiveStream::SrsLiveStream(SrsLiveSource* s, SrsRequest* r, SrsBufferCache* c)
 {
     source = s;
     cache = c;
     req = r->copy()->as_http();
+    shared = NULL;
 }
 
 SrsLiveStream::~SrsLiveStream()
 {
+    srs_freep(shared);
     srs_freep(req);
 }
 
 srs_error_t SrsLiveStream::update_auth(SrsLiveSource* s, SrsRequest* r)
 {
+    srs_error_t err = srs_success;
+    
     source = s;
     
     srs_freep(req);
     req = r->copy()->as_http();
     
-    return srs_success;
+    if (shared && (err = shared->update_auth(s, r)) != srs_success) {
+        return srs_error_wrap(err, "shared encoder");
+    }
+    
+    return err;
 }
 
 srs_error_t SrsLiveStream::serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r)
@@ -542,6 +1070,7 @@ srs_error_t SrsLiveStream::do_serve_http(ISrsHttpResponseWriter* w, ISrsHttpMess
     string enc_desc;
     ISrsBufferEncoder* enc = NULL;
     
+    // For TS/AAC/MP3, all viewers share the encoder of stream, so there is no encoder for viewer.
     srs_assert(entry);
     if (srs_string_ends_with(entry->pattern, ".flv")) {
         w->header()->set_content_type("video/x-flv");
@@ -550,15 +1079,12 @@ srs_error_t SrsLiveStream::do_serve_http(ISrsHttpResponseWriter* w, ISrsHttpMess
     } else if (srs_string_ends_with(entry->pattern, ".aac")) {
         w->header()->set_content_type("audio/x-aac");
         enc_desc = "AAC";
-        enc = new SrsAacStreamEncoder();
     } else if (srs_string_ends_with(entry->pattern, ".mp3")) {
         w->header()->set_content_type("audio/mpeg");
         enc_desc = "MP3";
-        enc = new SrsMp3StreamEncoder();
     } else if (srs_string_ends_with(entry->pattern, ".ts")) {
         w->header()->set_content_type("video/MP2T");
         enc_desc = "TS";
-        enc = new SrsTsStreamEncoder();
     } else {
         return srs_error_new(ERROR_HTTP_LIVE_STREAM_EXT, "invalid pattern=%s", entry->pattern.c_str());
     }
@@ -570,11 +1096,13 @@ srs_error_t SrsLiveStream::do_serve_http(ISrsHttpResponseWriter* w, ISrsHttpMess
     // create consumer of souce, ignore gop cache, use the audio gop cache.
     SrsLiveConsumer* consumer = NULL;
     SrsAutoFree(SrsLiveConsumer, consumer);
-    if ((err = source->create_consumer(consumer)) != srs_success) {
-        return srs_error_wrap(err, "create consumer");
-    }
-    if ((err = source->consumer_dumps(consumer, true, true, !enc->has_cache())) != srs_success) {
-        return srs_error_wrap(err, "dumps consumer");
+    if (enc) {
+        if ((err = source->create_consumer(consumer)) != srs_success) {
+            return srs_error_wrap(err, "create consumer");
+        }
+        if ((err = source->consumer_dumps(consumer, true, true, !enc->has_cache())) != srs_success) {
+            return srs_error_wrap(err, "dumps consumer");
+        }
     }
 
     SrsPithyPrint* pprint = SrsPithyPrint::create_http_stream();
@@ -598,14 +1126,16 @@ srs_error_t SrsLiveStream::do_serve_http(ISrsHttpResponseWriter* w, ISrsHttpMess
     
     // the memory writer.
     SrsBufferWriter writer(w);
-    if ((err = enc->initialize(&writer, cache)) != srs_success) {
-        return srs_error_wrap(err, "init encoder");
-    }
-    
-    // if gop cache enabled for encoder, dump to consumer.
-    if (enc->has_cache()) {
-        if ((err = enc->dump_cache(consumer, source->jitter())) != srs_success) {
-            return srs_error_wrap(err, "encoder dump cache");
+    if (enc) {
+        if ((err = enc->initialize(&writer, cache)) != srs_success) {
+            return srs_error_wrap(err, "init encoder");
+        }
+        
+        // if gop cache enabled for encoder, dump to consumer.
+        if (enc->has_cache()) {
+            if ((err = enc->dump_cache(consumer, source->jitter())) != srs_success) {
+                return srs_error_wrap(err, "encoder dump cache");
+            }
         }
     }
 
@@ -616,12 +1146,11 @@ srs_error_t SrsLiveStream::do_serve_http(ISrsHttpResponseWriter* w, ISrsHttpMess
     SrsResponseOnlyHttpConn* rohc = dynamic_cast<SrsResponseOnlyHttpConn*>(hc->handler());
     srs_assert(rohc);
     
-    // Set the socket options for transport.
+    // Set the socket options for transport, note that the TCP_NODELAY is enabled for HTTP requests, so we must
+    // disable it if not configured.
     bool tcp_nodelay = _srs_config->get_tcp_nodelay(req->vhost);
-    if (tcp_nodelay) {
-        if ((err = rohc->set_tcp_nodelay(tcp_nodelay)) != srs_success) {
-            return srs_error_wrap(err, "set tcp nodelay");
-        }
+    if ((err = rohc->set_tcp_nodelay(tcp_nodelay)) != srs_success) {
+        return srs_error_wrap(err, "set tcp nodelay");
     }
     
     srs_utime_t mw_sleep = _srs_config->get_mw_sleep(req->vhost);
@@ -637,9 +1166,18 @@ srs_error_t SrsLiveStream::do_serve_http(ISrsHttpResponseWriter* w, ISrsHttpMess
         return srs_error_wrap(err, "start recv thread");
     }
     
-    srs_trace("FLV %s, encoder=%s, nodelay=%d, mw_sleep=%dms, cache=%d, msgs=%d",
+    srs_trace("FLV %s, encoder=%s, nodelay=%d, mw_sleep=%dms, cache=%d, shared=%d, msgs=%d",
         entry->pattern.c_str(), enc_desc.c_str(), tcp_nodelay, srsu2msi(mw_sleep),
-        enc->has_cache(), msgs.max);
+        enc? enc->has_cache() : false, !enc, msgs.max);
+
+    // Write the chunks of shared encoder.
+    if (!enc) {
+        return serve_shared(w, trd, pprint, mw_sleep);
+    }
+
+    // The latency of messages, see stats.latency.
+    SrsStatisticLatencyRecorder latency;
+    latency.initialize(req, SrsStatisticLatencyTypeHttp);
 
     // TODO: free and erase the disabled entry after all related connections is closed.
     // TODO: FXIME: Support timeout for player, quit infinite-loop.
@@ -672,11 +1210,15 @@ srs_error_t SrsLiveStream::do_serve_http(ISrsHttpResponseWriter* w, ISrsHttpMess
         }
         
         // sendout all messages.
+        latency.on_dequeue(msgs.msgs, count);
         if (ffe) {
             err = ffe->write_tags(msgs.msgs, count);
         } else {
             err = streaming_send_messages(enc, msgs.msgs, count);
         }
+        if (err == srs_success) {
+            latency.on_sent();
+        }
 
         // TODO: FIXME: Update the stat.
 
@@ -697,6 +1239,91 @@ srs_error_t SrsLiveStream::do_serve_http(ISrsHttpResponseWriter* w, ISrsHttpMess
     return srs_error_new(ERROR_HTTP_STREAM_EOF, "Stream EOF");
 }
 
+srs_error_t SrsLiveStream::serve_shared(ISrsHttpResponseWriter* w, SrsHttpRecvThread* trd, SrsPithyPrint* pprint, srs_utime_t mw_sleep)
+{
+    srs_error_t err = srs_success;
+    
+    if (!shared) {
+        shared = new SrsBufferSharedEncoder(entry->pattern, source, req, cache);
+    }
+    if ((err = shared->start()) != srs_success) {
+        return srs_error_wrap(err, "start shared encoder");
+    }
+    
+    err = do_serve_shared(w, trd, pprint, mw_sleep);
+    
+    shared->stop();
+    
+    return err;
+}
+
+srs_error_t SrsLiveStream::do_serve_shared(ISrsHttpResponseWriter* w, SrsHttpRecvThread* trd, SrsPithyPrint* pprint, srs_utime_t mw_sleep)
+{
+    srs_error_t err = srs_success;
+    
+    // The header and chunks to write in a time.
+    iovec* iovs = new iovec[1 + SRS_PERF_MW_MSGS];
+    SrsAutoFreeA(iovec, iovs);
+    
+    std::vector<SrsBufferChunk*> chunks;
+    int64_t seq = -1;
+    string header = shared->header();
+    bool header_written = false;
+    
+    // TODO: free and erase the disabled entry after all related connections is closed.
+    while (entry->enabled) {
+        // Whether client closed the FD.
+        if ((err = trd->pull()) != srs_success) {
+            return srs_error_wrap(err, "recv thread");
+        }
+        
+        pprint->elapse();
+        
+        // Start from a sync chunk, for example, the PAT/PMT and keyframe of TS.
+        chunks.clear();
+        if ((err = shared->fetch(&seq, SRS_PERF_MW_MSGS, chunks)) != srs_success) {
+            return srs_error_wrap(err, "fetch chunks");
+        }
+        
+        if (chunks.empty()) {
+            srs_usleep(mw_sleep);
+            continue;
+        }
+        
+        if (pprint->can_print()) {
+            srs_trace("-> " SRS_CONSTS_LOG_HTTP_STREAM " http: got %d chunks, seq=%" PRId64 ", age=%d, mw=%d",
+                (int)chunks.size(), seq, pprint->age(), srsu2msi(mw_sleep));
+        }
+        
+        int nn_iovs = 0;
+        if (!header_written && !header.empty()) {
+            iovs[nn_iovs].iov_base = (char*)header.data();
+            iovs[nn_iovs++].iov_len = header.length();
+        }
+        header_written = true;
+        
+        for (int i = 0; i < (int)chunks.size(); i++) {
+            SrsBufferChunk* chunk = chunks.at(i);
+            iovs[nn_iovs].iov_base = chunk->data();
+            iovs[nn_iovs++].iov_len = chunk->size();
+        }
+        
+        err = w->writev(iovs, nn_iovs, NULL);
+        
+        for (int i = 0; i < (int)chunks.size(); i++) {
+            SrsBufferChunk* chunk = chunks.at(i);
+            srs_freep(chunk);
+        }
+        
+        if (err != srs_success) {
+            return srs_error_wrap(err, "send chunks");
+        }
+    }
+    
+    // The entry is disabled by encoder un-publishing or reloading, disconnect the client.
+    return srs_error_new(ERROR_HTTP_STREAM_EOF, "Stream EOF");
+}
+
 srs_error_t SrsLiveStream::http_hooks_on_play(ISrsHttpMessage* r)
 {
     srs_error_t err = srs_success;
@@ -11,7 +11,13 @@
 
 #include <srs_app_http_conn.hpp>
 
+#include <deque>
+#include <vector>
+
 class SrsAacTransmuxer;
+class SrsSimpleStream;
+class SrsHttpRecvThread;
+class SrsPithyPrint;
 class SrsMp3Transmuxer;
 class SrsFlvTransmuxer;
 class SrsTsTransmuxer;
@@ -102,6 +108,9 @@ public:
 public:
     virtual bool has_cache();
     virtual srs_error_t dump_cache(SrsLiveConsumer* consumer, SrsRtmpJitterAlgorithm jitter);
+public:
+    // Write the PAT/PMT before next frame, for viewers to start from it.
+    virtual void reset_pat_pmt();
 };
 
 // Transmux RTMP with AAC stream to HTTP AAC Streaming.
@@ -161,6 +170,136 @@ public:
     virtual srs_error_t writev(const iovec* iov, int iovcnt, ssize_t* pnwrite);
 };
 
+// Write stream to memory, to cut the encoded bytes to chunks.
+class SrsBufferChunkWriter : public SrsFileWriter
+{
+private:
+    SrsSimpleStream* buffer;
+public:
+    SrsBufferChunkWriter();
+    virtual ~SrsBufferChunkWriter();
+public:
+    virtual srs_error_t open(std::string file);
+    virtual void close();
+public:
+    virtual bool is_open();
+    virtual int64_t tellg();
+public:
+    virtual srs_error_t write(void* buf, size_t count, ssize_t* pnwrite);
+    virtual srs_error_t writev(const iovec* iov, int iovcnt, ssize_t* pnwrite);
+public:
+    // The bytes written, and erase all bytes.
+    virtual char* bytes();
+    virtual int length();
+    virtual void reset();
+};
+
+// The chunk of encoded stream, the bytes are shared by all viewers.
+class SrsBufferChunk
+{
+private:
+    class SrsBufferChunkPayload
+    {
+    public:
+        char* data;
+        int size;
+        // The reference count of chunks which share this payload.
+        int shared_count;
+    public:
+        SrsBufferChunkPayload();
+        virtual ~SrsBufferChunkPayload();
+    };
+    SrsBufferChunkPayload* ptr;
+public:
+    // The sequence number of chunk, set by SrsBufferChunkQueue.
+    int64_t seq;
+    // The timestamp in ms of the first message in chunk.
+    int64_t timestamp;
+    // Whether viewer could start from this chunk, for example, the TS chunk starts with PAT/PMT and keyframe.
+    bool sync;
+public:
+    SrsBufferChunk();
+    virtual ~SrsBufferChunk();
+public:
+    // Create the chunk by copying the bytes.
+    virtual void create(char* data, int size);
+    virtual char* data();
+    virtual int size();
+    // Copy the chunk, which shares the same payload.
+    virtual SrsBufferChunk* copy();
+};
+
+// The queue of encoded chunks, viewers fetch the chunks by sequence number.
+class SrsBufferChunkQueue
+{
+private:
+    // The viewer starts from the oldest sync chunk in this window, or the latest sync chunk if zero.
+    srs_utime_t join_window;
+    // The chunks in this window are kept for slow viewers, as well as the chunks from latest sync chunk.
+    srs_utime_t window;
+    std::deque<SrsBufferChunk*> chunks;
+    int64_t next_seq;
+    int64_t latest_sync;
+public:
+    SrsBufferChunkQueue(srs_utime_t jw);
+    virtual ~SrsBufferChunkQueue();
+public:
+    virtual int size();
+    // Append the chunk, and the queue owns it.
+    virtual void append(SrsBufferChunk* chunk);
+    // Fetch at most max chunks of viewer, user must free the chunks.
+    // @param pseq The next sequence of viewer, -1 to join. It's updated to the next sequence to fetch.
+    // @remark The viewer joins again from a sync chunk, if it's too slow and the chunks are dropped, or it's ahead of queue.
+    virtual void fetch(int64_t* pseq, int max, std::vector<SrsBufferChunk*>& out);
+private:
+    virtual void shrink();
+};
+
+// The shared encoder of stream, encodes the TS/AAC/MP3 once to chunks, then all viewers write the same
+// chunks, so the cost of HTTP-TS viewer is about the same as HTTP-FLV.
+class SrsBufferSharedEncoder : public ISrsCoroutineHandler
+{
+private:
+    std::string pattern;
+    SrsRequest* req;
+    SrsLiveSource* source;
+    SrsBufferCache* cache;
+    SrsCoroutine* trd;
+    ISrsBufferEncoder* enc;
+    SrsBufferChunkWriter* writer;
+    SrsBufferChunkQueue* chunks;
+    // The header of stream, for example, the ID3 of MP3.
+    std::string header_;
+    bool has_video;
+    // The timestamp and sync flag of chunk in writer.
+    int64_t timestamp;
+    bool sync;
+    // The number of viewers, the encoder stops when no viewer for a while.
+    int nn_viewers;
+public:
+    SrsBufferSharedEncoder(std::string p, SrsLiveSource* s, SrsRequest* r, SrsBufferCache* c);
+    virtual ~SrsBufferSharedEncoder();
+    virtual srs_error_t update_auth(SrsLiveSource* s, SrsRequest* r);
+public:
+    // When viewer starts, initialize the encoder, and start to encode the stream if not started.
+    virtual srs_error_t start();
+    // When viewer stops, the encoder stops if no viewer.
+    virtual void stop();
+    // Fetch chunks for viewer, @see SrsBufferChunkQueue::fetch
+    virtual srs_error_t fetch(int64_t* pseq, int max, std::vector<SrsBufferChunk*>& out);
+    // The header to write before chunks, empty if not required.
+    virtual std::string header();
+public:
+    virtual srs_error_t initialize();
+    // Encode messages to chunks, cut a chunk at each keyframe for TS.
+    virtual srs_error_t encode(SrsSharedPtrMessage** msgs, int count);
+private:
+    virtual void cut();
+// Interface ISrsCoroutineHandler.
+public:
+    virtual srs_error_t cycle();
+};
+
 // HTTP Live Streaming, to transmux RTMP to HTTP FLV or other format.
 // TODO: FIXME: Rename to SrsHttpLive
 class SrsLiveStream : public ISrsHttpHandler
@@ -169,6 +308,8 @@ private:
     SrsRequest* req;
     SrsLiveSource* source;
     SrsBufferCache* cache;
+    // The shared encoder for TS/AAC/MP3, created when the first viewer comes.
+    SrsBufferSharedEncoder* shared;
 public:
     SrsLiveStream(SrsLiveSource* s, SrsRequest* r, SrsBufferCache* c);
     virtual ~SrsLiveStream();
@@ -177,6 +318,8 @@ public:
     virtual srs_error_t serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r);
 private:
     virtual srs_error_t do_serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r);
+    virtual srs_error_t serve_shared(ISrsHttpResponseWriter* w, SrsHttpRecvThread* trd, SrsPithyPrint* pprint, srs_utime_t mw_sleep);
+    virtual srs_error_t do_serve_shared(ISrsHttpResponseWriter* w, SrsHttpRecvThread* trd, SrsPithyPrint* pprint, srs_utime_t mw_sleep);
     virtual srs_error_t http_hooks_on_play(ISrsHttpMessage* r);
     virtual void http_hooks_on_stop(ISrsHttpMessage* r);
     virtual srs_error_t streaming_send_messages(ISrsBufferEncoder* enc, SrsSharedPtrMessage** msgs, int nb_msgs);
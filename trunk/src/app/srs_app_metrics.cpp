@@ -0,0 +1,616 @@
+//
+// Copyright (c) 2013-2022 The SRS Authors
+//
+// SPDX-License-Identifier: MIT or MulanPSL-2.0
+//
+
+#include <srs_app_metrics.hpp>
+
+#include <stdio.h>
+#include <unistd.h>
+#include <algorithm>
+using namespace std;
+
+#include <srs_kernel_error.hpp>
+#include <srs_kernel_kbps.hpp>
+#include <srs_app_utility.hpp>
+#include <srs_app_statistic.hpp>
+#include <srs_app_source.hpp>
+#include <srs_app_http_hooks.hpp>
+#ifdef SRS_RTC
+#include <srs_app_conn.hpp>
+#endif
+
+SrsMetrics* _srs_metrics = NULL;
+
+extern SrsPps* _srs_pps_conn;
+extern SrsPps* _srs_pps_pub;
+extern SrsPps* _srs_pps_dispose;
+extern SrsPps* _srs_pps_timer;
+extern SrsPps* _srs_pps_ids;
+extern SrsPps* _srs_pps_fids;
+extern SrsPps* _srs_pps_fids_level0;
+extern SrsPps* _srs_pps_cids_get;
+extern SrsPps* _srs_pps_cids_set;
+extern SrsPps* _srs_pps_objs_msgs;
+
+extern SrsPps* _srs_pps_rpkts;
+extern SrsPps* _srs_pps_addrs;
+extern SrsPps* _srs_pps_fast_addrs;
+extern SrsPps* _srs_pps_spkts;
+
+#if defined(SRS_DEBUG) && defined(SRS_DEBUG_STATS)
+extern unsigned long long _st_stat_recvfrom;
+extern unsigned long long _st_stat_recvfrom_eagain;
+extern unsigned long long _st_stat_sendto;
+extern unsigned long long _st_stat_sendto_eagain;
+extern unsigned long long _st_stat_read;
+extern unsigned long long _st_stat_read_eagain;
+extern unsigned long long _st_stat_readv;
+extern unsigned long long _st_stat_readv_eagain;
+extern unsigned long long _st_stat_writev;
+extern unsigned long long _st_stat_writev_eagain;
+extern unsigned long long _st_stat_recvmsg;
+extern unsigned long long _st_stat_recvmsg_eagain;
+extern unsigned long long _st_stat_sendmsg;
+extern unsigned long long _st_stat_sendmsg_eagain;
+extern unsigned long long _st_stat_epoll;
+extern unsigned long long _st_stat_epoll_zero;
+extern unsigned long long _st_stat_epoll_shake;
+extern unsigned long long _st_stat_epoll_spin;
+extern unsigned long long _st_stat_thread_run;
+extern unsigned long long _st_stat_thread_idle;
+extern unsigned long long _st_stat_thread_yield;
+extern unsigned long long _st_stat_thread_yield2;
+#endif
+
+extern SrsPps* _srs_pps_clock_15ms;
+extern SrsPps* _srs_pps_clock_20ms;
+extern SrsPps* _srs_pps_clock_25ms;
+extern SrsPps* _srs_pps_clock_30ms;
+extern SrsPps* _srs_pps_clock_35ms;
+extern SrsPps* _srs_pps_clock_40ms;
+extern SrsPps* _srs_pps_clock_80ms;
+extern SrsPps* _srs_pps_clock_160ms;
+extern SrsPps* _srs_pps_timer_s;
+
+#ifdef SRS_RTC
+extern SrsPps* _srs_pps_sstuns;
+extern SrsPps* _srs_pps_srtcps;
+extern SrsPps* _srs_pps_srtps;
+extern SrsPps* _srs_pps_rstuns;
+extern SrsPps* _srs_pps_rrtps;
+extern SrsPps* _srs_pps_rrtcps;
+extern SrsPps* _srs_pps_aloss2;
+extern SrsPps* _srs_pps_pli;
+extern SrsPps* _srs_pps_twcc;
+extern SrsPps* _srs_pps_rr;
+extern SrsPps* _srs_pps_snack;
+extern SrsPps* _srs_pps_snack2;
+extern SrsPps* _srs_pps_snack4;
+extern SrsPps* _srs_pps_sanack;
+extern SrsPps* _srs_pps_svnack;
+extern SrsPps* _srs_pps_rnack;
+extern SrsPps* _srs_pps_rnack2;
+extern SrsPps* _srs_pps_rhnack;
+extern SrsPps* _srs_pps_rmnack;
+extern SrsPps* _srs_pps_objs_rtps;
+extern SrsPps* _srs_pps_objs_rraw;
+extern SrsPps* _srs_pps_objs_rfua;
+extern SrsPps* _srs_pps_objs_rbuf;
+extern SrsPps* _srs_pps_objs_rothers;
+
+extern SrsResourceManager* _srs_rtc_manager;
+#endif
+
+// Format the number, the integer is formatted without the fraction part.
+static void srs_metrics_append_number(string& buf, double v)
+{
+    char tmp[64];
+    int nn = snprintf(tmp, sizeof(tmp), "%.15g", v);
+    buf.append(tmp, nn);
+}
+
+// Append the line of sample, for example:
+//      srs_streams_clients{label="x",vhost="y"} 10
+static void srs_metrics_append_sample(string& buf, const string& name, const char* suffix,
+    const string& const_labels, const string& labels, const string& extra, double v)
+{
+    buf.append(name);
+    if (suffix) {
+        buf.append(suffix);
+    }
+
+    if (!const_labels.empty() || !labels.empty() || !extra.empty()) {
+        bool first = true;
+        buf.append("{");
+
+        const string* parts[] = {&const_labels, &labels, &extra};
+        for (int i = 0; i < 3; i++) {
+            if (parts[i]->empty()) {
+                continue;
+            }
+            if (!first) {
+                buf.append(",");
+            }
+            buf.append(*parts[i]);
+            first = false;
+        }
+
+        buf.append("}");
+    }
+
+    buf.append(" ");
+    srs_metrics_append_number(buf, v);
+    buf.append("\n");
+}
+
+string srs_metrics_label(const string& key, const string& value)
+{
+    string label = key;
+    label.reserve(key.length() + value.length() + 3);
+    label.append("=\"");
+
+    // Escape the backslash, double-quote and line feed, see text exposition format.
+    for (int i = 0; i < (int)value.length(); i++) {
+        char c = value.at(i);
+        if (c == '\\') {
+            label.append("\\\\");
+        } else if (c == '"') {
+            label.append("\\\"");
+        } else if (c == '\n') {
+            label.append("\\n");
+        } else {
+            label.push_back(c);
+        }
+    }
+
+    label.append("\"");
+    return label;
+}
+
+SrsMetricSeries::SrsMetricSeries(const string& l, const vector<double>* b)
+{
+    labels = l;
+    value = 0;
+    bounds = b;
+    sum = 0;
+    count = 0;
+
+    if (bounds) {
+        buckets.resize(bounds->size() + 1, 0);
+    }
+}
+
+SrsMetricSeries::~SrsMetricSeries()
+{
+}
+
+void SrsMetricSeries::inc(double v)
+{
+    value += v;
+}
+
+void SrsMetricSeries::set(double v)
+{
+    value = v;
+}
+
+void SrsMetricSeries::observe(double v)
+{
+    if (!bounds) {
+        return;
+    }
+
+    // The bucket is the first one whose upper bound is not less than v, the last is +Inf.
+    int i = (int)(std::lower_bound(bounds->begin(), bounds->end(), v) - bounds->begin());
+    buckets[i]++;
+
+    sum += v;
+    count++;
+}
+
+void SrsMetricSeries::observe_bucket(int bucket, int64_t n, double s)
+{
+    if (bucket < 0 || bucket >= (int)buckets.size()) {
+        return;
+    }
+
+    buckets[bucket] += n;
+    sum += s;
+    count += n;
+}
+
+SrsMetric::SrsMetric(const string& n, const string& h, SrsMetricType t, const vector<double>& b)
+{
+    name = n;
+    help = h;
+    type = t;
+    bounds_ = b;
+    max_series_ = SRS_METRICS_MAX_SERIES;
+    overflow_ = NULL;
+}
+
+SrsMetric::~SrsMetric()
+{
+    reset();
+}
+
+SrsMetricSeries* SrsMetric::with(const string& labels)
+{
+    map<string, SrsMetricSeries*>::iterator it = series_.find(labels);
+    if (it != series_.end()) {
+        return it->second;
+    }
+
+    const vector<double>* bounds = (type == SrsMetricTypeHistogram) ? &bounds_ : NULL;
+
+    // Aggregate to the overflow series when exceed the max series, to limit the cardinality.
+    if (max_series_ > 0 && (int)series_.size() >= max_series_) {
+        return overflow();
+    }
+
+    SrsMetricSeries* series = new SrsMetricSeries(labels, bounds);
+    series_[labels] = series;
+    return series;
+}
+
+SrsMetricSeries* SrsMetric::get()
+{
+    return with("");
+}
+
+SrsMetricSeries* SrsMetric::overflow()
+{
+    if (!overflow_) {
+        const vector<double>* bounds = (type == SrsMetricTypeHistogram) ? &bounds_ : NULL;
+        overflow_ = new SrsMetricSeries("overflow=\"true\"", bounds);
+    }
+    return overflow_;
+}
+
+void SrsMetric::reset()
+{
+    map<string, SrsMetricSeries*>::iterator it;
+    for (it = series_.begin(); it != series_.end(); ++it) {
+        SrsMetricSeries* series = it->second;
+        srs_freep(series);
+    }
+    series_.clear();
+
+    srs_freep(overflow_);
+}
+
+void SrsMetric::set_max_series(int v)
+{
+    max_series_ = v;
+}
+
+int SrsMetric::size()
+{
+    return (int)series_.size() + (overflow_ ? 1 : 0);
+}
+
+void SrsMetric::dumps(string& buf, const string& const_labels)
+{
+    if (series_.empty() && !overflow_) {
+        return;
+    }
+
+    static const char* types[] = {"counter", "gauge", "histogram"};
+    buf.append("# HELP ").append(name).append(" ").append(help).append("\n");
+    buf.append("# TYPE ").append(name).append(" ").append(types[type]).append("\n");
+
+    vector<SrsMetricSeries*> series;
+    for (map<string, SrsMetricSeries*>::iterator it = series_.begin(); it != series_.end(); ++it) {
+        series.push_back(it->second);
+    }
+    if (overflow_) {
+        series.push_back(overflow_);
+    }
+
+    for (int i = 0; i < (int)series.size(); i++) {
+        SrsMetricSeries* s = series.at(i);
+
+        if (type != SrsMetricTypeHistogram) {
+            srs_metrics_append_sample(buf, name, NULL, const_labels, s->labels, "", s->value);
+            continue;
+        }
+
+        // The buckets of histogram are cumulative.
+        int64_t cumulative = 0;
+        for (int j = 0; j < (int)s->buckets.size(); j++) {
+            cumulative += s->buckets.at(j);
+
+            string le = "le=\"+Inf\"";
+            if (j < (int)bounds_.size()) {
+                le = "le=\"";
+                srs_metrics_append_number(le, bounds_.at(j));
+                le.append("\"");
+            }
+
+            srs_metrics_append_sample(buf, name, "_bucket", const_labels, s->labels, le, (double)cumulative);
+        }
+        srs_metrics_append_sample(buf, name, "_sum", const_labels, s->labels, "", s->sum);
+        srs_metrics_append_sample(buf, name, "_count", const_labels, s->labels, "", (double)s->count);
+    }
+}
+
+ISrsMetricsCollector::ISrsMetricsCollector()
+{
+}
+
+ISrsMetricsCollector::~ISrsMetricsCollector()
+{
+}
+
+SrsMetrics::SrsMetrics()
+{
+    max_series_ = SRS_METRICS_MAX_SERIES;
+}
+
+SrsMetrics::~SrsMetrics()
+{
+    for (int i = 0; i < (int)metrics_.size(); i++) {
+        SrsMetric* metric = metrics_.at(i);
+        srs_freep(metric);
+    }
+    metrics_.clear();
+    index_.clear();
+}
+
+SrsMetric* SrsMetrics::counter(const string& name, const string& help)
+{
+    return create(name, help, SrsMetricTypeCounter, vector<double>());
+}
+
+SrsMetric* SrsMetrics::gauge(const string& name, const string& help)
+{
+    return create(name, help, SrsMetricTypeGauge, vector<double>());
+}
+
+SrsMetric* SrsMetrics::histogram(const string& name, const string& help, const vector<double>& bounds)
+{
+    return create(name, help, SrsMetricTypeHistogram, bounds);
+}
+
+SrsMetric* SrsMetrics::find(const string& name)
+{
+    map<string, SrsMetric*>::iterator it = index_.find(name);
+    return (it != index_.end()) ? it->second : NULL;
+}
+
+void SrsMetrics::subscribe(ISrsMetricsCollector* collector)
+{
+    vector<ISrsMetricsCollector*>::iterator it = std::find(collectors_.begin(), collectors_.end(), collector);
+    if (it == collectors_.end()) {
+        collectors_.push_back(collector);
+    }
+}
+
+void SrsMetrics::unsubscribe(ISrsMetricsCollector* collector)
+{
+    vector<ISrsMetricsCollector*>::iterator it = std::find(collectors_.begin(), collectors_.end(), collector);
+    if (it != collectors_.end()) {
+        collectors_.erase(it);
+    }
+}
+
+void SrsMetrics::set_const_labels(const string& labels)
+{
+    const_labels_ = labels;
+}
+
+void SrsMetrics::set_max_series(int v)
+{
+    max_series_ = v;
+
+    for (int i = 0; i < (int)metrics_.size(); i++) {
+        metrics_.at(i)->set_max_series(v);
+    }
+}
+
+string SrsMetrics::dumps()
+{
+    for (int i = 0; i < (int)collectors_.size(); i++) {
+        ISrsMetricsCollector* collector = collectors_.at(i);
+        collector->collect(this);
+    }
+
+    string buf;
+    buf.reserve(16 * 1024);
+
+    for (int i = 0; i < (int)metrics_.size(); i++) {
+        SrsMetric* metric = metrics_.at(i);
+        metric->dumps(buf, const_labels_);
+    }
+
+    return buf;
+}
+
+SrsMetric* SrsMetrics::create(const string& name, const string& help, SrsMetricType type, const vector<double>& bounds)
+{
+    SrsMetric* metric = find(name);
+    if (metric) {
+        return metric;
+    }
+
+    metric = new SrsMetric(name, help, type, bounds);
+    metric->set_max_series(max_series_);
+
+    metrics_.push_back(metric);
+    index_[name] = metric;
+
+    return metric;
+}
+
+// The counters of global SrsPps, which are updated in hot path by sugar.
+struct SrsMetricsPps
+{
+    const char* name;
+    const char* help;
+    SrsPps** pps;
+};
+
+static SrsMetricsPps _srs_metrics_pps[] = {
+    {"srs_conn_created_total", "The number of connections created.", &_srs_pps_conn},
+    {"srs_conn_disposed_total", "The number of connections disposed.", &_srs_pps_dispose},
+    {"srs_publish_total", "The number of publishers.", &_srs_pps_pub},
+    {"srs_timer_total", "The number of timer events.", &_srs_pps_timer},
+    {"srs_conn_find_by_id_total", "The number of finding connection by id.", &_srs_pps_ids},
+    {"srs_conn_find_by_fast_id_total", "The number of finding connection by fast id.", &_srs_pps_fids},
+    {"srs_conn_find_by_fast_id_level0_total", "The number of finding connection in level-0 cache.", &_srs_pps_fids_level0},
+    {"srs_cid_get_total", "The number of getting context id.", &_srs_pps_cids_get},
+    {"srs_cid_set_total", "The number of setting context id.", &_srs_pps_cids_set},
+    {"srs_objs_msgs_total", "The number of shared messages created.", &_srs_pps_objs_msgs},
+    {"srs_udp_recv_packets_total", "The number of UDP packets received.", &_srs_pps_rpkts},
+    {"srs_udp_recv_addrs_total", "The number of peer address parsed.", &_srs_pps_addrs},
+    {"srs_udp_recv_fast_addrs_total", "The number of peer address parsed by fast id.", &_srs_pps_fast_addrs},
+    {"srs_udp_send_packets_total", "The number of UDP packets sent.", &_srs_pps_spkts},
+#ifdef SRS_RTC
+    {"srs_rtc_recv_stun_total", "The number of STUN packets received.", &_srs_pps_rstuns},
+    {"srs_rtc_recv_rtp_total", "The number of RTP packets received.", &_srs_pps_rrtps},
+    {"srs_rtc_recv_rtcp_total", "The number of RTCP packets received.", &_srs_pps_rrtcps},
+    {"srs_rtc_send_stun_total", "The number of STUN packets sent.", &_srs_pps_sstuns},
+    {"srs_rtc_send_rtp_total", "The number of RTP packets sent.", &_srs_pps_srtps},
+    {"srs_rtc_send_rtcp_total", "The number of RTCP packets sent.", &_srs_pps_srtcps},
+    {"srs_rtc_pli_total", "The number of PLI sent.", &_srs_pps_pli},
+    {"srs_rtc_twcc_total", "The number of TWCC sent.", &_srs_pps_twcc},
+    {"srs_rtc_rr_total", "The number of RR sent.", &_srs_pps_rr},
+    {"srs_rtc_audio_loss_total", "The number of audio packets lost.", &_srs_pps_aloss2},
+    {"srs_rtc_send_nack_total", "The number of NACK sent for lost packets.", &_srs_pps_snack},
+    {"srs_rtc_send_nack2_total", "The number of NACK packets sent.", &_srs_pps_snack2},
+    {"srs_rtc_send_nack4_total", "The number of NACK timeout.", &_srs_pps_snack4},
+    {"srs_rtc_send_anack_total", "The number of NACK for audio.", &_srs_pps_sanack},
+    {"srs_rtc_send_vnack_total", "The number of NACK for video.", &_srs_pps_svnack},
+    {"srs_rtc_recv_nack_total", "The number of NACK received.", &_srs_pps_rnack},
+    {"srs_rtc_recv_nack2_total", "The number of lost packets in NACK received.", &_srs_pps_rnack2},
+    {"srs_rtc_nack_hit_total", "The number of NACK packets retransmitted.", &_srs_pps_rhnack},
+    {"srs_rtc_nack_miss_total", "The number of NACK packets not found.", &_srs_pps_rmnack},
+    {"srs_objs_rtps_total", "The number of RTP packets created.", &_srs_pps_objs_rtps},
+    {"srs_objs_rraw_total", "The number of RTP raw payloads created.", &_srs_pps_objs_rraw},
+    {"srs_objs_rfua_total", "The number of RTP FU-A payloads created.", &_srs_pps_objs_rfua},
+    {"srs_objs_rbuf_total", "The number of RTP buffers created.", &_srs_pps_objs_rbuf},
+    {"srs_objs_rothers_total", "The number of RTP other payloads created.", &_srs_pps_objs_rothers},
+#endif
+};
+
+#if defined(SRS_DEBUG) && defined(SRS_DEBUG_STATS)
+// The counters of ST, which are only available for debug stats.
+struct SrsMetricsStStat
+{
+    const char* name;
+    const char* help;
+    unsigned long long* value;
+};
+
+static SrsMetricsStStat _srs_metrics_st[] = {
+    {"srs_io_recvfrom_total", "The number of recvfrom.", &_st_stat_recvfrom},
+    {"srs_io_recvfrom_eagain_total", "The number of recvfrom EAGAIN.", &_st_stat_recvfrom_eagain},
+    {"srs_io_sendto_total", "The number of sendto.", &_st_stat_sendto},
+    {"srs_io_sendto_eagain_total", "The number of sendto EAGAIN.", &_st_stat_sendto_eagain},
+    {"srs_io_read_total", "The number of read.", &_st_stat_read},
+    {"srs_io_read_eagain_total", "The number of read EAGAIN.", &_st_stat_read_eagain},
+    {"srs_io_readv_total", "The number of readv.", &_st_stat_readv},
+    {"srs_io_readv_eagain_total", "The number of readv EAGAIN.", &_st_stat_readv_eagain},
+    {"srs_io_writev_total", "The number of writev.", &_st_stat_writev},
+    {"srs_io_writev_eagain_total", "The number of writev EAGAIN.", &_st_stat_writev_eagain},
+    {"srs_io_recvmsg_total", "The number of recvmsg.", &_st_stat_recvmsg},
+    {"srs_io_recvmsg_eagain_total", "The number of recvmsg EAGAIN.", &_st_stat_recvmsg_eagain},
+    {"srs_io_sendmsg_total", "The number of sendmsg.", &_st_stat_sendmsg},
+    {"srs_io_sendmsg_eagain_total", "The number of sendmsg EAGAIN.", &_st_stat_sendmsg_eagain},
+    {"srs_epoll_total", "The number of epoll wait.", &_st_stat_epoll},
+    {"srs_epoll_zero_total", "The number of epoll wait without timeout.", &_st_stat_epoll_zero},
+    {"srs_epoll_shake_total", "The number of epoll wait without events.", &_st_stat_epoll_shake},
+    {"srs_epoll_spin_total", "The number of epoll spin.", &_st_stat_epoll_spin},
+    {"srs_thread_run_total", "The number of coroutine run.", &_st_stat_thread_run},
+    {"srs_thread_idle_total", "The number of idle coroutine run.", &_st_stat_thread_idle},
+    {"srs_thread_yield_total", "The number of coroutine yield.", &_st_stat_thread_yield},
+    {"srs_thread_yield2_total", "The number of coroutine yield by idle.", &_st_stat_thread_yield2},
+};
+#endif
+
+// The clock buckets of SrsClockWallMonitor, in ms, the overflow is in +Inf.
+static SrsPps** _srs_metrics_clock[] = {
+    &_srs_pps_clock_15ms, &_srs_pps_clock_20ms, &_srs_pps_clock_25ms, &_srs_pps_clock_30ms,
+    &_srs_pps_clock_35ms, &_srs_pps_clock_40ms, &_srs_pps_clock_80ms, &_srs_pps_clock_160ms,
+    &_srs_pps_timer_s,
+};
+
+// The collector for the global stat of server, such as the SrsPps and process.
+class SrsMetricsServerCollector : public ISrsMetricsCollector
+{
+public:
+    SrsMetricsServerCollector() {
+    }
+    virtual ~SrsMetricsServerCollector() {
+    }
+public:
+    virtual void collect(SrsMetrics* metrics) {
+        int nn = (int)(sizeof(_srs_metrics_pps) / sizeof(SrsMetricsPps));
+        for (int i = 0; i < nn; i++) {
+            SrsMetricsPps* p = &_srs_metrics_pps[i];
+            if (*p->pps) {
+                metrics->counter(p->name, p->help)->get()->set((double)(*p->pps)->sugar);
+            }
+        }
+
+#if defined(SRS_DEBUG) && defined(SRS_DEBUG_STATS)
+        nn = (int)(sizeof(_srs_metrics_st) / sizeof(SrsMetricsStStat));
+        for (int i = 0; i < nn; i++) {
+            SrsMetricsStStat* p = &_srs_metrics_st[i];
+            metrics->counter(p->name, p->help)->get()->set((double)*p->value);
+        }
+#endif
+
+        // The clock of timer, see SrsClockWallMonitor.
+        if (true) {
+            static double bounds[] = {0.015, 0.020, 0.025, 0.030, 0.035, 0.040, 0.080, 0.160};
+            vector<double> b(bounds, bounds + sizeof(bounds) / sizeof(double));
+
+            SrsMetric* m = metrics->histogram("srs_clock_wall_seconds", "The wall clock of timer, the slow timer means the server is busy.", b);
+            m->reset();
+
+            SrsMetricSeries* s = m->get();
+            for (int i = 0; i < (int)(sizeof(_srs_metrics_clock) / sizeof(SrsPps**)); i++) {
+                SrsPps* pps = *_srs_metrics_clock[i];
+                if (pps) {
+                    s->observe_bucket(i, pps->sugar, 0);
+                }
+            }
+        }
+
+        // The process stat, updated by the timer of server.
+        if (true) {
+            SrsProcSelfStat* u = srs_get_self_proc_stat();
+            if (u->ok) {
+                double hz = (double)sysconf(_SC_CLK_TCK);
+                metrics->counter("srs_process_cpu_seconds_total", "The user and system CPU time in seconds.")->get()->set((u->utime + u->stime) / hz);
+                metrics->gauge("srs_process_cpu_percent", "The CPU usage in percent, 15.3 is 15.3%.")->get()->set(u->percent * 100);
+                metrics->gauge("srs_process_resident_memory_bytes", "The resident memory size in bytes.")->get()->set((double)u->rss * sysconf(_SC_PAGESIZE));
+                metrics->gauge("srs_process_threads", "The number of threads.")->get()->set(u->num_threads);
+            }
+        }
+
+#ifdef SRS_RTC
+        if (_srs_rtc_manager) {
+            metrics->gauge("srs_rtc_sessions", "The number of RTC sessions.")->get()->set((double)_srs_rtc_manager->size());
+        }
+#endif
+    }
+};
+
+void srs_metrics_register_collectors(SrsMetrics* metrics)
+{
+    static SrsMetricsServerCollector server;
+    metrics->subscribe(&server);
+
+    metrics->subscribe(SrsStatistic::instance());
+    if (_srs_sources) {
+        metrics->subscribe(_srs_sources);
+    }
+    if (_srs_hooks) {
+        metrics->subscribe(_srs_hooks);
+    }
+}
+
@@ -0,0 +1,150 @@
+//
+// Copyright (c) 2013-2022 The SRS Authors
+//
+// SPDX-License-Identifier: MIT or MulanPSL-2.0
+//
+
+#ifndef SRS_APP_METRICS_HPP
+#define SRS_APP_METRICS_HPP
+
+#include <srs_core.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+class SrsMetrics;
+
+// The type of metric, see https://prometheus.io/docs/concepts/metric_types/
+enum SrsMetricType
+{
+    SrsMetricTypeCounter = 0,
+    SrsMetricTypeGauge = 1,
+    SrsMetricTypeHistogram = 2,
+};
+
+// The default max number of series of a metric, to limit the cardinality of labels.
+#define SRS_METRICS_MAX_SERIES 1000
+
+// A series of metric, identified by the labels, for example:
+//      vhost="__defaultVhost__",app="live",stream="livestream"
+// @remark The series is updated in the hot path directly without lock, because SRS runs all
+//      coroutines in one thread, so please cache the series and update it, like the SrsPps.
+class SrsMetricSeries
+{
+public:
+    std::string labels;
+    // The value of counter or gauge.
+    double value;
+public:
+    // For histogram, the upper bounds of buckets, which is shared by all series of metric.
+    const std::vector<double>* bounds;
+    // For histogram, the number of observations of each bucket, not cumulative, the last is +Inf.
+    std::vector<int64_t> buckets;
+    double sum;
+    int64_t count;
+public:
+    SrsMetricSeries(const std::string& l, const std::vector<double>* b);
+    virtual ~SrsMetricSeries();
+public:
+    // Increase the counter or gauge.
+    void inc(double v = 1);
+    // Set the value of gauge.
+    void set(double v);
+    // Observe a value for histogram.
+    void observe(double v);
+    // Add the observations of a bucket to histogram, for the collected histogram.
+    void observe_bucket(int bucket, int64_t n, double sum);
+};
+
+// A metric with a set of series, which are identified by labels.
+class SrsMetric
+{
+public:
+    std::string name;
+    std::string help;
+    SrsMetricType type;
+private:
+    // For histogram, the upper bounds of buckets, in ascending order.
+    std::vector<double> bounds_;
+    int max_series_;
+    // The key is the labels.
+    std::map<std::string, SrsMetricSeries*> series_;
+    // When exceed the max series, aggregate to this series, with label overflow="true".
+    SrsMetricSeries* overflow_;
+public:
+    SrsMetric(const std::string& n, const std::string& h, SrsMetricType t, const std::vector<double>& b);
+    virtual ~SrsMetric();
+public:
+    // Get or create the series by labels, see srs_metrics_label.
+    // @remark Return the overflow series if exceed the max series, never be NULL.
+    SrsMetricSeries* with(const std::string& labels);
+    // Get the series without labels.
+    SrsMetricSeries* get();
+    // Get or create the overflow series, with label overflow="true".
+    SrsMetricSeries* overflow();
+    // Remove all series, for the metric which is collected when scraping.
+    void reset();
+    void set_max_series(int v);
+    int size();
+public:
+    // Write in the text exposition format, with the constant labels.
+    void dumps(std::string& buf, const std::string& const_labels);
+};
+
+// The collector to update the metrics when scraping, for the stat which is already there,
+// for example, the SrsPps and the statistic of streams.
+class ISrsMetricsCollector
+{
+public:
+    ISrsMetricsCollector();
+    virtual ~ISrsMetricsCollector();
+public:
+    virtual void collect(SrsMetrics* metrics) = 0;
+};
+
+// The registry of metrics, which is exported in Prometheus text exposition format.
+// @see https://prometheus.io/docs/instrumenting/exposition_formats/
+class SrsMetrics
+{
+private:
+    // The metrics in the order of register.
+    std::vector<SrsMetric*> metrics_;
+    std::map<std::string, SrsMetric*> index_;
+    std::vector<ISrsMetricsCollector*> collectors_;
+    // The constant labels for all series, for example, label="cn-beijing",tag="cn-edge".
+    std::string const_labels_;
+    int max_series_;
+public:
+    SrsMetrics();
+    virtual ~SrsMetrics();
+public:
+    // Register or get the metric by name.
+    SrsMetric* counter(const std::string& name, const std::string& help);
+    SrsMetric* gauge(const std::string& name, const std::string& help);
+    // The bounds is the upper bounds of buckets, in ascending order.
+    SrsMetric* histogram(const std::string& name, const std::string& help, const std::vector<double>& bounds);
+    SrsMetric* find(const std::string& name);
+public:
+    void subscribe(ISrsMetricsCollector* collector);
+    void unsubscribe(ISrsMetricsCollector* collector);
+    void set_const_labels(const std::string& labels);
+    void set_max_series(int v);
+public:
+    // Collect and dumps all metrics in text exposition format.
+    std::string dumps();
+private:
+    SrsMetric* create(const std::string& name, const std::string& help, SrsMetricType type, const std::vector<double>& bounds);
+};
+
+// Build the label, with the value escaped, for example, vhost="__defaultVhost__"
+extern std::string srs_metrics_label(const std::string& key, const std::string& value);
+
+// Register the collectors for the global stat, such as the SrsPps and the statistic of streams.
+extern void srs_metrics_register_collectors(SrsMetrics* metrics);
+
+// The global metrics registry.
+extern SrsMetrics* _srs_metrics;
+
+#endif
+
@@ -0,0 +1,447 @@
+//
+// Copyright (c) 2013-2022 The SRS Authors
+//
+// SPDX-License-Identifier: MIT or MulanPSL-2.0
+//
+
+#include <srs_app_profiler.hpp>
+
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <cxxabi.h>
+#include <algorithm>
+using namespace std;
+
+#ifndef SRS_OSX
+#include <elf.h>
+#include <ucontext.h>
+#include <sys/syscall.h>
+#endif
+
+#include <srs_kernel_error.hpp>
+#include <srs_kernel_log.hpp>
+#include <srs_kernel_file.hpp>
+#include <srs_kernel_utility.hpp>
+#include <srs_core_autofree.hpp>
+
+// The glibc might not define it, see man sigevent.
+#if !defined(SRS_OSX) && !defined(sigev_notify_thread_id)
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+// The max frames of signal handler to skip.
+#define SRS_PROFILER_SKIP_DEPTH 8
+
+SrsCpuProfiler* _srs_cpu_profiler = NULL;
+
+SrsCpuSymbols::SrsCpuSymbols()
+{
+    loaded_ = false;
+    bias_ = 0;
+}
+
+SrsCpuSymbols::~SrsCpuSymbols()
+{
+}
+
+static bool srs_cpu_symbol_less(const SrsCpuSymbol& a, const SrsCpuSymbol& b)
+{
+    return a.address < b.address;
+}
+
+srs_error_t SrsCpuSymbols::load(string exe)
+{
+    srs_error_t err = srs_success;
+
+    if (loaded_) {
+        return err;
+    }
+    loaded_ = true;
+
+#ifdef SRS_OSX
+    return srs_error_new(ERROR_SYSTEM_PROFILER, "ELF not supported");
+#else
+    SrsFileMmap f;
+    if ((err = f.open(exe)) != srs_success) {
+        return srs_error_wrap(err, "open %s", exe.c_str());
+    }
+
+    char* data = f.data();
+    int64_t size = f.size();
+    if (size < (int64_t)sizeof(Elf64_Ehdr) || memcmp(data, ELFMAG, SELFMAG) != 0 || data[EI_CLASS] != ELFCLASS64) {
+        return srs_error_new(ERROR_SYSTEM_PROFILER, "not ELF64 %s", exe.c_str());
+    }
+
+    Elf64_Ehdr* eh = (Elf64_Ehdr*)data;
+    if (eh->e_shoff == 0 || eh->e_shoff + (uint64_t)eh->e_shnum * sizeof(Elf64_Shdr) > (uint64_t)size) {
+        return srs_error_new(ERROR_SYSTEM_PROFILER, "no sections %s", exe.c_str());
+    }
+
+    // Prefer the full symbol table, fallback to the dynamic symbol table for stripped binary.
+    Elf64_Shdr* shs = (Elf64_Shdr*)(data + eh->e_shoff);
+    Elf64_Shdr* symtab = NULL;
+    for (int i = 0; i < eh->e_shnum; i++) {
+        if (shs[i].sh_type == SHT_SYMTAB || (!symtab && shs[i].sh_type == SHT_DYNSYM)) {
+            symtab = &shs[i];
+        }
+    }
+    if (!symtab || symtab->sh_link >= eh->e_shnum) {
+        return srs_error_new(ERROR_SYSTEM_PROFILER, "no symtab %s", exe.c_str());
+    }
+
+    Elf64_Shdr* strtab = &shs[symtab->sh_link];
+    if (symtab->sh_offset + symtab->sh_size > (uint64_t)size || strtab->sh_offset + strtab->sh_size > (uint64_t)size) {
+        return srs_error_new(ERROR_SYSTEM_PROFILER, "invalid symtab %s", exe.c_str());
+    }
+
+    // Copy the string table, because the file is unmapped when done.
+    strtab_.assign(data + strtab->sh_offset, strtab->sh_size);
+
+    Elf64_Sym* syms = (Elf64_Sym*)(data + symtab->sh_offset);
+    int nn_syms = (int)(symtab->sh_size / sizeof(Elf64_Sym));
+    for (int i = 0; i < nn_syms; i++) {
+        Elf64_Sym* sym = &syms[i];
+        if (ELF64_ST_TYPE(sym->st_info) != STT_FUNC || !sym->st_value || sym->st_name >= strtab_.size()) {
+            continue;
+        }
+
+        SrsCpuSymbol s;
+        s.address = sym->st_value;
+        s.size = sym->st_size;
+        s.name = sym->st_name;
+        symbols_.push_back(s);
+    }
+    std::sort(symbols_.begin(), symbols_.end(), srs_cpu_symbol_less);
+
+    // For PIE, the symbol address is relative to the load address of executable.
+    if (eh->e_type == ET_DYN) {
+        Dl_info info;
+        if (dladdr((void*)srs_cpu_symbol_less, &info) != 0) {
+            bias_ = (uint64_t)info.dli_fbase;
+        }
+    }
+
+    return err;
+#endif
+}
+
+string SrsCpuSymbols::resolve(void* pc)
+{
+    std::map<void*, std::string>::iterator it = cache_.find(pc);
+    if (it != cache_.end()) {
+        return it->second;
+    }
+
+    string name;
+    const char* mangled = NULL;
+
+    const SrsCpuSymbol* sym = find((uint64_t)pc - bias_);
+    if (sym) {
+        mangled = strtab_.c_str() + sym->name;
+    }
+
+    Dl_info info;
+    memset(&info, 0, sizeof(info));
+    if (!mangled && dladdr(pc, &info) != 0 && info.dli_sname) {
+        mangled = info.dli_sname;
+    }
+
+    if (mangled) {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(mangled, NULL, NULL, &status);
+        name = (status == 0 && demangled) ? demangled : mangled;
+        free(demangled);
+    } else if (info.dli_fname) {
+        // Format as module+offset, which can be resolved by addr2line.
+        string module = info.dli_fname;
+        size_t pos = module.rfind('/');
+        if (pos != string::npos) {
+            module = module.substr(pos + 1);
+        }
+        char buf[256];
+        snprintf(buf, sizeof(buf), "%s+0x%" PRIx64, module.c_str(), (uint64_t)pc - (uint64_t)info.dli_fbase);
+        name = buf;
+    } else {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "0x%" PRIx64, (uint64_t)pc);
+        name = buf;
+    }
+
+    // The semicolon is the separator of frames in folded stacks.
+    std::replace(name.begin(), name.end(), ';', ':');
+
+    cache_[pc] = name;
+    return name;
+}
+
+int SrsCpuSymbols::size()
+{
+    return (int)symbols_.size();
+}
+
+const SrsCpuSymbol* SrsCpuSymbols::find(uint64_t address)
+{
+    if (symbols_.empty()) {
+        return NULL;
+    }
+
+    // Find the last symbol whose address is not larger than the address.
+    SrsCpuSymbol key;
+    key.address = address;
+    vector<SrsCpuSymbol>::iterator it = std::upper_bound(symbols_.begin(), symbols_.end(), key, srs_cpu_symbol_less);
+    if (it == symbols_.begin()) {
+        return NULL;
+    }
+    --it;
+
+    // Ignore if out of the function, or symbols without size, such as _fini, which is the last
+    // symbol so all addresses of shared libraries are matched.
+    if (address >= it->address + it->size) {
+        return NULL;
+    }
+    return &*it;
+}
+
+#ifndef SRS_OSX
+static struct sigaction _srs_profiler_old_action;
+// The running profiler, which handles the signal.
+static SrsCpuProfiler* _srs_profiler_current = NULL;
+
+static void srs_profiler_on_signal(int /*signo*/, siginfo_t* /*info*/, void* ucontext)
+{
+    int saved_errno = errno;
+
+    // The interrupted address, to skip the frames of signal handler.
+    void* pc = NULL;
+    ucontext_t* uc = (ucontext_t*)ucontext;
+#if defined(__x86_64__)
+    pc = (void*)uc->uc_mcontext.gregs[REG_RIP];
+#elif defined(__aarch64__)
+    pc = (void*)uc->uc_mcontext.pc;
+#else
+    (void)uc;
+#endif
+
+    if (_srs_profiler_current) {
+        _srs_profiler_current->on_signal(pc);
+    }
+    errno = saved_errno;
+}
+#endif
+
+SrsCpuProfiler::SrsCpuProfiler()
+{
+    running_ = false;
+    hz_ = 0;
+    starttime_ = 0;
+    duration_ = 0;
+    samples_ = NULL;
+    capacity_ = 0;
+    nn_samples_ = 0;
+    nn_dropped_ = 0;
+    symbols_ = NULL;
+}
+
+SrsCpuProfiler::~SrsCpuProfiler()
+{
+    stop();
+    srs_freepa(samples_);
+    srs_freep(symbols_);
+}
+
+srs_error_t SrsCpuProfiler::start(int hz, srs_utime_t duration)
+{
+    srs_error_t err = srs_success;
+
+    if (running_) {
+        return srs_error_new(ERROR_SYSTEM_PROFILER, "already running, hz=%d", hz_);
+    }
+#ifndef SRS_OSX
+    if (_srs_profiler_current) {
+        return srs_error_new(ERROR_SYSTEM_PROFILER, "another profiler is running");
+    }
+#endif
+
+    if (hz <= 0 || hz > SRS_PROFILER_MAX_HZ) {
+        return srs_error_new(ERROR_SYSTEM_PROFILER, "invalid hz=%d", hz);
+    }
+    if (duration <= 0 || duration > SRS_PROFILER_MAX_DURATION) {
+        return srs_error_new(ERROR_SYSTEM_PROFILER, "invalid duration=%dms", srsu2msi(duration));
+    }
+
+#ifdef SRS_OSX
+    return srs_error_new(ERROR_SYSTEM_PROFILER, "not supported");
+#else
+    // Allocate the samples, with some more for the delay of stop.
+    srs_freepa(samples_);
+    capacity_ = (int)(hz * (duration / SRS_UTIME_SECONDS + 1) * 2);
+    samples_ = new SrsCpuSample[capacity_];
+    nn_samples_ = nn_dropped_ = 0;
+
+    // Load libgcc for backtrace, which malloc and is not async-signal-safe for the first time.
+    void* pcs[1];
+    backtrace(pcs, 1);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = srs_profiler_on_signal;
+    sa.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    if (sigaction(SIGPROF, &sa, &_srs_profiler_old_action) < 0) {
+        return srs_error_new(ERROR_SYSTEM_PROFILER, "sigaction");
+    }
+
+    // Use the CPU clock of the main thread, and signal it, because all coroutines run on it, while
+    // other threads might be running, see SrsThreadPool.
+    struct sigevent sev;
+    memset(&sev, 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_THREAD_ID;
+    sev.sigev_signo = SIGPROF;
+    sev.sigev_notify_thread_id = (pid_t)syscall(SYS_gettid);
+    if (timer_create(CLOCK_THREAD_CPUTIME_ID, &sev, &timer_) < 0) {
+        sigaction(SIGPROF, &_srs_profiler_old_action, NULL);
+        return srs_error_new(ERROR_SYSTEM_PROFILER, "timer_create");
+    }
+
+    struct itimerspec its;
+    its.it_interval.tv_sec = 0;
+    its.it_interval.tv_nsec = 1000 * 1000 * 1000 / hz;
+    its.it_value = its.it_interval;
+    if (timer_settime(timer_, 0, &its, NULL) < 0) {
+        timer_delete(timer_);
+        sigaction(SIGPROF, &_srs_profiler_old_action, NULL);
+        return srs_error_new(ERROR_SYSTEM_PROFILER, "timer_settime");
+    }
+
+    hz_ = hz;
+    duration_ = duration;
+    starttime_ = srs_update_system_time();
+    running_ = true;
+    _srs_profiler_current = this;
+
+    srs_trace("Profiler: start hz=%d, duration=%dms, capacity=%d", hz, srsu2msi(duration), capacity_);
+    return err;
+#endif
+}
+
+void SrsCpuProfiler::stop()
+{
+    if (!running_) {
+        return;
+    }
+    running_ = false;
+
+#ifndef SRS_OSX
+    timer_delete(timer_);
+    sigaction(SIGPROF, &_srs_profiler_old_action, NULL);
+    _srs_profiler_current = NULL;
+#endif
+
+    srs_trace("Profiler: stop hz=%d, cost=%dms, samples=%d, dropped=%d", hz_,
+        srsu2msi(srs_update_system_time() - starttime_), nn_samples_, nn_dropped_);
+}
+
+bool SrsCpuProfiler::running()
+{
+    return running_;
+}
+
+int SrsCpuProfiler::nn_samples()
+{
+    return nn_samples_;
+}
+
+int SrsCpuProfiler::nn_dropped()
+{
+    return nn_dropped_;
+}
+
+void SrsCpuProfiler::dumps(string& folded, bool by_cid)
+{
+    if (!symbols_) {
+        symbols_ = new SrsCpuSymbols();
+
+        srs_error_t err = symbols_->load("/proc/self/exe");
+        if (err != srs_success) {
+            srs_warn("Profiler: ignore load symbols err %s", srs_error_desc(err).c_str());
+            srs_freep(err);
+        }
+    }
+
+    // Merge the same stacks, in the order of stack.
+    std::map<std::string, int> stacks;
+    for (int i = 0; i < nn_samples_; i++) {
+        SrsCpuSample* sample = &samples_[i];
+
+        string stack;
+        if (by_cid) {
+            stack = string(sample->cid, strnlen(sample->cid, SRS_PROFILER_CID_SIZE));
+            if (stack.empty()) {
+                stack = "-";
+            }
+        }
+
+        // From root to leaf, the first frame is the interrupted address, others are return addresses,
+        // so we lookup the return address minus one, which is in the call instruction.
+        for (int j = sample->nn_pcs - 1; j >= 0; j--) {
+            void* pc = (j == 0) ? sample->pcs[j] : (void*)((char*)sample->pcs[j] - 1);
+            if (!stack.empty()) {
+                stack += ";";
+            }
+            stack += symbols_->resolve(pc);
+        }
+
+        stacks[stack]++;
+    }
+
+    for (std::map<std::string, int>::iterator it = stacks.begin(); it != stacks.end(); ++it) {
+        folded += it->first;
+        folded += " ";
+        folded += srs_int2str(it->second);
+        folded += "\n";
+    }
+}
+
+void SrsCpuProfiler::on_signal(void* pc)
+{
+#ifndef SRS_OSX
+    if (!running_ || !samples_) {
+        return;
+    }
+
+    if (nn_samples_ >= capacity_) {
+        nn_dropped_++;
+        return;
+    }
+
+    SrsCpuSample* sample = &samples_[nn_samples_];
+
+    // The stack is: on_signal, srs_profiler_on_signal, the signal trampoline, then the interrupted
+    // function, so we skip the frames of profiler, by the interrupted address.
+    void* pcs[SRS_PROFILER_MAX_DEPTH + SRS_PROFILER_SKIP_DEPTH];
+    int nn = backtrace(pcs, SRS_PROFILER_MAX_DEPTH + SRS_PROFILER_SKIP_DEPTH);
+    int skip = srs_min(3, nn);
+    for (int i = 0; pc && i < nn && i < SRS_PROFILER_SKIP_DEPTH; i++) {
+        if (pcs[i] == pc) {
+            skip = i;
+            break;
+        }
+    }
+    sample->nn_pcs = srs_min(nn - skip, SRS_PROFILER_MAX_DEPTH);
+    memcpy(sample->pcs, pcs + skip, sizeof(void*) * sample->nn_pcs);
+
+    // Never access the context object here, which might be freed by set_id, so we copy the fixed
+    // buffer of context id, which is async-signal-safe.
+    memcpy(sample->cid, srs_context_id_buffer(), SRS_PROFILER_CID_SIZE);
+
+    nn_samples_++;
+#endif
+}
+
@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2013-2022 The SRS Authors
+//
+// SPDX-License-Identifier: MIT or MulanPSL-2.0
+//
+
+#ifndef SRS_APP_PROFILER_HPP
+#define SRS_APP_PROFILER_HPP
+
+#include <srs_core.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <srs_protocol_log.hpp>
+
+#ifndef SRS_OSX
+#include <time.h>
+#endif
+
+// The max depth of stack of a sample.
+#define SRS_PROFILER_MAX_DEPTH 64
+// The max size of context id of a sample, see srs_context_id_buffer.
+#define SRS_PROFILER_CID_SIZE SRS_CONTEXT_ID_BUFFER_SIZE
+// The default and max sampling frequency in Hz.
+#define SRS_PROFILER_DEFAULT_HZ 99
+#define SRS_PROFILER_MAX_HZ 1000
+// The max duration of profiling, to limit the memory of samples.
+#define SRS_PROFILER_MAX_DURATION (60 * SRS_UTIME_SECONDS)
+
+// A sample of CPU profiler, the stack of current coroutine when timer fired.
+struct SrsCpuSample
+{
+    int nn_pcs;
+    void* pcs[SRS_PROFILER_MAX_DEPTH];
+    // The context id of coroutine, the string is NOT null-terminated when it's full.
+    char cid[SRS_PROFILER_CID_SIZE];
+};
+
+// A function symbol, in the symbol table of ELF.
+struct SrsCpuSymbol
+{
+    uint64_t address;
+    uint64_t size;
+    // The offset of name in the string table.
+    uint32_t name;
+};
+
+// Resolve the address to function name, by the symbol table of executable, or dladdr for
+// shared libraries. Unknown address is formatted as module+offset, for addr2line.
+class SrsCpuSymbols
+{
+private:
+    bool loaded_;
+    // The load bias of executable, zero for non-PIE.
+    uint64_t bias_;
+    // The function symbols sorted by address.
+    std::vector<SrsCpuSymbol> symbols_;
+    std::string strtab_;
+    std::map<void*, std::string> cache_;
+public:
+    SrsCpuSymbols();
+    virtual ~SrsCpuSymbols();
+public:
+    // Load the symbols of executable, it's ok to ignore the error and fallback to dladdr.
+    virtual srs_error_t load(std::string exe);
+    // Get the function name of address.
+    virtual std::string resolve(void* pc);
+    virtual int size();
+private:
+    const SrsCpuSymbol* find(uint64_t address);
+};
+
+// The sampling CPU profiler, which is driven by the SIGPROF of a CPU timer of the main thread,
+// so it only samples the coroutines, and the samples are attributed to the context id.
+// @remark Only one profiler is running at the same time, because the signal is global.
+// @remark The samples are kept after stop, until next start.
+class SrsCpuProfiler
+{
+private:
+    bool running_;
+    int hz_;
+    srs_utime_t starttime_;
+    srs_utime_t duration_;
+    // The samples, allocated when start, so we never allocate in signal handler.
+    SrsCpuSample* samples_;
+    int capacity_;
+    int nn_samples_;
+    // The samples dropped because buffer is full.
+    int nn_dropped_;
+    SrsCpuSymbols* symbols_;
+#ifndef SRS_OSX
+    timer_t timer_;
+#endif
+public:
+    SrsCpuProfiler();
+    virtual ~SrsCpuProfiler();
+public:
+    // Start sampling at hz, for about duration, user should stop it when done.
+    virtual srs_error_t start(int hz, srs_utime_t duration);
+    virtual void stop();
+    virtual bool running();
+    virtual int nn_samples();
+    virtual int nn_dropped();
+    // Dumps the samples as folded stacks, one stack per line, from root to leaf, with count:
+    //      _st_thread_main;SrsFastCoroutine::cycle;...;SrsRtcPlayStream::send_packet 27
+    // If by_cid, the context id is the root frame, to distinguish the coroutines.
+    // @see https://github.com/brendangregg/FlameGraph
+    virtual void dumps(std::string& folded, bool by_cid);
+public:
+    // Take a sample, called in the signal handler, so it must be async-signal-safe.
+    // @param pc The interrupted address, NULL if unknown.
+    void on_signal(void* pc);
+};
+
+// The global CPU profiler.
+extern SrsCpuProfiler* _srs_cpu_profiler;
+
+#endif
+
@@ -43,18 +43,18 @@ srs_error_t SrsGoApiRtcPlay::serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessa
 {
     srs_error_t err = srs_success;
 
-    SrsJsonObject* res = SrsJsonAny::object();
-    SrsAutoFree(SrsJsonObject, res);
+    // Write the response by streaming writer, without the tree of JSON objects.
+    SrsJsonWriter res;
 
-    if ((err = do_serve_http(w, r, res)) != srs_success) {
+    if ((err = do_serve_http(w, r, &res)) != srs_success) {
         srs_warn("RTC error %s", srs_error_desc(err).c_str()); srs_freep(err);
         return srs_api_response_code(w, r, SRS_CONSTS_HTTP_BadRequest);
     }
 
-    return srs_api_response(w, r, res->dumps());
+    return srs_api_response(w, r, res.data());
 }
 
-srs_error_t SrsGoApiRtcPlay::do_serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, SrsJsonObject* res)
+srs_error_t SrsGoApiRtcPlay::do_serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, SrsJsonWriter* res)
 {
     srs_error_t err = srs_success;
 
@@ -216,13 +216,15 @@ srs_error_t SrsGoApiRtcPlay::do_serve_http(ISrsHttpResponseWriter* w, ISrsHttpMe
     // Filter the \r\n to \\r\\n for JSON.
     string local_sdp_escaped = srs_string_replace(local_sdp_str.c_str(), "\r\n", "\\r\\n");
 
-    res->set("code", SrsJsonAny::integer(ERROR_SUCCESS));
-    res->set("server", SrsJsonAny::str(SrsStatistic::instance()->server_id().c_str()));
+    res->begin_object();
+    res->key("code")->integer(ERROR_SUCCESS);
+    res->key("server")->str(SrsStatistic::instance()->server_id());
 
     // TODO: add candidates in response json?
 
-    res->set("sdp", SrsJsonAny::str(local_sdp_str.c_str()));
-    res->set("sessionid", SrsJsonAny::str(session->username().c_str()));
+    res->key("sdp")->str(local_sdp_str);
+    res->key("sessionid")->str(session->username());
+    res->end_object();
 
     srs_trace("RTC username=%s, dtls=%u, srtp=%u, offer=%dB, answer=%dB", session->username().c_str(),
         ruc.dtls_, ruc.srtp_, remote_sdp_str.length(), local_sdp_escaped.length());
@@ -317,18 +319,18 @@ srs_error_t SrsGoApiRtcPublish::serve_http(ISrsHttpResponseWriter* w, ISrsHttpMe
 {
     srs_error_t err = srs_success;
 
-    SrsJsonObject* res = SrsJsonAny::object();
-    SrsAutoFree(SrsJsonObject, res);
+    // Write the response by streaming writer, without the tree of JSON objects.
+    SrsJsonWriter res;
 
-    if ((err = do_serve_http(w, r, res)) != srs_success) {
+    if ((err = do_serve_http(w, r, &res)) != srs_success) {
         srs_warn("RTC error %s", srs_error_desc(err).c_str()); srs_freep(err);
         return srs_api_response_code(w, r, SRS_CONSTS_HTTP_BadRequest);
     }
 
-    return srs_api_response(w, r, res->dumps());
+    return srs_api_response(w, r, res.data());
 }
 
-srs_error_t SrsGoApiRtcPublish::do_serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, SrsJsonObject* res)
+srs_error_t SrsGoApiRtcPublish::do_serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, SrsJsonWriter* res)
 {
     srs_error_t err = srs_success;
 
@@ -469,13 +471,15 @@ srs_error_t SrsGoApiRtcPublish::do_serve_http(ISrsHttpResponseWriter* w, ISrsHtt
     // Filter the \r\n to \\r\\n for JSON.
     string local_sdp_escaped = srs_string_replace(local_sdp_str.c_str(), "\r\n", "\\r\\n");
 
-    res->set("code", SrsJsonAny::integer(ERROR_SUCCESS));
-    res->set("server", SrsJsonAny::str(SrsStatistic::instance()->server_id().c_str()));
+    res->begin_object();
+    res->key("code")->integer(ERROR_SUCCESS);
+    res->key("server")->str(SrsStatistic::instance()->server_id());
 
     // TODO: add candidates in response json?
 
-    res->set("sdp", SrsJsonAny::str(local_sdp_str.c_str()));
-    res->set("sessionid", SrsJsonAny::str(session->username().c_str()));
+    res->key("sdp")->str(local_sdp_str);
+    res->key("sessionid")->str(session->username());
+    res->end_object();
 
     srs_trace("RTC username=%s, offer=%dB, answer=%dB", session->username().c_str(),
         remote_sdp_str.length(), local_sdp_escaped.length());
@@ -14,6 +14,7 @@
 class SrsRtcServer;
 class SrsRequest;
 class SrsSdp;
+class SrsJsonWriter;
 
 class SrsGoApiRtcPlay : public ISrsHttpHandler
 {
@@ -25,7 +26,7 @@ public:
 public:
     virtual srs_error_t serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r);
 private:
-    virtual srs_error_t do_serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, SrsJsonObject* res);
+    virtual srs_error_t do_serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, SrsJsonWriter* res);
     srs_error_t check_remote_sdp(const SrsSdp& remote_sdp);
 private:
     virtual srs_error_t http_hooks_on_play(SrsRequest* req);
@@ -41,7 +42,7 @@ public:
 public:
     virtual srs_error_t serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r);
 private:
-    virtual srs_error_t do_serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, SrsJsonObject* res);
+    virtual srs_error_t do_serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, SrsJsonWriter* res);
     srs_error_t check_remote_sdp(const SrsSdp& remote_sdp);
 private:
     virtual srs_error_t http_hooks_on_publish(SrsRequest* req);
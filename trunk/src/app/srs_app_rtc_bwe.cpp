@@ -0,0 +1,215 @@
+//
+// Copyright (c) 2013-2022 The SRS Authors
+//
+// SPDX-License-Identifier: MIT or MulanPSL-2.0
+//
+
+#include <srs_app_rtc_bwe.hpp>
+
+#include <string.h>
+using namespace std;
+
+#include <srs_kernel_rtc_rtcp.hpp>
+#include <srs_kernel_utility.hpp>
+
+// The queuing delay increased in a feedback, to detect the overuse.
+#define SRS_RTC_BWE_OVERUSE_THRESHOLD (10 * SRS_UTIME_MILLISECONDS)
+// The min duration of feedback to calculate the acked bitrate.
+#define SRS_RTC_BWE_MIN_ACKED_SPAN (20 * SRS_UTIME_MILLISECONDS)
+
+SrsRtcSendSideBwe::SrsRtcSendSideBwe()
+{
+    history_ = new SrsRtcSentPacket[SRS_RTC_BWE_HISTORY];
+    memset(history_, 0, sizeof(SrsRtcSentPacket) * SRS_RTC_BWE_HISTORY);
+    next_sn_ = 0;
+
+    min_bitrate_ = SRS_RTC_BWE_MIN_BITRATE;
+    max_bitrate_ = 20 * 1000 * 1000;
+    bitrate_ = SRS_RTC_BWE_START_BITRATE;
+    acked_bitrate_ = 0;
+    loss_ = 0;
+    usage_ = SrsRtcBweUsageNormal;
+    nn_overuse_ = 0;
+    last_update_ = 0;
+}
+
+SrsRtcSendSideBwe::~SrsRtcSendSideBwe()
+{
+    srs_freepa(history_);
+}
+
+void SrsRtcSendSideBwe::set_bitrate_range(int64_t min, int64_t max)
+{
+    min_bitrate_ = min;
+    max_bitrate_ = srs_max(min, max);
+    bitrate_ = srs_max(min_bitrate_, srs_min(bitrate_, max_bitrate_));
+}
+
+uint16_t SrsRtcSendSideBwe::next_sn()
+{
+    return next_sn_++;
+}
+
+void SrsRtcSendSideBwe::on_sent(uint16_t sn, int size, srs_utime_t now)
+{
+    SrsRtcSentPacket* pkt = &history_[sn & (SRS_RTC_BWE_HISTORY - 1)];
+    pkt->sn = sn;
+    pkt->size = size;
+    pkt->send_time = now;
+}
+
+void SrsRtcSendSideBwe::on_feedback(const vector<SrsRtcpTWCCStatus>& statuses, srs_utime_t now)
+{
+    int nn_total = 0, nn_lost = 0;
+    int64_t acked_bytes = 0;
+    srs_utime_t first_recv = 0, last_recv = 0, first_send = 0, last_send = 0;
+
+    for (int i = 0; i < (int)statuses.size(); i++) {
+        const SrsRtcpTWCCStatus& status = statuses.at(i);
+
+        // Ignore the unknown packet, which is overwritten or never sent.
+        SrsRtcSentPacket* pkt = &history_[status.sn & (SRS_RTC_BWE_HISTORY - 1)];
+        if (!pkt->send_time || pkt->sn != status.sn) {
+            continue;
+        }
+
+        nn_total++;
+        if (!status.received) {
+            nn_lost++;
+            continue;
+        }
+
+        acked_bytes += pkt->size;
+        if (!first_send) {
+            first_recv = status.recv_time;
+            first_send = pkt->send_time;
+        }
+        last_recv = status.recv_time;
+        last_send = pkt->send_time;
+    }
+
+    if (!nn_total) {
+        return;
+    }
+    loss_ = nn_lost * 100 / nn_total;
+
+    // The queuing delay increased in this feedback, by the receive interval minus the send interval.
+    srs_utime_t recv_span = last_recv - first_recv;
+    srs_utime_t delay = recv_span - (last_send - first_send);
+    if (delay > SRS_RTC_BWE_OVERUSE_THRESHOLD) {
+        nn_overuse_++;
+    } else {
+        nn_overuse_ = 0;
+    }
+
+    if (nn_overuse_ >= 2) {
+        usage_ = SrsRtcBweUsageOveruse;
+    } else if (delay < -SRS_RTC_BWE_OVERUSE_THRESHOLD) {
+        usage_ = SrsRtcBweUsageUnderuse;
+    } else {
+        usage_ = SrsRtcBweUsageNormal;
+    }
+
+    // The acked bitrate, smoothed.
+    if (recv_span >= SRS_RTC_BWE_MIN_ACKED_SPAN) {
+        int64_t v = acked_bytes * 8 * SRS_UTIME_SECONDS / recv_span;
+        acked_bitrate_ = acked_bitrate_ ? (acked_bitrate_ + v) / 2 : v;
+    }
+
+    srs_utime_t elapsed = last_update_ ? srs_min(now - last_update_, SRS_UTIME_SECONDS) : 0;
+    last_update_ = now;
+
+    if (usage_ == SrsRtcBweUsageOveruse) {
+        // Decrease to the acked bitrate, which is the capacity of link.
+        int64_t base = acked_bitrate_ ? acked_bitrate_ : bitrate_;
+        bitrate_ = srs_min(bitrate_, base * 85 / 100);
+    } else if (loss_ > 10) {
+        bitrate_ = bitrate_ * (100 - loss_ / 2) / 100;
+    } else if (loss_ < 2 && usage_ == SrsRtcBweUsageNormal && elapsed > 0) {
+        int64_t v = bitrate_ + bitrate_ * 8 * elapsed / 100 / SRS_UTIME_SECONDS;
+        // Never increase far more than the acked bitrate, but never decrease here.
+        if (acked_bitrate_) {
+            v = srs_min(v, srs_max(bitrate_, acked_bitrate_ * 3 / 2 + 10 * 1000));
+        }
+        bitrate_ = v;
+    }
+
+    bitrate_ = srs_max(min_bitrate_, srs_min(bitrate_, max_bitrate_));
+}
+
+int64_t SrsRtcSendSideBwe::bitrate()
+{
+    return bitrate_;
+}
+
+int64_t SrsRtcSendSideBwe::acked_bitrate()
+{
+    return acked_bitrate_;
+}
+
+int SrsRtcSendSideBwe::loss()
+{
+    return loss_;
+}
+
+SrsRtcBweUsage SrsRtcSendSideBwe::usage()
+{
+    return usage_;
+}
+
+SrsRtcPacer::SrsRtcPacer()
+{
+    rate_ = 0;
+    budget_ = 0;
+    last_ = 0;
+    // The sleep of coroutine is about 1ms, so allow some burst.
+    max_burst_ = 10 * SRS_UTIME_MILLISECONDS;
+    max_delay_ = 200 * SRS_UTIME_MILLISECONDS;
+}
+
+SrsRtcPacer::~SrsRtcPacer()
+{
+}
+
+void SrsRtcPacer::set_rate(int64_t bps)
+{
+    rate_ = bps;
+}
+
+int64_t SrsRtcPacer::rate()
+{
+    return rate_;
+}
+
+srs_utime_t SrsRtcPacer::consume(int size, srs_utime_t now)
+{
+    if (rate_ <= 0) {
+        return 0;
+    }
+
+    // Refill the tokens, at most the burst.
+    double bytes_per_us = rate_ / 8.0 / SRS_UTIME_SECONDS;
+    if (last_) {
+        budget_ += bytes_per_us * (now - last_);
+    } else {
+        budget_ = bytes_per_us * max_burst_;
+    }
+    last_ = now;
+    budget_ = srs_min(budget_, bytes_per_us * max_burst_);
+
+    budget_ -= size;
+    if (budget_ >= 0) {
+        return 0;
+    }
+
+    // If wait too long, the link is overused, we send it directly and wait for BWE to decrease, because
+    // pacing never makes it better but increase the latency.
+    srs_utime_t wait = (srs_utime_t)(-budget_ / bytes_per_us);
+    if (wait > max_delay_) {
+        budget_ = -bytes_per_us * max_delay_;
+        return 0;
+    }
+
+    return wait;
+}
+
@@ -0,0 +1,111 @@
+//
+// Copyright (c) 2013-2022 The SRS Authors
+//
+// SPDX-License-Identifier: MIT or MulanPSL-2.0
+//
+
+#ifndef SRS_APP_RTC_BWE_HPP
+#define SRS_APP_RTC_BWE_HPP
+
+#include <srs_core.hpp>
+
+#include <vector>
+
+struct SrsRtcpTWCCStatus;
+
+// The capacity of sent packets history, for TWCC feedback, must be power of 2.
+#define SRS_RTC_BWE_HISTORY 4096
+// The default bitrate of estimation, in bps.
+#define SRS_RTC_BWE_MIN_BITRATE (100 * 1000)
+#define SRS_RTC_BWE_START_BITRATE (2000 * 1000)
+// The pacing rate is the estimation multiple this factor, to allow some burst.
+#define SRS_RTC_PACING_FACTOR 2.5
+
+// The state of delay-based detector, by the gradient of queuing delay.
+enum SrsRtcBweUsage
+{
+    SrsRtcBweUsageNormal = 0,
+    SrsRtcBweUsageOveruse = 1,
+    SrsRtcBweUsageUnderuse = 2,
+};
+
+// A sent packet with transport-wide sequence number.
+struct SrsRtcSentPacket
+{
+    uint16_t sn;
+    int size;
+    // The send time in us, zero for empty slot.
+    srs_utime_t send_time;
+};
+
+// The send-side bandwidth estimation, driven by the TWCC feedback of player, which is a simplified
+// GCC(Google Congestion Control), combined with the delay-based and loss-based controller:
+//      * Delay-based: Compare the receive interval with send interval, if the queuing delay keeps
+//          increasing, the link is overused, so decrease to 85% of acked bitrate.
+//      * Loss-based: If loss is larger than 10%, decrease by loss; if loss is less than 2% and not
+//          overused, increase about 8% per second, but never far more than the acked bitrate.
+// @see https://datatracker.ietf.org/doc/html/draft-ietf-rmcat-gcc-02
+class SrsRtcSendSideBwe
+{
+private:
+    // The sent packets, indexed by sn.
+    SrsRtcSentPacket* history_;
+    uint16_t next_sn_;
+private:
+    int64_t min_bitrate_;
+    int64_t max_bitrate_;
+    // The estimated bitrate in bps.
+    int64_t bitrate_;
+    // The bitrate acked by receiver in bps, zero if unknown.
+    int64_t acked_bitrate_;
+    // The last loss in percent.
+    int loss_;
+    SrsRtcBweUsage usage_;
+    // The number of continuous overuse feedback.
+    int nn_overuse_;
+    srs_utime_t last_update_;
+public:
+    SrsRtcSendSideBwe();
+    virtual ~SrsRtcSendSideBwe();
+public:
+    // Set the range of estimation, in bps.
+    void set_bitrate_range(int64_t min, int64_t max);
+    // Get the transport-wide sequence number for next packet.
+    uint16_t next_sn();
+    // When sent a packet with sn, in size bytes.
+    void on_sent(uint16_t sn, int size, srs_utime_t now);
+    // When got the TWCC feedback.
+    void on_feedback(const std::vector<SrsRtcpTWCCStatus>& statuses, srs_utime_t now);
+public:
+    int64_t bitrate();
+    int64_t acked_bitrate();
+    int loss();
+    SrsRtcBweUsage usage();
+};
+
+// The token bucket pacer, to send the packets by pacing rate, to smooth the burst such as
+// keyframe, which might overflow the link of viewer and cause lots of NACK.
+class SrsRtcPacer
+{
+private:
+    // The pacing rate in bps, zero to disable pacing.
+    int64_t rate_;
+    // The tokens in bytes, negative if in debt.
+    double budget_;
+    srs_utime_t last_;
+    // The max burst and max delay, to avoid queuing too long.
+    srs_utime_t max_burst_;
+    srs_utime_t max_delay_;
+public:
+    SrsRtcPacer();
+    virtual ~SrsRtcPacer();
+public:
+    void set_rate(int64_t bps);
+    int64_t rate();
+    // Consume the tokens of packet in size bytes at now.
+    // @return The duration to wait before sending the packet, 0 to send it now.
+    srs_utime_t consume(int size, srs_utime_t now);
+};
+
+#endif
+
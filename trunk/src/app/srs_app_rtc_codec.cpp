@@ -6,9 +6,21 @@
 
 #include <srs_app_rtc_codec.hpp>
 
+#include <string.h>
+
 #include <srs_kernel_codec.hpp>
 #include <srs_kernel_error.hpp>
 #include <srs_kernel_log.hpp>
+#include <srs_app_threads.hpp>
+
+using namespace std;
+
+// The max number of idle transcoders in pool.
+#define SRS_AUDIO_TRANSCODER_IDLES 32
+// The max number of transcoded frames for a stream, which are not fetched.
+#define SRS_AUDIO_TRANSCODER_OUTS 1024
+// The max number of tasks for a worker.
+#define SRS_AUDIO_TRANSCODER_TASKS 65536
 
 static const AVCodec* srs_find_decoder_by_id(SrsAudioCodecId id)
 {
@@ -93,6 +105,9 @@ SrsAudioTranscoder::SrsAudioTranscoder()
     fifo_ = NULL;
     new_pkt_pts_ = AV_NOPTS_VALUE;
     next_out_pts_ = AV_NOPTS_VALUE;
+
+    from_ = to_ = SrsAudioCodecIdForbidden;
+    channels_ = sample_rate_ = bit_rate_ = 0;
 }
 
 SrsAudioTranscoder::~SrsAudioTranscoder()
@@ -114,18 +129,7 @@ SrsAudioTranscoder::~SrsAudioTranscoder()
     }
 
     free_swr_samples();
-
-    if (enc_) {
-        avcodec_free_context(&enc_);
-    }
-
-    if (enc_frame_) {
-        av_frame_free(&enc_frame_);
-    }
-
-    if (enc_packet_) {
-        av_packet_free(&enc_packet_);
-    }
+    free_enc();
 
     if (fifo_) {
         av_audio_fifo_free(fifo_);
@@ -150,6 +154,57 @@ srs_error_t SrsAudioTranscoder::initialize(SrsAudioCodecId src_codec, SrsAudioCo
         return srs_error_wrap(err, "fifo init");
     }
 
+    from_ = src_codec;
+    to_ = dst_codec;
+    channels_ = dst_channels;
+    sample_rate_ = dst_samplerate;
+    bit_rate_ = dst_bit_rate;
+
+    return err;
+}
+
+bool SrsAudioTranscoder::match(SrsAudioCodecId from, SrsAudioCodecId to, int channels, int sample_rate, int bit_rate)
+{
+    return from_ == from && to_ == to && channels_ == channels && sample_rate_ == sample_rate && bit_rate_ == bit_rate;
+}
+
+void SrsAudioTranscoder::reset()
+{
+    if (dec_) {
+        avcodec_flush_buffers(dec_);
+    }
+
+    // The resampler is created by the decoded frame, which might be changed.
+    if (swr_) {
+        swr_free(&swr_);
+    }
+    free_swr_samples();
+
+    if (fifo_) {
+        av_audio_fifo_reset(fifo_);
+    }
+
+    // The encoder might keep the samples of previous stream, and FFmpeg can't flush it, so we
+    // free it and open it again when reuse.
+    free_enc();
+
+    new_pkt_pts_ = AV_NOPTS_VALUE;
+    next_out_pts_ = AV_NOPTS_VALUE;
+}
+
+srs_error_t SrsAudioTranscoder::reopen()
+{
+    srs_error_t err = srs_success;
+
+    if (enc_) {
+        return err;
+    }
+
+    if ((err = init_enc(to_, channels_, sample_rate_, bit_rate_)) != srs_success) {
+        return srs_error_wrap(err, "enc init codec:%d, channels:%d, samplerate:%d, bitrate:%d",
+            to_, channels_, sample_rate_, bit_rate_);
+    }
+
     return err;
 }
 
@@ -274,6 +329,21 @@ srs_error_t SrsAudioTranscoder::init_enc(SrsAudioCodecId dst_codec, int dst_chan
     return srs_success;
 }
 
+void SrsAudioTranscoder::free_enc()
+{
+    if (enc_) {
+        avcodec_free_context(&enc_);
+    }
+
+    if (enc_frame_) {
+        av_frame_free(&enc_frame_);
+    }
+
+    if (enc_packet_) {
+        av_packet_free(&enc_packet_);
+    }
+}
+
 srs_error_t SrsAudioTranscoder::init_swr(AVCodecContext* decoder)
 {
     swr_ = swr_alloc_set_opts(NULL, enc_->channel_layout, enc_->sample_fmt, enc_->sample_rate,
@@ -461,3 +531,335 @@ void SrsAudioTranscoder::free_swr_samples()
     }
 }
 
+SrsAudioTranscoderPool::SrsAudioTranscoderPool()
+{
+    lock_ = new SrsThreadMutex();
+}
+
+SrsAudioTranscoderPool::~SrsAudioTranscoderPool()
+{
+    for (int i = 0; i < (int)idles_.size(); i++) {
+        SrsAudioTranscoder* transcoder = idles_.at(i);
+        srs_freep(transcoder);
+    }
+    srs_freep(lock_);
+}
+
+srs_error_t SrsAudioTranscoderPool::fetch(SrsAudioCodecId from, SrsAudioCodecId to, int channels, int sample_rate, int bit_rate, SrsAudioTranscoder** ptranscoder)
+{
+    srs_error_t err = srs_success;
+
+    SrsAudioTranscoder* reused = NULL;
+    if (true) {
+        SrsThreadLocker(lock_);
+        for (vector<SrsAudioTranscoder*>::iterator it = idles_.begin(); it != idles_.end(); ++it) {
+            SrsAudioTranscoder* transcoder = *it;
+            if (transcoder->match(from, to, channels, sample_rate, bit_rate)) {
+                idles_.erase(it);
+                reused = transcoder;
+                break;
+            }
+        }
+    }
+
+    // Reuse the decoder and open a new encoder, or create a new transcoder if failed.
+    if (reused) {
+        if ((err = reused->reopen()) == srs_success) {
+            *ptranscoder = reused;
+            return err;
+        }
+
+        srs_warn("transcoder: reopen failed, %s", srs_error_desc(err).c_str());
+        srs_freep(err);
+        srs_freep(reused);
+    }
+
+    SrsAudioTranscoder* transcoder = new SrsAudioTranscoder();
+    if ((err = transcoder->initialize(from, to, channels, sample_rate, bit_rate)) != srs_success) {
+        srs_freep(transcoder);
+        return srs_error_wrap(err, "initialize");
+    }
+
+    *ptranscoder = transcoder;
+    return err;
+}
+
+void SrsAudioTranscoderPool::recycle(SrsAudioTranscoder* transcoder)
+{
+    if (!transcoder) {
+        return;
+    }
+
+    transcoder->reset();
+
+    if (true) {
+        SrsThreadLocker(lock_);
+        if ((int)idles_.size() < SRS_AUDIO_TRANSCODER_IDLES) {
+            idles_.push_back(transcoder);
+            return;
+        }
+    }
+
+    srs_freep(transcoder);
+}
+
+int SrsAudioTranscoderPool::size()
+{
+    SrsThreadLocker(lock_);
+    return (int)idles_.size();
+}
+
+// It MUST be thread-safe, global shared object.
+SrsAudioTranscoderPool* _srs_audio_transcoders = new SrsAudioTranscoderPool();
+
+SrsAsyncAudioTranscoder::SrsAsyncAudioTranscoder()
+{
+    codec_ = NULL;
+    worker_ = NULL;
+    outs_ = new SrsCircleQueue<SrsAudioFrame*>(SRS_AUDIO_TRANSCODER_OUTS);
+}
+
+SrsAsyncAudioTranscoder::~SrsAsyncAudioTranscoder()
+{
+    _srs_audio_transcoders->recycle(codec_);
+
+    vector<SrsAudioFrame*> frames;
+    fetch(frames);
+    free_frames(frames);
+
+    srs_freep(outs_);
+}
+
+srs_error_t SrsAsyncAudioTranscoder::initialize(SrsAudioCodecId from, SrsAudioCodecId to, int channels, int sample_rate, int bit_rate)
+{
+    srs_error_t err = srs_success;
+
+    if ((err = _srs_audio_transcoders->fetch(from, to, channels, sample_rate, bit_rate, &codec_)) != srs_success) {
+        return srs_error_wrap(err, "fetch transcoder");
+    }
+
+    worker_ = _srs_audio_workers->select();
+
+    return err;
+}
+
+srs_error_t SrsAsyncAudioTranscoder::transcode(SrsAudioFrame* in)
+{
+    srs_error_t err = srs_success;
+
+    // Copy the frame, because the input is shared.
+    SrsAudioFrame* frame = new SrsAudioFrame();
+    for (int i = 0; i < in->nb_samples; i++) {
+        SrsSample* sample = &in->samples[i];
+        char* bytes = new char[sample->size];
+        memcpy(bytes, sample->bytes, sample->size);
+        frame->add_sample(bytes, sample->size);
+    }
+    frame->dts = in->dts;
+    frame->cts = in->cts;
+
+    if (!worker_) {
+        do_transcode(frame);
+        return err;
+    }
+
+    SrsAudioTranscodeTask task;
+    task.transcoder = this;
+    task.frame = frame;
+    if ((err = worker_->push(task)) != srs_success) {
+        vector<SrsAudioFrame*> frames;
+        frames.push_back(frame);
+        free_frames(frames);
+        return srs_error_wrap(err, "push task");
+    }
+
+    return err;
+}
+
+void SrsAsyncAudioTranscoder::fetch(vector<SrsAudioFrame*>& outs)
+{
+    srs_error_t err = srs_success;
+
+    int nn = (int)outs_->size();
+    for (int i = 0; i < nn; i++) {
+        SrsAudioFrame* frame = NULL;
+        if ((err = outs_->shift(frame)) != srs_success) {
+            srs_freep(err);
+            break;
+        }
+        outs.push_back(frame);
+    }
+}
+
+void SrsAsyncAudioTranscoder::free_frames(vector<SrsAudioFrame*>& frames)
+{
+    for (vector<SrsAudioFrame*>::iterator it = frames.begin(); it != frames.end(); ++it) {
+        SrsAudioFrame* p = *it;
+
+        for (int i = 0; i < p->nb_samples; i++) {
+            char* pa = p->samples[i].bytes;
+            srs_freepa(pa);
+        }
+
+        srs_freep(p);
+    }
+}
+
+void SrsAsyncAudioTranscoder::aac_codec_header(uint8_t** data, int* len)
+{
+    codec_->aac_codec_header(data, len);
+}
+
+void SrsAsyncAudioTranscoder::dispose(SrsAsyncAudioTranscoder* transcoder)
+{
+    srs_error_t err = srs_success;
+
+    if (!transcoder) {
+        return;
+    }
+
+    if (!transcoder->worker_) {
+        srs_freep(transcoder);
+        return;
+    }
+
+    // The worker frees the transcoder, after all tasks of it are done.
+    SrsAudioTranscodeTask task;
+    task.transcoder = transcoder;
+    task.frame = NULL;
+    if ((err = transcoder->worker_->push(task)) != srs_success) {
+        srs_warn("leak transcoder, err %s", srs_error_desc(err).c_str());
+        srs_freep(err);
+    }
+}
+
+void SrsAsyncAudioTranscoder::do_transcode(SrsAudioFrame* in)
+{
+    srs_error_t err = srs_success;
+
+    vector<SrsAudioFrame*> frames;
+    if ((err = codec_->transcode(in, frames)) != srs_success) {
+        srs_warn("transcode audio err %s", srs_error_desc(err).c_str());
+        srs_freep(err);
+    }
+
+    for (int i = 0; i < (int)frames.size(); i++) {
+        SrsAudioFrame* frame = frames.at(i);
+        frame->dts = in->dts;
+        frame->cts = 0;
+
+        // Drop the frame if user never fetches it.
+        if ((err = outs_->push(frame)) != srs_success) {
+            srs_freep(err);
+
+            vector<SrsAudioFrame*> drops;
+            drops.push_back(frame);
+            free_frames(drops);
+        }
+    }
+
+    vector<SrsAudioFrame*> ins;
+    ins.push_back(in);
+    free_frames(ins);
+}
+
+SrsAudioTranscodeWorker::SrsAudioTranscodeWorker()
+{
+    tasks_ = new SrsCircleQueue<SrsAudioTranscodeTask>(SRS_AUDIO_TRANSCODER_TASKS);
+    interval_ = 2 * SRS_UTIME_MILLISECONDS;
+}
+
+SrsAudioTranscodeWorker::~SrsAudioTranscodeWorker()
+{
+    srs_freep(tasks_);
+}
+
+srs_error_t SrsAudioTranscodeWorker::start(void* arg)
+{
+    SrsAudioTranscodeWorker* worker = (SrsAudioTranscodeWorker*)arg;
+    return worker->do_start();
+}
+
+srs_error_t SrsAudioTranscodeWorker::push(SrsAudioTranscodeTask task)
+{
+    return tasks_->push(task);
+}
+
+int SrsAudioTranscodeWorker::size()
+{
+    return (int)tasks_->size();
+}
+
+srs_error_t SrsAudioTranscodeWorker::do_start()
+{
+    srs_error_t err = srs_success;
+
+    srs_trace("audio transcode thread, interval=%dms", srsu2msi(interval_));
+
+    // Never quit for this thread.
+    while (true) {
+        int nn = (int)tasks_->size();
+        for (int i = 0; i < nn; i++) {
+            SrsAudioTranscodeTask task;
+            if ((err = tasks_->shift(task)) != srs_success) {
+                srs_error_reset(err);
+                break;
+            }
+
+            // All tasks of transcoder are done, free it.
+            if (!task.frame) {
+                srs_freep(task.transcoder);
+                continue;
+            }
+
+            task.transcoder->do_transcode(task.frame);
+        }
+
+        // It's ok to use ST sleep.
+        if (!nn) {
+            srs_usleep(interval_);
+        }
+    }
+
+    return err;
+}
+
+SrsAudioTranscodeWorkers::SrsAudioTranscodeWorkers()
+{
+    next_ = 0;
+}
+
+SrsAudioTranscodeWorkers::~SrsAudioTranscodeWorkers()
+{
+    // The workers never quit, so we never free them.
+}
+
+srs_error_t SrsAudioTranscodeWorkers::start(int count)
+{
+    srs_error_t err = srs_success;
+
+    for (int i = 0; i < count; i++) {
+        SrsAudioTranscodeWorker* worker = new SrsAudioTranscodeWorker();
+        workers_.push_back(worker);
+
+        if ((err = _srs_thread_pool->execute("audio", SrsAudioTranscodeWorker::start, worker)) != srs_success) {
+            return srs_error_wrap(err, "start worker %d", i);
+        }
+    }
+
+    return err;
+}
+
+SrsAudioTranscodeWorker* SrsAudioTranscodeWorkers::select()
+{
+    if (workers_.empty()) {
+        return NULL;
+    }
+
+    SrsAudioTranscodeWorker* worker = workers_.at(next_ % workers_.size());
+    next_ = (next_ + 1) % workers_.size();
+    return worker;
+}
+
+// It MUST be thread-safe, global shared object.
+SrsAudioTranscodeWorkers* _srs_audio_workers = new SrsAudioTranscodeWorkers();
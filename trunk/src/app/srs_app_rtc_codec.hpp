@@ -12,6 +12,7 @@
 #include <srs_kernel_codec.hpp>
 
 #include <string>
+#include <vector>
 
 #ifdef __cplusplus
 extern "C" {
@@ -30,6 +31,11 @@ extern "C" {
 }
 #endif
 
+class SrsThreadMutex;
+template<typename T>
+class SrsCircleQueue;
+class SrsAudioTranscodeWorker;
+
 class SrsAudioTranscoder
 {
 private:
@@ -48,6 +54,13 @@ private:
 
     int64_t new_pkt_pts_;
     int64_t next_out_pts_;
+private:
+    // The parameters of transcoder, to reuse it.
+    SrsAudioCodecId from_;
+    SrsAudioCodecId to_;
+    int channels_;
+    int sample_rate_;
+    int bit_rate_;
 public:
     SrsAudioTranscoder();
     virtual ~SrsAudioTranscoder();
@@ -57,6 +70,13 @@ public:
     // The sample_rate specifies the sample rate of encoder, for example, 48000.
     // The bit_rate specifies the bitrate of encoder, for example, 48000.
     srs_error_t initialize(SrsAudioCodecId from, SrsAudioCodecId to, int channels, int sample_rate, int bit_rate);
+    // Whether the transcoder is initialized by the parameters.
+    bool match(SrsAudioCodecId from, SrsAudioCodecId to, int channels, int sample_rate, int bit_rate);
+    // Reset the state of decoder, resampler and FIFO, and free the encoder, to reuse the transcoder
+    // for another stream. Note that we can't flush the encoder, which might keep the samples.
+    void reset();
+    // Open the encoder again, for the transcoder which is reset.
+    srs_error_t reopen();
     // Transcode the input audio frame in, as output audio frames outs.
     virtual srs_error_t transcode(SrsAudioFrame* in, std::vector<SrsAudioFrame*>& outs);
     // Free the generated audio frames by transcode.
@@ -68,6 +88,7 @@ public:
 private:
     srs_error_t init_dec(SrsAudioCodecId from);
     srs_error_t init_enc(SrsAudioCodecId to, int channels, int samplerate, int bit_rate);
+    void free_enc();
     srs_error_t init_swr(AVCodecContext* decoder);
     srs_error_t init_fifo();
 
@@ -78,5 +99,102 @@ private:
     void free_swr_samples();
 };
 
+// The pool of idle transcoders, to reuse the codec contexts when stream restarts, because it's
+// expensive to open the codecs. It's thread safe.
+class SrsAudioTranscoderPool
+{
+private:
+    SrsThreadMutex* lock_;
+    std::vector<SrsAudioTranscoder*> idles_;
+public:
+    SrsAudioTranscoderPool();
+    virtual ~SrsAudioTranscoderPool();
+public:
+    // Fetch an idle transcoder by the parameters, or create a new one.
+    srs_error_t fetch(SrsAudioCodecId from, SrsAudioCodecId to, int channels, int sample_rate, int bit_rate, SrsAudioTranscoder** ptranscoder);
+    // Reset the transcoder and put it to pool, or free it if pool is full.
+    void recycle(SrsAudioTranscoder* transcoder);
+    int size();
+};
+
+extern SrsAudioTranscoderPool* _srs_audio_transcoders;
+
+// The transcoder of a stream, which transcodes in the worker thread if there is any worker, or in
+// current thread, and user fetches the transcoded frames later.
+// @remark The dts of output frames is the dts of input frame.
+class SrsAsyncAudioTranscoder
+{
+    friend class SrsAudioTranscodeWorker;
+private:
+    SrsAudioTranscoder* codec_;
+    // The worker to transcode, NULL to transcode in current thread.
+    SrsAudioTranscodeWorker* worker_;
+    // The transcoded frames, which is written by worker.
+    SrsCircleQueue<SrsAudioFrame*>* outs_;
+public:
+    SrsAsyncAudioTranscoder();
+private:
+    // User should use dispose to free it.
+    virtual ~SrsAsyncAudioTranscoder();
+public:
+    srs_error_t initialize(SrsAudioCodecId from, SrsAudioCodecId to, int channels, int sample_rate, int bit_rate);
+    // Transcode the input frame, which is copied.
+    srs_error_t transcode(SrsAudioFrame* in);
+    // Fetch the transcoded frames, user should free them by free_frames.
+    void fetch(std::vector<SrsAudioFrame*>& outs);
+    void free_frames(std::vector<SrsAudioFrame*>& frames);
+    // Get the aac codec header, which is never changed after initialized.
+    void aac_codec_header(uint8_t** data, int* len);
+    // Free the transcoder, by worker after all frames are done, so user should never use it again.
+    static void dispose(SrsAsyncAudioTranscoder* transcoder);
+private:
+    // Transcode the frame and free it, in the worker thread.
+    void do_transcode(SrsAudioFrame* in);
+};
+
+// The task to transcode, the frame is NULL to dispose the transcoder.
+struct SrsAudioTranscodeTask
+{
+    SrsAsyncAudioTranscoder* transcoder;
+    SrsAudioFrame* frame;
+};
+
+// The worker thread to transcode audio for many streams, so we never block the hybrid thread.
+class SrsAudioTranscodeWorker
+{
+private:
+    SrsCircleQueue<SrsAudioTranscodeTask>* tasks_;
+    // The interval to check the tasks if idle.
+    srs_utime_t interval_;
+public:
+    SrsAudioTranscodeWorker();
+    virtual ~SrsAudioTranscodeWorker();
+public:
+    // Run the worker thread.
+    static srs_error_t start(void* arg);
+    srs_error_t push(SrsAudioTranscodeTask task);
+    int size();
+private:
+    srs_error_t do_start();
+};
+
+// The manager of transcode workers, to select a worker for a stream.
+class SrsAudioTranscodeWorkers
+{
+private:
+    std::vector<SrsAudioTranscodeWorker*> workers_;
+    int next_;
+public:
+    SrsAudioTranscodeWorkers();
+    virtual ~SrsAudioTranscodeWorkers();
+public:
+    // Start the worker threads, by thread pool.
+    srs_error_t start(int count);
+    // Select a worker by round-robin, NULL if no worker.
+    SrsAudioTranscodeWorker* select();
+};
+
+extern SrsAudioTranscodeWorkers* _srs_audio_workers;
+
 #endif /* SRS_APP_AUDIO_RECODE_HPP */
 
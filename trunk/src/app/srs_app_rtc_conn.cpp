@@ -30,6 +30,7 @@ using namespace std;
 #include <srs_app_utility.hpp>
 #include <srs_app_config.hpp>
 #include <srs_app_rtc_queue.hpp>
+#include <srs_app_rtc_bwe.hpp>
 #include <srs_app_source.hpp>
 #include <srs_app_server.hpp>
 #include <srs_protocol_utility.hpp>
@@ -425,6 +426,7 @@ SrsRtcPlayStream::SrsRtcPlayStream(SrsRtcConnection* s, const SrsContextId& cid)
 
     cache_ssrc0_ = cache_ssrc1_ = cache_ssrc2_ = 0;
     cache_track0_ = cache_track1_ = cache_track2_ = NULL;
+    selector_ = new SrsRtcLayerSelector();
 }
 
 SrsRtcPlayStream::~SrsRtcPlayStream()
@@ -442,6 +444,7 @@ SrsRtcPlayStream::~SrsRtcPlayStream()
 
     srs_freep(nack_epp);
     srs_freep(pli_worker_);
+    srs_freep(selector_);
     srs_freep(trd_);
     srs_freep(req_);
 
@@ -494,15 +497,17 @@ srs_error_t SrsRtcPlayStream::initialize(SrsRequest* req, std::map<uint32_t, Srs
     nack_no_copy_ = _srs_config->get_rtc_nack_no_copy(req->vhost);
     srs_trace("RTC player nack=%d, nnc=%d", nack_enabled_, nack_no_copy_);
 
-    // Setup tracks.
+    // Setup tracks, retransmit from the shared history of source.
     for (map<uint32_t, SrsRtcAudioSendTrack*>::iterator it = audio_tracks_.begin(); it != audio_tracks_.end(); ++it) {
         SrsRtcAudioSendTrack* track = it->second;
         track->set_nack_no_copy(nack_no_copy_);
+        track->set_history(source_->history());
     }
 
     for (map<uint32_t, SrsRtcVideoSendTrack*>::iterator it = video_tracks_.begin(); it != video_tracks_.end(); ++it) {
         SrsRtcVideoSendTrack* track = it->second;
         track->set_nack_no_copy(nack_no_copy_);
+        track->set_history(source_->history());
     }
 
     return err;
@@ -643,6 +648,10 @@ srs_error_t SrsRtcPlayStream::cycle()
         }
     }
 
+    // The latency of packets from ingress to sent, for stat.
+    SrsStatisticLatencyRecorder latency;
+    latency.initialize(req_, SrsStatisticLatencyTypeRtc);
+
     while (true) {
         if ((err = trd_->pull()) != srs_success) {
             return srs_error_wrap(err, "rtc sender thread");
@@ -656,6 +665,16 @@ srs_error_t SrsRtcPlayStream::cycle()
             consumer->wait(mw_msgs);
             continue;
         }
+        latency.on_dequeue(pkt->ingress());
+
+        // Pace the video packets by the estimated bandwidth, the consumer queue is the pacer queue,
+        // but never delay the audio, which is small and sensitive to latency.
+        if (session_->pacer_) {
+            srs_utime_t wait = session_->pacer_->consume(pkt->nb_bytes(), srs_update_system_time());
+            if (wait > 0 && !pkt->is_audio()) {
+                srs_usleep(wait);
+            }
+        }
 
         // Send-out the RTP packet and do cleanup
         // @remark Note that the pkt might be set to NULL.
@@ -665,6 +684,9 @@ srs_error_t SrsRtcPlayStream::cycle()
                 srs_warn("play send packets=%u, nn=%u/%u, err: %s", 1, epp->nn_count, nn, srs_error_desc(err).c_str());
             }
             srs_freep(err);
+            latency.on_discard();
+        } else {
+            latency.on_sent();
         }
 
         // Free the packet.
@@ -677,11 +699,19 @@ srs_error_t SrsRtcPlayStream::send_packet(SrsRtpPacket*& pkt)
 {
     srs_error_t err = srs_success;
 
+    // The original SSRC and sequence, before rewritten by layer selector and track.
     uint32_t ssrc = pkt->header.get_ssrc();
+    uint16_t seq = pkt->header.get_sequence();
 
     // Try to find track from cache.
     SrsRtcSendTrack* track = NULL;
-    if (cache_ssrc0_ == ssrc) {
+    if (!pkt->is_audio() && !source_->layers().empty()) {
+        // For simulcast, the selected layer is the only video track of player.
+        if (!select_layer(pkt)) {
+            return err;
+        }
+        track = video_tracks_.empty() ? NULL : video_tracks_.begin()->second;
+    } else if (cache_ssrc0_ == ssrc) {
         track = cache_track0_;
     } else if (cache_ssrc1_ == ssrc) {
         track = cache_track1_;
@@ -731,7 +761,7 @@ srs_error_t SrsRtcPlayStream::send_packet(SrsRtpPacket*& pkt)
     // For NACK to handle packet.
     // @remark Note that the pkt might be set to NULL.
     if (nack_enabled_) {
-        if ((err = track->on_nack(&pkt)) != srs_success) {
+        if ((err = track->on_nack(&pkt, ssrc, seq)) != srs_success) {
             return srs_error_wrap(err, "on nack");
         }
     }
@@ -795,7 +825,15 @@ srs_error_t SrsRtcPlayStream::on_rtcp_rr(SrsRtcpRR* rtcp)
 {
     srs_error_t err = srs_success;
 
-    // TODO: FIXME: Implements it.
+    // The loss rate of video track, for FEC.
+    uint32_t ssrc = rtcp->get_rb_ssrc();
+    for (map<uint32_t, SrsRtcVideoSendTrack*>::iterator it = video_tracks_.begin(); it != video_tracks_.end(); ++it) {
+        SrsRtcVideoSendTrack* track = it->second;
+        if (track->has_ssrc(ssrc)) {
+            track->on_loss(rtcp->get_lost_rate());
+            break;
+        }
+    }
 
     return err;
 }
@@ -866,6 +904,10 @@ srs_error_t SrsRtcPlayStream::on_rtcp_ps_feedback(SrsRtcpPsfbCommon* rtcp)
     switch (fmt) {
         case kPLI: {
             uint32_t ssrc = get_video_publish_ssrc(rtcp->get_media_ssrc());
+            // For simulcast, request keyframe of the current layer.
+            if (selector_->current()) {
+                ssrc = selector_->current();
+            }
             if (ssrc) {
                 pli_worker_->request_keyframe(ssrc, cid_);
             }
@@ -891,6 +933,26 @@ srs_error_t SrsRtcPlayStream::on_rtcp_ps_feedback(SrsRtcpPsfbCommon* rtcp)
     return err;
 }
 
+bool SrsRtcPlayStream::select_layer(SrsRtpPacket* pkt)
+{
+    srs_utime_t now = srs_get_system_time();
+
+    // Choose layer by the estimation of send-side BWE, or the highest layer if disabled.
+    int64_t bitrate = 0;
+    bool congested = false;
+    if (session_->bwe_) {
+        bitrate = session_->bwe_->bitrate();
+        congested = session_->bwe_->usage() == SrsRtcBweUsageOveruse || session_->bwe_->loss() > 10;
+    }
+
+    uint32_t ssrc = selector_->select(source_->layers(), bitrate, congested, now);
+    if (ssrc) {
+        pli_worker_->request_keyframe(ssrc, cid_);
+    }
+
+    return selector_->on_rtp(pkt, now);
+}
+
 uint32_t SrsRtcPlayStream::get_video_publish_ssrc(uint32_t play_ssrc)
 {
     std::map<uint32_t, SrsRtcVideoSendTrack*>::iterator it;
@@ -1073,6 +1135,7 @@ SrsRtcPublishStream::SrsRtcPublishStream(SrsRtcConnection* session, const SrsCon
     
     pli_worker_ = new SrsRtcPLIWorker(this);
     last_time_send_twcc_ = 0;
+    rid_id_ = 0;
 
     timer_rtcp_ = new SrsRtcPublishRtcpTimer(this);
     timer_twcc_ = new SrsRtcPublishTwccTimer(this);
@@ -1154,6 +1217,11 @@ srs_error_t SrsRtcPublishStream::initialize(SrsRequest* r, SrsRtcSourceDescripti
         rtcp_twcc_.set_media_ssrc(media_ssrc);
     }
 
+    for (int i = 0; i < (int)stream_desc->video_track_descs_.size(); ++i) {
+        SrsRtcTrackDescription* desc = stream_desc->video_track_descs_.at(i);
+        rid_id_ = srs_max(rid_id_, desc->get_rtp_extension_id(kRidExt));
+    }
+
     nack_enabled_ = _srs_config->get_rtc_nack_enabled(req_->vhost);
     nack_no_copy_ = _srs_config->get_rtc_nack_no_copy(req_->vhost);
     pt_to_drop_ = (uint16_t)_srs_config->get_rtc_drop_for_pt(req_->vhost);
@@ -1398,6 +1466,32 @@ srs_error_t SrsRtcPublishStream::on_rtp(char* data, int nb_data)
     return err;
 }
 
+bool SrsRtcPublishStream::bind_rid(char* buf, int nb_buf, uint32_t ssrc)
+{
+    if (rid_id_ <= 0) {
+        return false;
+    }
+
+    // The header extension is not encrypted by SRTP, so we parse it from cipher.
+    string rid;
+    srs_error_t err = srs_rtp_fast_parse_rid(buf, nb_buf, rid_id_, rid);
+    if (err != srs_success) {
+        srs_freep(err);
+        return false;
+    }
+
+    for (int i = 0; i < (int)video_tracks_.size(); ++i) {
+        SrsRtcVideoRecvTrack* track = video_tracks_.at(i);
+        if (track->bind_rid(rid, ssrc)) {
+            source->bind_layer(rid, ssrc);
+            srs_trace("RTC: Bind simulcast layer rid=%s, ssrc=%u", rid.c_str(), ssrc);
+            return true;
+        }
+    }
+
+    return false;
+}
+
 srs_error_t SrsRtcPublishStream::on_rtp_plaintext(char* plaintext, int nb_plaintext)
 {
     srs_error_t err = srs_success;
@@ -1802,6 +1896,9 @@ SrsRtcConnection::SrsRtcConnection(SrsRtcServer* s, const SrsContextId& cid)
     hijacker_ = NULL;
 
     sendonly_skt = NULL;
+    stun_responder_ = NULL;
+    stun_skt_ = NULL;
+    stun_mapped_address_ = 0;
     server_ = s;
     transport_ = new SrsSecurityTransport(this);
 
@@ -1816,6 +1913,8 @@ SrsRtcConnection::SrsRtcConnection(SrsRtcServer* s, const SrsContextId& cid)
     disposing_ = false;
 
     twcc_id_ = 0;
+    bwe_ = NULL;
+    pacer_ = NULL;
     nn_simulate_player_nack_drop = 0;
     pp_address_change = new SrsErrorPithyPrint();
     pli_epp = new SrsErrorPithyPrint();
@@ -1855,6 +1954,7 @@ SrsRtcConnection::~SrsRtcConnection()
         SrsUdpMuxSocket* addr = it->second;
         srs_freep(addr);
     }
+    srs_freep(stun_responder_);
 
     if (true) {
         char* iov_base = (char*)cache_iov_->iov_base;
@@ -1867,6 +1967,8 @@ SrsRtcConnection::~SrsRtcConnection()
     srs_freep(req_);
     srs_freep(pp_address_change);
     srs_freep(pli_epp);
+    srs_freep(bwe_);
+    srs_freep(pacer_);
 }
 
 void SrsRtcConnection::on_before_dispose(ISrsResource* c)
@@ -2166,7 +2268,8 @@ srs_error_t SrsRtcConnection::dispatch_rtcp(SrsRtcpCommon* rtcp)
 
     // For TWCC packet.
     if (SrsRtcpType_rtpfb == rtcp->type() && 15 == rtcp->get_rc()) {
-        return on_rtcp_feedback_twcc(rtcp->data(), rtcp->size());
+        SrsRtcpTWCC* twcc = dynamic_cast<SrsRtcpTWCC*>(rtcp);
+        return twcc ? on_rtcp_feedback_twcc(twcc) : err;
     }
 
     // For REMB packet.
@@ -2243,9 +2346,26 @@ srs_error_t SrsRtcConnection::dispatch_rtcp(SrsRtcpCommon* rtcp)
     return err;
 }
 
-srs_error_t SrsRtcConnection::on_rtcp_feedback_twcc(char* data, int nb_data)
+srs_error_t SrsRtcConnection::on_rtcp_feedback_twcc(SrsRtcpTWCC* rtcp)
 {
-    return srs_success;
+    srs_error_t err = srs_success;
+
+    // Ignore if BWE disabled, or it's a publisher.
+    if (!bwe_) {
+        return err;
+    }
+
+    bwe_->on_feedback(rtcp->get_statuses(), srs_update_system_time());
+    pacer_->set_rate((int64_t)(bwe_->bitrate() * SRS_RTC_PACING_FACTOR));
+
+    // Update the estimation to stat, for each player of this session.
+    int kbps = (int)(bwe_->bitrate() / 1000);
+    for (map<string, SrsRtcPlayStream*>::iterator it = players_.begin(); it != players_.end(); ++it) {
+        SrsRtcPlayStream* player = it->second;
+        SrsStatistic::instance()->on_client_bwe(player->context_id().c_str(), kbps);
+    }
+
+    return err;
 }
 
 srs_error_t SrsRtcConnection::on_rtcp_feedback_remb(SrsRtcpPsfbCommon *rtcp)
@@ -2287,6 +2407,16 @@ srs_error_t SrsRtcConnection::find_publisher(char* buf, int size, SrsRtcPublishS
 
     map<uint32_t, SrsRtcPublishStream*>::iterator it = publishers_ssrc_map_.find(ssrc);
     if(it == publishers_ssrc_map_.end()) {
+        // For simulcast by RID, the SSRC of layer is unknown until the first packet.
+        for (map<string, SrsRtcPublishStream*>::iterator it2 = publishers_.begin(); it2 != publishers_.end(); ++it2) {
+            SrsRtcPublishStream* publisher = it2->second;
+            if (publisher->bind_rid(buf, size, ssrc)) {
+                publishers_ssrc_map_[ssrc] = publisher;
+                *ppublisher = publisher;
+                return err;
+            }
+        }
+
         return srs_error_new(ERROR_RTC_NO_PUBLISHER, "no publisher for ssrc:%u", ssrc);
     }
 
@@ -2407,7 +2537,12 @@ void SrsRtcConnection::alive()
 
 void SrsRtcConnection::update_sendonly_socket(SrsUdpMuxSocket* skt)
 {
-    // TODO: FIXME: Refine performance.
+    // Ignore if same address, by fast id which does not build the peer id.
+    uint64_t fast_id = skt->fast_id();
+    if (fast_id && sendonly_skt && fast_id == sendonly_skt->fast_id()) {
+        return;
+    }
+
     string prev_peer_id, peer_id = skt->peer_id();
     if (sendonly_skt) {
         prev_peer_id = sendonly_skt->peer_id();
@@ -2443,7 +2578,6 @@ void SrsRtcConnection::update_sendonly_socket(SrsUdpMuxSocket* skt)
         peer_addresses_[peer_id] = addr_cache = skt->copy_sendonly();
         _srs_rtc_manager->add_with_id(peer_id, this);
 
-        uint64_t fast_id = skt->fast_id();
         if (fast_id) {
             _srs_rtc_manager->add_with_fast_id(fast_id, this);
         }
@@ -2637,6 +2771,13 @@ srs_error_t SrsRtcConnection::do_send_packet(SrsRtpPacket* pkt)
     iov->iov_len = kRtpPacketSize;
     cache_buffer_->skip(-1 * cache_buffer_->pos());
 
+    // Stamp the transport-wide sequence number, for TWCC feedback.
+    uint16_t twcc_sn = 0;
+    if (bwe_) {
+        twcc_sn = bwe_->next_sn();
+        pkt->header.set_twcc_sequence_number(twcc_id_, twcc_sn);
+    }
+
     // Marshal packet to bytes in iovec.
     if (true) {
         if ((err = pkt->encode(cache_buffer_)) != srs_success) {
@@ -2666,6 +2807,10 @@ srs_error_t SrsRtcConnection::do_send_packet(SrsRtpPacket* pkt)
     // TODO: FIXME: Handle error.
     sendonly_skt->sendto(iov->iov_base, iov->iov_len, 0);
 
+    if (bwe_) {
+        bwe_->on_sent(twcc_sn, (int)iov->iov_len, srs_update_system_time());
+    }
+
     // Detail log, should disable it in release version.
     srs_info("RTC: SEND PT=%u, SSRC=%#x, SEQ=%u, Time=%u, %u/%u bytes", pkt->header.get_payload_type(), pkt->header.get_ssrc(),
         pkt->header.get_sequence(), pkt->header.get_timestamp(), pkt->nb_bytes(), iov->iov_len);
@@ -2717,20 +2862,28 @@ srs_error_t SrsRtcConnection::on_binding_request(SrsStunPacket* r)
         return srs_error_new(ERROR_RTC_STUN, "Peer must not in ice-controlled role in ice-lite mode.");
     }
 
-    SrsStunPacket stun_binding_response;
+    // The response is same for the session, so we build it once, and only patch the transaction id and address.
+    // Note that the username of response is the username of request, that is the username of session.
+    if (!stun_responder_) {
+        stun_responder_ = new SrsStunBindingResponder();
+        if ((err = stun_responder_->initialize(username_, get_local_sdp()->get_ice_pwd())) != srs_success) {
+            srs_freep(stun_responder_);
+            return srs_error_wrap(err, "stun responder init");
+        }
+    }
+
+    // The mapped address only changes when peer address changed.
+    if (stun_skt_ != sendonly_skt) {
+        stun_skt_ = sendonly_skt;
+        // FIXME: inet_addr is deprecated, IPV6 support
+        stun_mapped_address_ = be32toh(inet_addr(sendonly_skt->get_peer_ip().c_str()));
+    }
+
     char buf[kRtpPacketSize];
     SrsBuffer* stream = new SrsBuffer(buf, sizeof(buf));
     SrsAutoFree(SrsBuffer, stream);
 
-    stun_binding_response.set_message_type(BindingResponse);
-    stun_binding_response.set_local_ufrag(r->get_remote_ufrag());
-    stun_binding_response.set_remote_ufrag(r->get_local_ufrag());
-    stun_binding_response.set_transcation_id(r->get_transcation_id());
-    // FIXME: inet_addr is deprecated, IPV6 support
-    stun_binding_response.set_mapped_address(be32toh(inet_addr(sendonly_skt->get_peer_ip().c_str())));
-    stun_binding_response.set_mapped_port(sendonly_skt->get_peer_port());
-
-    if ((err = stun_binding_response.encode(get_local_sdp()->get_ice_pwd(), stream)) != srs_success) {
+    if ((err = stun_responder_->encode(r->get_transcation_id(), stun_mapped_address_, sendonly_skt->get_peer_port(), stream)) != srs_success) {
         return srs_error_wrap(err, "stun binding response encode failed");
     }
 
@@ -3004,6 +3157,38 @@ srs_error_t SrsRtcConnection::negotiate_publish_capability(SrsRtcUserConfig* ruc
         track_desc->create_auxiliary_payload(remote_media_desc.find_media_with_encoding_name("rtx"));
         track_desc->create_auxiliary_payload(remote_media_desc.find_media_with_encoding_name("ulpfec"));
 
+        // For simulcast by RID, each layer is a track without SSRC, which is bound by the RID extension of
+        // the first packet, see SrsRtcPublishStream::bind_rid. Only for H.264, because switch at keyframe.
+        if (remote_media_desc.is_video() && remote_media_desc.rids_.size() > 1 && track_desc->media_
+            && track_desc->media_->name_ == "H264"
+        ) {
+            int rid_id = 0, mid_id = 0;
+            map<int, string> extmaps = remote_media_desc.get_extmaps();
+            for (map<int, string>::iterator it = extmaps.begin(); it != extmaps.end(); ++it) {
+                if (it->second == kRidExt) rid_id = it->first;
+                if (it->second == kMidExt) mid_id = it->first;
+            }
+
+            if (rid_id > 0) {
+                track_desc->add_rtp_extension_desc(rid_id, kRidExt);
+                if (mid_id > 0) {
+                    track_desc->add_rtp_extension_desc(mid_id, kMidExt);
+                }
+
+                for (int j = 0; j < (int)remote_media_desc.rids_.size(); ++j) {
+                    SrsRtcTrackDescription* layer = track_desc->copy();
+                    layer->rid_ = remote_media_desc.rids_.at(j);
+                    layer->id_ = remote_media_desc.msid_tracker_.empty() ? "video-" + remote_media_desc.mid_ : remote_media_desc.msid_tracker_;
+                    layer->msid_ = remote_media_desc.msid_;
+                    stream_desc->video_track_descs_.push_back(layer);
+                }
+
+                vector<string> rids = remote_media_desc.rids_;
+                srs_trace("RTC publisher simulcast by rid=[%s], mid=%s", srs_join_vector_string(rids, ",").c_str(), remote_media_desc.mid_.c_str());
+                continue;
+            }
+        }
+
         std::string track_id;
         for (int j = 0; j < (int)remote_media_desc.ssrc_infos_.size(); ++j) {
             const SrsSSRCInfo& ssrc_info = remote_media_desc.ssrc_infos_.at(j);
@@ -3024,6 +3209,34 @@ srs_error_t SrsRtcConnection::negotiate_publish_capability(SrsRtcUserConfig* ruc
             track_id = ssrc_info.msid_tracker_;
         }
 
+        // For simulcast by SSRC, each SSRC of SIM group is a layer, from the low to high resolution.
+        for (int j = 0; j < (int)remote_media_desc.ssrc_groups_.size(); ++j) {
+            const SrsSSRCGroup& ssrc_group = remote_media_desc.ssrc_groups_.at(j);
+            if (ssrc_group.semantic_ != "SIM" || ssrc_group.ssrcs_.size() < 2 || !remote_media_desc.is_video()) {
+                continue;
+            }
+
+            SrsRtcTrackDescription* first = NULL;
+            for (int k = 0; k < (int)stream_desc->video_track_descs_.size(); ++k) {
+                SrsRtcTrackDescription* desc = stream_desc->video_track_descs_.at(k);
+                if (desc->ssrc_ == ssrc_group.ssrcs_[0]) {
+                    first = desc;
+                }
+            }
+            if (!first || !first->media_ || first->media_->name_ != "H264") {
+                continue;
+            }
+
+            first->rid_ = "0";
+            for (int k = 1; k < (int)ssrc_group.ssrcs_.size(); ++k) {
+                SrsRtcTrackDescription* layer = first->copy();
+                layer->ssrc_ = ssrc_group.ssrcs_[k];
+                layer->rid_ = srs_int2str(k);
+                stream_desc->video_track_descs_.push_back(layer);
+            }
+            srs_trace("RTC publisher simulcast by ssrc, layers=%d, mid=%s", (int)ssrc_group.ssrcs_.size(), remote_media_desc.mid_.c_str());
+        }
+
         // set track fec_ssrc and rtx_ssrc
         for (int j = 0; j < (int)remote_media_desc.ssrc_groups_.size(); ++j) {
             const SrsSSRCGroup& ssrc_group = remote_media_desc.ssrc_groups_.at(j);
@@ -3106,6 +3319,11 @@ srs_error_t SrsRtcConnection::generate_publish_local_sdp(SrsRequest* req, SrsSdp
     for (int i = 0;  i < (int)stream_desc->video_track_descs_.size(); ++i) {
         SrsRtcTrackDescription* video_track = stream_desc->video_track_descs_.at(i);
 
+        // For simulcast, the layers are in the same media, which is answered by the first layer.
+        if (!video_track->rid_.empty() && i > 0 && stream_desc->video_track_descs_.at(i - 1)->mid_ == video_track->mid_) {
+            continue;
+        }
+
         local_sdp.media_descs_.push_back(SrsMediaDesc("video"));
         SrsMediaDesc& local_media_desc = local_sdp.media_descs_.back();
 
@@ -3122,6 +3340,16 @@ srs_error_t SrsRtcConnection::generate_publish_local_sdp(SrsRequest* req, SrsSdp
         //local_media_desc.msid_tracker_ = video_track->id_;
         local_media_desc.extmaps_ = video_track->extmaps_;
 
+        // For simulcast by RID, answer to receive all layers.
+        if (video_track->get_rtp_extension_id(kRidExt) > 0) {
+            for (int j = i; j < (int)stream_desc->video_track_descs_.size(); ++j) {
+                SrsRtcTrackDescription* layer = stream_desc->video_track_descs_.at(j);
+                if (layer->mid_ == video_track->mid_ && !layer->rid_.empty()) {
+                    local_media_desc.rids_.push_back(layer->rid_);
+                }
+            }
+        }
+
         if (video_track->direction_ == "recvonly") {
             local_media_desc.recvonly_ = true;
         } else if (video_track->direction_ == "sendonly") {
@@ -3158,6 +3386,8 @@ srs_error_t SrsRtcConnection::negotiate_play_capability(SrsRtcUserConfig* ruc, s
 
     bool nack_enabled = _srs_config->get_rtc_nack_enabled(req->vhost);
     bool twcc_enabled = _srs_config->get_rtc_twcc_enabled(req->vhost);
+    bool rtx_enabled = _srs_config->get_rtc_rtx_enabled(req->vhost);
+    bool fec_enabled = _srs_config->get_rtc_fec_enabled(req->vhost);
     // TODO: FIME: Should check packetization-mode=1 also.
     bool has_42e01f = srs_sdp_has_h264_profile(remote_sdp, "42e01f");
 
@@ -3232,8 +3462,27 @@ srs_error_t SrsRtcConnection::negotiate_play_capability(SrsRtcUserConfig* ruc, s
             track_descs = source->get_track_desc("video", "H264");
         }
 
+        // The RTX payload type of remote, which apt is the media payload type.
+        int remote_rtx_pt = 0;
+        if (remote_media_desc.is_video()) {
+            vector<SrsMediaPayloadType> payloads = remote_media_desc.find_media_with_encoding_name("rtx");
+            for (int j = 0; j < (int)payloads.size(); j++) {
+                const SrsMediaPayloadType& payload = payloads.at(j);
+                if (payload.format_specific_param_ == "apt=" + srs_int2str(remote_payload.payload_type_)) {
+                    remote_rtx_pt = payload.payload_type_;
+                    break;
+                }
+            }
+        }
+
         for (int j = 0; j < (int)track_descs.size(); ++j) {
+            // For simulcast, the player only has one video track, to forward the selected layer.
+            if (!track_descs.at(j)->rid_.empty() && j > 0 && !track_descs.at(j - 1)->rid_.empty()) {
+                continue;
+            }
+
             SrsRtcTrackDescription* track = track_descs.at(j)->copy();
+            track->rid_ = "";
 
             // We should clear the extmaps of source(publisher).
             // @see https://github.com/ossrs/srs/issues/2370
@@ -3278,11 +3527,26 @@ srs_error_t SrsRtcConnection::negotiate_play_capability(SrsRtcUserConfig* ruc, s
             
             // TODO: FIXME: set audio_payload rtcp_fbs_,
             // according by whether downlink is support transport algorithms.
-            // TODO: FIXME: if we support downlink RTX, MUST assign rtx_ssrc_, rtx_pt, rtx_apt
-            // not support rtx
-            if (true) {
-                srs_freep(track->rtx_);
-                track->rtx_ssrc_ = 0;
+            // Retransmit in RTX stream if player offers it, the publisher RTX is never forwarded.
+            srs_freep(track->rtx_);
+            track->rtx_ssrc_ = 0;
+            if (rtx_enabled && nack_enabled && remote_rtx_pt) {
+                SrsRtxPayloadDes* rtx = new SrsRtxPayloadDes(remote_rtx_pt, remote_payload.payload_type_);
+                rtx->sample_ = track->media_->sample_;
+                track->rtx_ = rtx;
+                track->rtx_ssrc_ = SrsRtcSSRCGenerator::instance()->generate_ssrc();
+            }
+
+            // Generate ULPFEC in RED if player offers it, only when publisher never sends RED, because
+            // the FEC of publisher is forwarded in RED. The RED without PT of publisher is for FEC.
+            vector<SrsMediaPayloadType> ulpfec_pts = remote_media_desc.find_media_with_encoding_name("ulpfec");
+            if (fec_enabled && remote_media_desc.is_video() && !track->red_ && !red_pts.empty() && !ulpfec_pts.empty()) {
+                track->red_ = new SrsRedPayload(red_pts.at(0).payload_type_, "red", 90000, 0);
+                track->red_->pt_of_publisher_ = 0;
+
+                srs_freep(track->ulpfec_);
+                track->ulpfec_ = new SrsCodecPayload(ulpfec_pts.at(0).payload_type_, "ulpfec", 90000);
+                track->fec_ssrc_ = 0;
             }
 
             track->set_direction("sendonly");
@@ -3341,6 +3605,16 @@ void video_track_generate_play_offer(SrsRtcTrackDescription* track, string mid,
         SrsRedPayload* red_payload = (SrsRedPayload*)track->red_;
         local_media_desc.payload_types_.push_back(red_payload->generate_media_payload_type());
     }
+
+    if (track->rtx_ && track->rtx_ssrc_) {
+        SrsRtxPayloadDes* rtx_payload = (SrsRtxPayloadDes*)track->rtx_;
+        local_media_desc.payload_types_.push_back(rtx_payload->generate_media_payload_type());
+    }
+
+    // The ULPFEC in RED, in the same stream of media.
+    if (track->red_ && !track->red_->pt_of_publisher_ && track->ulpfec_) {
+        local_media_desc.payload_types_.push_back(track->ulpfec_->generate_media_payload_type());
+    }
 }
 
 srs_error_t SrsRtcConnection::generate_play_local_sdp(SrsRequest* req, SrsSdp& local_sdp, SrsRtcSourceDescription* stream_desc, bool unified_plan)
@@ -3526,6 +3800,20 @@ srs_error_t SrsRtcConnection::create_player(SrsRequest* req, std::map<uint32_t,
     }
     srs_trace("RTC connection player gcc=%d", twcc_id);
 
+    // Enable the send-side BWE and pacer, if player supports TWCC, shared by all players of session.
+    if (twcc_id > 0 && !bwe_ && _srs_config->get_rtc_bwe_enabled(req->vhost)) {
+        twcc_id_ = twcc_id;
+
+        int64_t max_bitrate = (int64_t)_srs_config->get_rtc_bwe_max_bitrate(req->vhost) * 1000;
+        bwe_ = new SrsRtcSendSideBwe();
+        bwe_->set_bitrate_range(SRS_RTC_BWE_MIN_BITRATE, max_bitrate);
+
+        pacer_ = new SrsRtcPacer();
+        pacer_->set_rate((int64_t)(bwe_->bitrate() * SRS_RTC_PACING_FACTOR));
+        srs_trace("RTC connection player bwe, twcc=%d, bitrate=%" PRId64 ", max=%" PRId64, twcc_id_,
+            bwe_->bitrate(), max_bitrate);
+    }
+
     // If DTLS done, start the player. Because maybe create some players after DTLS done.
     // For example, for single PC, we maybe start publisher when create it, because DTLS is done.
     if(ESTABLISHED == state_) {
@@ -3583,6 +3871,10 @@ srs_error_t SrsRtcConnection::create_publisher(SrsRequest* req, SrsRtcSourceDesc
 
     for(int i = 0; i < (int)stream_desc->video_track_descs_.size(); ++i) {
         SrsRtcTrackDescription* track_desc = stream_desc->video_track_descs_.at(i);
+        // Ignore the simulcast layer by RID, which is bound when got the first packet.
+        if (!track_desc->ssrc_) {
+            continue;
+        }
         if(publishers_ssrc_map_.end() != publishers_ssrc_map_.find(track_desc->ssrc_)) {
             return srs_error_new(ERROR_RTC_DUPLICATED_SSRC, " duplicate ssrc %d, track id: %s",
                 track_desc->ssrc_, track_desc->id_.c_str());
@@ -33,6 +33,7 @@
 class SrsUdpMuxSocket;
 class SrsLiveConsumer;
 class SrsStunPacket;
+class SrsStunBindingResponder;
 class SrsRtcServer;
 class SrsRtcConnection;
 class SrsSharedPtrMessage;
@@ -51,6 +52,9 @@ class SrsStatistic;
 class SrsRtcUserConfig;
 class SrsRtcSendTrack;
 class SrsRtcPublishStream;
+class SrsRtcSendSideBwe;
+class SrsRtcPacer;
+class SrsRtcLayerSelector;
 
 const uint8_t kSR   = 200;
 const uint8_t kRR   = 201;
@@ -235,6 +239,8 @@ private:
     SrsRtcSendTrack* cache_track0_;
     SrsRtcSendTrack* cache_track1_;
     SrsRtcSendTrack* cache_track2_;
+    // The layer selector for simulcast source.
+    SrsRtcLayerSelector* selector_;
 private:
     // For merged-write messages.
     int mw_msgs;
@@ -265,6 +271,8 @@ public:
     virtual srs_error_t cycle();
 private:
     srs_error_t send_packet(SrsRtpPacket*& pkt);
+    // Whether forward the packet of simulcast layer, by the estimated bandwidth of player.
+    bool select_layer(SrsRtpPacket* pkt);
 public:
     // Directly set the status of track, generally for init to set the default value.
     void set_all_tracks_status(bool status);
@@ -361,6 +369,8 @@ private:
     SrsRtpExtensionTypes extension_types_;
     bool is_started;
     srs_utime_t last_time_send_twcc_;
+    // The RID extension id, for simulcast by RID.
+    int rid_id_;
 public:
     SrsRtcPublishStream(SrsRtcConnection* session, const SrsContextId& cid);
     virtual ~SrsRtcPublishStream();
@@ -375,6 +385,9 @@ private:
     srs_error_t send_rtcp_xr_rrtr();
 public:
     srs_error_t on_rtp(char* buf, int nb_buf);
+    // Bind the SSRC to the simulcast layer, by the RID extension of RTP packet.
+    // @return Whether the SSRC is bound to a layer of this publisher.
+    bool bind_rid(char* buf, int nb_buf, uint32_t ssrc);
 private:
     // @remark We copy the plaintext, user should free it.
     srs_error_t on_rtp_plaintext(char* plaintext, int nb_plaintext);
@@ -467,6 +480,10 @@ private:
     SrsUdpMuxSocket* sendonly_skt;
     // The address list, client may use multiple addresses.
     std::map<std::string, SrsUdpMuxSocket*> peer_addresses_;
+    // The cached STUN binding response, and the mapped address of the peer address.
+    SrsStunBindingResponder* stun_responder_;
+    SrsUdpMuxSocket* stun_skt_;
+    uint32_t stun_mapped_address_;
 private:
     // TODO: FIXME: Rename it.
     // The timeout of session, keep alive by STUN ping pong.
@@ -482,6 +499,9 @@ private:
 private:
     // twcc handler
     int twcc_id_;
+    // The send-side BWE and pacer for players, NULL if disabled.
+    SrsRtcSendSideBwe* bwe_;
+    SrsRtcPacer* pacer_;
     // Simulators.
     int nn_simulate_player_nack_drop;
     // Pithy print for address change, use port as error code.
@@ -538,7 +558,7 @@ public:
 private:
     srs_error_t dispatch_rtcp(SrsRtcpCommon* rtcp);
 public:
-    srs_error_t on_rtcp_feedback_twcc(char* buf, int nb_buf);
+    srs_error_t on_rtcp_feedback_twcc(SrsRtcpTWCC* rtcp);
     srs_error_t on_rtcp_feedback_remb(SrsRtcpPsfbCommon *rtcp);
 public:
     void set_hijacker(ISrsRtcConnectionHijacker* h);
@@ -18,6 +18,7 @@ using namespace std;
 #include <srs_app_utility.hpp>
 #include <srs_kernel_rtc_rtp.hpp>
 #include <srs_app_log.hpp>
+#include <srs_app_threads.hpp>
 #include <srs_kernel_utility.hpp>
 #include <srs_protocol_utility.hpp>
 
@@ -29,6 +30,9 @@ using namespace std;
 // @see https://github.com/ossrs/srs/issues/2415
 const int DTLS_FRAGMENT_MAX_SIZE = 1200;
 
+// The max number of DTLS sessions in cache, for session resumption.
+#define SRS_DTLS_SESSION_CACHE 4096
+
 // Defined in HTTP/HTTPS client.
 extern int srs_verify_callback(int preverify_ok, X509_STORE_CTX *ctx);
 
@@ -186,9 +190,82 @@ SSL_CTX* srs_build_dtls_ctx(SrsDtlsVersion version, std::string role)
         srs_assert(SSL_CTX_set_tlsext_use_srtp(dtls_ctx, "SRTP_AES128_CM_SHA1_80") == 0);
     }
 
+    // Setup the session cache, for client to resume the session when reconnecting, which does not
+    // require the ECDHE and signing. Note that it requires the session id context, for verify peer.
+    // @see https://www.openssl.org/docs/man1.1.1/man3/SSL_CTX_set_session_id_context.html
+    if (true) {
+        static const unsigned char sid_ctx[] = "srs-dtls";
+        srs_assert(SSL_CTX_set_session_id_context(dtls_ctx, sid_ctx, sizeof(sid_ctx) - 1) == 1);
+        SSL_CTX_set_session_cache_mode(dtls_ctx, SSL_SESS_CACHE_SERVER);
+        SSL_CTX_sess_set_cache_size(dtls_ctx, SRS_DTLS_SESSION_CACHE);
+    }
+
     return dtls_ctx;
 }
 
+// The DTLS contexts shared by all sessions, indexed by version and role, because it's expensive to
+// create the context and setup the certificate, and the session cache only works in the same context.
+// @remark The contexts are only used by the hybrid thread, so it's safe.
+static SSL_CTX* _srs_dtls_ctxs[3][2];
+
+SSL_CTX* srs_fetch_dtls_ctx(SrsDtlsVersion version, std::string role)
+{
+    int index = (version == SrsDtlsVersion1_0) ? 1 : ((version == SrsDtlsVersion1_2) ? 2 : 0);
+    int active = (role == "active") ? 1 : 0;
+
+    SSL_CTX*& dtls_ctx = _srs_dtls_ctxs[index][active];
+    if (!dtls_ctx) {
+        dtls_ctx = srs_build_dtls_ctx(version, role);
+    }
+
+    return dtls_ctx;
+}
+
+SrsDtlsAdmission::SrsDtlsAdmission()
+{
+    rate_ = 0;
+    window_ = 0;
+    nn_admitted_ = 0;
+    nn_rejected_ = 0;
+}
+
+SrsDtlsAdmission::~SrsDtlsAdmission()
+{
+}
+
+void SrsDtlsAdmission::set_rate(int rate)
+{
+    rate_ = rate;
+}
+
+bool SrsDtlsAdmission::admit(srs_utime_t now)
+{
+    // Start a new window every 1s.
+    if (now - window_ >= SRS_UTIME_SECONDS) {
+        if (nn_rejected_) {
+            srs_warn("DTLS: Admission reject %d handshakes, admit %d, rate=%d", nn_rejected_, nn_admitted_, rate_);
+        }
+
+        window_ = now;
+        nn_admitted_ = 0;
+        nn_rejected_ = 0;
+    }
+
+    // Prefer the existing sessions, when CPU is critical.
+    if (_srs_circuit_breaker->hybrid_critical_water_level()) {
+        nn_rejected_++;
+        return false;
+    }
+
+    if (rate_ > 0 && nn_admitted_ >= rate_) {
+        nn_rejected_++;
+        return false;
+    }
+
+    nn_admitted_++;
+    return true;
+}
+
 SrsDtlsCertificate::SrsDtlsCertificate()
 {
     ecdsa_mode = true;
@@ -407,10 +484,8 @@ SrsDtlsImpl::~SrsDtlsImpl()
             version_, nn_arq_packets);
     }
 
-    if (dtls_ctx) {
-        SSL_CTX_free(dtls_ctx);
-        dtls_ctx = NULL;
-    }
+    // The context is shared, and SSL holds a reference of it.
+    dtls_ctx = NULL;
 
     if (dtls) {
         // this function will free bio_in and bio_out
@@ -431,7 +506,7 @@ srs_error_t SrsDtlsImpl::initialize(std::string version, std::string role)
         version_ = SrsDtlsVersionAuto;
     }
 
-    dtls_ctx = srs_build_dtls_ctx(version_, role);
+    dtls_ctx = srs_fetch_dtls_ctx(version_, role);
 
     if ((dtls = SSL_new(dtls_ctx)) == NULL) {
         return srs_error_new(ERROR_OpenSslCreateSSL, "SSL_new dtls");
@@ -894,6 +969,7 @@ srs_error_t SrsDtlsClientImpl::cycle()
 
 SrsDtlsServerImpl::SrsDtlsServerImpl(ISrsDtlsCallback* callback) : SrsDtlsImpl(callback)
 {
+    admitted_ = false;
 }
 
 SrsDtlsServerImpl::~SrsDtlsServerImpl()
@@ -926,6 +1002,19 @@ bool SrsDtlsServerImpl::should_reset_timer()
     return false;
 }
 
+srs_error_t SrsDtlsServerImpl::on_dtls(char* data, int nb_data)
+{
+    // Drop the ClientHello if not admitted, the client will retransmit it later.
+    if (!admitted_) {
+        if (!_srs_rtc_dtls_admission->admit(srs_get_system_time())) {
+            return srs_success;
+        }
+        admitted_ = true;
+    }
+
+    return SrsDtlsImpl::on_dtls(data, nb_data);
+}
+
 srs_error_t SrsDtlsServerImpl::on_final_out_data(uint8_t* data, int size)
 {
     // No ARQ, driven by DTLS client packets.
@@ -48,6 +48,30 @@ public:
 // @global config object.
 extern SrsDtlsCertificate* _srs_rtc_dtls_certificate;
 
+// The admission control of DTLS handshakes, to limit the number of new handshakes per second, because
+// the handshake crypto blocks the hybrid thread, which stalls the media of all sessions, when lots of
+// clients reconnect at the same time.
+class SrsDtlsAdmission
+{
+private:
+    // The max number of new handshakes per second, 0 for no limit.
+    int rate_;
+    // The start time of current window, and the number of admitted and rejected handshakes in it.
+    srs_utime_t window_;
+    int nn_admitted_;
+    int nn_rejected_;
+public:
+    SrsDtlsAdmission();
+    virtual ~SrsDtlsAdmission();
+public:
+    void set_rate(int rate);
+    // Whether admit a new handshake at now, the ClientHello should be dropped if not.
+    bool admit(srs_utime_t now);
+};
+
+// @global The admission control of DTLS handshakes.
+extern SrsDtlsAdmission* _srs_rtc_dtls_admission;
+
 // @remark: play the role of DTLS_CLIENT, will send handshake
 // packet first.
 enum SrsDtlsRole {
@@ -160,6 +184,9 @@ public:
 
 class SrsDtlsServerImpl : public SrsDtlsImpl
 {
+private:
+    // Whether the handshake is admitted, by the first packet from client.
+    bool admitted_;
 public:
     SrsDtlsServerImpl(ISrsDtlsCallback* callback);
     virtual ~SrsDtlsServerImpl();
@@ -167,6 +194,7 @@ public:
     virtual srs_error_t initialize(std::string version, std::string role);
     virtual srs_error_t start_active_handshake();
     virtual bool should_reset_timer();
+    virtual srs_error_t on_dtls(char* data, int nb_data);
 protected:
     virtual srs_error_t on_final_out_data(uint8_t* data, int size);
     virtual srs_error_t on_handshake_done();
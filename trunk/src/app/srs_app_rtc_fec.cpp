@@ -0,0 +1,278 @@
+//
+// Copyright (c) 2013-2022 The SRS Authors
+//
+// SPDX-License-Identifier: MIT or MulanPSL-2.0
+//
+
+#include <srs_app_rtc_fec.hpp>
+
+#include <string.h>
+using namespace std;
+
+#include <srs_kernel_error.hpp>
+#include <srs_kernel_buffer.hpp>
+#include <srs_kernel_rtc_rtp.hpp>
+#include <srs_kernel_utility.hpp>
+
+// Disable FEC if loss is less than this rate.
+#define SRS_RTC_FEC_MIN_LOSS 0.005
+
+void srs_rtp_fec_xor(uint8_t* dst, const uint8_t* src, int size)
+{
+    int i = 0;
+
+    // Use memcpy for unaligned words, which is optimized to load and store by compiler.
+    for (; i + 8 <= size; i += 8) {
+        uint64_t a, b;
+        memcpy(&a, dst + i, 8);
+        memcpy(&b, src + i, 8);
+        a ^= b;
+        memcpy(dst + i, &a, 8);
+    }
+
+    for (; i < size; i++) {
+        dst[i] ^= src[i];
+    }
+}
+
+SrsRtpUlpfecEncoder::SrsRtpUlpfecEncoder()
+{
+    loss_ = 0;
+    group_ = 0;
+    payload_ = new uint8_t[SRS_RTC_FEC_MAX_PROTECTED];
+    memset(payload_, 0, SRS_RTC_FEC_MAX_PROTECTED);
+
+    max_length_ = 0;
+    reset();
+}
+
+SrsRtpUlpfecEncoder::~SrsRtpUlpfecEncoder()
+{
+    srs_freepa(payload_);
+}
+
+void SrsRtpUlpfecEncoder::on_loss(float loss)
+{
+    loss_ = (loss_ + loss) / 2;
+
+    if (loss_ < SRS_RTC_FEC_MIN_LOSS) {
+        group_ = 0;
+        return;
+    }
+
+    // A FEC packet recovers one lost packet of group, so the group should be about half of the
+    // number of packets to lose one packet, which makes FEC useful but not too much overhead.
+    int v = (int)(1 / (2 * loss_));
+    group_ = srs_max(SRS_RTC_FEC_MIN_GROUP, srs_min(v, SRS_RTC_FEC_MAX_GROUP));
+}
+
+bool SrsRtpUlpfecEncoder::enabled()
+{
+    return group_ > 0;
+}
+
+int SrsRtpUlpfecEncoder::group()
+{
+    return group_;
+}
+
+int SrsRtpUlpfecEncoder::count()
+{
+    return count_;
+}
+
+srs_error_t SrsRtpUlpfecEncoder::protect(uint16_t seq, char* data, int size)
+{
+    srs_error_t err = srs_success;
+
+    int length = size - SRS_RTC_FEC_RTP_HEADER;
+    if (length < 0 || length > SRS_RTC_FEC_MAX_PROTECTED) {
+        return srs_error_new(ERROR_RTC_RTP_MUXER, "invalid size %d", size);
+    }
+
+    // Start a new group if the sequence is out of mask, for example, some packets are lost.
+    if (count_ > 0) {
+        int16_t distance = srs_rtp_seq_distance(base_, seq);
+        if (distance <= 0 || distance >= SRS_RTC_FEC_MAX_GROUP) {
+            reset();
+        }
+    }
+
+    if (!count_) {
+        base_ = seq;
+    }
+
+    uint8_t* p = (uint8_t*)data;
+    byte0_ ^= p[0];
+    byte1_ ^= p[1];
+    ts_ ^= ((uint32_t)p[4] << 24) | ((uint32_t)p[5] << 16) | ((uint32_t)p[6] << 8) | (uint32_t)p[7];
+    length_ ^= (uint16_t)length;
+    srs_rtp_fec_xor(payload_, p + SRS_RTC_FEC_RTP_HEADER, length);
+
+    mask_ |= (uint16_t)(0x8000 >> srs_rtp_seq_distance(base_, seq));
+    max_length_ = srs_max(max_length_, length);
+    count_++;
+
+    return err;
+}
+
+bool SrsRtpUlpfecEncoder::is_ready(bool marker)
+{
+    if (!group_ || !count_) {
+        return false;
+    }
+
+    return count_ >= group_ || (marker && count_ * 2 >= group_);
+}
+
+int SrsRtpUlpfecEncoder::nb_bytes()
+{
+    return SRS_RTC_FEC_HEADER + max_length_;
+}
+
+srs_error_t SrsRtpUlpfecEncoder::encode(SrsBuffer* buf)
+{
+    srs_error_t err = srs_success;
+
+    if (!buf->require(nb_bytes())) {
+        return srs_error_new(ERROR_RTC_RTP_MUXER, "requires %d bytes", nb_bytes());
+    }
+
+    // The FEC header, E=0 and L=0 for 16 bits mask.
+    buf->write_1bytes(byte0_ & 0x3f);
+    buf->write_1bytes(byte1_);
+    buf->write_2bytes(base_);
+    buf->write_4bytes(ts_);
+    buf->write_2bytes(length_);
+
+    // The ULP level header.
+    buf->write_2bytes(max_length_);
+    buf->write_2bytes(mask_);
+
+    buf->write_bytes((char*)payload_, max_length_);
+
+    reset();
+
+    return err;
+}
+
+void SrsRtpUlpfecEncoder::reset()
+{
+    count_ = 0;
+    base_ = 0;
+    mask_ = 0;
+    byte0_ = byte1_ = 0;
+    ts_ = 0;
+    length_ = 0;
+
+    memset(payload_, 0, max_length_);
+    max_length_ = 0;
+}
+
+SrsRtcFecSender::SrsRtcFecSender(uint8_t red_pt, uint8_t fec_pt)
+{
+    red_pt_ = red_pt;
+    fec_pt_ = fec_pt;
+    seq_offset_ = 0;
+    encoder_ = new SrsRtpUlpfecEncoder();
+    cache_ = new char[kRtpPacketSize];
+}
+
+SrsRtcFecSender::~SrsRtcFecSender()
+{
+    srs_freep(encoder_);
+    srs_freepa(cache_);
+}
+
+void SrsRtcFecSender::on_loss(float loss)
+{
+    encoder_->on_loss(loss);
+}
+
+void SrsRtcFecSender::on_media(SrsRtpPacket* pkt)
+{
+    pkt->header.set_sequence(pkt->header.get_sequence() + seq_offset_);
+
+    ISrsRtpPayloader* payload = pkt->payload();
+    if (!payload) {
+        return;
+    }
+
+    // All media packets are in RED, even FEC is disabled, because the receiver might not switch
+    // between RED and media PT smoothly.
+    SrsRtpRedPayload* red = new SrsRtpRedPayload();
+    red->block_pt = pkt->header.get_payload_type();
+    red->block = payload;
+
+    pkt->set_payload(red, SrsRtspPacketPayloadTypeRED);
+    pkt->header.set_payload_type(red_pt_);
+}
+
+srs_error_t SrsRtcFecSender::on_sent(SrsRtpPacket* pkt, SrsRtpPacket** pfec)
+{
+    srs_error_t err = srs_success;
+
+    if (!encoder_->enabled()) {
+        return err;
+    }
+
+    SrsRtpRedPayload* red = dynamic_cast<SrsRtpRedPayload*>(pkt->payload());
+    if (!red) {
+        return err;
+    }
+
+    // Marshal the packet, then restore the media packet from RED, by setting the PT to media and
+    // removing the RED header, because the receiver recovers the media packet.
+    SrsBuffer buf(cache_, kRtpPacketSize);
+    if ((err = pkt->encode(&buf)) != srs_success) {
+        return srs_error_wrap(err, "encode packet");
+    }
+
+    int size = buf.pos();
+    int header = (int)pkt->header.nb_bytes();
+    if (size <= header) {
+        return err;
+    }
+
+    cache_[1] = (cache_[1] & 0x80) | (red->block_pt & 0x7f);
+    memmove(cache_ + header, cache_ + header + 1, size - header - 1);
+    size--;
+
+    uint16_t seq = pkt->header.get_sequence();
+    if ((err = encoder_->protect(seq, cache_, size)) != srs_success) {
+        return srs_error_wrap(err, "protect seq=%u", seq);
+    }
+
+    if (!encoder_->is_ready(pkt->header.get_marker())) {
+        return err;
+    }
+
+    // The FEC packet takes the sequence after the media packet.
+    SrsRtpPacket* fec = new SrsRtpPacket();
+    *pfec = fec;
+
+    fec->header = pkt->header;
+    fec->header.set_sequence(seq + 1);
+    fec->header.set_payload_type(red_pt_);
+    fec->header.set_marker(false);
+    fec->header.set_padding(0);
+    seq_offset_++;
+
+    int nb_fec = encoder_->nb_bytes();
+    SrsBuffer b(fec->wrap(nb_fec), nb_fec);
+    if ((err = encoder_->encode(&b)) != srs_success) {
+        return srs_error_wrap(err, "encode fec");
+    }
+
+    SrsRtpRawPayload* raw = new SrsRtpRawPayload();
+    raw->payload = b.data();
+    raw->nn_payload = nb_fec;
+
+    SrsRtpRedPayload* fec_red = new SrsRtpRedPayload();
+    fec_red->block_pt = fec_pt_;
+    fec_red->block = raw;
+    fec->set_payload(fec_red, SrsRtspPacketPayloadTypeRED);
+
+    return err;
+}
+
@@ -0,0 +1,105 @@
+//
+// Copyright (c) 2013-2022 The SRS Authors
+//
+// SPDX-License-Identifier: MIT or MulanPSL-2.0
+//
+
+#ifndef SRS_APP_RTC_FEC_HPP
+#define SRS_APP_RTC_FEC_HPP
+
+#include <srs_core.hpp>
+
+class SrsBuffer;
+class SrsRtpPacket;
+
+// The size of RTP fixed header, which is not protected by payload of FEC.
+#define SRS_RTC_FEC_RTP_HEADER 12
+// The size of FEC header and ULP level header with 16 bits mask.
+#define SRS_RTC_FEC_HEADER 14
+// The max size of protected bytes of a media packet.
+#define SRS_RTC_FEC_MAX_PROTECTED 1500
+// The max number of media packets protected by a FEC packet, limited by the 16 bits mask.
+#define SRS_RTC_FEC_MAX_GROUP 16
+// The min number of media packets protected by a FEC packet.
+#define SRS_RTC_FEC_MIN_GROUP 2
+
+// XOR the src to dst in size bytes, by 64 bits words, which is vectorized by compiler.
+extern void srs_rtp_fec_xor(uint8_t* dst, const uint8_t* src, int size);
+
+// The ULPFEC encoder, to generate a FEC packet for a group of media packets, by XOR the header
+// fields and the protected bytes incrementally, so we never keep the media packets.
+// The size of group is adaptive to the loss rate reported by receiver, for example, a FEC packet
+// for 10 media packets when loss is 5%, and disabled when almost no loss.
+// @see https://datatracker.ietf.org/doc/html/rfc5109
+class SrsRtpUlpfecEncoder
+{
+private:
+    // The smoothed loss rate, in [0, 1].
+    float loss_;
+    // The number of media packets in a group, zero to disable FEC.
+    int group_;
+private:
+    // The number of media packets protected, and the sequence of first one.
+    int count_;
+    uint16_t base_;
+    uint16_t mask_;
+    // The XOR of header fields, P/X/CC, M/PT, timestamp and length.
+    uint8_t byte0_;
+    uint8_t byte1_;
+    uint32_t ts_;
+    uint16_t length_;
+    // The XOR of protected bytes, and the max size of protected bytes.
+    uint8_t* payload_;
+    int max_length_;
+public:
+    SrsRtpUlpfecEncoder();
+    virtual ~SrsRtpUlpfecEncoder();
+public:
+    // When got the loss rate of receiver, in [0, 1], to update the size of group.
+    void on_loss(float loss);
+    // Whether FEC is enabled, by the loss rate.
+    bool enabled();
+    int group();
+    int count();
+    // Protect a media packet, the data is the RTP packet with media PT, not the RED.
+    srs_error_t protect(uint16_t seq, char* data, int size);
+    // Whether should generate the FEC packet, when reach the size of group, or at the end of a
+    // frame if protected more than half of group, to recover the frame as soon as possible.
+    bool is_ready(bool marker);
+    // The size of FEC payload.
+    int nb_bytes();
+    // Write the FEC payload to buf, and reset for next group.
+    srs_error_t encode(SrsBuffer* buf);
+private:
+    void reset();
+};
+
+// The FEC sender for a video track of player, to send the ULPFEC packets in the same stream of media,
+// and all media packets are encapsulated in RED, so the FEC packets also take sequence numbers, which
+// means we must shift the sequence of media packets after each FEC packet.
+// @see https://datatracker.ietf.org/doc/html/rfc2198
+class SrsRtcFecSender
+{
+private:
+    uint8_t red_pt_;
+    uint8_t fec_pt_;
+    // The number of FEC packets sent, to shift the sequence of media packets.
+    uint16_t seq_offset_;
+    SrsRtpUlpfecEncoder* encoder_;
+    // The cache to marshal the media packet.
+    char* cache_;
+public:
+    SrsRtcFecSender(uint8_t red_pt, uint8_t fec_pt);
+    virtual ~SrsRtcFecSender();
+public:
+    // When got the loss rate of receiver, in [0, 1].
+    void on_loss(float loss);
+    // Shift the sequence and encapsulate the media packet in RED, before sending it.
+    void on_media(SrsRtpPacket* pkt);
+    // Protect the sent media packet, generate the FEC packet if ready, or NULL.
+    // @remark User should free the FEC packet.
+    srs_error_t on_sent(SrsRtpPacket* pkt, SrsRtpPacket** pfec);
+};
+
+#endif
+
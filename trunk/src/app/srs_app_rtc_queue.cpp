@@ -23,6 +23,9 @@ using namespace std;
 extern SrsPps* _srs_pps_snack3;
 extern SrsPps* _srs_pps_snack4;
 
+// The max generic NACK chunks in a RTCP packet.
+#define SRS_RTC_NACK_MAX_CHUNKS ((kRtcpPacketSize - 12) / 4)
+
 SrsRtpRingBuffer::SrsRtpRingBuffer(int capacity)
 {
     nn_seq_flip_backs = 0;
@@ -167,6 +170,68 @@ void SrsRtpRingBuffer::clear_all_histroy()
     }
 }
 
+SrsRtpPacketHistory::SrsRtpPacketHistory()
+{
+    cache_ssrc_ = 0;
+    cache_queue_ = NULL;
+}
+
+SrsRtpPacketHistory::~SrsRtpPacketHistory()
+{
+    clear();
+}
+
+void SrsRtpPacketHistory::put(SrsRtpPacket* pkt)
+{
+    uint32_t ssrc = pkt->header.get_ssrc();
+
+    SrsRtpRingBuffer* queue = cache_queue_;
+    if (!queue || cache_ssrc_ != ssrc) {
+        std::map<uint32_t, SrsRtpRingBuffer*>::iterator it = queues_.find(ssrc);
+        if (it != queues_.end()) {
+            queue = it->second;
+        } else {
+            // The same size of NACK ring buffer of player, see SrsRtcSendTrack.
+            queue = new SrsRtpRingBuffer(pkt->is_audio() ? 100 : 1000);
+            queues_[ssrc] = queue;
+        }
+
+        cache_ssrc_ = ssrc;
+        cache_queue_ = queue;
+    }
+
+    queue->set(pkt->header.get_sequence(), pkt->copy());
+}
+
+SrsRtpPacket* SrsRtpPacketHistory::fetch(uint32_t ssrc, uint16_t seq)
+{
+    std::map<uint32_t, SrsRtpRingBuffer*>::iterator it = queues_.find(ssrc);
+    if (it == queues_.end()) {
+        return NULL;
+    }
+
+    // For NACK, it sequence must match exactly, or it cause SRTP fail.
+    SrsRtpPacket* pkt = it->second->at(seq);
+    if (!pkt || pkt->header.get_sequence() != seq) {
+        return NULL;
+    }
+
+    return pkt;
+}
+
+void SrsRtpPacketHistory::clear()
+{
+    std::map<uint32_t, SrsRtpRingBuffer*>::iterator it;
+    for (it = queues_.begin(); it != queues_.end(); ++it) {
+        SrsRtpRingBuffer* queue = it->second;
+        srs_freep(queue);
+    }
+    queues_.clear();
+
+    cache_ssrc_ = 0;
+    cache_queue_ = NULL;
+}
+
 SrsNackOption::SrsNackOption()
 {
     max_count = 15;
@@ -192,7 +257,8 @@ SrsNackOption::SrsNackOption()
 
 SrsRtpNackInfo::SrsRtpNackInfo()
 {
-    generate_time_ = srs_update_system_time();
+    seq_ = 0;
+    generate_time_ = 0;
     pre_req_nack_time_ = 0;
     req_nack_count_ = 0;
 }
@@ -204,12 +270,25 @@ SrsRtpNackForReceiver::SrsRtpNackForReceiver(SrsRtpRingBuffer* rtp, size_t queue
     pre_check_time_ = 0;
     rtt_ = 0;
 
-    srs_info("max_queue_size=%u, nack opt: max_count=%d, max_alive_time=%us, first_nack_interval=%" PRId64 ", nack_interval=%" PRId64,
-        max_queue_size_, opts_.max_count, opts_.max_alive_time, opts_.first_nack_interval, opts_.nack_interval);
+    // The window should hold the max nack count, and at least a word of bitmap.
+    capacity_ = 64;
+    while (capacity_ < queue_size && capacity_ < 32768) {
+        capacity_ <<= 1;
+    }
+    queue_ = new SrsRtpNackInfo[capacity_];
+    bitmap_ = new uint64_t[capacity_ / 64];
+    memset(bitmap_, 0, sizeof(uint64_t) * (capacity_ / 64));
+    head_ = tail_ = 0;
+    size_ = 0;
+
+    srs_info("max_queue_size=%u, capacity=%u, nack opt: max_count=%d, max_alive_time=%us, first_nack_interval=%" PRId64 ", nack_interval=%" PRId64,
+        max_queue_size_, capacity_, opts_.max_count, opts_.max_alive_time, opts_.first_nack_interval, opts_.nack_interval);
 }
 
 SrsRtpNackForReceiver::~SrsRtpNackForReceiver()
 {
+    srs_freepa(queue_);
+    srs_freepa(bitmap_);
 }
 
 void SrsRtpNackForReceiver::insert(uint16_t first, uint16_t last)
@@ -220,40 +299,86 @@ void SrsRtpNackForReceiver::insert(uint16_t first, uint16_t last)
         return;
     }
 
+    // Only the last window of range is kept, and the queue is full then.
+    if (srs_rtp_seq_distance(first, last) > capacity_) {
+        first = last - capacity_;
+    }
+
+    uint16_t mask = capacity_ - 1;
+    srs_utime_t now = srs_update_system_time();
+
     for (uint16_t s = first; s != last; ++s) {
-        queue_[s] = SrsRtpNackInfo();
+        if (!size_) {
+            head_ = tail_ = s;
+        } else if (srs_rtp_seq_distance(tail_, s) > 0) {
+            // Drop the oldest lost packets, which are out of window.
+            if (srs_rtp_seq_distance(head_, s) >= capacity_) {
+                drop_before(s - capacity_ + 1);
+            }
+            tail_ = s;
+        } else if (srs_rtp_seq_distance(s, head_) > 0) {
+            // Ignore the too old packet, which is out of window.
+            if (srs_rtp_seq_distance(s, tail_) >= capacity_) {
+                continue;
+            }
+            head_ = s;
+        }
+
+        uint16_t slot = s & mask;
+        uint64_t bit = (uint64_t)1 << (slot & 63);
+        if ((bitmap_[slot >> 6] & bit) == 0) {
+            bitmap_[slot >> 6] |= bit;
+            size_++;
+        }
+
+        SrsRtpNackInfo& info = queue_[slot];
+        info.seq_ = s;
+        info.generate_time_ = now;
+        info.pre_req_nack_time_ = 0;
+        info.req_nack_count_ = 0;
     }
 }
 
 void SrsRtpNackForReceiver::remove(uint16_t seq)
 {
-    queue_.erase(seq);
+    if (!find(seq)) {
+        return;
+    }
+
+    uint16_t slot = seq & (capacity_ - 1);
+    bitmap_[slot >> 6] &= ~((uint64_t)1 << (slot & 63));
+    size_--;
 }
 
 SrsRtpNackInfo* SrsRtpNackForReceiver::find(uint16_t seq)
 {
-    std::map<uint16_t, SrsRtpNackInfo>::iterator iter = queue_.find(seq);
-
-    if (iter == queue_.end()) {
+    uint16_t slot = seq & (capacity_ - 1);
+    if ((bitmap_[slot >> 6] & ((uint64_t)1 << (slot & 63))) == 0) {
         return NULL;
     }
 
-    return &(iter->second);
+    SrsRtpNackInfo* info = &queue_[slot];
+    return (info->seq_ == seq) ? info : NULL;
 }
 
 void SrsRtpNackForReceiver::check_queue_size()
 {
-    if (queue_.size() >= max_queue_size_) {
+    if (size_ >= max_queue_size_) {
         rtp_->notify_nack_list_full();
-        queue_.clear();
+        clear();
     }
 }
 
+size_t SrsRtpNackForReceiver::size()
+{
+    return size_;
+}
+
 void SrsRtpNackForReceiver::get_nack_seqs(SrsRtcpNack& seqs, uint32_t& timeout_nacks)
 {
     // If circuit-breaker is enabled, disable nack.
     if (_srs_circuit_breaker->hybrid_high_water_level()) {
-        queue_.clear();
+        clear();
         ++_srs_pps_snack4->sugar;
         return;
     }
@@ -266,37 +391,117 @@ void SrsRtpNackForReceiver::get_nack_seqs(SrsRtcpNack& seqs, uint32_t& timeout_n
     }
     pre_check_time_ = now;
 
-    std::map<uint16_t, SrsRtpNackInfo>::iterator iter = queue_.begin();
-    while (iter != queue_.end()) {
-        const uint16_t& seq = iter->first;
-        SrsRtpNackInfo& nack_info = iter->second;
+    if (!size_) {
+        return;
+    }
+
+    srs_utime_t nack_interval = srs_max(opts_.min_nack_interval, opts_.nack_interval / 3);
+    if(opts_.nack_interval < 50 * SRS_UTIME_MILLISECONDS){
+        nack_interval = srs_max(opts_.min_nack_interval, opts_.nack_interval);
+    }
+
+    // The generic NACK to pack, the lost PID and the BLP of following 16 packets.
+    bool in_use = false;
+    uint16_t pid = 0, blp = 0;
+    int nn_chunks = 0;
+
+    // The new head, the first lost packet in queue after scan.
+    bool has_head = false;
+    uint16_t head = head_;
+
+    uint16_t mask = capacity_ - 1;
+    int span = srs_rtp_seq_distance(head_, tail_) + 1;
+    for (int i = 0; (i += next_lost((head_ + i) & mask, span - i)) < span; i++) {
+        uint16_t seq = head_ + i;
+        uint16_t slot = seq & mask;
+        SrsRtpNackInfo& nack_info = queue_[slot];
 
         int alive_time = now - nack_info.generate_time_;
         if (alive_time > opts_.max_alive_time || nack_info.req_nack_count_ > opts_.max_count) {
             ++timeout_nacks;
             rtp_->notify_drop_seq(seq);
-            queue_.erase(iter++);
+            bitmap_[slot >> 6] &= ~((uint64_t)1 << (slot & 63));
+            size_--;
             continue;
         }
 
+        if (!has_head) {
+            has_head = true;
+            head = seq;
+        }
+
         // TODO:Statistics unorder packet.
         if (now - nack_info.generate_time_ < opts_.first_nack_interval) {
             break;
         }
 
-        srs_utime_t nack_interval = srs_max(opts_.min_nack_interval, opts_.nack_interval / 3);
-        if(opts_.nack_interval < 50 * SRS_UTIME_MILLISECONDS){
-            nack_interval = srs_max(opts_.min_nack_interval, opts_.nack_interval);
+        if (now - nack_info.pre_req_nack_time_ < nack_interval) {
+            continue;
         }
 
-        if (now - nack_info.pre_req_nack_time_ >= nack_interval ) {
-            ++nack_info.req_nack_count_;
-            nack_info.pre_req_nack_time_ = now;
-            seqs.add_lost_sn(seq);
+        // Pack to the chunk if in the following 16 packets of PID, or start a new chunk.
+        int distance = srs_rtp_seq_distance(pid, seq);
+        if (in_use && distance >= 1 && distance <= 16) {
+            blp |= (uint16_t)(1 << (distance - 1));
+        } else {
+            // Request the left packets in next time, if RTCP packet is full.
+            if (nn_chunks >= SRS_RTC_NACK_MAX_CHUNKS) {
+                break;
+            }
+            if (in_use) {
+                seqs.add_lost_chunk(pid, blp);
+            }
+            in_use = true;
+            pid = seq;
+            blp = 0;
+            nn_chunks++;
         }
 
-        ++iter;
+        ++nack_info.req_nack_count_;
+        nack_info.pre_req_nack_time_ = now;
+    }
+
+    if (in_use) {
+        seqs.add_lost_chunk(pid, blp);
+    }
+
+    if (has_head) {
+        head_ = head;
+    }
+}
+
+void SrsRtpNackForReceiver::clear()
+{
+    memset(bitmap_, 0, sizeof(uint64_t) * (capacity_ / 64));
+    size_ = 0;
+}
+
+void SrsRtpNackForReceiver::drop_before(uint16_t seq)
+{
+    uint16_t mask = capacity_ - 1;
+    int count = srs_rtp_seq_distance(head_, seq);
+    for (int i = 0; (i += next_lost((head_ + i) & mask, count - i)) < count; i++) {
+        uint16_t s = head_ + i;
+        uint16_t slot = s & mask;
+        rtp_->notify_drop_seq(s);
+        bitmap_[slot >> 6] &= ~((uint64_t)1 << (slot & 63));
+        size_--;
+    }
+    head_ = seq;
+}
+
+int SrsRtpNackForReceiver::next_lost(int slot, int count)
+{
+    // Scan the bitmap by word, skip 64 slots if no lost packet.
+    for (int i = 0; i < count;) {
+        int pos = (slot + i) & (capacity_ - 1);
+        uint64_t word = bitmap_[pos >> 6] >> (pos & 63);
+        if (word) {
+            return srs_min(i + __builtin_ctzll(word), count);
+        }
+        i += 64 - (pos & 63);
     }
+    return count;
 }
 
 void SrsRtpNackForReceiver::update_rtt(int rtt)
@@ -312,3 +517,225 @@ void SrsRtpNackForReceiver::update_rtt(int rtt)
     opts_.nack_interval = srs_min(opts_.nack_interval, opts_.max_nack_interval);
 }
 
+SrsRtpJitterBuffer::SrsRtpJitterBuffer(uint16_t capacity)
+{
+    // The capacity must be power of 2.
+    capacity_ = 64;
+    while (capacity_ < capacity && capacity_ < 16384) {
+        capacity_ <<= 1;
+    }
+
+    pkts_ = new SrsRtpPacket*[capacity_];
+    memset(pkts_, 0, sizeof(SrsRtpPacket*) * capacity_);
+    size_ = 0;
+
+    started_ = popped_ = false;
+    head_ = highest_ = 0;
+    scanned_ = 0;
+    wait_keyframe_ = true;
+    delay_ = 0;
+    wait_start_ = 0;
+    nn_dropped_ = 0;
+}
+
+SrsRtpJitterBuffer::~SrsRtpJitterBuffer()
+{
+    clear();
+    srs_freepa(pkts_);
+}
+
+void SrsRtpJitterBuffer::set_delay(srs_utime_t v)
+{
+    delay_ = v;
+}
+
+void SrsRtpJitterBuffer::put(SrsRtpPacket* pkt)
+{
+    uint16_t seq = pkt->header.get_sequence();
+
+    if (!started_) {
+        reset(seq);
+    }
+
+    int16_t distance = srs_rtp_seq_distance(head_, seq);
+    if (distance < 0 && distance > -capacity_) {
+        // Drop the late packet, whose frame is done. Note that we accept the packets before the first
+        // frame, for out-of-order packets.
+        if (popped_ || srs_rtp_seq_distance(seq, highest_) >= capacity_) {
+            srs_freep(pkt);
+            return;
+        }
+        head_ = seq;
+        scanned_ = 0;
+    } else if (distance < 0 || distance >= capacity_) {
+        // The sequence jumps too far, for example, the publisher restarts.
+        srs_warn("RTC: Jitter reset, head=%u, highest=%u, seq=%u, size=%d", head_, highest_, seq, size_);
+        if (size_) {
+            nn_dropped_++;
+        }
+        reset(seq);
+    }
+
+    if (srs_rtp_seq_distance(highest_, seq) > 0) {
+        highest_ = seq;
+    }
+
+    SrsRtpPacket*& slot = pkts_[seq & (capacity_ - 1)];
+    if (slot) {
+        // Duplicated packet, for example, retransmitted.
+        srs_freep(pkt);
+        return;
+    }
+
+    slot = pkt;
+    size_++;
+}
+
+bool SrsRtpJitterBuffer::pop(vector<SrsRtpPacket*>& frame, srs_utime_t now)
+{
+    while (size_ > 0) {
+        SrsRtpPacket* first = pkts_[head_ & (capacity_ - 1)];
+        uint32_t ts = first ? first->header.get_timestamp() : 0;
+
+        // Find the end of frame, which is the marker, or the packet before the next frame.
+        bool complete = false, lost = false;
+        uint16_t end = head_;
+        for (uint16_t seq = head_ + scanned_; ; seq++) {
+            SrsRtpPacket* pkt = pkts_[seq & (capacity_ - 1)];
+            if (!pkt) {
+                lost = srs_rtp_seq_distance(seq, highest_) > 0;
+                break;
+            }
+            if (pkt->header.get_timestamp() != ts) {
+                end = seq - 1;
+                complete = true;
+                break;
+            }
+            if (pkt->header.get_marker()) {
+                end = seq;
+                complete = true;
+                break;
+            }
+            scanned_++;
+            if (seq == highest_) {
+                break;
+            }
+        }
+
+        if (!complete) {
+            // Wait for more packets of frame.
+            if (!lost) {
+                wait_start_ = 0;
+                return false;
+            }
+
+            // Wait for the lost packet, which might be retransmitted.
+            if (!wait_start_) {
+                wait_start_ = now;
+            }
+            if (now - wait_start_ < delay_) {
+                return false;
+            }
+
+            drop_frame();
+            continue;
+        }
+
+        // Got a frame, the first packet must be the start of frame.
+        SrsRtpFUAPayload2* fua = dynamic_cast<SrsRtpFUAPayload2*>(first->payload());
+        bool broken = (fua && !fua->start);
+        bool keyframe = first->is_keyframe();
+
+        for (uint16_t seq = head_; seq != (uint16_t)(end + 1); seq++) {
+            SrsRtpPacket*& slot = pkts_[seq & (capacity_ - 1)];
+            frame.push_back(slot);
+            slot = NULL;
+            size_--;
+        }
+        head_ = end + 1;
+        scanned_ = 0;
+        popped_ = true;
+        wait_start_ = 0;
+
+        if (broken || (wait_keyframe_ && !keyframe)) {
+            for (int i = 0; i < (int)frame.size(); i++) {
+                SrsRtpPacket* pkt = frame.at(i);
+                srs_freep(pkt);
+            }
+            frame.clear();
+
+            nn_dropped_++;
+            wait_keyframe_ = true;
+            continue;
+        }
+
+        wait_keyframe_ = false;
+        return true;
+    }
+
+    return false;
+}
+
+int SrsRtpJitterBuffer::size()
+{
+    return size_;
+}
+
+int SrsRtpJitterBuffer::nn_dropped()
+{
+    return nn_dropped_;
+}
+
+void SrsRtpJitterBuffer::drop_frame()
+{
+    // The next frame starts after the marker, or the timestamp changed. Note that we keep the previous
+    // packet across the lost ones, for example, the marker is lost and the next frame follows.
+    bool has_prev = false, prev_marker = false;
+    uint32_t prev_ts = 0;
+
+    uint16_t seq = head_;
+    for (; srs_rtp_seq_distance(seq, highest_) >= 0; seq++) {
+        SrsRtpPacket*& slot = pkts_[seq & (capacity_ - 1)];
+
+        if (slot && has_prev && (prev_marker || prev_ts != slot->header.get_timestamp())) {
+            break;
+        }
+
+        if (slot) {
+            has_prev = true;
+            prev_marker = slot->header.get_marker();
+            prev_ts = slot->header.get_timestamp();
+            srs_freep(slot);
+            size_--;
+        }
+    }
+
+    srs_warn("RTC: Jitter drop frame, seq=%u-%u, size=%d, dropped=%d", head_, (uint16_t)(seq - 1), size_, nn_dropped_ + 1);
+
+    head_ = seq;
+    scanned_ = 0;
+    wait_start_ = 0;
+    wait_keyframe_ = true;
+    nn_dropped_++;
+}
+
+void SrsRtpJitterBuffer::reset(uint16_t seq)
+{
+    clear();
+
+    started_ = true;
+    popped_ = false;
+    head_ = highest_ = seq;
+    scanned_ = 0;
+    wait_start_ = 0;
+    wait_keyframe_ = true;
+}
+
+void SrsRtpJitterBuffer::clear()
+{
+    for (int i = 0; i < capacity_; i++) {
+        srs_freep(pkts_[i]);
+    }
+    size_ = 0;
+}
+
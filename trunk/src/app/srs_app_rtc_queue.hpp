@@ -75,6 +75,80 @@ public:
     void clear_all_histroy();
 };
 
+// The history of packets of a source, shared by all players for NACK, so we only keep one copy of
+// each packet for a source, and rewrite the header for each player when retransmit it.
+class SrsRtpPacketHistory
+{
+private:
+    // The packets of each SSRC, indexed by sequence.
+    std::map<uint32_t, SrsRtpRingBuffer*> queues_;
+    // The cache of last queue, because packets of a SSRC are continuous generally.
+    uint32_t cache_ssrc_;
+    SrsRtpRingBuffer* cache_queue_;
+public:
+    SrsRtpPacketHistory();
+    virtual ~SrsRtpPacketHistory();
+public:
+    // Keep a copy of packet.
+    void put(SrsRtpPacket* pkt);
+    // Fetch the packet by original SSRC and sequence, NULL if not found.
+    // @remark User should never free the packet, which is owned by history.
+    SrsRtpPacket* fetch(uint32_t ssrc, uint16_t seq);
+    void clear();
+};
+
+// The capacity of jitter buffer, enough for a large keyframe.
+#define SRS_RTC_JITTER_CAPACITY 2048
+
+// The jitter buffer of video packets, to reorder the packets by sequence and assemble the complete
+// frames, for example, to transmux RTC to RTMP. The packets of a frame are in the same timestamp,
+// and the frame is complete if the packets are continuous, from the end of last frame to marker.
+//      * If lost a packet, wait for it for a while, because it might be out-of-order or retransmitted.
+//      * If timeout, drop the broken frame and the frames after it until a keyframe.
+class SrsRtpJitterBuffer
+{
+private:
+    // The packets indexed by sequence, the capacity is power of 2.
+    SrsRtpPacket** pkts_;
+    uint16_t capacity_;
+    int size_;
+private:
+    // Whether got the first packet.
+    bool started_;
+    // Whether popped any frame, we accept the packets before head only if not.
+    bool popped_;
+    // The first sequence of next frame, and the highest sequence.
+    uint16_t head_;
+    uint16_t highest_;
+    // The number of packets from head, which are checked to be in the frame and not the end of frame,
+    // so we resume the scan from there, rather than rescan from head for each packet.
+    uint16_t scanned_;
+    // Drop the frames until a keyframe, because the frames depend on the previous frames.
+    bool wait_keyframe_;
+    // The max time to wait for the lost packet, and the time we start to wait, zero if not wait.
+    srs_utime_t delay_;
+    srs_utime_t wait_start_;
+    // The number of frames dropped for packet lost.
+    int nn_dropped_;
+public:
+    SrsRtpJitterBuffer(uint16_t capacity);
+    virtual ~SrsRtpJitterBuffer();
+public:
+    void set_delay(srs_utime_t v);
+    // Put a packet to jitter buffer, which takes the ownership of packet.
+    void put(SrsRtpPacket* pkt);
+    // Pop a complete frame, the packets are in sequence.
+    // @return Whether got a frame. User should free the packets.
+    bool pop(std::vector<SrsRtpPacket*>& frame, srs_utime_t now);
+    int size();
+    int nn_dropped();
+private:
+    // Drop the packets of broken frame, until the start of next frame.
+    void drop_frame();
+    void reset(uint16_t seq);
+    void clear();
+};
+
 struct SrsNackOption
 {
     int max_count;
@@ -91,6 +165,8 @@ struct SrsNackOption
 
 struct SrsRtpNackInfo
 {
+    // The sequence of lost packet, to verify the slot of window.
+    uint16_t seq_;
     // Use to control the time of first nack req and the life of seq.
     srs_utime_t generate_time_;
     // Use to control nack interval.
@@ -101,11 +177,24 @@ struct SrsRtpNackInfo
     SrsRtpNackInfo();
 };
 
+// The lost packets of receiver, in a window of sequence indexed by seq modulo capacity, with a bitmap
+// of lost slots, so insert and remove are O(1), and we scan the bitmap by word to find the NACK to
+// request, then pack the generic NACK(PID and BLP) directly in order of sequence.
+//      [head_ ... tail_] in window of capacity_, slot is seq & (capacity_ - 1)
 class SrsRtpNackForReceiver
 {
 private:
-    // Nack queue, seq order, oldest to newest.
-    std::map<uint16_t, SrsRtpNackInfo, SrsSeqCompareLess> queue_;
+    // The nack info of lost packets, indexed by slot.
+    SrsRtpNackInfo* queue_;
+    // The bitmap of lost slots, set if the slot is in queue.
+    uint64_t* bitmap_;
+    // The capacity of window, must be power of 2.
+    uint16_t capacity_;
+    // The oldest and newest lost sequence, the head is lazy, which might be received.
+    uint16_t head_;
+    uint16_t tail_;
+    // The number of lost packets in queue.
+    size_t size_;
     // Max nack count.
     size_t max_queue_size_;
     SrsRtpRingBuffer* rtp_;
@@ -122,10 +211,17 @@ public:
     void remove(uint16_t seq);
     SrsRtpNackInfo* find(uint16_t seq);
     void check_queue_size();
+    size_t size();
 public:
     void get_nack_seqs(SrsRtcpNack& seqs, uint32_t& timeout_nacks);
 public:
     void update_rtt(int rtt);
+private:
+    void clear();
+    // Drop the lost packets before seq, which are out of window.
+    void drop_before(uint16_t seq);
+    // Get the next lost slot from the slot, in count slots, return count if not found.
+    int next_lost(int slot, int count);
 };
 
 #endif
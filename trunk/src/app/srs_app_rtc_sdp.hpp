@@ -16,6 +16,10 @@
 #include <vector>
 #include <map>
 const std::string kTWCCExt = "http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01";
+// The RTP stream id and MID, for simulcast by RID.
+// @see https://datatracker.ietf.org/doc/html/rfc8852
+const std::string kRidExt = "urn:ietf:params:rtp-hdrext:sdes:rtp-stream-id";
+const std::string kMidExt = "urn:ietf:params:rtp-hdrext:sdes:mid";
 
 // TDOO: FIXME: Rename it, and add utest.
 extern std::vector<std::string> split_str(const std::string& str, const std::string& delim);
@@ -143,6 +147,8 @@ private:
     srs_error_t parse_attr_ssrc(const std::string& value);
     srs_error_t parse_attr_ssrc_group(const std::string& value);
     srs_error_t parse_attr_extmap(const std::string& value);
+    srs_error_t parse_attr_rid(const std::string& value);
+    srs_error_t parse_attr_simulcast(const std::string& value);
 private:
     SrsSSRCInfo& fetch_or_create_ssrc_info(uint32_t ssrc);
 
@@ -169,6 +175,9 @@ public:
     std::vector<SrsSSRCGroup> ssrc_groups_;
     std::vector<SrsSSRCInfo>  ssrc_infos_;
     std::map<int, std::string> extmaps_;
+    // The RID of simulcast layers, in the order of a=simulcast if exists.
+    // @see https://datatracker.ietf.org/doc/html/rfc8853
+    std::vector<std::string> rids_;
 };
 
 class SrsSdp
@@ -122,6 +122,9 @@ SrsRtcBlackhole* _srs_blackhole = NULL;
 // @global dtls certficate for rtc module.
 SrsDtlsCertificate* _srs_rtc_dtls_certificate = NULL;
 
+// @global dtls admission control for rtc module.
+SrsDtlsAdmission* _srs_rtc_dtls_admission = NULL;
+
 // TODO: Should support error response.
 // For STUN packet, 0x00 is binding request, 0x01 is binding success response.
 bool srs_is_stun(const uint8_t* data, size_t size)
@@ -424,13 +427,17 @@ srs_error_t SrsRtcServer::on_udp_packet(SrsUdpMuxSocket* skt)
     // For STUN, the peer address may change.
     if (!is_rtp_or_rtcp && srs_is_stun((uint8_t*)data, size)) {
         ++_srs_pps_rstuns->sugar;
-        string peer_id = skt->peer_id();
 
+        // For known session by address, for example, the consent freshness, never parse the username.
         SrsStunPacket ping;
-        if ((err = ping.decode(data, size)) != srs_success) {
-            return srs_error_wrap(err, "decode stun packet failed");
-        }
-        if (!session) {
+        if (session) {
+            if ((err = ping.decode_fast(data, size)) != srs_success) {
+                return srs_error_wrap(err, "decode stun packet failed");
+            }
+        } else {
+            if ((err = ping.decode(data, size)) != srs_success) {
+                return srs_error_wrap(err, "decode stun packet failed");
+            }
             session = find_session_by_username(ping.get_username());
         }
         if (session) {
@@ -438,12 +445,12 @@ srs_error_t SrsRtcServer::on_udp_packet(SrsUdpMuxSocket* skt)
         }
 
         srs_info("recv stun packet from %s, fast=%" PRId64 ", use-candidate=%d, ice-controlled=%d, ice-controlling=%d",
-            peer_id.c_str(), fast_id, ping.get_use_candidate(), ping.get_ice_controlled(), ping.get_ice_controlling());
+            skt->peer_id().c_str(), fast_id, ping.get_use_candidate(), ping.get_ice_controlled(), ping.get_ice_controlling());
 
         // TODO: FIXME: For ICE trickle, we may get STUN packets before SDP answer, so maybe should response it.
         if (!session) {
             return srs_error_new(ERROR_RTC_STUN, "no session, stun username=%s, peer_id=%s, fast=%" PRId64,
-                ping.get_username().c_str(), peer_id.c_str(), fast_id);
+                ping.get_username().c_str(), skt->peer_id().c_str(), fast_id);
         }
 
         return session->on_stun(skt, &ping);
@@ -737,6 +744,8 @@ srs_error_t RtcServerAdapter::initialize()
         return srs_error_wrap(err, "rtc dtls certificate initialize");
     }
 
+    _srs_rtc_dtls_admission->set_rate(_srs_config->get_rtc_server_dtls_handshake_rate());
+
     if ((err = rtc->initialize()) != srs_success) {
         return srs_error_wrap(err, "rtc server initialize");
     }
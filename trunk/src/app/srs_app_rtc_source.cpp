@@ -22,6 +22,7 @@
 #include <srs_kernel_rtc_rtp.hpp>
 #include <srs_core_autofree.hpp>
 #include <srs_app_rtc_queue.hpp>
+#include <srs_app_rtc_fec.hpp>
 #include <srs_app_rtc_conn.hpp>
 #include <srs_protocol_utility.hpp>
 #include <srs_protocol_json.hpp>
@@ -328,6 +329,7 @@ SrsRtcSource::SrsRtcSource()
 {
     is_created_ = false;
     is_delivering_packets_ = false;
+    stamp_ingress_ = false;
 
     publish_stream_ = NULL;
     stream_desc_ = NULL;
@@ -336,6 +338,7 @@ SrsRtcSource::SrsRtcSource()
     bridge_ = NULL;
 
     pli_for_rtmp_ = pli_elapsed_ = 0;
+    history_ = new SrsRtpPacketHistory();
 }
 
 SrsRtcSource::~SrsRtcSource()
@@ -347,6 +350,7 @@ SrsRtcSource::~SrsRtcSource()
     srs_freep(bridge_);
     srs_freep(req);
     srs_freep(stream_desc_);
+    srs_freep(history_);
 }
 
 srs_error_t SrsRtcSource::initialize(SrsRequest* r)
@@ -354,6 +358,7 @@ srs_error_t SrsRtcSource::initialize(SrsRequest* r)
     srs_error_t err = srs_success;
 
     req = r->copy();
+    stamp_ingress_ = _srs_config->get_stats_latency();
 
 	// Create default relations to allow play before publishing.
 	// @see https://github.com/ossrs/srs/issues/2362
@@ -502,6 +507,11 @@ void SrsRtcSource::on_consumer_destroy(SrsRtcConsumer* consumer)
     }
 }
 
+bool SrsRtcSource::has_consumers()
+{
+    return !consumers.empty();
+}
+
 bool SrsRtcSource::can_publish()
 {
     // TODO: FIXME: Should check the status of bridge.
@@ -582,6 +592,8 @@ void SrsRtcSource::on_unpublish()
         srs_freep(bridge_);
     }
 
+    history_->clear();
+
     SrsStatistic* stat = SrsStatistic::instance();
     stat->on_stream_close(req);
 }
@@ -622,6 +634,32 @@ srs_error_t SrsRtcSource::on_rtp(SrsRtpPacket* pkt)
         return err;
     }
 
+    // Stamp the packet if not, for example, the packet from RTMP is stamped by the message.
+    if (stamp_ingress_ && !pkt->ingress()) {
+        pkt->set_ingress(srs_update_system_time());
+    }
+
+    // Sample the bitrate of simulcast layer, for player to choose layer.
+    SrsRtcSimulcastLayer* layer = NULL;
+    if (!layers_.empty() && !pkt->is_audio() && (layer = find_layer(pkt->header.get_ssrc())) != NULL) {
+        srs_utime_t now = srs_get_system_time();
+        layer->bytes += pkt->nb_bytes();
+        layer->last_packet = now;
+
+        if (!layer->starttime) {
+            layer->starttime = now;
+        } else if (now - layer->starttime >= SRS_UTIME_SECONDS) {
+            layer->kbps = (int)(layer->bytes * 8 * 1000 / (now - layer->starttime));
+            layer->bytes = 0;
+            layer->starttime = now;
+        }
+    }
+
+    // Keep one copy for all players to retransmit, see SrsRtcSendTrack::on_recv_nack.
+    if (!consumers.empty()) {
+        history_->put(pkt);
+    }
+
     for (int i = 0; i < (int)consumers.size(); i++) {
         SrsRtcConsumer* consumer = consumers.at(i);
         if ((err = consumer->enqueue(pkt->copy())) != srs_success) {
@@ -629,6 +667,11 @@ srs_error_t SrsRtcSource::on_rtp(SrsRtpPacket* pkt)
         }
     }
 
+    // For simulcast, only bridge the first layer, because the layers are different streams.
+    if (layer && layer != &layers_.at(0)) {
+        return err;
+    }
+
     if (bridge_ && (err = bridge_->on_rtp(pkt)) != srs_success) {
         return srs_error_wrap(err, "bridge consume message");
     }
@@ -644,10 +687,28 @@ bool SrsRtcSource::has_stream_desc()
 void SrsRtcSource::set_stream_desc(SrsRtcSourceDescription* stream_desc)
 {
     srs_freep(stream_desc_);
+    layers_.clear();
 
     if (stream_desc) {
         stream_desc_ = stream_desc->copy();
     }
+
+    // Setup the simulcast layers, by video tracks with RID.
+    for (int i = 0; stream_desc_ && i < (int)stream_desc_->video_track_descs_.size(); i++) {
+        SrsRtcTrackDescription* desc = stream_desc_->video_track_descs_.at(i);
+        if (desc->rid_.empty()) {
+            continue;
+        }
+
+        SrsRtcSimulcastLayer layer;
+        layer.rid = desc->rid_;
+        layer.ssrc = desc->ssrc_;
+        layer.kbps = 0;
+        layer.last_packet = 0;
+        layer.bytes = 0;
+        layer.starttime = 0;
+        layers_.push_back(layer);
+    }
 }
 
 std::vector<SrsRtcTrackDescription*> SrsRtcSource::get_track_desc(std::string type, std::string media_name)
@@ -677,6 +738,44 @@ std::vector<SrsRtcTrackDescription*> SrsRtcSource::get_track_desc(std::string ty
     return track_descs;
 }
 
+const std::vector<SrsRtcSimulcastLayer>& SrsRtcSource::layers()
+{
+    return layers_;
+}
+
+void SrsRtcSource::bind_layer(std::string rid, uint32_t ssrc)
+{
+    for (int i = 0; i < (int)layers_.size(); i++) {
+        SrsRtcSimulcastLayer& layer = layers_.at(i);
+        if (layer.rid == rid) {
+            layer.ssrc = ssrc;
+        }
+    }
+
+    for (int i = 0; stream_desc_ && i < (int)stream_desc_->video_track_descs_.size(); i++) {
+        SrsRtcTrackDescription* desc = stream_desc_->video_track_descs_.at(i);
+        if (desc->rid_ == rid) {
+            desc->ssrc_ = ssrc;
+        }
+    }
+}
+
+SrsRtpPacketHistory* SrsRtcSource::history()
+{
+    return history_;
+}
+
+SrsRtcSimulcastLayer* SrsRtcSource::find_layer(uint32_t ssrc)
+{
+    for (int i = 0; i < (int)layers_.size(); i++) {
+        SrsRtcSimulcastLayer* layer = &layers_.at(i);
+        if (layer->ssrc == ssrc) {
+            return layer;
+        }
+    }
+    return NULL;
+}
+
 srs_error_t SrsRtcSource::on_timer(srs_utime_t interval)
 {
     srs_error_t err = srs_success;
@@ -696,20 +795,31 @@ srs_error_t SrsRtcSource::on_timer(srs_utime_t interval)
 
     for (int i = 0; i < (int)stream_desc_->video_track_descs_.size(); i++) {
         SrsRtcTrackDescription* desc = stream_desc_->video_track_descs_.at(i);
-        publish_stream_->request_keyframe(desc->ssrc_);
+        if (desc->ssrc_) {
+            publish_stream_->request_keyframe(desc->ssrc_);
+        }
     }
 
     return err;
 }
 
 #ifdef SRS_FFMPEG_FIT
+// Deactivate the lazy bridge, if no RTC player for this duration.
+#define SRS_RTC_BRIDGE_IDLE_TIMEOUT (30 * SRS_UTIME_SECONDS)
+// The max number of messages to cache for lazy bridge, drop the GOP if exceed.
+#define SRS_RTC_BRIDGE_MAX_GOP 4096
+
 SrsRtcFromRtmpBridge::SrsRtcFromRtmpBridge(SrsRtcSource* source)
 {
     req = NULL;
     source_ = source;
     format = new SrsRtmpFormat();
-    codec_ = new SrsAudioTranscoder();
+    codec_ = NULL;
     rtmp_to_rtc = false;
+    lazy_ = false;
+    active_ = false;
+    wait_keyframe_ = false;
+    idle_at_ = 0;
     keep_bframe = false;
     merge_nalus = false;
     meta = new SrsMetaCache();
@@ -736,8 +846,9 @@ SrsRtcFromRtmpBridge::SrsRtcFromRtmpBridge(SrsRtcSource* source)
 SrsRtcFromRtmpBridge::~SrsRtcFromRtmpBridge()
 {
     srs_freep(format);
-    srs_freep(codec_);
+    _srs_audio_transcoders->recycle(codec_);
     srs_freep(meta);
+    clear_gop();
 }
 
 srs_error_t SrsRtcFromRtmpBridge::initialize(SrsRequest* r)
@@ -747,22 +858,23 @@ srs_error_t SrsRtcFromRtmpBridge::initialize(SrsRequest* r)
     req = r;
     rtmp_to_rtc = _srs_config->get_rtc_from_rtmp(req->vhost);
 
+    lazy_ = _srs_config->get_rtc_from_rtmp_lazy(req->vhost);
+
     if (rtmp_to_rtc) {
         if ((err = format->initialize()) != srs_success) {
             return srs_error_wrap(err, "format initialize");
         }
 
-        int bitrate = 48000; // The output bitrate in bps.
-        if ((err = codec_->initialize(SrsAudioCodecIdAAC, SrsAudioCodecIdOpus, kAudioChannel, kAudioSamplerate,
-                                      bitrate)) != srs_success) {
-            return srs_error_wrap(err, "init codec");
+        // For lazy bridge, activate it when RTC player comes.
+        if (!lazy_ && (err = activate()) != srs_success) {
+            return srs_error_wrap(err, "activate");
         }
     }
 
     keep_bframe = _srs_config->get_rtc_keep_bframe(req->vhost);
     merge_nalus = _srs_config->get_rtc_server_merge_nalus();
-    srs_trace("RTC bridge from RTMP, rtmp2rtc=%d, keep_bframe=%d, merge_nalus=%d",
-              rtmp_to_rtc, keep_bframe, merge_nalus);
+    srs_trace("RTC bridge from RTMP, rtmp2rtc=%d, lazy=%d, keep_bframe=%d, merge_nalus=%d",
+              rtmp_to_rtc, lazy_, keep_bframe, merge_nalus);
 
     return err;
 }
@@ -783,6 +895,7 @@ srs_error_t SrsRtcFromRtmpBridge::on_publish()
     // Reset the metadata cache, to make VLC happy when disable/enable stream.
     // @see https://github.com/ossrs/srs/issues/1630#issuecomment-597979448
     meta->clear();
+    clear_gop();
 
     return err;
 }
@@ -811,6 +924,160 @@ srs_error_t SrsRtcFromRtmpBridge::on_audio(SrsSharedPtrMessage* msg)
         return err;
     }
 
+    // Cache the sequence header, to parse it when activate the lazy bridge.
+    if (SrsFlvAudio::sh(msg->payload, msg->size) && (err = meta->update_ash(msg)) != srs_success) {
+        return srs_error_wrap(err, "meta update audio");
+    }
+
+    if (lazy_ && (err = update_state(msg, false)) != srs_success) {
+        return srs_error_wrap(err, "update state");
+    }
+
+    if (!active_) {
+        return err;
+    }
+
+    return package_audio(msg);
+}
+
+srs_error_t SrsRtcFromRtmpBridge::on_video(SrsSharedPtrMessage* msg)
+{
+    srs_error_t err = srs_success;
+
+    if (!rtmp_to_rtc) {
+        return err;
+    }
+
+    // cache the sequence header if h264
+    bool is_sequence_header = SrsFlvVideo::sh(msg->payload, msg->size);
+    if (is_sequence_header && (err = meta->update_vsh(msg)) != srs_success) {
+        return srs_error_wrap(err, "meta update video");
+    }
+
+    if (lazy_ && (err = update_state(msg, true)) != srs_success) {
+        return srs_error_wrap(err, "update state");
+    }
+
+    if (!active_) {
+        return err;
+    }
+
+    // Drop the frames util keyframe, because player is unable to decode them.
+    if (wait_keyframe_ && !is_sequence_header) {
+        if (!SrsFlvVideo::keyframe(msg->payload, msg->size)) {
+            return err;
+        }
+        wait_keyframe_ = false;
+    }
+
+    return package_video(msg);
+}
+
+srs_error_t SrsRtcFromRtmpBridge::update_state(SrsSharedPtrMessage* msg, bool is_video)
+{
+    srs_error_t err = srs_success;
+
+    // Activate before caching the message, which is packaged by caller.
+    bool has_consumers = source_->has_consumers();
+    if (!active_ && has_consumers) {
+        if ((err = activate()) != srs_success) {
+            return srs_error_wrap(err, "activate");
+        }
+    } else if (active_ && has_consumers) {
+        idle_at_ = 0;
+    } else if (active_) {
+        srs_utime_t now = srs_get_system_time();
+        if (!idle_at_) {
+            idle_at_ = now;
+        } else if (now - idle_at_ > SRS_RTC_BRIDGE_IDLE_TIMEOUT) {
+            deactivate();
+        }
+    }
+
+    // Start a new GOP at keyframe, and drop the messages before the first keyframe.
+    if (is_video && SrsFlvVideo::keyframe(msg->payload, msg->size) && !SrsFlvVideo::sh(msg->payload, msg->size)) {
+        clear_gop();
+        gop_.push_back(msg->copy());
+    } else if (!gop_.empty()) {
+        if ((int)gop_.size() >= SRS_RTC_BRIDGE_MAX_GOP) {
+            clear_gop();
+        } else {
+            gop_.push_back(msg->copy());
+        }
+    }
+
+    return err;
+}
+
+srs_error_t SrsRtcFromRtmpBridge::activate()
+{
+    srs_error_t err = srs_success;
+
+    int bitrate = 48000; // The output bitrate in bps.
+    if ((err = _srs_audio_transcoders->fetch(SrsAudioCodecIdAAC, SrsAudioCodecIdOpus, kAudioChannel, kAudioSamplerate,
+                                             bitrate, &codec_)) != srs_success) {
+        return srs_error_wrap(err, "init codec");
+    }
+
+    active_ = true;
+    idle_at_ = 0;
+
+    if (!lazy_) {
+        return err;
+    }
+
+    // The sequence headers are not parsed when inactive, so we parse them first.
+    if (meta->ash() && (err = package_audio(meta->ash())) != srs_success) {
+        return srs_error_wrap(err, "audio sequence header");
+    }
+    if (meta->vsh() && (err = package_video(meta->vsh())) != srs_success) {
+        return srs_error_wrap(err, "video sequence header");
+    }
+
+    // Bootstrap the player by the GOP, so it's unnecessary to wait for the next keyframe.
+    wait_keyframe_ = gop_.empty();
+    for (int i = 0; i < (int)gop_.size(); i++) {
+        SrsSharedPtrMessage* msg = gop_.at(i);
+        if (msg->is_audio()) {
+            err = package_audio(msg);
+        } else if (msg->is_video()) {
+            err = package_video(msg);
+        }
+
+        if (err != srs_success) {
+            return srs_error_wrap(err, "bootstrap");
+        }
+    }
+
+    srs_trace("RTC bridge from RTMP activated, gop=%d", (int)gop_.size());
+
+    return err;
+}
+
+void SrsRtcFromRtmpBridge::deactivate()
+{
+    active_ = false;
+    idle_at_ = 0;
+
+    _srs_audio_transcoders->recycle(codec_);
+    codec_ = NULL;
+
+    srs_trace("RTC bridge from RTMP deactivated, no player for %dms", srsu2msi(SRS_RTC_BRIDGE_IDLE_TIMEOUT));
+}
+
+void SrsRtcFromRtmpBridge::clear_gop()
+{
+    for (int i = 0; i < (int)gop_.size(); i++) {
+        SrsSharedPtrMessage* msg = gop_.at(i);
+        srs_freep(msg);
+    }
+    gop_.clear();
+}
+
+srs_error_t SrsRtcFromRtmpBridge::package_audio(SrsSharedPtrMessage* msg)
+{
+    srs_error_t err = srs_success;
+
     // TODO: FIXME: Support parsing OPUS for RTC.
     if ((err = format->on_audio(msg)) != srs_success) {
         return srs_error_wrap(err, "format consume audio");
@@ -852,7 +1119,7 @@ srs_error_t SrsRtcFromRtmpBridge::on_audio(SrsSharedPtrMessage* msg)
     aac.cts = format->audio->cts;
     if ((err = aac.add_sample(adts_audio, nn_adts_audio)) == srs_success) {
         // If OK, transcode the AAC to Opus and consume it.
-        err = transcode(&aac);
+        err = transcode(&aac, msg->ingress());
     }
 
     srs_freepa(adts_audio);
@@ -860,7 +1127,7 @@ srs_error_t SrsRtcFromRtmpBridge::on_audio(SrsSharedPtrMessage* msg)
     return err;
 }
 
-srs_error_t SrsRtcFromRtmpBridge::transcode(SrsAudioFrame* audio)
+srs_error_t SrsRtcFromRtmpBridge::transcode(SrsAudioFrame* audio, srs_utime_t ingress)
 {
     srs_error_t err = srs_success;
 
@@ -884,6 +1151,7 @@ srs_error_t SrsRtcFromRtmpBridge::transcode(SrsAudioFrame* audio)
             err = srs_error_wrap(err, "package opus");
             break;
         }
+        pkt->set_ingress(ingress);
 
         if ((err = source_->on_rtp(pkt)) != srs_success) {
             err = srs_error_wrap(err, "consume opus");
@@ -917,20 +1185,10 @@ srs_error_t SrsRtcFromRtmpBridge::package_opus(SrsAudioFrame* audio, SrsRtpPacke
     return err;
 }
 
-srs_error_t SrsRtcFromRtmpBridge::on_video(SrsSharedPtrMessage* msg)
+srs_error_t SrsRtcFromRtmpBridge::package_video(SrsSharedPtrMessage* msg)
 {
     srs_error_t err = srs_success;
 
-    if (!rtmp_to_rtc) {
-        return err;
-    }
-
-    // cache the sequence header if h264
-    bool is_sequence_header = SrsFlvVideo::sh(msg->payload, msg->size);
-    if (is_sequence_header && (err = meta->update_vsh(msg)) != srs_success) {
-        return srs_error_wrap(err, "meta update video");
-    }
-
     if ((err = format->on_video(msg)) != srs_success) {
         return srs_error_wrap(err, "format consume video");
     }
@@ -956,6 +1214,7 @@ srs_error_t SrsRtcFromRtmpBridge::on_video(SrsSharedPtrMessage* msg)
         if ((err = package_stap_a(source_, msg, pkt)) != srs_success) {
             return srs_error_wrap(err, "package stap-a");
         }
+        pkt->set_ingress(msg->ingress());
 
         if ((err = source_->on_rtp(pkt)) != srs_success) {
             return srs_error_wrap(err, "consume sps/pps");
@@ -995,7 +1254,7 @@ srs_error_t SrsRtcFromRtmpBridge::on_video(SrsSharedPtrMessage* msg)
         pkts.back()->header.set_marker(true);
     }
 
-    return consume_packets(pkts);
+    return consume_packets(pkts, msg->ingress());
 }
 
 srs_error_t SrsRtcFromRtmpBridge::filter(SrsSharedPtrMessage* msg, SrsFormat* format, bool& has_idr, vector<SrsSample*>& samples)
@@ -1249,13 +1508,14 @@ srs_error_t SrsRtcFromRtmpBridge::package_fu_a(SrsSharedPtrMessage* msg, SrsSamp
     return err;
 }
 
-srs_error_t SrsRtcFromRtmpBridge::consume_packets(vector<SrsRtpPacket*>& pkts)
+srs_error_t SrsRtcFromRtmpBridge::consume_packets(vector<SrsRtpPacket*>& pkts, srs_utime_t ingress)
 {
     srs_error_t err = srs_success;
 
     // TODO: FIXME: Consume a range of packets.
     for (int i = 0; i < (int)pkts.size(); i++) {
         SrsRtpPacket* pkt = pkts[i];
+        pkt->set_ingress(ingress);
         if ((err = source_->on_rtp(pkt)) != srs_success) {
             err = srs_error_wrap(err, "consume sps/pps");
             break;
@@ -1274,26 +1534,26 @@ SrsRtmpFromRtcBridge::SrsRtmpFromRtcBridge(SrsLiveSource *src)
 {
     source_ = src;
     codec_ = NULL;
+    has_outputs_ = false;
+    outputs_updated_at_ = 0;
     is_first_audio = true;
     is_first_video = true;
     format = NULL;
-    rtp_key_frame_ts_ = -1;
-    header_sn_ = 0;
-    memset(cache_video_pkts_, 0, sizeof(cache_video_pkts_));
+    jitter_ = new SrsRtpJitterBuffer(SRS_RTC_JITTER_CAPACITY);
 }
 
 SrsRtmpFromRtcBridge::~SrsRtmpFromRtcBridge()
 {
-    srs_freep(codec_);
+    SrsAsyncAudioTranscoder::dispose(codec_);
     srs_freep(format);
-    clear_cached_video();
+    srs_freep(jitter_);
 }
 
 srs_error_t SrsRtmpFromRtcBridge::initialize(SrsRequest* r)
 {
     srs_error_t err = srs_success;
 
-    codec_ = new SrsAudioTranscoder();
+    codec_ = new SrsAsyncAudioTranscoder();
     format = new SrsRtmpFormat();
 
     SrsAudioCodecId from = SrsAudioCodecIdOpus; // TODO: From SDP?
@@ -1309,6 +1569,8 @@ srs_error_t SrsRtmpFromRtcBridge::initialize(SrsRequest* r)
         return srs_error_wrap(err, "format initialize");
     }
 
+    jitter_->set_delay(_srs_config->get_rtc_jitter_for_rtmp(r->vhost));
+
     return err;
 }
 
@@ -1347,6 +1609,15 @@ srs_error_t SrsRtmpFromRtcBridge::on_rtp(SrsRtpPacket *pkt)
         err = packet_video(pkt);
     }
 
+    if (err != srs_success) {
+        return err;
+    }
+
+    // Consume the audio transcoded by worker, for each packet, to avoid delay.
+    if ((err = consume_audio()) != srs_success) {
+        return srs_error_wrap(err, "consume audio");
+    }
+
     return err;
 }
 
@@ -1377,7 +1648,11 @@ srs_error_t SrsRtmpFromRtcBridge::transcode_audio(SrsRtpPacket *pkt)
         is_first_audio = false;
     }
 
-    std::vector<SrsAudioFrame *> out_pkts;
+    // Never transcode if nobody plays the stream, because transcoding is expensive.
+    if (!should_transcode()) {
+        return err;
+    }
+
     SrsRtpRawPayload *payload = dynamic_cast<SrsRtpRawPayload *>(pkt->payload());
 
     SrsAudioFrame frame;
@@ -1385,15 +1660,23 @@ srs_error_t SrsRtmpFromRtcBridge::transcode_audio(SrsRtpPacket *pkt)
     frame.dts = ts;
     frame.cts = 0;
 
-    err = codec_->transcode(&frame, out_pkts);
-    if (err != srs_success) {
-        return err;
+    if ((err = codec_->transcode(&frame)) != srs_success) {
+        return srs_error_wrap(err, "transcode");
     }
 
+    return err;
+}
+
+srs_error_t SrsRtmpFromRtcBridge::consume_audio()
+{
+    srs_error_t err = srs_success;
+
+    std::vector<SrsAudioFrame *> out_pkts;
+    codec_->fetch(out_pkts);
+
     for (std::vector<SrsAudioFrame *>::iterator it = out_pkts.begin(); it != out_pkts.end(); ++it) {
         SrsCommonMessage out_rtmp;
-        out_rtmp.header.timestamp = (*it)->dts;
-        packet_aac(&out_rtmp, (*it)->samples[0].bytes, (*it)->samples[0].size, ts, is_first_audio);
+        packet_aac(&out_rtmp, (*it)->samples[0].bytes, (*it)->samples[0].size, (uint32_t)(*it)->dts, false);
 
         if ((err = source_->on_audio(&out_rtmp)) != srs_success) {
             err = srs_error_wrap(err, "source on audio");
@@ -1405,6 +1688,22 @@ srs_error_t SrsRtmpFromRtcBridge::transcode_audio(SrsRtpPacket *pkt)
     return err;
 }
 
+bool SrsRtmpFromRtcBridge::should_transcode()
+{
+    if (source_->has_consumers()) {
+        return true;
+    }
+
+    // The outputs depend on config, so we update it every some seconds.
+    srs_utime_t now = srs_get_system_time();
+    if (now - outputs_updated_at_ > SRS_UTIME_SECONDS) {
+        outputs_updated_at_ = now;
+        has_outputs_ = source_->has_outputs();
+    }
+
+    return has_outputs_;
+}
+
 void SrsRtmpFromRtcBridge::packet_aac(SrsCommonMessage* audio, char* data, int len, uint32_t pts, bool is_header)
 {
     int rtmp_len = len + 2;
@@ -1426,168 +1725,130 @@ srs_error_t SrsRtmpFromRtcBridge::packet_video(SrsRtpPacket* src)
 {
     srs_error_t err = srs_success;
 
-    // TODO: Only copy when need
-    SrsRtpPacket* pkt = src->copy();
-
-    if (pkt->is_keyframe()) {
-        return packet_video_key_frame(pkt);
-    }
-
-    // store in cache
-    int index = cache_index(pkt->header.get_sequence());
-    cache_video_pkts_[index].in_use = true;
-    srs_freep(cache_video_pkts_[index].pkt);
-    cache_video_pkts_[index].pkt = pkt;
-    cache_video_pkts_[index].sn = pkt->header.get_sequence();
-    cache_video_pkts_[index].ts = pkt->get_avsync_time();
-    cache_video_pkts_[index].rtp_ts = pkt->header.get_timestamp();
-
-    // check whether to recovery lost packet and can construct a video frame
-    if (lost_sn_ == pkt->header.get_sequence()) {
-        uint16_t tail_sn = 0;
-        int sn = find_next_lost_sn(lost_sn_, tail_sn);
-        if (-1 == sn ) {
-            if (check_frame_complete(header_sn_, tail_sn)) {
-                if ((err = packet_video_rtmp(header_sn_, tail_sn)) != srs_success) {
-                    err = srs_error_wrap(err, "fail to pack video frame");
-                }
-            }
-        } else if (-2 == sn) {
-            return srs_error_new(ERROR_RTC_RTP_MUXER, "video cache is overflow");
-        } else {
-            lost_sn_ = (uint16_t)sn;
+    // The jitter buffer takes the copy, because the packet is shared by consumers.
+    jitter_->put(src->copy());
+
+    vector<SrsRtpPacket*> frame;
+    while (jitter_->pop(frame, srs_get_system_time())) {
+        if (frame.front()->is_keyframe()) {
+            err = packet_video_key_frame(frame);
+        }
+
+        if (err == srs_success) {
+            err = packet_video_rtmp(frame);
+        }
+
+        for (int i = 0; i < (int)frame.size(); i++) {
+            SrsRtpPacket* pkt = frame.at(i);
+            srs_freep(pkt);
+        }
+        frame.clear();
+
+        if (err != srs_success) {
+            return srs_error_wrap(err, "packet video");
         }
     }
 
     return err;
 }
 
-srs_error_t SrsRtmpFromRtcBridge::packet_video_key_frame(SrsRtpPacket* pkt)
+srs_error_t SrsRtmpFromRtcBridge::packet_video_key_frame(const vector<SrsRtpPacket*>& frame)
 {
     srs_error_t err = srs_success;
 
-    // TODO: handle sps and pps in 2 rtp packets
-    SrsRtpSTAPPayload* stap_payload = dynamic_cast<SrsRtpSTAPPayload*>(pkt->payload());
-    if (stap_payload) {
-        SrsSample* sps = stap_payload->get_sps();
-        SrsSample* pps = stap_payload->get_pps();
-        if (NULL == sps || NULL == pps) {
-            return srs_error_new(ERROR_RTC_RTP_MUXER, "no sps or pps in stap-a rtp. sps: %p, pps:%p", sps, pps);
-        } else {
-            //type_codec1 + avc_type + composition time + fix header + count of sps + len of sps + sps + count of pps + len of pps + pps
-            int nb_payload = 1 + 1 + 3 + 5 + 1 + 2 + sps->size + 1 + 2 + pps->size;
-            SrsCommonMessage rtmp;
-            rtmp.header.initialize_video(nb_payload, pkt->get_avsync_time(), 1);
-            rtmp.create_payload(nb_payload);
-            rtmp.size = nb_payload;
-            SrsBuffer payload(rtmp.payload, rtmp.size);
-            //TODO: call api
-            payload.write_1bytes(0x17);// type(4 bits): key frame; code(4bits): avc
-            payload.write_1bytes(0x0); // avc_type: sequence header
-            payload.write_1bytes(0x0); // composition time
-            payload.write_1bytes(0x0);
-            payload.write_1bytes(0x0);
-            payload.write_1bytes(0x01); // version
-            payload.write_1bytes(sps->bytes[1]);
-            payload.write_1bytes(sps->bytes[2]);
-            payload.write_1bytes(sps->bytes[3]);
-            payload.write_1bytes(0xff);
-            payload.write_1bytes(0xe1);
-            payload.write_2bytes(sps->size);
-            payload.write_bytes(sps->bytes, sps->size);
-            payload.write_1bytes(0x01);
-            payload.write_2bytes(pps->size);
-            payload.write_bytes(pps->bytes, pps->size);
-            if ((err = source_->on_video(&rtmp)) != srs_success) {
-                return err;
-            }
+    // The SPS and PPS might be in a STAP-A packet, or in two single NALU packets.
+    SrsSample* sps = NULL;
+    SrsSample* pps = NULL;
+    SrsSample raw_sps, raw_pps;
+    for (int i = 0; i < (int)frame.size(); i++) {
+        SrsRtpPacket* pkt = frame.at(i);
+
+        SrsRtpSTAPPayload* stap_payload = dynamic_cast<SrsRtpSTAPPayload*>(pkt->payload());
+        if (stap_payload) {
+            sps = stap_payload->get_sps() ? stap_payload->get_sps() : sps;
+            pps = stap_payload->get_pps() ? stap_payload->get_pps() : pps;
+            continue;
         }
-    }
 
-    if (-1 == rtp_key_frame_ts_) {
-        rtp_key_frame_ts_ = pkt->header.get_timestamp();
-        header_sn_ = pkt->header.get_sequence();
-        lost_sn_ = header_sn_ + 1;
-        // Received key frame and clean cache of old p frame pkts
-        clear_cached_video();
-        srs_trace("set ts=%u, header=%hu, lost=%hu", (uint32_t)rtp_key_frame_ts_, header_sn_, lost_sn_);
-    } else if (rtp_key_frame_ts_ != pkt->header.get_timestamp()) {
-        //new key frame, clean cache
-        int64_t old_ts = rtp_key_frame_ts_;
-        uint16_t old_header_sn = header_sn_;
-        uint16_t old_lost_sn = lost_sn_;
-        rtp_key_frame_ts_ = pkt->header.get_timestamp();
-        header_sn_ = pkt->header.get_sequence();
-        lost_sn_ = header_sn_ + 1;
-        clear_cached_video();
-        srs_warn("drop old ts=%u, header=%hu, lost=%hu, set new ts=%u, header=%hu, lost=%hu",
-            (uint32_t)old_ts, old_header_sn, old_lost_sn, (uint32_t)rtp_key_frame_ts_, header_sn_, lost_sn_);
-    }
-
-    uint16_t index = cache_index(pkt->header.get_sequence());
-    cache_video_pkts_[index].in_use = true;
-    srs_freep(cache_video_pkts_[index].pkt);
-    cache_video_pkts_[index].pkt = pkt;
-    cache_video_pkts_[index].sn = pkt->header.get_sequence();
-    cache_video_pkts_[index].ts = pkt->get_avsync_time();
-    cache_video_pkts_[index].rtp_ts = pkt->header.get_timestamp();
-
-    int32_t sn = lost_sn_;
-    uint16_t tail_sn = 0;
-    if (srs_rtp_seq_distance(header_sn_, pkt->header.get_sequence()) < 0){
-        // When receive previous pkt in the same frame, update header sn;
-        header_sn_ = pkt->header.get_sequence();
-        sn = find_next_lost_sn(header_sn_, tail_sn);
-    } else if (lost_sn_ == pkt->header.get_sequence()) {
-        sn = find_next_lost_sn(lost_sn_, tail_sn);
-    }
-
-    if (-1 == sn) {
-        if (check_frame_complete(header_sn_, tail_sn)) {
-            if ((err = packet_video_rtmp(header_sn_, tail_sn)) != srs_success) {
-                err = srs_error_wrap(err, "fail to packet key frame");
+        SrsRtpRawPayload* raw_payload = dynamic_cast<SrsRtpRawPayload*>(pkt->payload());
+        if (raw_payload && raw_payload->nn_payload > 0) {
+            SrsAvcNaluType nalu_type = (SrsAvcNaluType)(raw_payload->payload[0] & kNalTypeMask);
+            if (nalu_type == SrsAvcNaluTypeSPS) {
+                raw_sps.bytes = raw_payload->payload;
+                raw_sps.size = raw_payload->nn_payload;
+                sps = &raw_sps;
+            } else if (nalu_type == SrsAvcNaluTypePPS) {
+                raw_pps.bytes = raw_payload->payload;
+                raw_pps.size = raw_payload->nn_payload;
+                pps = &raw_pps;
             }
         }
-    } else if (-2 == sn) {
-        return srs_error_new(ERROR_RTC_RTP_MUXER, "video cache is overflow");
-    } else {
-        lost_sn_ = (uint16_t)sn;
+    }
+
+    if (!sps || !pps || sps->size < 4) {
+        return err;
+    }
+
+    //type_codec1 + avc_type + composition time + fix header + count of sps + len of sps + sps + count of pps + len of pps + pps
+    int nb_payload = 1 + 1 + 3 + 5 + 1 + 2 + sps->size + 1 + 2 + pps->size;
+    SrsCommonMessage rtmp;
+    rtmp.header.initialize_video(nb_payload, frame.front()->get_avsync_time(), 1);
+    rtmp.create_payload(nb_payload);
+    rtmp.size = nb_payload;
+    SrsBuffer payload(rtmp.payload, rtmp.size);
+    //TODO: call api
+    payload.write_1bytes(0x17);// type(4 bits): key frame; code(4bits): avc
+    payload.write_1bytes(0x0); // avc_type: sequence header
+    payload.write_1bytes(0x0); // composition time
+    payload.write_1bytes(0x0);
+    payload.write_1bytes(0x0);
+    payload.write_1bytes(0x01); // version
+    payload.write_1bytes(sps->bytes[1]);
+    payload.write_1bytes(sps->bytes[2]);
+    payload.write_1bytes(sps->bytes[3]);
+    payload.write_1bytes(0xff);
+    payload.write_1bytes(0xe1);
+    payload.write_2bytes(sps->size);
+    payload.write_bytes(sps->bytes, sps->size);
+    payload.write_1bytes(0x01);
+    payload.write_2bytes(pps->size);
+    payload.write_bytes(pps->bytes, pps->size);
+    if ((err = source_->on_video(&rtmp)) != srs_success) {
+        return srs_error_wrap(err, "source on video");
     }
 
     return err;
 }
 
-srs_error_t SrsRtmpFromRtcBridge::packet_video_rtmp(const uint16_t start, const uint16_t end)
+srs_error_t SrsRtmpFromRtcBridge::packet_video_rtmp(const vector<SrsRtpPacket*>& frame)
 {
     srs_error_t err = srs_success;
 
+    // Calculate the size of NALUs, ignore the FU-A fragments without start.
     int nb_payload = 0;
-    int16_t cnt = srs_rtp_seq_distance(start, end) + 1;
-    srs_assert(cnt >= 1);
-
-    for (uint16_t i = 0; i < (uint16_t)cnt; ++i) {
-        uint16_t sn = start + i;
-        uint16_t index = cache_index(sn);
-        SrsRtpPacket* pkt = cache_video_pkts_[index].pkt;
+    bool in_fua = false;
+    for (int i = 0; i < (int)frame.size(); ++i) {
+        SrsRtpPacket* pkt = frame.at(i);
 
-        // fix crash when pkt->payload() if pkt is nullptr;
-        if (!pkt) continue;
-
-        // calculate nalu len
         SrsRtpFUAPayload2* fua_payload = dynamic_cast<SrsRtpFUAPayload2*>(pkt->payload());
-        if (fua_payload && fua_payload->size > 0) {
+        if (fua_payload) {
             if (fua_payload->start) {
-                nb_payload += 1 + 4;
+                in_fua = true;
+                nb_payload += 4 + 1;
+            }
+            if (in_fua && fua_payload->size > 0) {
+                nb_payload += fua_payload->size;
             }
-            nb_payload += fua_payload->size;
+            in_fua = in_fua && !fua_payload->end;
             continue;
         }
+        in_fua = false;
 
         SrsRtpSTAPPayload* stap_payload = dynamic_cast<SrsRtpSTAPPayload*>(pkt->payload());
         if (stap_payload) {
             for (int j = 0; j < (int)stap_payload->nalus.size(); ++j) {
                 SrsSample* sample = stap_payload->nalus.at(j);
-                if (sample->size > 0) {    
+                if (sample->size > 0) {
                     nb_payload += 4 + sample->size;
                 }
             }
@@ -1597,7 +1858,6 @@ srs_error_t SrsRtmpFromRtcBridge::packet_video_rtmp(const uint16_t start, const
         SrsRtpRawPayload* raw_payload = dynamic_cast<SrsRtpRawPayload*>(pkt->payload());
         if (raw_payload && raw_payload->nn_payload > 0) {
             nb_payload += 4 + raw_payload->nn_payload;
-            continue;
         }
     }
 
@@ -1605,19 +1865,18 @@ srs_error_t SrsRtmpFromRtcBridge::packet_video_rtmp(const uint16_t start, const
         srs_warn("empty nalu");
         return err;
     }
-	
+
     //type_codec1 + avc_type + composition time + nalu size + nalu
     nb_payload += 1 + 1 + 3;
 
     SrsCommonMessage rtmp;
-    SrsRtpPacket* pkt = cache_video_pkts_[cache_index(start)].pkt;
-    rtmp.header.initialize_video(nb_payload, pkt->get_avsync_time(), 1);
+    SrsRtpPacket* first = frame.front();
+    rtmp.header.initialize_video(nb_payload, first->get_avsync_time(), 1);
     rtmp.create_payload(nb_payload);
     rtmp.size = nb_payload;
     SrsBuffer payload(rtmp.payload, rtmp.size);
-    if (pkt->is_keyframe()) {
+    if (first->is_keyframe()) {
         payload.write_1bytes(0x17); // type(4 bits): key frame; code(4bits): avc
-        rtp_key_frame_ts_ = -1;
     } else {
         payload.write_1bytes(0x27); // type(4 bits): inter frame; code(4bits): avc
     }
@@ -1626,52 +1885,45 @@ srs_error_t SrsRtmpFromRtcBridge::packet_video_rtmp(const uint16_t start, const
     payload.write_1bytes(0x0);
     payload.write_1bytes(0x0);
 
+    // The position and size of NALU in FU-A, to write the size when got more fragments.
+    int nalu_pos = -1;
     int nalu_len = 0;
-    for (uint16_t i = 0; i < (uint16_t)cnt; ++i) {
-        uint16_t index = cache_index((start + i));
-        SrsRtpPacket* pkt = cache_video_pkts_[index].pkt;
-
-        // fix crash when pkt->payload() if pkt is nullptr;
-        if (!pkt) continue;
-
-        cache_video_pkts_[index].in_use = false;
-        cache_video_pkts_[index].pkt = NULL;
-        cache_video_pkts_[index].ts = 0;
-        cache_video_pkts_[index].rtp_ts = 0;
-        cache_video_pkts_[index].sn = 0;
+    for (int i = 0; i < (int)frame.size(); ++i) {
+        SrsRtpPacket* pkt = frame.at(i);
 
         SrsRtpFUAPayload2* fua_payload = dynamic_cast<SrsRtpFUAPayload2*>(pkt->payload());
-        if (fua_payload && fua_payload->size > 0) {
+        if (fua_payload) {
             if (fua_payload->start) {
-                nalu_len = fua_payload->size + 1;
-                //skip 4 bytes to write nalu_len future
-                payload.skip(4);
+                nalu_pos = payload.pos();
+                nalu_len = 1;
+                payload.write_4bytes(nalu_len);
                 payload.write_1bytes(fua_payload->nri | fua_payload->nalu_type);
-                payload.write_bytes(fua_payload->payload, fua_payload->size);
-            } else {
+            }
+            if (nalu_pos >= 0 && fua_payload->size > 0) {
                 nalu_len += fua_payload->size;
                 payload.write_bytes(fua_payload->payload, fua_payload->size);
-                if (fua_payload->end) {
-                    //write nalu_len back
-                    payload.skip(-(4 + nalu_len));
-                    payload.write_4bytes(nalu_len);
-                    payload.skip(nalu_len);
-                }
+
+                int pos = payload.pos();
+                payload.skip(nalu_pos - pos);
+                payload.write_4bytes(nalu_len);
+                payload.skip(pos - nalu_pos - 4);
+            }
+            if (fua_payload->end) {
+                nalu_pos = -1;
             }
-            srs_freep(pkt);
             continue;
         }
+        nalu_pos = -1;
 
         SrsRtpSTAPPayload* stap_payload = dynamic_cast<SrsRtpSTAPPayload*>(pkt->payload());
         if (stap_payload) {
             for (int j = 0; j < (int)stap_payload->nalus.size(); ++j) {
                 SrsSample* sample = stap_payload->nalus.at(j);
-                if (sample->size > 0) {  
+                if (sample->size > 0) {
                     payload.write_4bytes(sample->size);
                     payload.write_bytes(sample->bytes, sample->size);
                 }
             }
-            srs_freep(pkt);
             continue;
         }
 
@@ -1679,101 +1931,15 @@ srs_error_t SrsRtmpFromRtcBridge::packet_video_rtmp(const uint16_t start, const
         if (raw_payload && raw_payload->nn_payload > 0) {
             payload.write_4bytes(raw_payload->nn_payload);
             payload.write_bytes(raw_payload->payload, raw_payload->nn_payload);
-            srs_freep(pkt);
-            continue;
         }
-
-        srs_freep(pkt);
     }
 
     if ((err = source_->on_video(&rtmp)) != srs_success) {
-        srs_warn("fail to pack video frame");
-    }
-
-    header_sn_ = end + 1;
-    uint16_t tail_sn = 0;
-    int sn = find_next_lost_sn(header_sn_, tail_sn);
-    if (-1 == sn) {
-        if (check_frame_complete(header_sn_, tail_sn)) {
-            err = packet_video_rtmp(header_sn_, tail_sn);
-        }
-    } else if (-2 == sn) {
-        return srs_error_new(ERROR_RTC_RTP_MUXER, "video cache is overflow");
-    } else {
-        lost_sn_ = sn;
+        return srs_error_wrap(err, "source on video");
     }
 
     return err;
 }
-
-int32_t SrsRtmpFromRtcBridge::find_next_lost_sn(uint16_t current_sn, uint16_t& end_sn)
-{
-    uint32_t last_rtp_ts = cache_video_pkts_[cache_index(header_sn_)].rtp_ts;
-    for (int i = 0; i < s_cache_size; ++i) {
-        uint16_t lost_sn = current_sn + i;
-        int index = cache_index(lost_sn);
-
-        if (!cache_video_pkts_[index].in_use) {
-            return lost_sn;
-        }
-        //check time first, avoid two small frame mixed case decode fail
-        if (last_rtp_ts != cache_video_pkts_[index].rtp_ts) {
-            end_sn = lost_sn - 1;
-            return -1;
-        }
-
-        if (cache_video_pkts_[index].pkt->header.get_marker()) {
-            end_sn = lost_sn;
-            return -1;
-        }
-    }
-
-    srs_error("cache overflow. the packet count of video frame is more than %u", s_cache_size);
-    return -2;
-}
-
-void SrsRtmpFromRtcBridge::clear_cached_video()
-{
-    for (size_t i = 0; i < s_cache_size; i++)
-    {
-        if (cache_video_pkts_[i].in_use) {
-            srs_freep(cache_video_pkts_[i].pkt);
-            cache_video_pkts_[i].sn = 0;
-            cache_video_pkts_[i].ts = 0;
-            cache_video_pkts_[i].rtp_ts = 0;
-            cache_video_pkts_[i].in_use = false;
-        }
-    }
-}
-
-bool SrsRtmpFromRtcBridge::check_frame_complete(const uint16_t start, const uint16_t end)
-{
-    int16_t cnt = srs_rtp_seq_distance(start, end) + 1;
-    srs_assert(cnt >= 1);
-
-    uint16_t fu_s_c = 0;
-    uint16_t fu_e_c = 0;
-    for (uint16_t i = 0; i < (uint16_t)cnt; ++i) {
-        int index = cache_index((start + i));
-        SrsRtpPacket* pkt = cache_video_pkts_[index].pkt;
-
-        // fix crash when pkt->payload() if pkt is nullptr;
-        if (!pkt) continue;
-
-        SrsRtpFUAPayload2* fua_payload = dynamic_cast<SrsRtpFUAPayload2*>(pkt->payload());
-        if (!fua_payload) continue;
-
-        if (fua_payload->start) {
-            ++fu_s_c;
-        }
-
-        if (fua_payload->end) {
-            ++fu_e_c;
-        }
-    }
-
-    return fu_s_c == fu_e_c;
-}
 #endif
 
 SrsCodecPayload::SrsCodecPayload()
@@ -2073,7 +2239,7 @@ SrsMediaPayloadType SrsRtxPayloadDes::generate_media_payload_type()
     media_payload_type.encoding_name_ = name_;
     media_payload_type.clock_rate_ = sample_;
     std::ostringstream format_specific_param;
-    format_specific_param << "fmtp:" << pt_ << " apt="<< apt_;
+    format_specific_param << "apt=" << (int)apt_;
 
     media_payload_type.format_specific_param_ = format_specific_param.str();
 
@@ -2198,6 +2364,7 @@ SrsRtcTrackDescription* SrsRtcTrackDescription::copy()
     cp->direction_ = direction_;
     cp->mid_ = mid_;
     cp->msid_ = msid_;
+    cp->rid_ = rid_;
     cp->is_active_ = is_active_;
     cp->media_ = media_ ? media_->copy():NULL;
     cp->red_ = red_ ? red_->copy():NULL;
@@ -2350,7 +2517,12 @@ srs_error_t SrsRtcRecvTrack::send_rtcp_rr()
 {
     srs_error_t err = srs_success;
 
+    // Ignore the simulcast layer not bound.
     uint32_t ssrc = track_desc_->ssrc_;
+    if (!ssrc) {
+        return err;
+    }
+
     const uint64_t& last_time = last_sender_report_sys_time_;
     if ((err = session_->send_rtcp_rr(ssrc, rtp_queue_, last_time, last_sender_report_ntp_)) != srs_success) {
         return srs_error_wrap(err, "ssrc=%u, last_time=%" PRId64, ssrc, last_time);
@@ -2363,6 +2535,10 @@ srs_error_t SrsRtcRecvTrack::send_rtcp_xr_rrtr()
 {
     srs_error_t err = srs_success;
 
+    if (!track_desc_->ssrc_) {
+        return err;
+    }
+
     if ((err = session_->send_rtcp_xr_rrtr(track_desc_->ssrc_)) != srs_success) {
         return srs_error_wrap(err, "ssrc=%u", track_desc_->ssrc_);
     }
@@ -2387,6 +2563,16 @@ std::string SrsRtcRecvTrack::get_track_id()
     return track_desc_->id_;
 }
 
+bool SrsRtcRecvTrack::bind_rid(const std::string& rid, uint32_t ssrc)
+{
+    if (track_desc_->rid_.empty() || track_desc_->rid_ != rid || track_desc_->ssrc_) {
+        return false;
+    }
+
+    track_desc_->ssrc_ = ssrc;
+    return true;
+}
+
 srs_error_t SrsRtcRecvTrack::on_nack(SrsRtpPacket** ppkt)
 {
     srs_error_t err = srs_success;
@@ -2558,12 +2744,19 @@ SrsRtcSendTrack::SrsRtcSendTrack(SrsRtcConnection* session, SrsRtcTrackDescripti
         rtp_queue_ = new SrsRtpRingBuffer(1000);
     }
 
+    history_ = NULL;
+    nn_sents_ = is_audio ? 128 : 1024;
+    sents_ = new SrsRtpSentInfo[nn_sents_];
+    memset(sents_, 0, sizeof(SrsRtpSentInfo) * nn_sents_);
+    rtx_seq_ = 0;
+
     nack_epp = new SrsErrorPithyPrint();
 }
 
 SrsRtcSendTrack::~SrsRtcSendTrack()
 {
     srs_freep(rtp_queue_);
+    srs_freepa(sents_);
     srs_freep(track_desc_);
     srs_freep(nack_epp);
 }
@@ -2616,13 +2809,23 @@ std::string SrsRtcSendTrack::get_track_id()
     return track_desc_->id_;
 }
 
-srs_error_t SrsRtcSendTrack::on_nack(SrsRtpPacket** ppkt)
+srs_error_t SrsRtcSendTrack::on_nack(SrsRtpPacket** ppkt, uint32_t ssrc, uint16_t osn)
 {
     srs_error_t err = srs_success;
 
     SrsRtpPacket* pkt = *ppkt;
     uint16_t seq = pkt->header.get_sequence();
 
+    // Only keep the sent info, the packet is in shared history of source.
+    if (history_) {
+        SrsRtpSentInfo* info = &sents_[seq & (nn_sents_ - 1)];
+        info->seq = seq;
+        info->ts = pkt->header.get_timestamp();
+        info->ssrc = ssrc;
+        info->osn = osn;
+        return err;
+    }
+
     // insert into video_queue and audio_queue
     // We directly use the pkt, never copy it, so we should set the pkt to NULL.
     if (nack_no_copy_) {
@@ -2643,7 +2846,12 @@ srs_error_t SrsRtcSendTrack::on_recv_nack(const vector<uint16_t>& lost_seqs)
 
     for(int i = 0; i < (int)lost_seqs.size(); ++i) {
         uint16_t seq = lost_seqs.at(i);
-        SrsRtpPacket* pkt = fetch_rtp_packet(seq);
+
+        // The packet from history is rewritten for this track, which is a copy.
+        SrsRtpPacket* copy = NULL;
+        SrsAutoFree(SrsRtpPacket, copy);
+
+        SrsRtpPacket* pkt = history_ ? (copy = fetch_history_packet(seq)) : fetch_rtp_packet(seq);
         if (pkt == NULL) {
             continue;
         }
@@ -2654,6 +2862,17 @@ srs_error_t SrsRtcSendTrack::on_recv_nack(const vector<uint16_t>& lost_seqs)
                 pkt->header.get_ssrc(), pkt->header.get_timestamp(), nn, nack_epp->nn_count, pkt->nb_bytes());
         }
 
+        // Retransmit in RTX stream if negotiated.
+        SrsRtpPacket* rtx = NULL;
+        SrsAutoFree(SrsRtpPacket, rtx);
+
+        if (track_desc_->rtx_ && track_desc_->rtx_ssrc_) {
+            if ((err = build_rtx(pkt, &rtx)) != srs_success) {
+                return srs_error_wrap(err, "rtx seq=%u", seq);
+            }
+            pkt = rtx;
+        }
+
         // By default, we send packets by sendmmsg.
         if ((err = session_->do_send_packet(pkt)) != srs_success) {
             return srs_error_wrap(err, "raw send");
@@ -2663,6 +2882,78 @@ srs_error_t SrsRtcSendTrack::on_recv_nack(const vector<uint16_t>& lost_seqs)
     return err;
 }
 
+void SrsRtcSendTrack::update_payload_type(SrsRtpPacket* pkt)
+{
+    // Should update PT, because subscriber may use different PT to publisher.
+    if (track_desc_->media_ && pkt->header.get_payload_type() == track_desc_->media_->pt_of_publisher_) {
+        // If PT is media from publisher, change to PT of media for subscriber.
+        pkt->header.set_payload_type(track_desc_->media_->pt_);
+    } else if (track_desc_->red_ && pkt->header.get_payload_type() == track_desc_->red_->pt_of_publisher_) {
+        // If PT is RED from publisher, change to PT of RED for subscriber.
+        pkt->header.set_payload_type(track_desc_->red_->pt_);
+    } else {
+        // TODO: FIXME: Should update PT for RTX.
+    }
+}
+
+SrsRtpPacket* SrsRtcSendTrack::fetch_history_packet(uint16_t seq)
+{
+    SrsRtpSentInfo* info = &sents_[seq & (nn_sents_ - 1)];
+
+    SrsRtpPacket* pkt = NULL;
+    if (info->ssrc && info->seq == seq) {
+        pkt = history_->fetch(info->ssrc, info->osn);
+    }
+
+    if (!pkt) {
+        ++_srs_pps_rmnack->sugar;
+        return NULL;
+    }
+    ++_srs_pps_rhnack->sugar;
+
+    SrsRtpPacket* cp = pkt->copy();
+    cp->header.set_ssrc(track_desc_->ssrc_);
+    cp->header.set_sequence(seq);
+    cp->header.set_timestamp(info->ts);
+    update_payload_type(cp);
+
+    return cp;
+}
+
+srs_error_t SrsRtcSendTrack::build_rtx(SrsRtpPacket* pkt, SrsRtpPacket** prtx)
+{
+    srs_error_t err = srs_success;
+
+    ISrsRtpPayloader* payload = pkt->payload();
+    int size = 2 + (payload ? (int)payload->nb_bytes() : 0);
+
+    SrsRtpPacket* rtx = new SrsRtpPacket();
+    *prtx = rtx;
+
+    rtx->header = pkt->header;
+    rtx->header.set_ssrc(track_desc_->rtx_ssrc_);
+    rtx->header.set_sequence(rtx_seq_++);
+    rtx->header.set_payload_type(track_desc_->rtx_->pt_);
+    rtx->header.set_padding(0);
+    rtx->frame_type = pkt->frame_type;
+    rtx->nalu_type = pkt->nalu_type;
+
+    // The payload of RTX is the original sequence and the original payload.
+    char* buf = rtx->wrap(size);
+    SrsBuffer b(buf, size);
+    b.write_2bytes(pkt->header.get_sequence());
+    if (payload && (err = payload->encode(&b)) != srs_success) {
+        return srs_error_wrap(err, "encode payload");
+    }
+
+    SrsRtpRawPayload* raw = new SrsRtpRawPayload();
+    raw->payload = buf;
+    raw->nn_payload = size;
+    rtx->set_payload(raw, SrsRtspPacketPayloadTypeRaw);
+
+    return err;
+}
+
 SrsRtcAudioSendTrack::SrsRtcAudioSendTrack(SrsRtcConnection* session, SrsRtcTrackDescription* track_desc)
     : SrsRtcSendTrack(session, track_desc, true)
 {
@@ -2681,17 +2972,7 @@ srs_error_t SrsRtcAudioSendTrack::on_rtp(SrsRtpPacket* pkt)
     }
 
     pkt->header.set_ssrc(track_desc_->ssrc_);
-
-    // Should update PT, because subscriber may use different PT to publisher.
-    if (track_desc_->media_ && pkt->header.get_payload_type() == track_desc_->media_->pt_of_publisher_) {
-        // If PT is media from publisher, change to PT of media for subscriber.
-        pkt->header.set_payload_type(track_desc_->media_->pt_);
-    } else if (track_desc_->red_ && pkt->header.get_payload_type() == track_desc_->red_->pt_of_publisher_) {
-        // If PT is RED from publisher, change to PT of RED for subscriber.
-        pkt->header.set_payload_type(track_desc_->red_->pt_);
-    } else {
-        // TODO: FIXME: Should update PT for RTX.
-    }
+    update_payload_type(pkt);
 
     if ((err = session_->do_send_packet(pkt)) != srs_success) {
         return srs_error_wrap(err, "raw send");
@@ -2710,10 +2991,25 @@ srs_error_t SrsRtcAudioSendTrack::on_rtcp(SrsRtpPacket* pkt)
 SrsRtcVideoSendTrack::SrsRtcVideoSendTrack(SrsRtcConnection* session, SrsRtcTrackDescription* track_desc)
     : SrsRtcSendTrack(session, track_desc, false)
 {
+    fec_ = NULL;
+
+    // The RED without PT of publisher is generated for FEC, see SrsRtcConnection::negotiate_play_capability.
+    SrsCodecPayload* red = track_desc_->red_;
+    if (red && !red->pt_of_publisher_ && track_desc_->ulpfec_) {
+        fec_ = new SrsRtcFecSender(red->pt_, track_desc_->ulpfec_->pt_);
+    }
 }
 
 SrsRtcVideoSendTrack::~SrsRtcVideoSendTrack()
 {
+    srs_freep(fec_);
+}
+
+void SrsRtcVideoSendTrack::on_loss(float loss)
+{
+    if (fec_) {
+        fec_->on_loss(loss);
+    }
 }
 
 srs_error_t SrsRtcVideoSendTrack::on_rtp(SrsRtpPacket* pkt)
@@ -2725,22 +3021,30 @@ srs_error_t SrsRtcVideoSendTrack::on_rtp(SrsRtpPacket* pkt)
     }
     
     pkt->header.set_ssrc(track_desc_->ssrc_);
+    update_payload_type(pkt);
 
-    // Should update PT, because subscriber may use different PT to publisher.
-    if (track_desc_->media_ && pkt->header.get_payload_type() == track_desc_->media_->pt_of_publisher_) {
-        // If PT is media from publisher, change to PT of media for subscriber.
-        pkt->header.set_payload_type(track_desc_->media_->pt_);
-    } else if (track_desc_->red_ && pkt->header.get_payload_type() == track_desc_->red_->pt_of_publisher_) {
-        // If PT is RED from publisher, change to PT of RED for subscriber.
-        pkt->header.set_payload_type(track_desc_->red_->pt_);
-    } else {
-        // TODO: FIXME: Should update PT for RTX.
+    if (fec_) {
+        fec_->on_media(pkt);
     }
 
     if ((err = session_->do_send_packet(pkt)) != srs_success) {
         return srs_error_wrap(err, "raw send");
     }
 
+    // Send the FEC packet after the protected media packets.
+    if (fec_) {
+        SrsRtpPacket* fec = NULL;
+        SrsAutoFree(SrsRtpPacket, fec);
+
+        if ((err = fec_->on_sent(pkt, &fec)) != srs_success) {
+            return srs_error_wrap(err, "fec");
+        }
+
+        if (fec && (err = session_->do_send_packet(fec)) != srs_success) {
+            return srs_error_wrap(err, "send fec");
+        }
+    }
+
     return err;
 }
 
@@ -2751,6 +3055,142 @@ srs_error_t SrsRtcVideoSendTrack::on_rtcp(SrsRtpPacket* pkt)
     return err;
 }
 
+// The min and max interval to probe the higher simulcast layer.
+#define SRS_RTC_LAYER_PROBE_MIN (5 * SRS_UTIME_SECONDS)
+#define SRS_RTC_LAYER_PROBE_MAX (60 * SRS_UTIME_SECONDS)
+// The layer is paused if no packets for a while.
+#define SRS_RTC_LAYER_TIMEOUT (2 * SRS_UTIME_SECONDS)
+
+SrsRtcLayerSelector::SrsRtcLayerSelector()
+{
+    current_ = target_ = 0;
+    last_select_ = last_switch_ = 0;
+    probe_interval_ = SRS_RTC_LAYER_PROBE_MIN;
+    probing_ = false;
+
+    started_ = false;
+    seq_offset_ = 0;
+    ts_offset_ = 0;
+    last_seq_ = 0;
+    last_ts_ = 0;
+    last_time_ = 0;
+}
+
+SrsRtcLayerSelector::~SrsRtcLayerSelector()
+{
+}
+
+uint32_t SrsRtcLayerSelector::select(const vector<SrsRtcSimulcastLayer>& layers, int64_t bitrate, bool congested, srs_utime_t now)
+{
+    if (target_ && now - last_select_ < SRS_UTIME_SECONDS) {
+        return 0;
+    }
+    last_select_ = now;
+
+    // The active layers, sorted by bitrate in ascending order.
+    vector<const SrsRtcSimulcastLayer*> actives;
+    for (int i = 0; i < (int)layers.size(); i++) {
+        const SrsRtcSimulcastLayer* layer = &layers.at(i);
+        if (!layer->ssrc || !layer->kbps || now - layer->last_packet > SRS_RTC_LAYER_TIMEOUT) {
+            continue;
+        }
+
+        vector<const SrsRtcSimulcastLayer*>::iterator it = actives.begin();
+        while (it != actives.end() && (*it)->kbps <= layer->kbps) {
+            ++it;
+        }
+        actives.insert(it, layer);
+    }
+    if (actives.empty()) {
+        return 0;
+    }
+
+    int current = -1;
+    for (int i = 0; i < (int)actives.size(); i++) {
+        if (actives.at(i)->ssrc == current_) {
+            current = i;
+        }
+    }
+
+    // Choose the highest layer under the estimation, or the lowest one.
+    int best = (int)actives.size() - 1;
+    if (bitrate > 0) {
+        best = 0;
+        for (int i = 0; i < (int)actives.size(); i++) {
+            if (actives.at(i)->kbps * 1000 <= bitrate) {
+                best = i;
+            }
+        }
+    }
+
+    if (bitrate > 0 && current >= 0) {
+        if (congested) {
+            // Back off if the probe failed, which is congested after switching up.
+            if (probing_ && now - last_switch_ < 2 * SRS_RTC_LAYER_PROBE_MIN) {
+                probe_interval_ = srs_min(probe_interval_ * 2, SRS_RTC_LAYER_PROBE_MAX);
+            }
+            probing_ = false;
+            best = srs_min(best, current);
+        } else if (best < current) {
+            // Never switch down if not congested, because the estimation is limited by the current layer.
+            best = current;
+        } else if (best == current && current + 1 < (int)actives.size() && now - last_switch_ >= probe_interval_) {
+            // Probe the higher layer, because the estimation never exceeds the current layer much.
+            best = current + 1;
+            probing_ = true;
+        }
+    }
+
+    // Request keyframe of target layer, again if still waiting for it.
+    target_ = actives.at(best)->ssrc;
+    return target_ != current_ ? target_ : 0;
+}
+
+bool SrsRtcLayerSelector::on_rtp(SrsRtpPacket* pkt, srs_utime_t now)
+{
+    uint32_t ssrc = pkt->header.get_ssrc();
+
+    // Switch to the target layer at keyframe.
+    if (ssrc == target_ && target_ != current_ && pkt->is_keyframe()) {
+        if (started_) {
+            // Continue the sequence, and the timestamp by the elapsed time in 90kHz.
+            uint32_t elapsed = (uint32_t)srs_max(1, srsu2ms(now - last_time_) * 90);
+            seq_offset_ = (uint16_t)(last_seq_ + 1 - pkt->header.get_sequence());
+            ts_offset_ = last_ts_ + elapsed - pkt->header.get_timestamp();
+        }
+
+        current_ = target_;
+        last_switch_ = now;
+        started_ = true;
+    }
+
+    if (ssrc != current_) {
+        return false;
+    }
+
+    pkt->header.set_sequence(pkt->header.get_sequence() + seq_offset_);
+    pkt->header.set_timestamp(pkt->header.get_timestamp() + ts_offset_);
+
+    // Never move back, for the packets out of order or retransmitted.
+    if (srs_rtp_seq_distance(last_seq_, pkt->header.get_sequence()) > 0 || last_time_ == 0) {
+        last_seq_ = pkt->header.get_sequence();
+        last_ts_ = pkt->header.get_timestamp();
+        last_time_ = now;
+    }
+
+    return true;
+}
+
+uint32_t SrsRtcLayerSelector::current()
+{
+    return current_;
+}
+
+uint32_t SrsRtcLayerSelector::target()
+{
+    return target_;
+}
+
 SrsRtcSSRCGenerator* SrsRtcSSRCGenerator::_instance = NULL;
 
 SrsRtcSSRCGenerator::SrsRtcSSRCGenerator()
@@ -29,6 +29,7 @@ class SrsMessageArray;
 class SrsRtcSource;
 class SrsRtcFromRtmpBridge;
 class SrsAudioTranscoder;
+class SrsAsyncAudioTranscoder;
 class SrsRtpPacket;
 class SrsSample;
 class SrsRtcSourceDescription;
@@ -36,8 +37,11 @@ class SrsRtcTrackDescription;
 class SrsRtcConnection;
 class SrsRtpRingBuffer;
 class SrsRtpNackForReceiver;
+class SrsRtpPacketHistory;
+class SrsRtpJitterBuffer;
 class SrsJsonObject;
 class SrsErrorPithyPrint;
+class SrsRtcFecSender;
 
 class SrsNtp
 {
@@ -155,6 +159,22 @@ public:
     virtual void on_unpublish() = 0;
 };
 
+// A simulcast layer of video, which is a RTP stream of publisher, identified by RID or SSRC.
+struct SrsRtcSimulcastLayer
+{
+    // The RID of layer, or the index in SIM group for SSRC simulcast.
+    std::string rid;
+    // The SSRC of layer, zero if not bound, for RID which is not in SDP.
+    uint32_t ssrc;
+    // The bitrate in kbps, sampled about each second.
+    int kbps;
+    // The time of last packet, to detect the paused layer.
+    srs_utime_t last_packet;
+    // The bytes and start time of current sample.
+    int64_t bytes;
+    srs_utime_t starttime;
+};
+
 // A Source is a stream, to publish and to play with, binding to SrsRtcPublishStream and SrsRtcPlayStream.
 class SrsRtcSource : public ISrsFastTimer
 {
@@ -181,6 +201,12 @@ private:
     bool is_delivering_packets_;
     // Notify stream event to event handler
     std::vector<ISrsRtcSourceEventHandler*> event_handlers_;
+    // Whether stamp the ingress time of packets, for latency stat.
+    bool stamp_ingress_;
+    // The simulcast layers of video, empty if not simulcast.
+    std::vector<SrsRtcSimulcastLayer> layers_;
+    // The history of packets, shared by players for NACK.
+    SrsRtpPacketHistory* history_;
 private:
     // The PLI for RTC2RTMP.
     srs_utime_t pli_for_rtmp_;
@@ -214,6 +240,8 @@ public:
     // @param dg, whether dumps the gop cache.
     virtual srs_error_t consumer_dumps(SrsRtcConsumer* consumer, bool ds = true, bool dm = true, bool dg = true);
     virtual void on_consumer_destroy(SrsRtcConsumer* consumer);
+    // Whether there is any consumer, for example, RTC player.
+    virtual bool has_consumers();
     // Whether we can publish stream to the source, return false if it exists.
     // @remark Note that when SDP is done, we set the stream is not able to publish.
     virtual bool can_publish();
@@ -237,6 +265,15 @@ public:
     bool has_stream_desc();
     void set_stream_desc(SrsRtcSourceDescription* stream_desc);
     std::vector<SrsRtcTrackDescription*> get_track_desc(std::string type, std::string media_type);
+public:
+    // Get the simulcast layers of video, empty if not simulcast.
+    const std::vector<SrsRtcSimulcastLayer>& layers();
+    // Bind the SSRC to layer of RID, when got the first packet of layer.
+    void bind_layer(std::string rid, uint32_t ssrc);
+    // Get the history of packets, for player to retransmit the lost packets.
+    SrsRtpPacketHistory* history();
+private:
+    SrsRtcSimulcastLayer* find_layer(uint32_t ssrc);
 // interface ISrsFastTimer
 private:
     srs_error_t on_timer(srs_utime_t interval);
@@ -254,6 +291,17 @@ private:
     SrsMetaCache* meta;
 private:
     bool rtmp_to_rtc;
+    // Whether only package RTP when there is any RTC player.
+    bool lazy_;
+    // Whether packaging RTP now, always true if not lazy.
+    bool active_;
+    // Whether drop the video until keyframe, when activated without cached GOP.
+    bool wait_keyframe_;
+    // The time when there is no RTC player, to deactivate the bridge when idle.
+    srs_utime_t idle_at_;
+    // The messages from the last keyframe, to bootstrap the RTC player when activated.
+    std::vector<SrsSharedPtrMessage*> gop_;
+    // The transcoder from pool, only available when active.
     SrsAudioTranscoder* codec_;
     bool keep_bframe;
     bool merge_nalus;
@@ -269,44 +317,44 @@ public:
     virtual srs_error_t on_publish();
     virtual void on_unpublish();
     virtual srs_error_t on_audio(SrsSharedPtrMessage* msg);
+    virtual srs_error_t on_video(SrsSharedPtrMessage* msg);
 private:
-    srs_error_t transcode(SrsAudioFrame* audio);
+    // Cache the GOP and activate or deactivate the bridge by RTC players, for lazy bridge.
+    srs_error_t update_state(SrsSharedPtrMessage* msg, bool is_video);
+    srs_error_t activate();
+    void deactivate();
+    void clear_gop();
+private:
+    srs_error_t package_audio(SrsSharedPtrMessage* msg);
+    // The ingress is the time when the RTMP message arrived, for latency stat, see SrsStatisticLatency.
+    srs_error_t transcode(SrsAudioFrame* audio, srs_utime_t ingress);
     srs_error_t package_opus(SrsAudioFrame* audio, SrsRtpPacket* pkt);
-public:
-    virtual srs_error_t on_video(SrsSharedPtrMessage* msg);
 private:
+    srs_error_t package_video(SrsSharedPtrMessage* msg);
     srs_error_t filter(SrsSharedPtrMessage* msg, SrsFormat* format, bool& has_idr, std::vector<SrsSample*>& samples);
     srs_error_t package_stap_a(SrsRtcSource* source, SrsSharedPtrMessage* msg, SrsRtpPacket* pkt);
     srs_error_t package_nalus(SrsSharedPtrMessage* msg, const std::vector<SrsSample*>& samples, std::vector<SrsRtpPacket*>& pkts);
     srs_error_t package_single_nalu(SrsSharedPtrMessage* msg, SrsSample* sample, std::vector<SrsRtpPacket*>& pkts);
     srs_error_t package_fu_a(SrsSharedPtrMessage* msg, SrsSample* sample, int fu_payload_size, std::vector<SrsRtpPacket*>& pkts);
-    srs_error_t consume_packets(std::vector<SrsRtpPacket*>& pkts);
+    srs_error_t consume_packets(std::vector<SrsRtpPacket*>& pkts, srs_utime_t ingress);
 };
 
 class SrsRtmpFromRtcBridge : public ISrsRtcSourceBridge
 {
 private:
     SrsLiveSource *source_;
-    SrsAudioTranscoder *codec_;
+    // The transcoder in worker thread, to transcode Opus to AAC.
+    SrsAsyncAudioTranscoder* codec_;
+    // Whether there is any output, which is updated every some seconds.
+    bool has_outputs_;
+    srs_utime_t outputs_updated_at_;
     bool is_first_audio;
     bool is_first_video;
     // The format, codec information.
     SrsRtmpFormat* format;
 
-    //TODO:use SrsRtpRingBuffer
-    //TODO:jitter buffer class
-    struct RtcPacketCache {
-        bool in_use;
-        uint16_t sn;
-        uint32_t ts;
-        uint32_t rtp_ts;
-        SrsRtpPacket* pkt;
-    };
-    const static uint16_t s_cache_size = 512;
-    RtcPacketCache cache_video_pkts_[s_cache_size];
-    uint16_t header_sn_;
-    uint16_t lost_sn_;
-    int64_t rtp_key_frame_ts_;
+    // The jitter buffer to assemble the video frames.
+    SrsRtpJitterBuffer* jitter_;
 public:
     SrsRtmpFromRtcBridge(SrsLiveSource *src);
     virtual ~SrsRtmpFromRtcBridge();
@@ -318,16 +366,16 @@ public:
     virtual void on_unpublish();
 private:
     srs_error_t transcode_audio(SrsRtpPacket *pkt);
+    // Consume the transcoded audio frames.
+    srs_error_t consume_audio();
+    // Whether should transcode the audio, if there is any consumer or output.
+    bool should_transcode();
     void packet_aac(SrsCommonMessage* audio, char* data, int len, uint32_t pts, bool is_header);
     srs_error_t packet_video(SrsRtpPacket* pkt);
-    srs_error_t packet_video_key_frame(SrsRtpPacket* pkt);
-    srs_error_t packet_video_rtmp(const uint16_t start, const uint16_t end);
-    int32_t find_next_lost_sn(uint16_t current_sn, uint16_t& end_sn);
-    void clear_cached_video();
-    inline uint16_t cache_index(uint16_t current_sn) {
-        return current_sn % s_cache_size;
-    }
-    bool check_frame_complete(const uint16_t start, const uint16_t end);
+    // Packet the sequence header, if got SPS and PPS in keyframe.
+    srs_error_t packet_video_key_frame(const std::vector<SrsRtpPacket*>& frame);
+    // Packet the frame of packets, which is complete.
+    srs_error_t packet_video_rtmp(const std::vector<SrsRtpPacket*>& frame);
 };
 #endif
 
@@ -460,6 +508,8 @@ public:
     std::string mid_;
     // msid_: track stream id
     std::string msid_;
+    // The RID of simulcast layer, empty if not simulcast.
+    std::string rid_;
 
     // meida payload, such as opus, h264.
     SrsCodecPayload* media_;
@@ -544,6 +594,9 @@ public:
     bool set_track_status(bool active);
     bool get_track_status();
     std::string get_track_id();
+    // Bind the SSRC of RID, for the simulcast layer without SSRC in SDP.
+    // @return Whether the RID matches this track.
+    bool bind_rid(const std::string& rid, uint32_t ssrc);
 public:
     // Note that we can set the pkt to NULL to avoid copy, for example, if the NACK cache the pkt and
     // set to NULL, nack nerver copy it but set the pkt to NULL.
@@ -579,6 +632,17 @@ public:
     virtual srs_error_t check_send_nacks();
 };
 
+// The packet sent to player, to find the original packet in the shared history of source.
+struct SrsRtpSentInfo
+{
+    // The sequence and timestamp sent to player.
+    uint16_t seq;
+    uint32_t ts;
+    // The original SSRC and sequence of packet in source, zero SSRC for empty slot.
+    uint32_t ssrc;
+    uint16_t osn;
+};
+
 class SrsRtcSendTrack
 {
 protected:
@@ -587,8 +651,17 @@ protected:
 protected:
     // The owner connection for this track.
     SrsRtcConnection* session_;
-    // NACK ARQ ring buffer.
+    // NACK ARQ ring buffer, if no shared history.
     SrsRtpRingBuffer* rtp_queue_;
+private:
+    // The shared history of source, to retransmit the original packet by rewriting the header, so
+    // we only keep the sent info of each packet, instead of a copy of packet for each player.
+    SrsRtpPacketHistory* history_;
+    // The sent info indexed by sequence, the capacity is power of 2.
+    SrsRtpSentInfo* sents_;
+    uint16_t nn_sents_;
+    // The sequence of RTX stream.
+    uint16_t rtx_seq_;
 private:
     // By config, whether no copy.
     bool nack_no_copy_;
@@ -600,6 +673,8 @@ public:
 public:
     // SrsRtcSendTrack::set_nack_no_copy
     void set_nack_no_copy(bool v) { nack_no_copy_ = v; }
+    // Retransmit from the shared history of source, NULL to keep packets in track.
+    void set_history(SrsRtpPacketHistory* v) { history_ = v; }
     bool has_ssrc(uint32_t ssrc);
     SrsRtpPacket* fetch_rtp_packet(uint16_t seq);
     bool set_track_status(bool active);
@@ -608,11 +683,23 @@ public:
 public:
     // Note that we can set the pkt to NULL to avoid copy, for example, if the NACK cache the pkt and
     // set to NULL, nack nerver copy it but set the pkt to NULL.
-    srs_error_t on_nack(SrsRtpPacket** ppkt);
+    // @param ssrc The original SSRC of packet in source, before rewritten by track.
+    // @param seq The original sequence of packet in source.
+    srs_error_t on_nack(SrsRtpPacket** ppkt, uint32_t ssrc, uint16_t seq);
 public:
     virtual srs_error_t on_rtp(SrsRtpPacket* pkt) = 0;
     virtual srs_error_t on_rtcp(SrsRtpPacket* pkt) = 0;
     virtual srs_error_t on_recv_nack(const std::vector<uint16_t>& lost_seqs);
+protected:
+    // Update the PT of publisher to the PT of player.
+    void update_payload_type(SrsRtpPacket* pkt);
+private:
+    // Fetch the original packet from history, and rewrite it as the sent one.
+    // @remark User should free the returned packet.
+    SrsRtpPacket* fetch_history_packet(uint16_t seq);
+    // Build the RTX packet, with the original sequence and payload.
+    // @see https://datatracker.ietf.org/doc/html/rfc4588#section-4
+    srs_error_t build_rtx(SrsRtpPacket* pkt, SrsRtpPacket** prtx);
 };
 
 class SrsRtcAudioSendTrack : public SrsRtcSendTrack
@@ -627,14 +714,57 @@ public:
 
 class SrsRtcVideoSendTrack : public SrsRtcSendTrack
 {
+private:
+    // The ULPFEC sender, NULL if not negotiated.
+    SrsRtcFecSender* fec_;
 public:
     SrsRtcVideoSendTrack(SrsRtcConnection* session, SrsRtcTrackDescription* track_desc);
     virtual ~SrsRtcVideoSendTrack();
 public:
+    // When got the loss rate in [0, 1] from RR of player, to adjust the FEC.
+    void on_loss(float loss);
     virtual srs_error_t on_rtp(SrsRtpPacket* pkt);
     virtual srs_error_t on_rtcp(SrsRtpPacket* pkt);
 };
 
+// Select the simulcast layer for a player, and switch layer at keyframe, by rewriting the sequence
+// and timestamp to make the layers looks like a stream, so the SSRC of player never changes.
+// The target layer is chosen by the estimated bandwidth of player, and if the estimation is limited
+// by the current layer, probe the higher layer periodically, and back off when congested.
+class SrsRtcLayerSelector
+{
+private:
+    // The SSRC of current layer to forward, and the target layer to switch to, zero if none.
+    uint32_t current_;
+    uint32_t target_;
+    srs_utime_t last_select_;
+    srs_utime_t last_switch_;
+    // The interval to probe the higher layer, doubled when probe failed.
+    srs_utime_t probe_interval_;
+    bool probing_;
+private:
+    // The offsets to rewrite the sequence and timestamp of current layer.
+    bool started_;
+    uint16_t seq_offset_;
+    uint32_t ts_offset_;
+    uint16_t last_seq_;
+    uint32_t last_ts_;
+    srs_utime_t last_time_;
+public:
+    SrsRtcLayerSelector();
+    virtual ~SrsRtcLayerSelector();
+public:
+    // Select the target layer about each second.
+    // @param bitrate The estimated bandwidth in bps, zero if unknown, to choose the best layer.
+    // @param congested Whether lost packets or overused, to switch to lower layer.
+    // @return The SSRC of target layer to request keyframe, zero if not.
+    uint32_t select(const std::vector<SrsRtcSimulcastLayer>& layers, int64_t bitrate, bool congested, srs_utime_t now);
+    // Whether forward the packet, the packet is rewritten if forward it.
+    bool on_rtp(SrsRtpPacket* pkt, srs_utime_t now);
+    uint32_t current();
+    uint32_t target();
+};
+
 class SrsRtcSSRCGenerator
 {
 private:
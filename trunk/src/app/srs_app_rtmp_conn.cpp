@@ -706,6 +706,10 @@ srs_error_t SrsRtmpConn::do_playing(SrsLiveSource* source, SrsLiveConsumer* cons
     bool user_specified_duration_to_stop = (req->duration > 0);
     int64_t starttime = -1;
 
+    // The latency of messages, see stats.latency.
+    SrsStatisticLatencyRecorder latency;
+    latency.initialize(req, SrsStatisticLatencyTypeRtmp);
+
     // setup the realtime.
     realtime = _srs_config->get_realtime_enabled(req->vhost);
     // setup the mw config.
@@ -789,9 +793,11 @@ srs_error_t SrsRtmpConn::do_playing(SrsLiveSource* source, SrsLiveConsumer* cons
         
         // sendout messages, all messages are freed by send_and_free_messages().
         // no need to assert msg, for the rtmp will assert it.
+        latency.on_dequeue(msgs.msgs, count);
         if (count > 0 && (err = rtmp->send_and_free_messages(msgs.msgs, count, info->res->stream_id)) != srs_success) {
             return srs_error_wrap(err, "rtmp: send %d messages", count);
         }
+        latency.on_sent();
         
         // if duration specified, and exceed it, stop play live.
         // @see: https://github.com/ossrs/srs/issues/45
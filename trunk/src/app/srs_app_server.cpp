@@ -37,6 +37,7 @@ using namespace std;
 #include <srs_protocol_log.hpp>
 #include <srs_app_latest_version.hpp>
 #include <srs_app_threads.hpp>
+#include <srs_app_metrics.hpp>
 
 std::string srs_listener_type2string(SrsListenerType type)
 {
@@ -786,6 +787,33 @@ srs_error_t SrsServer::http_handle()
     if ((err = http_api_mux->handle("/api/v1/clusters", new SrsGoApiClusters())) != srs_success) {
         return srs_error_wrap(err, "handle clusters");
     }
+    if ((err = http_api_mux->handle("/api/v1/hooks", new SrsGoApiHooks())) != srs_success) {
+        return srs_error_wrap(err, "handle hooks");
+    }
+
+    // The Prometheus exporter.
+    if (_srs_config->get_exporter_enabled()) {
+        string labels;
+        if (!_srs_config->get_exporter_label().empty()) {
+            labels = srs_metrics_label("label", _srs_config->get_exporter_label());
+        }
+        if (!_srs_config->get_exporter_tag().empty()) {
+            labels += string(labels.empty() ? "" : ",") + srs_metrics_label("tag", _srs_config->get_exporter_tag());
+        }
+
+        _srs_metrics->set_const_labels(labels);
+        _srs_metrics->set_max_series(_srs_config->get_exporter_max_series());
+        srs_metrics_register_collectors(_srs_metrics);
+
+        if ((err = http_api_mux->handle("/metrics", new SrsGoApiMetrics())) != srs_success) {
+            return srs_error_wrap(err, "handle metrics");
+        }
+    }
+    
+    // The CPU profiler, which is always available, without rebuild with gperf.
+    if ((err = http_api_mux->handle("/api/v1/profiler", new SrsGoApiProfiler())) != srs_success) {
+        return srs_error_wrap(err, "handle profiler");
+    }
     
     // test the request info.
     if ((err = http_api_mux->handle("/api/v1/tests/requests", new SrsGoApiRequests())) != srs_success) {
@@ -523,6 +523,11 @@ srs_error_t SrsLiveConsumer::dump_packets(SrsMessageArray* msgs, int& count)
     return err;
 }
 
+int SrsLiveConsumer::queue_length()
+{
+    return queue->size();
+}
+
 #ifdef SRS_PERF_QUEUE_COND_WAIT
 void SrsLiveConsumer::wait(int nb_msgs, srs_utime_t msgs_duration)
 {
@@ -899,6 +904,16 @@ bool SrsOriginHub::active()
     return is_active;
 }
 
+bool SrsOriginHub::has_outputs()
+{
+    if (!forwarders.empty() || encoder->has_engines()) {
+        return true;
+    }
+
+    return _srs_config->get_hls_enabled(req_->vhost) || _srs_config->get_dash_enabled(req_->vhost)
+        || _srs_config->get_dvr_enabled(req_->vhost) || _srs_config->get_exec_enabled(req_->vhost);
+}
+
 srs_error_t SrsOriginHub::on_meta_data(SrsSharedPtrMessage* shared_metadata, SrsOnMetaDataPacket* packet)
 {
     srs_error_t err = srs_success;
@@ -1843,6 +1858,21 @@ void SrsLiveSourceManager::dispose()
     return;
 }
 
+void SrsLiveSourceManager::collect(SrsMetrics* metrics)
+{
+    // The sources might be removed, so we reset the series before collecting.
+    SrsMetric* consumers = metrics->gauge("srs_stream_consumers", "The number of consumers of stream.");
+    SrsMetric* queued = metrics->gauge("srs_stream_queue_messages", "The number of messages in queue of consumers.");
+    consumers->reset();
+    queued->reset();
+
+    std::map<std::string, SrsLiveSource*>::iterator it;
+    for (it = pool.begin(); it != pool.end(); ++it) {
+        SrsLiveSource* source = it->second;
+        source->collect(consumers, queued);
+    }
+}
+
 srs_error_t SrsLiveSourceManager::setup_ticks()
 {
     srs_error_t err = srs_success;
@@ -1922,6 +1952,7 @@ SrsLiveSource::SrsLiveSource()
     req = NULL;
     jitter_algorithm = SrsRtmpJitterAlgorithmOFF;
     mix_correct = false;
+    stamp_ingress = false;
     mix_queue = new SrsMixQueue();
     
     _can_publish = true;
@@ -2032,6 +2063,7 @@ srs_error_t SrsLiveSource::initialize(SrsRequest* r, ISrsLiveSourceHandler* h)
     
     jitter_algorithm = (SrsRtmpJitterAlgorithm)_srs_config->get_time_jitter(req->vhost);
     mix_correct = _srs_config->get_mix_correct(req->vhost);
+    stamp_ingress = _srs_config->get_stats_latency();
     
     return err;
 }
@@ -2163,6 +2195,16 @@ bool SrsLiveSource::inactive()
     return _can_publish;
 }
 
+bool SrsLiveSource::has_consumers()
+{
+    return !consumers.empty();
+}
+
+bool SrsLiveSource::has_outputs()
+{
+    return hub && hub->has_outputs();
+}
+
 void SrsLiveSource::update_auth(SrsRequest* r)
 {
     req->update_auth(r);
@@ -2244,6 +2286,9 @@ srs_error_t SrsLiveSource::on_audio(SrsCommonMessage* shared_audio)
     if ((err = msg.create(shared_audio)) != srs_success) {
         return srs_error_wrap(err, "create message");
     }
+    if (stamp_ingress) {
+        msg.set_ingress(srs_update_system_time());
+    }
     
     // directly process the audio message.
     if (!mix_correct) {
@@ -2369,6 +2414,9 @@ srs_error_t SrsLiveSource::on_video(SrsCommonMessage* shared_video)
     if ((err = msg.create(shared_video)) != srs_success) {
         return srs_error_wrap(err, "create message");
     }
+    if (stamp_ingress) {
+        msg.set_ingress(srs_update_system_time());
+    }
     
     // directly process the video message.
     if (!mix_correct) {
@@ -2717,6 +2765,22 @@ void SrsLiveSource::on_consumer_destroy(SrsLiveConsumer* consumer)
     }
 }
 
+void SrsLiveSource::collect(SrsMetric* metric_consumers, SrsMetric* metric_queued)
+{
+    int nn_queued = 0;
+    for (int i = 0; i < (int)consumers.size(); i++) {
+        nn_queued += consumers.at(i)->queue_length();
+    }
+
+    std::string labels = srs_metrics_label("vhost", req->vhost);
+    labels += "," + srs_metrics_label("app", req->app);
+    labels += "," + srs_metrics_label("stream", req->stream);
+
+    // Sum up the sources in the overflow series, if exceed the max series.
+    metric_consumers->with(labels)->inc(consumers.size());
+    metric_queued->with(labels)->inc(nn_queued);
+}
+
 void SrsLiveSource::set_cache(bool enabled)
 {
     gop_cache->set(enabled);
@@ -18,6 +18,7 @@
 #include <srs_core_performance.hpp>
 #include <srs_protocol_st.hpp>
 #include <srs_app_hourglass.hpp>
+#include <srs_app_metrics.hpp>
 
 class SrsFormat;
 class SrsRtmpFormat;
@@ -202,6 +203,8 @@ public:
     // @param count the count in array, intput and output param.
     // @remark user can specifies the count to get specified msgs; 0 to get all if possible.
     virtual srs_error_t dump_packets(SrsMessageArray* msgs, int& count);
+    // Get the number of messages in queue, which are not sent to client.
+    virtual int queue_length();
 #ifdef SRS_PERF_QUEUE_COND_WAIT
     // wait for messages incomming, atleast nb_msgs and in duration.
     // @param nb_msgs the messages count to wait.
@@ -346,6 +349,8 @@ public:
     virtual srs_error_t cycle();
     // Whether the stream hub is active, or stream is publishing.
     virtual bool active();
+    // Whether there is any output of stream, such as HLS, DVR and forwarding.
+    virtual bool has_outputs();
 public:
     // When got a parsed metadata.
     virtual srs_error_t on_meta_data(SrsSharedPtrMessage* shared_metadata, SrsOnMetaDataPacket* packet);
@@ -433,7 +438,7 @@ public:
 };
 
 // The source manager to create and refresh all stream sources.
-class SrsLiveSourceManager : public ISrsHourGlass
+class SrsLiveSourceManager : public ISrsHourGlass, public ISrsMetricsCollector
 {
 private:
     srs_mutex_t lock;
@@ -455,6 +460,9 @@ public:
 public:
     // dispose and cycle all sources.
     virtual void dispose();
+// Interface ISrsMetricsCollector
+public:
+    virtual void collect(SrsMetrics* metrics);
 // interface ISrsHourGlass
 private:
     virtual srs_error_t setup_ticks();
@@ -503,6 +511,8 @@ private:
     bool mix_correct;
     // The mix queue to implements the mix correct algorithm.
     SrsMixQueue* mix_queue;
+    // Whether stamp the ingress time of messages, for latency stat.
+    bool stamp_ingress;
     // For play, whether enabled atc.
     // The atc(use absolute time and donot adjust time),
     // directly use msg time and donot adjust if atc is true,
@@ -556,6 +566,10 @@ public:
     // Whether source is inactive, which means there is no publishing stream source.
     // @remark For edge, it's inactive util stream has been pulled from origin.
     virtual bool inactive();
+    // Whether there is any consumer or output, to avoid generating the stream which nobody uses,
+    // for example, transcoding the audio from RTC.
+    virtual bool has_consumers();
+    virtual bool has_outputs();
     // Update the authentication information in request.
     virtual void update_auth(SrsRequest* r);
 public:
@@ -588,6 +602,8 @@ public:
     // @param dg, whether dumps the gop cache.
     virtual srs_error_t consumer_dumps(SrsLiveConsumer* consumer, bool ds = true, bool dm = true, bool dg = true);
     virtual void on_consumer_destroy(SrsLiveConsumer* consumer);
+    // Collect the number of consumers, and the total messages in queue of consumers.
+    virtual void collect(SrsMetric* consumers, SrsMetric* queued);
     virtual void set_cache(bool enabled);
     virtual SrsRtmpJitterAlgorithm jitter();
 public:
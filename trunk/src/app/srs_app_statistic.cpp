@@ -16,6 +16,7 @@ using namespace std;
 #include <srs_app_conn.hpp>
 #include <srs_app_config.hpp>
 #include <srs_kernel_utility.hpp>
+#include <srs_kernel_flv.hpp>
 #include <srs_protocol_amf0.hpp>
 #include <srs_protocol_utility.hpp>
 
@@ -24,6 +25,46 @@ string srs_generate_stat_vid()
     return "vid-" + srs_random_str(7);
 }
 
+// The names of fields, the index is the bit of mask.
+static const char* _srs_stat_stream_fields[] = {
+    "id", "name", "vhost", "app", "live_ms", "clients", "frames", "send_bytes", "recv_bytes", "kbps",
+    "publish", "video", "audio", "latency", NULL
+};
+static const char* _srs_stat_client_fields[] = {
+    "id", "vhost", "stream", "ip", "pageUrl", "swfUrl", "tcUrl", "url", "type", "publish", "alive", "bwe", NULL
+};
+
+uint32_t srs_stat_parse_fields(string fields, const char** names)
+{
+    if (fields.empty()) {
+        return SRS_STAT_FIELDS_ALL;
+    }
+
+    uint32_t mask = 0;
+    vector<string> keys = srs_string_split(fields, ",");
+    for (int i = 0; i < (int)keys.size(); i++) {
+        string key = srs_string_trim_start(srs_string_trim_end(keys.at(i), " "), " ");
+        for (int j = 0; names[j]; j++) {
+            if (key == names[j]) {
+                mask |= 1 << j;
+                break;
+            }
+        }
+    }
+
+    return mask;
+}
+
+uint32_t srs_stat_stream_fields(string fields)
+{
+    return srs_stat_parse_fields(fields, _srs_stat_stream_fields);
+}
+
+uint32_t srs_stat_client_fields(string fields)
+{
+    return srs_stat_parse_fields(fields, _srs_stat_client_fields);
+}
+
 SrsStatisticVhost::SrsStatisticVhost()
 {
     id = srs_generate_stat_vid();
@@ -75,6 +116,111 @@ srs_error_t SrsStatisticVhost::dumps(SrsJsonObject* obj)
     return err;
 }
 
+SrsStatisticLatency::SrsStatisticLatency()
+{
+}
+
+SrsStatisticLatency::~SrsStatisticLatency()
+{
+}
+
+// Dumps the histogram in ms, for example, {"count":100,"avg":1.2,"p50":1.0,"p90":..,"p99":..,"max":..}
+static void srs_stat_dumps_histogram(SrsJsonWriter* w, SrsLatencyHistogram* h)
+{
+    w->begin_object();
+    w->key("count")->integer(h->count());
+    w->key("avg")->number(h->mean() / 1000.0);
+    w->key("p50")->number(h->percentile(50) / 1000.0);
+    w->key("p90")->number(h->percentile(90) / 1000.0);
+    w->key("p99")->number(h->percentile(99) / 1000.0);
+    w->key("p999")->number(h->percentile(99.9) / 1000.0);
+    w->key("max")->number(h->max() / 1000.0);
+    w->end_object();
+}
+
+void SrsStatisticLatency::dumps(SrsJsonWriter* w)
+{
+    w->begin_object();
+    w->key("queue");
+    srs_stat_dumps_histogram(w, &queue);
+    w->key("send");
+    srs_stat_dumps_histogram(w, &send);
+    w->key("jitter");
+    srs_stat_dumps_histogram(w, &jitter);
+    w->end_object();
+}
+
+SrsStatisticLatencyRecorder::SrsStatisticLatencyRecorder()
+{
+    latency_ = NULL;
+    last_ = -1;
+}
+
+SrsStatisticLatencyRecorder::~SrsStatisticLatencyRecorder()
+{
+}
+
+void SrsStatisticLatencyRecorder::initialize(SrsRequest* req, SrsStatisticLatencyType type)
+{
+    if (!_srs_config->get_stats_latency()) {
+        return;
+    }
+
+    // The stream of stat is never freed, see SrsStatisticClient.stream.
+    latency_ = SrsStatistic::instance()->latency(req, type);
+}
+
+void SrsStatisticLatencyRecorder::on_dequeue(SrsSharedPtrMessage** msgs, int count)
+{
+    if (!latency_ || count <= 0) {
+        return;
+    }
+
+    srs_utime_t now = srs_update_system_time();
+    for (int i = 0; i < count; i++) {
+        srs_utime_t ingress = msgs[i]->ingress();
+        if (ingress > 0) {
+            latency_->queue.record(now - ingress);
+            ingresses_.push_back(ingress);
+        }
+    }
+}
+
+void SrsStatisticLatencyRecorder::on_dequeue(srs_utime_t ingress)
+{
+    if (!latency_ || ingress <= 0) {
+        return;
+    }
+
+    latency_->queue.record(srs_update_system_time() - ingress);
+    ingresses_.push_back(ingress);
+}
+
+void SrsStatisticLatencyRecorder::on_sent()
+{
+    if (!latency_ || ingresses_.empty()) {
+        return;
+    }
+
+    srs_utime_t now = srs_update_system_time();
+    for (int i = 0; i < (int)ingresses_.size(); i++) {
+        srs_utime_t v = now - ingresses_.at(i);
+        latency_->send.record(v);
+
+        if (last_ >= 0) {
+            latency_->jitter.record(v > last_ ? v - last_ : last_ - v);
+        }
+        last_ = v;
+    }
+
+    ingresses_.clear();
+}
+
+void SrsStatisticLatencyRecorder::on_discard()
+{
+    ingresses_.clear();
+}
+
 SrsStatisticStream::SrsStatisticStream()
 {
     id = srs_generate_stat_vid();
@@ -100,12 +246,26 @@ SrsStatisticStream::SrsStatisticStream()
     
     nb_clients = 0;
     nb_frames = 0;
+
+    for (int i = 0; i < SrsStatisticLatencyTypeMax; i++) {
+        latency[i] = NULL;
+    }
+
+    seq = 0;
+    slot = -1;
+
+    metrics_collected = false;
+    metrics_overflow = false;
 }
 
 SrsStatisticStream::~SrsStatisticStream()
 {
     srs_freep(kbps);
     srs_freep(clk);
+
+    for (int i = 0; i < SrsStatisticLatencyTypeMax; i++) {
+        srs_freep(latency[i]);
+    }
 }
 
 srs_error_t SrsStatisticStream::dumps(SrsJsonObject* obj)
@@ -162,6 +322,84 @@ srs_error_t SrsStatisticStream::dumps(SrsJsonObject* obj)
     return err;
 }
 
+void SrsStatisticStream::dumps(SrsJsonWriter* w, uint32_t fields, srs_utime_t now)
+{
+    w->begin_object();
+
+    if ((fields & SrsStatisticStreamFieldId)) w->key("id")->str(id);
+    if ((fields & SrsStatisticStreamFieldName)) w->key("name")->str(stream);
+    if ((fields & SrsStatisticStreamFieldVhost)) w->key("vhost")->str(vhost->id);
+    if ((fields & SrsStatisticStreamFieldApp)) w->key("app")->str(app);
+    if ((fields & SrsStatisticStreamFieldLiveMs)) w->key("live_ms")->integer(srsu2ms(now));
+    if ((fields & SrsStatisticStreamFieldClients)) w->key("clients")->integer(nb_clients);
+    if ((fields & SrsStatisticStreamFieldFrames)) w->key("frames")->integer(nb_frames);
+    if ((fields & SrsStatisticStreamFieldSendBytes)) w->key("send_bytes")->integer(kbps->get_send_bytes());
+    if ((fields & SrsStatisticStreamFieldRecvBytes)) w->key("recv_bytes")->integer(kbps->get_recv_bytes());
+
+    if ((fields & SrsStatisticStreamFieldKbps)) {
+        w->key("kbps")->begin_object();
+        w->key("recv_30s")->integer(kbps->get_recv_kbps_30s());
+        w->key("send_30s")->integer(kbps->get_send_kbps_30s());
+        w->end_object();
+    }
+
+    if ((fields & SrsStatisticStreamFieldPublish)) {
+        w->key("publish")->begin_object();
+        w->key("active")->boolean(active);
+        w->key("cid")->str(publisher_id);
+        w->end_object();
+    }
+
+    if ((fields & SrsStatisticStreamFieldVideo)) {
+        if (!has_video) {
+            w->key("video")->null();
+        } else {
+            w->key("video")->begin_object();
+            w->key("codec")->str(srs_video_codec_id2str(vcodec));
+            w->key("profile")->str(srs_avc_profile2str(avc_profile));
+            w->key("level")->str(srs_avc_level2str(avc_level));
+            w->key("width")->integer(width);
+            w->key("height")->integer(height);
+            w->end_object();
+        }
+    }
+
+    if ((fields & SrsStatisticStreamFieldAudio)) {
+        if (!has_audio) {
+            w->key("audio")->null();
+        } else {
+            w->key("audio")->begin_object();
+            w->key("codec")->str(srs_audio_codec_id2str(acodec));
+            w->key("sample_rate")->integer(srs_flv_srates[asample_rate]);
+            w->key("channel")->integer(asound_type + 1);
+            w->key("profile")->str(srs_aac_object2str(aac_object));
+            w->end_object();
+        }
+    }
+
+    // Only dumps the latency of types which are recorded, see stats.latency.
+    if ((fields & SrsStatisticStreamFieldLatency)) {
+        bool has_latency = false;
+        for (int i = 0; i < SrsStatisticLatencyTypeMax; i++) {
+            has_latency = has_latency || latency[i];
+        }
+
+        if (has_latency) {
+            static const char* types[SrsStatisticLatencyTypeMax] = {"rtmp", "http", "rtc"};
+            w->key("latency")->begin_object();
+            for (int i = 0; i < SrsStatisticLatencyTypeMax; i++) {
+                if (latency[i]) {
+                    w->key(types[i]);
+                    latency[i]->dumps(w);
+                }
+            }
+            w->end_object();
+        }
+    }
+
+    w->end_object();
+}
+
 void SrsStatisticStream::publish(std::string id)
 {
     publisher_id = id;
@@ -186,6 +424,10 @@ SrsStatisticClient::SrsStatisticClient()
     req = NULL;
     type = SrsRtmpConnUnknown;
     create = srs_get_system_time();
+    bwe = 0;
+
+    seq = 0;
+    slot = -1;
 }
 
 SrsStatisticClient::~SrsStatisticClient()
@@ -208,10 +450,43 @@ srs_error_t SrsStatisticClient::dumps(SrsJsonObject* obj)
     obj->set("type", SrsJsonAny::str(srs_client_type_string(type).c_str()));
     obj->set("publish", SrsJsonAny::boolean(srs_client_type_is_publish(type)));
     obj->set("alive", SrsJsonAny::number(srsu2ms(srs_get_system_time() - create) / 1000.0));
+    if (bwe > 0) {
+        obj->set("bwe", SrsJsonAny::integer(bwe));
+    }
     
     return err;
 }
 
+void SrsStatisticClient::dumps(SrsJsonWriter* w, uint32_t fields, srs_utime_t now)
+{
+    w->begin_object();
+
+    if ((fields & SrsStatisticClientFieldId)) w->key("id")->str(id);
+    if ((fields & SrsStatisticClientFieldVhost)) w->key("vhost")->str(stream->vhost->id);
+    if ((fields & SrsStatisticClientFieldStream)) w->key("stream")->str(stream->id);
+    if ((fields & SrsStatisticClientFieldIp)) w->key("ip")->str(req->ip);
+    if ((fields & SrsStatisticClientFieldPageUrl)) w->key("pageUrl")->str(req->pageUrl);
+    if ((fields & SrsStatisticClientFieldSwfUrl)) w->key("swfUrl")->str(req->swfUrl);
+    if ((fields & SrsStatisticClientFieldTcUrl)) w->key("tcUrl")->str(req->tcUrl);
+    if ((fields & SrsStatisticClientFieldUrl)) w->key("url")->str(req->get_stream_url());
+    if ((fields & SrsStatisticClientFieldType)) w->key("type")->str(srs_client_type_string(type));
+    if ((fields & SrsStatisticClientFieldPublish)) w->key("publish")->boolean(srs_client_type_is_publish(type));
+    if ((fields & SrsStatisticClientFieldAlive)) w->key("alive")->number(srsu2ms(now - create) / 1000.0);
+    if ((fields & SrsStatisticClientFieldBwe) && bwe > 0) w->key("bwe")->integer(bwe);
+
+    w->end_object();
+}
+
+SrsStatisticPage::SrsStatisticPage()
+{
+    by_cursor = false;
+    cursor = 0;
+    start = 0;
+    count = 10;
+    fields = SRS_STAT_FIELDS_ALL;
+    next = 0;
+}
+
 SrsStatistic* SrsStatistic::_instance = NULL;
 
 SrsStatistic::SrsStatistic()
@@ -221,6 +496,10 @@ SrsStatistic::SrsStatistic()
     clk = new SrsWallClock();
     kbps = new SrsKbps(clk);
     kbps->set_io(NULL, NULL);
+
+    overflow_frames = 0;
+    overflow_send_bytes = 0;
+    overflow_recv_bytes = 0;
 }
 
 SrsStatistic::~SrsStatistic()
@@ -363,6 +642,13 @@ void SrsStatistic::on_stream_close(SrsRequest* req)
     SrsStatisticVhost* vhost = create_vhost(req);
     SrsStatisticStream* stream = create_stream(vhost, req);
     stream->close();
+
+    // Absorb the final values of stream, to keep the counters of overflow series monotonic.
+    if (stream->metrics_overflow) {
+        overflow_frames += stream->nb_frames;
+        overflow_send_bytes += stream->kbps->get_send_bytes();
+        overflow_recv_bytes += stream->kbps->get_recv_bytes();
+    }
     
     // TODO: FIXME: Should fix https://github.com/ossrs/srs/issues/803
     if (true) {
@@ -370,6 +656,7 @@ void SrsStatistic::on_stream_close(SrsRequest* req)
         if ((it=streams.find(stream->id)) != streams.end()) {
             streams.erase(it);
         }
+        stream_table.remove(stream);
     }
     
     // TODO: FIXME: Should fix https://github.com/ossrs/srs/issues/803
@@ -390,13 +677,15 @@ srs_error_t SrsStatistic::on_client(std::string id, SrsRequest* req, ISrsExpire*
     
     // create client if not exists
     SrsStatisticClient* client = NULL;
-    if (clients.find(id) == clients.end()) {
+    std::map<std::string, SrsStatisticClient*>::iterator it = clients.find(id);
+    if (it == clients.end()) {
         client = new SrsStatisticClient();
         client->id = id;
         client->stream = stream;
         clients[id] = client;
+        client_table.insert(client);
     } else {
-        client = clients[id];
+        client = it->second;
     }
     
     // got client.
@@ -424,6 +713,7 @@ void SrsStatistic::on_disconnect(std::string id)
     SrsStatisticStream* stream = client->stream;
     SrsStatisticVhost* vhost = stream->vhost;
     
+    client_table.remove(client);
     srs_freep(client);
     clients.erase(it);
     
@@ -431,13 +721,22 @@ void SrsStatistic::on_disconnect(std::string id)
     vhost->nb_clients--;
 }
 
+void SrsStatistic::on_client_bwe(std::string id, int kbps)
+{
+    std::map<std::string, SrsStatisticClient*>::iterator it = clients.find(id);
+    if (it != clients.end()) {
+        it->second->bwe = kbps;
+    }
+}
+
 void SrsStatistic::kbps_add_delta(std::string id, ISrsKbpsDelta* delta)
 {
-    if (clients.find(id) == clients.end()) {
+    std::map<std::string, SrsStatisticClient*>::iterator it = clients.find(id);
+    if (it == clients.end()) {
         return;
     }
     
-    SrsStatisticClient* client = clients[id];
+    SrsStatisticClient* client = it->second;
     
     // resample the kbps to collect the delta.
     int64_t in, out;
@@ -460,10 +759,9 @@ SrsKbps* SrsStatistic::kbps_sample()
             vhost->kbps->sample();
         }
     }
-    if (true) {
-        std::map<std::string, SrsStatisticStream*>::iterator it;
-        for (it = streams.begin(); it != streams.end(); it++) {
-            SrsStatisticStream* stream = it->second;
+    for (int i = 0; i < stream_table.slots(); i++) {
+        SrsStatisticStream* stream = stream_table.at(i);
+        if (stream) {
             stream->kbps->sample();
         }
     }
@@ -499,13 +797,11 @@ srs_error_t SrsStatistic::dumps_streams(SrsJsonArray* arr, int start, int count)
 {
     srs_error_t err = srs_success;
 
-    std::map<std::string, SrsStatisticStream*>::iterator it = streams.begin();
-    for (int i = 0; i < start + count && it != streams.end(); it++, i++) {
-        if (i < start) {
+    for (int i = 0, j = 0; i < stream_table.slots() && j < start + count; i++) {
+        SrsStatisticStream* stream = stream_table.at(i);
+        if (!stream || j++ < start) {
             continue;
         }
-
-        SrsStatisticStream* stream = it->second;
         
         SrsJsonObject* obj = SrsJsonAny::object();
         arr->append(obj);
@@ -522,14 +818,12 @@ srs_error_t SrsStatistic::dumps_clients(SrsJsonArray* arr, int start, int count)
 {
     srs_error_t err = srs_success;
     
-    std::map<std::string, SrsStatisticClient*>::iterator it = clients.begin();
-    for (int i = 0; i < start + count && it != clients.end(); it++, i++) {
-        if (i < start) {
+    for (int i = 0, j = 0; i < client_table.slots() && j < start + count; i++) {
+        SrsStatisticClient* client = client_table.at(i);
+        if (!client || j++ < start) {
             continue;
         }
         
-        SrsStatisticClient* client = it->second;
-        
         SrsJsonObject* obj = SrsJsonAny::object();
         arr->append(obj);
         
@@ -541,6 +835,149 @@ srs_error_t SrsStatistic::dumps_clients(SrsJsonArray* arr, int start, int count)
     return err;
 }
 
+// Dumps the page of objects in table to writer, for stream or client.
+template<typename T>
+void srs_stat_dumps_page(SrsStatisticTable<T>& table, SrsJsonWriter* w, SrsStatisticPage* page)
+{
+    srs_utime_t now = srs_get_system_time();
+
+    int i = 0;
+    if (page->by_cursor) {
+        i = table.after(page->cursor);
+    } else {
+        // Skip the objects before start, note that there might be holes.
+        for (int j = 0; i < table.slots() && j < page->start; i++) {
+            if (table.at(i)) {
+                j++;
+            }
+        }
+    }
+
+    page->next = 0;
+    w->begin_array();
+
+    uint64_t last = page->cursor;
+    for (int nn = 0; i < table.slots(); i++) {
+        T* item = table.at(i);
+        if (!item) {
+            continue;
+        }
+
+        // There are more objects, the cursor of next page is the last dumped one.
+        if (nn >= page->count) {
+            page->next = last;
+            break;
+        }
+
+        item->dumps(w, page->fields, now);
+        last = item->seq;
+        nn++;
+    }
+
+    w->end_array();
+}
+
+void SrsStatistic::dumps_streams(SrsJsonWriter* w, SrsStatisticPage* page)
+{
+    srs_stat_dumps_page(stream_table, w, page);
+}
+
+void SrsStatistic::dumps_clients(SrsJsonWriter* w, SrsStatisticPage* page)
+{
+    srs_stat_dumps_page(client_table, w, page);
+}
+
+int SrsStatistic::nb_streams()
+{
+    return stream_table.size();
+}
+
+int SrsStatistic::nb_clients()
+{
+    return client_table.size();
+}
+
+void SrsStatistic::collect(SrsMetrics* metrics)
+{
+    metrics->gauge("srs_streams", "The number of streams.")->get()->set(stream_table.size());
+    metrics->gauge("srs_clients", "The number of clients.")->get()->set(client_table.size());
+
+    // The streams might be removed, so we reset the series before collecting.
+    SrsMetric* clients = metrics->gauge("srs_stream_clients", "The number of clients of stream.");
+    SrsMetric* frames = metrics->counter("srs_stream_frames_total", "The number of video frames of stream.");
+    SrsMetric* sent = metrics->counter("srs_stream_send_bytes_total", "The bytes sent of stream.");
+    SrsMetric* recv = metrics->counter("srs_stream_recv_bytes_total", "The bytes received of stream.");
+    clients->reset();
+    frames->reset();
+    sent->reset();
+    recv->reset();
+
+    // The overflow series sums up the closed streams and the alive streams in it, so it never decreases.
+    int nn_overflows = 0;
+    int nb_clients = 0;
+    uint64_t nb_frames = overflow_frames;
+    uint64_t send_bytes = overflow_send_bytes;
+    uint64_t recv_bytes = overflow_recv_bytes;
+
+    // Collect the streams which already have series first, so they always keep their own series,
+    // then the new streams, which go to the overflow series if exceed the max series.
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < stream_table.slots(); i++) {
+            SrsStatisticStream* stream = stream_table.at(i);
+            if (!stream) {
+                continue;
+            }
+
+            bool has_series = stream->metrics_collected && !stream->metrics_overflow;
+            if (has_series != (pass == 0)) {
+                continue;
+            }
+
+            string labels = srs_metrics_label("vhost", stream->vhost->vhost);
+            labels += "," + srs_metrics_label("app", stream->app);
+            labels += "," + srs_metrics_label("stream", stream->stream);
+
+            // Once in the overflow series, the stream never gets its own series.
+            if (!stream->metrics_overflow) {
+                stream->metrics_collected = true;
+                stream->metrics_overflow = (frames->with(labels)->labels != labels);
+            }
+
+            if (stream->metrics_overflow) {
+                nn_overflows++;
+                nb_clients += stream->nb_clients;
+                nb_frames += stream->nb_frames;
+                send_bytes += stream->kbps->get_send_bytes();
+                recv_bytes += stream->kbps->get_recv_bytes();
+                continue;
+            }
+
+            clients->with(labels)->set(stream->nb_clients);
+            frames->with(labels)->set((double)stream->nb_frames);
+            sent->with(labels)->set((double)stream->kbps->get_send_bytes());
+            recv->with(labels)->set((double)stream->kbps->get_recv_bytes());
+        }
+    }
+
+    if (nn_overflows > 0 || nb_frames > 0 || send_bytes > 0 || recv_bytes > 0) {
+        clients->overflow()->set(nb_clients);
+        frames->overflow()->set((double)nb_frames);
+        sent->overflow()->set((double)send_bytes);
+        recv->overflow()->set((double)recv_bytes);
+    }
+}
+
+SrsStatisticLatency* SrsStatistic::latency(SrsRequest* req, SrsStatisticLatencyType type)
+{
+    SrsStatisticVhost* vhost = create_vhost(req);
+    SrsStatisticStream* stream = create_stream(vhost, req);
+
+    if (!stream->latency[type]) {
+        stream->latency[type] = new SrsStatisticLatency();
+    }
+    return stream->latency[type];
+}
+
 SrsStatisticVhost* SrsStatistic::create_vhost(SrsRequest* req)
 {
     SrsStatisticVhost* vhost = NULL;
@@ -574,6 +1011,7 @@ SrsStatisticStream* SrsStatistic::create_stream(SrsStatisticVhost* vhost, SrsReq
         stream->url = url;
         rstreams[url] = stream;
         streams[stream->id] = stream;
+        stream_table.insert(stream);
         return stream;
     }
     
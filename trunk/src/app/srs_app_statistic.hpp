@@ -12,9 +12,12 @@
 #include <map>
 #include <string>
 #include <vector>
+#include <algorithm>
 
 #include <srs_kernel_codec.hpp>
 #include <srs_protocol_rtmp_stack.hpp>
+#include <srs_kernel_kbps.hpp>
+#include <srs_app_metrics.hpp>
 
 class SrsKbps;
 class SrsWallClock;
@@ -22,7 +25,53 @@ class SrsRequest;
 class ISrsExpire;
 class SrsJsonObject;
 class SrsJsonArray;
+class SrsJsonWriter;
 class ISrsKbpsDelta;
+class SrsSharedPtrMessage;
+
+// The fields of stream to dump, the mask of SrsStatisticStream::dumps.
+enum SrsStatisticStreamField
+{
+    SrsStatisticStreamFieldId = 1 << 0,
+    SrsStatisticStreamFieldName = 1 << 1,
+    SrsStatisticStreamFieldVhost = 1 << 2,
+    SrsStatisticStreamFieldApp = 1 << 3,
+    SrsStatisticStreamFieldLiveMs = 1 << 4,
+    SrsStatisticStreamFieldClients = 1 << 5,
+    SrsStatisticStreamFieldFrames = 1 << 6,
+    SrsStatisticStreamFieldSendBytes = 1 << 7,
+    SrsStatisticStreamFieldRecvBytes = 1 << 8,
+    SrsStatisticStreamFieldKbps = 1 << 9,
+    SrsStatisticStreamFieldPublish = 1 << 10,
+    SrsStatisticStreamFieldVideo = 1 << 11,
+    SrsStatisticStreamFieldAudio = 1 << 12,
+    SrsStatisticStreamFieldLatency = 1 << 13,
+};
+
+// The fields of client to dump, the mask of SrsStatisticClient::dumps.
+enum SrsStatisticClientField
+{
+    SrsStatisticClientFieldId = 1 << 0,
+    SrsStatisticClientFieldVhost = 1 << 1,
+    SrsStatisticClientFieldStream = 1 << 2,
+    SrsStatisticClientFieldIp = 1 << 3,
+    SrsStatisticClientFieldPageUrl = 1 << 4,
+    SrsStatisticClientFieldSwfUrl = 1 << 5,
+    SrsStatisticClientFieldTcUrl = 1 << 6,
+    SrsStatisticClientFieldUrl = 1 << 7,
+    SrsStatisticClientFieldType = 1 << 8,
+    SrsStatisticClientFieldPublish = 1 << 9,
+    SrsStatisticClientFieldAlive = 1 << 10,
+    SrsStatisticClientFieldBwe = 1 << 11,
+};
+
+// All fields of stream or client.
+#define SRS_STAT_FIELDS_ALL 0xffffffff
+
+// Parse the fields such as "id,name,clients" to mask of stream or client, return
+// SRS_STAT_FIELDS_ALL if empty. The unknown field is ignored.
+extern uint32_t srs_stat_stream_fields(std::string fields);
+extern uint32_t srs_stat_client_fields(std::string fields);
 
 struct SrsStatisticVhost
 {
@@ -42,6 +91,33 @@ public:
     virtual srs_error_t dumps(SrsJsonObject* obj);
 };
 
+// The type of consumers, to stat the latency of each type.
+enum SrsStatisticLatencyType
+{
+    SrsStatisticLatencyTypeRtmp = 0,
+    // The HTTP stream, such as HTTP-FLV, HTTP-TS, HTTP-AAC and HTTP-MP3.
+    SrsStatisticLatencyTypeHttp = 1,
+    SrsStatisticLatencyTypeRtc = 2,
+    SrsStatisticLatencyTypeMax = 3,
+};
+
+// The latency of a type of consumers of stream, from the time the message is received.
+class SrsStatisticLatency
+{
+public:
+    // The latency when message is dequeued from the queue of consumer.
+    SrsLatencyHistogram queue;
+    // The latency when message is written to socket.
+    SrsLatencyHistogram send;
+    // The difference of send latency between consecutive messages of a consumer.
+    SrsLatencyHistogram jitter;
+public:
+    SrsStatisticLatency();
+    virtual ~SrsStatisticLatency();
+public:
+    virtual void dumps(SrsJsonWriter* w);
+};
+
 struct SrsStatisticStream
 {
 public:
@@ -79,11 +155,25 @@ public:
     // 1.5.1.1 Audio object type definition, page 23,
     //           in ISO_IEC_14496-3-AAC-2001.pdf.
     SrsAacObjectType aac_object;
+public:
+    // The latency of each type of consumers, NULL if never recorded.
+    SrsStatisticLatency* latency[SrsStatisticLatencyTypeMax];
+public:
+    // The sequence and slot in table, see SrsStatisticTable.
+    uint64_t seq;
+    int slot;
+public:
+    // Whether collected to metrics, and whether aggregated to the overflow series. A stream in the
+    // overflow series never gets its own series, to keep the counters of overflow series monotonic.
+    bool metrics_collected;
+    bool metrics_overflow;
 public:
     SrsStatisticStream();
     virtual ~SrsStatisticStream();
 public:
     virtual srs_error_t dumps(SrsJsonObject* obj);
+    // Dumps the fields to writer, the now is the current time.
+    virtual void dumps(SrsJsonWriter* w, uint32_t fields, srs_utime_t now);
 public:
     // Publish the stream, id is the publisher.
     virtual void publish(std::string id);
@@ -100,14 +190,151 @@ public:
     SrsRtmpConnType type;
     std::string id;
     srs_utime_t create;
+    // The estimated bandwidth in kbps by send-side BWE of RTC player, zero if unknown.
+    int bwe;
+public:
+    // The sequence and slot in table, see SrsStatisticTable.
+    uint64_t seq;
+    int slot;
 public:
     SrsStatisticClient();
     virtual ~SrsStatisticClient();
 public:
     virtual srs_error_t dumps(SrsJsonObject* obj);
+    // Dumps the fields to writer, the now is the current time.
+    virtual void dumps(SrsJsonWriter* w, uint32_t fields, srs_utime_t now);
 };
 
-class SrsStatistic
+// The recorder of latency for a consumer, which stamps the messages when dequeued from
+// the queue of consumer, and when written to socket, see SrsStatisticLatency.
+// @remark Disabled if stats.latency is off, so it's free to call it.
+class SrsStatisticLatencyRecorder
+{
+private:
+    SrsStatisticLatency* latency_;
+    // The ingress time of messages, which are dequeued but not sent.
+    std::vector<srs_utime_t> ingresses_;
+    // The send latency of last message, to calculate the jitter.
+    srs_utime_t last_;
+public:
+    SrsStatisticLatencyRecorder();
+    virtual ~SrsStatisticLatencyRecorder();
+public:
+    // Initialize the recorder for the stream and the type of consumer.
+    virtual void initialize(SrsRequest* req, SrsStatisticLatencyType type);
+    // When messages are dequeued from the queue of consumer.
+    virtual void on_dequeue(SrsSharedPtrMessage** msgs, int count);
+    // When a packet is dequeued, with the ingress time of it.
+    virtual void on_dequeue(srs_utime_t ingress);
+    // When the dequeued messages are written to socket.
+    virtual void on_sent();
+    // When the dequeued messages are dropped, for example, failed to send.
+    virtual void on_discard();
+};
+
+// The flat table of stat objects, in the order of insert, to iterate in a cache-friendly
+// way and to page by cursor. Each object is assigned an increasing seq when inserted, and
+// the cursor is the seq of last object of previous page, which is stable when objects
+// are removed between polls. The T must have fields seq and slot.
+// @remark The removed object leaves a hole, which is compacted when too many holes.
+template<typename T>
+class SrsStatisticTable
+{
+private:
+    uint64_t next_seq_;
+    int nn_holes_;
+    // The objects and the seqs of them, in the same slot, the seq is kept for holes.
+    std::vector<T*> items_;
+    std::vector<uint64_t> seqs_;
+public:
+    SrsStatisticTable() {
+        next_seq_ = 1;
+        nn_holes_ = 0;
+    }
+    virtual ~SrsStatisticTable() {
+    }
+public:
+    // Insert object to the end of table, assign the seq and slot.
+    void insert(T* item) {
+        item->seq = next_seq_++;
+        item->slot = (int)items_.size();
+        items_.push_back(item);
+        seqs_.push_back(item->seq);
+    }
+    // Remove the object from table, leave a hole in its slot.
+    void remove(T* item) {
+        int slot = item->slot;
+        if (slot < 0 || slot >= (int)items_.size() || items_[slot] != item) {
+            return;
+        }
+
+        items_[slot] = NULL;
+        item->slot = -1;
+        nn_holes_++;
+
+        if (nn_holes_ > 64 && nn_holes_ > (int)items_.size() / 2) {
+            compact();
+        }
+    }
+    // The number of objects, not including the holes.
+    int size() {
+        return (int)items_.size() - nn_holes_;
+    }
+    // The number of slots, including the holes.
+    int slots() {
+        return (int)items_.size();
+    }
+    // Get the object at slot, NULL for hole.
+    T* at(int slot) {
+        return items_[slot];
+    }
+    // Get the first slot after the cursor seq.
+    int after(uint64_t cursor) {
+        return (int)(std::upper_bound(seqs_.begin(), seqs_.end(), cursor) - seqs_.begin());
+    }
+private:
+    void compact() {
+        int j = 0;
+        for (int i = 0; i < (int)items_.size(); i++) {
+            T* item = items_[i];
+            if (!item) {
+                continue;
+            }
+
+            item->slot = j;
+            items_[j] = item;
+            seqs_[j] = seqs_[i];
+            j++;
+        }
+
+        items_.resize(j);
+        seqs_.resize(j);
+        nn_holes_ = 0;
+    }
+};
+
+// The page to dump streams or clients.
+struct SrsStatisticPage
+{
+public:
+    // Whether page by cursor, or by start index.
+    bool by_cursor;
+    // The seq of last object in previous page, 0 for the first page.
+    uint64_t cursor;
+    // The start index, from 0, when not by cursor.
+    int start;
+    // The max count of objects to dump.
+    int count;
+    // The fields to dump, see SrsStatisticStreamField and SrsStatisticClientField.
+    uint32_t fields;
+public:
+    // The cursor for next page, 0 if no more objects.
+    uint64_t next;
+public:
+    SrsStatisticPage();
+};
+
+class SrsStatistic : public ISrsMetricsCollector
 {
 private:
     static SrsStatistic *_instance;
@@ -125,9 +352,17 @@ private:
     // The key: stream url, value: stream Object.
     // @remark a fast index for streams.
     std::map<std::string, SrsStatisticStream*> rstreams;
+    // The flat table of streams, to iterate and page.
+    SrsStatisticTable<SrsStatisticStream> stream_table;
+    // The final values of the closed streams in the overflow series of metrics.
+    uint64_t overflow_frames;
+    uint64_t overflow_send_bytes;
+    uint64_t overflow_recv_bytes;
 private:
     // The key: client id, value: stream object.
     std::map<std::string, SrsStatisticClient*> clients;
+    // The flat table of clients, to iterate and page.
+    SrsStatisticTable<SrsStatisticClient> client_table;
     // The server total kbps.
     SrsKbps* kbps;
     SrsWallClock* clk;
@@ -169,6 +404,8 @@ public:
     //      only got the request object, so the client specified by id maybe not
     //      exists in stat.
     virtual void on_disconnect(std::string id);
+    // When the estimated bandwidth of client changed, in kbps.
+    virtual void on_client_bwe(std::string id, int kbps);
     // Sample the kbps, add delta bytes of conn.
     // Use kbps_sample() to get all result of kbps stat.
     virtual void kbps_add_delta(std::string id, ISrsKbpsDelta* delta);
@@ -189,6 +426,18 @@ public:
     // @param start the start index, from 0.
     // @param count the max count of clients to dump.
     virtual srs_error_t dumps_clients(SrsJsonArray* arr, int start, int count);
+    // Dumps the page of streams to writer, as an array, and update the next cursor of page.
+    virtual void dumps_streams(SrsJsonWriter* w, SrsStatisticPage* page);
+    // Dumps the page of clients to writer, as an array, and update the next cursor of page.
+    virtual void dumps_clients(SrsJsonWriter* w, SrsStatisticPage* page);
+    // Get the number of streams and clients.
+    virtual int nb_streams();
+    virtual int nb_clients();
+    // Get the latency of type of consumers for the stream of req, create it if not exists.
+    virtual SrsStatisticLatency* latency(SrsRequest* req, SrsStatisticLatencyType type);
+// Interface ISrsMetricsCollector
+public:
+    virtual void collect(SrsMetrics* metrics);
 private:
     virtual SrsStatisticVhost* create_vhost(SrsRequest* req);
     virtual SrsStatisticStream* create_stream(SrsStatisticVhost* vhost, SrsRequest* req);
@@ -16,6 +16,9 @@
 #include <srs_app_rtc_server.hpp>
 #include <srs_app_log.hpp>
 #include <srs_app_async_call.hpp>
+#include <srs_app_http_hooks.hpp>
+#include <srs_app_metrics.hpp>
+#include <srs_app_profiler.hpp>
 #include <srs_kernel_flv.hpp>
 #include <srs_kernel_file.hpp>
 
@@ -58,6 +61,7 @@ extern SrsResourceManager* _srs_rtc_manager;
 
 extern SrsResourceManager* _srs_rtc_manager;
 extern SrsDtlsCertificate* _srs_rtc_dtls_certificate;
+extern SrsDtlsAdmission* _srs_rtc_dtls_admission;
 #endif
 
 #include <srs_protocol_kbps.hpp>
@@ -324,6 +328,7 @@ srs_error_t srs_global_initialize()
 
     _srs_rtc_manager = new SrsResourceManager("RTC", true);
     _srs_rtc_dtls_certificate = new SrsDtlsCertificate();
+    _srs_rtc_dtls_admission = new SrsDtlsAdmission();
 #endif
 
     // Initialize global pps, which depends on _srs_clock
@@ -433,6 +438,15 @@ srs_error_t srs_global_initialize()
     // Create global async worker for DVR.
     _srs_dvr_async = new SrsAsyncCallWorker();
 
+    // The dispatcher for HTTP hooks.
+    _srs_hooks = new SrsHttpHooksDispatcher();
+
+    // The registry of metrics for exporter.
+    _srs_metrics = new SrsMetrics();
+
+    // The CPU profiler, started by API.
+    _srs_cpu_profiler = new SrsCpuProfiler();
+
     return err;
 }
 
@@ -100,6 +100,8 @@
 #define ERROR_THREAD_CREATE                 1082
 #define ERROR_THREAD_FINISHED               1083
 #define ERROR_SYSTEM_LOGFILE                1084
+#define ERROR_SYSTEM_FILE_MMAP              1085
+#define ERROR_SYSTEM_PROFILER               1086
 
 ///////////////////////////////////////////////////////
 // RTMP protocol error.
@@ -10,18 +10,26 @@
 #ifndef _WIN32
 #include <unistd.h>
 #include <sys/uio.h>
+#include <sys/mman.h>
 #endif
 
 #include <fcntl.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
 #include <sstream>
 using namespace std;
 
 #include <srs_kernel_log.hpp>
 #include <srs_kernel_error.hpp>
+#include <srs_kernel_utility.hpp>
 
 // For utest to mock it.
 srs_open_t _srs_open_fn = ::open;
 srs_write_t _srs_write_fn = ::write;
+srs_writev_t _srs_writev_fn = ::writev;
 srs_read_t _srs_read_fn = ::read;
 srs_lseek_t _srs_lseek_fn = ::lseek;
 srs_close_t _srs_close_fn = ::close;
@@ -29,11 +37,66 @@ srs_close_t _srs_close_fn = ::close;
 SrsFileWriter::SrsFileWriter()
 {
     fd = -1;
+    iobuf_ = NULL;
+    iobuf_size_ = 0;
+    nb_iobuf_ = 0;
+    pos_ = 0;
+    preallocate_ = 0;
+    direct_io_ = false;
+    direct_enabled_ = false;
 }
 
 SrsFileWriter::~SrsFileWriter()
 {
     close();
+    
+    // The iobuf is allocated by posix_memalign, for O_DIRECT.
+    ::free(iobuf_);
+}
+
+srs_error_t SrsFileWriter::set_iobuf_size(int size)
+{
+    if (fd > 0) {
+        return srs_error_new(ERROR_SYSTEM_FILE_ALREADY_OPENED, "file %s already opened", path.c_str());
+    }
+    
+    // Align the size, because O_DIRECT requires the size of write to be aligned.
+    if (size > 0) {
+        size = (size + SRS_FILE_DIRECT_ALIGN - 1) / SRS_FILE_DIRECT_ALIGN * SRS_FILE_DIRECT_ALIGN;
+    }
+    
+    // Ignore if size not changed.
+    if (size == iobuf_size_) {
+        return srs_success;
+    }
+    
+    ::free(iobuf_);
+    iobuf_ = NULL;
+    iobuf_size_ = 0;
+    
+    if (size <= 0) {
+        return srs_success;
+    }
+    
+    void* buf = NULL;
+    if (::posix_memalign(&buf, SRS_FILE_DIRECT_ALIGN, size) != 0) {
+        return srs_error_new(ERROR_SYSTEM_FILE_WRITE, "alloc iobuf size=%d", size);
+    }
+    
+    iobuf_ = (char*)buf;
+    iobuf_size_ = size;
+    
+    return srs_success;
+}
+
+void SrsFileWriter::set_preallocate(int64_t size)
+{
+    preallocate_ = size;
+}
+
+void SrsFileWriter::set_direct_io(bool v)
+{
+    direct_io_ = v;
 }
 
 srs_error_t SrsFileWriter::open(string p)
@@ -45,13 +108,19 @@ srs_error_t SrsFileWriter::open(string p)
     }
     
     int flags = O_CREAT|O_WRONLY|O_TRUNC;
-    mode_t mode = S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH;
-    
-    if ((fd = _srs_open_fn(p.c_str(), flags, mode)) < 0) {
-        return srs_error_new(ERROR_SYSTEM_FILE_OPENE, "open file %s failed", p.c_str());
+    if ((err = do_open(p, flags)) != srs_success) {
+        return srs_error_wrap(err, "open");
     }
     
-    path = p;
+    pos_ = 0;
+    
+#if !defined(_WIN32) && !defined(SRS_OSX)
+    // Preallocate the space, without changing the file size, so the file is
+    // still valid even when crash, and we release the unused space when close.
+    if (preallocate_ > 0 && ::fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, (off_t)preallocate_) < 0) {
+        srs_warn("fallocate file %s size=%" PRId64 " failed, errno=%d", p.c_str(), preallocate_, errno);
+    }
+#endif
     
     return err;
 }
@@ -65,27 +134,77 @@ srs_error_t SrsFileWriter::open_append(string p)
     }
     
     int flags = O_CREAT|O_APPEND|O_WRONLY;
+    if ((err = do_open(p, flags)) != srs_success) {
+        return srs_error_wrap(err, "open append");
+    }
+    
+    // The writes are always appended to the end, so we start from the end.
+    if (iobuf_) {
+        pos_ = (int64_t)_srs_lseek_fn(fd, 0, SEEK_END);
+    }
+    
+    return err;
+}
+
+srs_error_t SrsFileWriter::do_open(string p, int flags)
+{
     mode_t mode = S_IRUSR|S_IWUSR|S_IRGRP|S_IWGRP|S_IROTH;
     
+    nb_iobuf_ = 0;
+    direct_enabled_ = false;
+    
+#if !defined(_WIN32) && !defined(SRS_OSX)
+    // O_DIRECT requires aligned offset, so never use it for append mode.
+    if (direct_io_ && iobuf_ && (flags & O_APPEND) == 0) {
+        if ((fd = _srs_open_fn(p.c_str(), flags|O_DIRECT, mode)) >= 0) {
+            direct_enabled_ = true;
+            path = p;
+            return srs_success;
+        }
+        
+        // Some filesystem such as tmpfs doesn't support O_DIRECT, fallback to normal IO.
+        srs_warn("open file %s with O_DIRECT failed, errno=%d, fallback", p.c_str(), errno);
+    }
+#endif
+    
     if ((fd = _srs_open_fn(p.c_str(), flags, mode)) < 0) {
         return srs_error_new(ERROR_SYSTEM_FILE_OPENE, "open file %s failed", p.c_str());
     }
     
     path = p;
     
-    return err;
+    return srs_success;
 }
 
 void SrsFileWriter::close()
 {
+    srs_error_t err = srs_success;
+    
     if (fd < 0) {
         return;
     }
     
+    if ((err = flush()) != srs_success) {
+        srs_warn("flush file %s failed, err is %s", path.c_str(), srs_error_desc(err).c_str());
+        srs_freep(err);
+    }
+    
+#if !defined(_WIN32) && !defined(SRS_OSX)
+    // Release the preallocated space beyond the end of file.
+    if (preallocate_ > 0) {
+        off_t size = _srs_lseek_fn(fd, 0, SEEK_END);
+        if (size >= 0 && ::ftruncate(fd, size) < 0) {
+            srs_warn("truncate file %s size=%d failed", path.c_str(), (int)size);
+        }
+    }
+#endif
+    
     if (_srs_close_fn(fd) < 0) {
         srs_warn("close file %s failed", path.c_str());
     }
     fd = -1;
+    nb_iobuf_ = 0;
+    direct_enabled_ = false;
     
     return;
 }
@@ -97,19 +216,99 @@ bool SrsFileWriter::is_open()
 
 void SrsFileWriter::seek2(int64_t offset)
 {
-    off_t r0 = _srs_lseek_fn(fd, (off_t)offset, SEEK_SET);
-    srs_assert(r0 != -1);
+    off_t r0 = -1;
+    srs_error_t err = lseek((off_t)offset, SEEK_SET, &r0);
+    srs_assert(err == srs_success && r0 != -1);
 }
 
 int64_t SrsFileWriter::tellg()
 {
+    if (iobuf_) {
+        return pos_ + nb_iobuf_;
+    }
+    
     return (int64_t)_srs_lseek_fn(fd, 0, SEEK_CUR);
 }
 
+srs_error_t SrsFileWriter::flush()
+{
+    srs_error_t err = srs_success;
+    
+    if (!iobuf_ || nb_iobuf_ <= 0) {
+        return err;
+    }
+    
+    // The tail of iobuf is not aligned, so we must disable O_DIRECT to write it, and
+    // never enable it again because the offset of file is not aligned any more.
+    if (direct_enabled_ && (nb_iobuf_ % SRS_FILE_DIRECT_ALIGN) != 0) {
+        if ((err = disable_direct_io()) != srs_success) {
+            return srs_error_wrap(err, "disable direct io");
+        }
+    }
+    
+    iovec iov;
+    iov.iov_base = iobuf_;
+    iov.iov_len = nb_iobuf_;
+    if ((err = do_writev(&iov, 1)) != srs_success) {
+        return srs_error_wrap(err, "flush %d bytes", nb_iobuf_);
+    }
+    
+    pos_ += nb_iobuf_;
+    nb_iobuf_ = 0;
+    
+    return err;
+}
+
+srs_error_t SrsFileWriter::do_writev(iovec* iov, int iovcnt)
+{
+    // Write all data, because the write to file might be partial, for example, when interrupted.
+    while (iovcnt > 0) {
+        ssize_t nwrite = _srs_writev_fn(fd, iov, srs_min(iovcnt, IOV_MAX));
+        if (nwrite < 0) {
+            return srs_error_new(ERROR_SYSTEM_FILE_WRITE, "writev to file %s failed", path.c_str());
+        }
+        
+        // Skip the written iovs, and adjust the partial written one.
+        while (iovcnt > 0 && nwrite >= (ssize_t)iov->iov_len) {
+            nwrite -= (ssize_t)iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0 && nwrite > 0) {
+            iov->iov_base = (char*)iov->iov_base + nwrite;
+            iov->iov_len -= nwrite;
+        }
+    }
+    
+    return srs_success;
+}
+
+srs_error_t SrsFileWriter::disable_direct_io()
+{
+#if !defined(_WIN32) && !defined(SRS_OSX)
+    int flags = ::fcntl(fd, F_GETFL);
+    if (flags < 0 || ::fcntl(fd, F_SETFL, flags & ~O_DIRECT) < 0) {
+        return srs_error_new(ERROR_SYSTEM_FILE_WRITE, "clear O_DIRECT of %s", path.c_str());
+    }
+#endif
+    
+    direct_enabled_ = false;
+    
+    return srs_success;
+}
+
 srs_error_t SrsFileWriter::write(void* buf, size_t count, ssize_t* pnwrite)
 {
     srs_error_t err = srs_success;
     
+    // Coalesce to iobuf, by writev.
+    if (iobuf_) {
+        iovec iov;
+        iov.iov_base = buf;
+        iov.iov_len = count;
+        return writev(&iov, 1, pnwrite);
+    }
+    
     ssize_t nwrite;
     // TODO: FIXME: use st_write.
 #ifdef _WIN32
@@ -133,12 +332,56 @@ srs_error_t SrsFileWriter::writev(const iovec* iov, int iovcnt, ssize_t* pnwrite
     
     ssize_t nwrite = 0;
     for (int i = 0; i < iovcnt; i++) {
-        const iovec* piov = iov + i;
-        ssize_t this_nwrite = 0;
-        if ((err = write(piov->iov_base, piov->iov_len, &this_nwrite)) != srs_success) {
-            return srs_error_wrap(err, "write file");
+        nwrite += (ssize_t)iov[i].iov_len;
+    }
+    
+    // Without iobuf, write each iov to file.
+    if (!iobuf_) {
+        nwrite = 0;
+        for (int i = 0; i < iovcnt; i++) {
+            const iovec* piov = iov + i;
+            ssize_t this_nwrite = 0;
+            if ((err = write(piov->iov_base, piov->iov_len, &this_nwrite)) != srs_success) {
+                return srs_error_wrap(err, "write file");
+            }
+            nwrite += this_nwrite;
+        }
+    } else if (nb_iobuf_ + nwrite <= iobuf_size_) {
+        // Enough space in iobuf, copy to it.
+        for (int i = 0; i < iovcnt; i++) {
+            memcpy(iobuf_ + nb_iobuf_, iov[i].iov_base, iov[i].iov_len);
+            nb_iobuf_ += (int)iov[i].iov_len;
+        }
+    } else if (direct_enabled_) {
+        // For O_DIRECT, we always fill the iobuf and write it out, to keep the size aligned.
+        for (int i = 0; i < iovcnt; i++) {
+            char* p = (char*)iov[i].iov_base;
+            size_t left = iov[i].iov_len;
+            while (left > 0) {
+                size_t size = srs_min(left, (size_t)(iobuf_size_ - nb_iobuf_));
+                memcpy(iobuf_ + nb_iobuf_, p, size);
+                nb_iobuf_ += (int)size;
+                p += size;
+                left -= size;
+                
+                if (nb_iobuf_ == iobuf_size_ && (err = flush()) != srs_success) {
+                    return srs_error_wrap(err, "flush");
+                }
+            }
         }
-        nwrite += this_nwrite;
+    } else {
+        // Coalesce the iobuf and data to one writev.
+        iovs_.resize(iovcnt + 1);
+        iovs_[0].iov_base = iobuf_;
+        iovs_[0].iov_len = nb_iobuf_;
+        memcpy(&iovs_[1], iov, sizeof(iovec) * iovcnt);
+        
+        if ((err = do_writev(&iovs_[0], iovcnt + 1)) != srs_success) {
+            return srs_error_wrap(err, "writev");
+        }
+        
+        pos_ += nb_iobuf_ + nwrite;
+        nb_iobuf_ = 0;
     }
     
     if (pnwrite) {
@@ -150,16 +393,41 @@ srs_error_t SrsFileWriter::writev(const iovec* iov, int iovcnt, ssize_t* pnwrite
 
 srs_error_t SrsFileWriter::lseek(off_t offset, int whence, off_t* seeked)
 {
+    srs_error_t err = srs_success;
+    
+    if (iobuf_) {
+        // Query the current position, no need to flush, for example, by the MP4 muxer for each sample.
+        if (offset == 0 && whence == SEEK_CUR) {
+            if (seeked) {
+                *seeked = (off_t)(pos_ + nb_iobuf_);
+            }
+            return err;
+        }
+        
+        if ((err = flush()) != srs_success) {
+            return srs_error_wrap(err, "flush");
+        }
+    }
+    
     off_t sk = _srs_lseek_fn(fd, offset, whence);
     if (sk < 0) {
         return srs_error_new(ERROR_SYSTEM_FILE_SEEK, "seek file");
     }
     
+    if (iobuf_) {
+        pos_ = sk;
+        
+        // Once seek to unaligned offset, disable O_DIRECT.
+        if (direct_enabled_ && (sk % SRS_FILE_DIRECT_ALIGN) != 0 && (err = disable_direct_io()) != srs_success) {
+            return srs_error_wrap(err, "disable direct io");
+        }
+    }
+    
     if (seeked) {
         *seeked = sk;
     }
     
-    return srs_success;
+    return err;
 }
 
 ISrsFileReaderFactory::ISrsFileReaderFactory()
@@ -218,6 +486,11 @@ void SrsFileReader::close()
     return;
 }
 
+int SrsFileReader::get_fd()
+{
+    return fd;
+}
+
 bool SrsFileReader::is_open()
 {
     return fd > 0;
@@ -289,3 +562,103 @@ srs_error_t SrsFileReader::lseek(off_t offset, int whence, off_t* seeked)
     return srs_success;
 }
 
+
+SrsFileMmap::SrsFileMmap()
+{
+    fd = -1;
+    data_ = NULL;
+    size_ = 0;
+    mtime_ = 0;
+    inode_ = 0;
+}
+
+SrsFileMmap::~SrsFileMmap()
+{
+    close();
+}
+
+srs_error_t SrsFileMmap::open(string p)
+{
+    srs_error_t err = srs_success;
+    
+    if (fd > 0) {
+        return srs_error_new(ERROR_SYSTEM_FILE_ALREADY_OPENED, "file %s already opened", path.c_str());
+    }
+    
+    if ((fd = _srs_open_fn(p.c_str(), O_RDONLY)) < 0) {
+        return srs_error_new(ERROR_SYSTEM_FILE_OPENE, "open file %s failed", p.c_str());
+    }
+    
+    path = p;
+    
+    struct stat st;
+    if (::fstat(fd, &st) < 0) {
+        return srs_error_new(ERROR_SYSTEM_FILE_MMAP, "stat file %s failed", p.c_str());
+    }
+    
+    size_ = (int64_t)st.st_size;
+    mtime_ = (int64_t)st.st_mtime;
+    inode_ = (uint64_t)st.st_ino;
+    
+    // The mmap fails for empty file.
+    if (size_ <= 0) {
+        return err;
+    }
+    
+#ifndef _WIN32
+    void* addr = ::mmap(NULL, (size_t)size_, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        return srs_error_new(ERROR_SYSTEM_FILE_MMAP, "mmap file %s size=%" PRId64 " failed", p.c_str(), size_);
+    }
+    data_ = (char*)addr;
+    
+#ifndef SRS_OSX
+    // Hint kernel for readahead, because the samples are read sequentially.
+    ::madvise(addr, (size_t)size_, MADV_SEQUENTIAL);
+#endif
+#else
+    return srs_error_new(ERROR_SYSTEM_FILE_MMAP, "mmap not supported");
+#endif
+    
+    return err;
+}
+
+void SrsFileMmap::close()
+{
+#ifndef _WIN32
+    if (data_) {
+        ::munmap(data_, (size_t)size_);
+    }
+#endif
+    data_ = NULL;
+    size_ = 0;
+    
+    if (fd < 0) {
+        return;
+    }
+    
+    if (_srs_close_fn(fd) < 0) {
+        srs_warn("close file %s failed", path.c_str());
+    }
+    fd = -1;
+}
+
+char* SrsFileMmap::data()
+{
+    return data_;
+}
+
+int64_t SrsFileMmap::size()
+{
+    return size_;
+}
+
+int64_t SrsFileMmap::mtime()
+{
+    return mtime_;
+}
+
+uint64_t SrsFileMmap::inode()
+{
+    return inode_;
+}
@@ -12,6 +12,7 @@
 #include <srs_kernel_io.hpp>
 
 #include <string>
+#include <vector>
 
 // for srs-librtmp, @see https://github.com/ossrs/srs/issues/213
 #ifndef _WIN32
@@ -20,17 +21,48 @@
 
 class SrsFileReader;
 
+// The alignment for O_DIRECT, which requires the buffer, size and offset aligned.
+#define SRS_FILE_DIRECT_ALIGN 4096
+
 /**
  * file writer, to write to file.
+ * @remark When iobuf is set, small writes are coalesced in userspace and flushed
+ *      by one write or writev syscall, which is useful for TS, FLV and MP4 muxers.
  */
 class SrsFileWriter : public ISrsWriteSeeker
 {
 private:
     std::string path;
     int fd;
+private:
+    // The userspace buffer to coalesce writes, NULL to write directly to fd.
+    char* iobuf_;
+    int iobuf_size_;
+    // The bytes in iobuf, not flushed to fd.
+    int nb_iobuf_;
+    // The offset of fd, where the iobuf starts. Only valid when iobuf enabled.
+    int64_t pos_;
+    // The size in bytes to preallocate by fallocate when open, 0 to disable.
+    int64_t preallocate_;
+    // Whether open file with O_DIRECT, requires iobuf.
+    bool direct_io_;
+    // Whether O_DIRECT is currently set on fd, it's cleared when writing unaligned data.
+    bool direct_enabled_;
+    // The cache for writev to coalesce the iobuf and data.
+    std::vector<iovec> iovs_;
 public:
     SrsFileWriter();
     virtual ~SrsFileWriter();
+public:
+    // Set the size of userspace buffer, 0 to disable it.
+    // @remark Must be set before open, and the size is aligned for O_DIRECT.
+    virtual srs_error_t set_iobuf_size(int size);
+    // Set the size to preallocate by fallocate when open, to avoid fragmentation.
+    // @remark The preallocated but unused space is released when close.
+    virtual void set_preallocate(int64_t size);
+    // Whether open file with O_DIRECT to bypass page cache, requires iobuf.
+    // @remark Ignore for append mode, or fallback to normal IO if not supported by filesystem.
+    virtual void set_direct_io(bool v);
 public:
     /**
      * open file writer, in truncate mode.
@@ -51,6 +83,12 @@ public:
     virtual bool is_open();
     virtual void seek2(int64_t offset);
     virtual int64_t tellg();
+    // Flush the data in iobuf to fd.
+    virtual srs_error_t flush();
+private:
+    virtual srs_error_t do_open(std::string p, int flags);
+    virtual srs_error_t do_writev(iovec* iov, int iovcnt);
+    virtual srs_error_t disable_direct_io();
 // Interface ISrsWriteSeeker
 public:
     virtual srs_error_t write(void* buf, size_t count, ssize_t* pnwrite);
@@ -97,15 +135,48 @@ public:
     virtual void skip(int64_t size);
     virtual int64_t seek2(int64_t offset);
     virtual int64_t filesize();
+    // The fd of file, -1 if not opened, for example, to sendfile.
+    virtual int get_fd();
 // Interface ISrsReadSeeker
 public:
     virtual srs_error_t read(void* buf, size_t count, ssize_t* pnread);
     virtual srs_error_t lseek(off_t offset, int whence, off_t* seeked);
 };
 
+/**
+ * The read-only memory mapped file, for VOD to serve large file without read syscall.
+ * @remark The file should not be truncated when mapped, or SIGBUS when access the data.
+ */
+class SrsFileMmap
+{
+private:
+    std::string path;
+    int fd;
+    char* data_;
+    int64_t size_;
+    // The modify time and inode of file when open, to check whether file changed.
+    int64_t mtime_;
+    uint64_t inode_;
+public:
+    SrsFileMmap();
+    virtual ~SrsFileMmap();
+public:
+    // Open and map the whole file.
+    virtual srs_error_t open(std::string p);
+    virtual void close();
+public:
+    virtual char* data();
+    virtual int64_t size();
+    // The last modify time of file in seconds.
+    virtual int64_t mtime();
+    // The inode of file, changed when file is replaced by rename.
+    virtual uint64_t inode();
+};
+
 // For utest to mock it.
 typedef int (*srs_open_t)(const char* path, int oflag, ...);
 typedef ssize_t (*srs_write_t)(int fildes, const void* buf, size_t nbyte);
+typedef ssize_t (*srs_writev_t)(int fildes, const iovec* iov, int iovcnt);
 typedef ssize_t (*srs_read_t)(int fildes, void* buf, size_t nbyte);
 typedef off_t (*srs_lseek_t)(int fildes, off_t offset, int whence);
 typedef int (*srs_close_t)(int fildes);
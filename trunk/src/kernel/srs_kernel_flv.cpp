@@ -13,6 +13,7 @@
 
 #include <fcntl.h>
 #include <sstream>
+#include <algorithm>
 using namespace std;
 
 #include <srs_kernel_log.hpp>
@@ -26,6 +27,9 @@ using namespace std;
 
 #include <srs_kernel_kbps.hpp>
 
+// The number of tags to scan, before yielding to other coroutines.
+#define SRS_FLV_VOD_INDEX_YIELD_TAGS 1024
+
 SrsPps* _srs_pps_objs_msgs = NULL;
 
 SrsMessageHeader::SrsMessageHeader()
@@ -187,6 +191,8 @@ SrsSharedPtrMessage::SrsSharedPtrPayload::SrsSharedPtrPayload()
     payload = NULL;
     size = 0;
     shared_count = 0;
+    flv_timestamp = -1;
+    ingress = 0;
 }
 
 SrsSharedPtrMessage::SrsSharedPtrPayload::~SrsSharedPtrPayload()
@@ -325,6 +331,37 @@ int SrsSharedPtrMessage::chunk_header(char* cache, int nb_cache, bool c0)
     }
 }
 
+char* SrsSharedPtrMessage::flv_tag_cache(bool* pready)
+{
+    srs_assert(ptr);
+    
+    // Hit, the tag header is generated for the same timestamp.
+    if (ptr->flv_timestamp == timestamp) {
+        *pready = true;
+        return ptr->flv_tag;
+    }
+    
+    // Miss, the caller generates the tag header for this timestamp.
+    if (ptr->flv_timestamp < 0) {
+        ptr->flv_timestamp = timestamp;
+        *pready = false;
+        return ptr->flv_tag;
+    }
+    
+    return NULL;
+}
+
+void SrsSharedPtrMessage::set_ingress(srs_utime_t v)
+{
+    srs_assert(ptr);
+    ptr->ingress = v;
+}
+
+srs_utime_t SrsSharedPtrMessage::ingress()
+{
+    return ptr ? ptr->ingress : 0;
+}
+
 SrsSharedPtrMessage* SrsSharedPtrMessage::copy()
 {
     srs_assert(ptr);
@@ -514,24 +551,33 @@ srs_error_t SrsFlvTransmuxer::write_tags(SrsSharedPtrMessage** msgs, int count)
     for (int i = 0; i < count; i++) {
         SrsSharedPtrMessage* msg = msgs[i];
         
-        // cache all flv header.
-        if (msg->is_audio()) {
-            cache_audio(msg->timestamp, msg->payload, msg->size, cache);
-        } else if (msg->is_video()) {
-            cache_video(msg->timestamp, msg->payload, msg->size, cache);
-        } else {
-            cache_metadata(SrsFrameTypeScript, msg->payload, msg->size, cache);
-        }
+        // Use the tag header shared by all writers, which is generated only once for each message.
+        bool ready = false;
+        char* shared = msg->flv_tag_cache(&ready);
         
-        // cache all pts.
-        cache_pts(SRS_FLV_TAG_HEADER_SIZE + msg->size, pts);
+        char* header = shared? shared : cache;
+        char* ts = shared? shared + SRS_FLV_TAG_HEADER_SIZE : pts;
+        
+        if (!ready) {
+            // cache all flv header.
+            if (msg->is_audio()) {
+                cache_audio(msg->timestamp, msg->payload, msg->size, header);
+            } else if (msg->is_video()) {
+                cache_video(msg->timestamp, msg->payload, msg->size, header);
+            } else {
+                cache_metadata(SrsFrameTypeScript, msg->payload, msg->size, header);
+            }
+            
+            // cache all pts.
+            cache_pts(SRS_FLV_TAG_HEADER_SIZE + msg->size, ts);
+        }
         
         // all ioves.
-        iovs[0].iov_base = cache;
+        iovs[0].iov_base = header;
         iovs[0].iov_len = SRS_FLV_TAG_HEADER_SIZE;
         iovs[1].iov_base = msg->payload;
         iovs[1].iov_len = msg->size;
-        iovs[2].iov_base = pts;
+        iovs[2].iov_base = ts;
         iovs[2].iov_len = SRS_FLV_PREVIOUS_TAG_SIZE;
         
         // move next.
@@ -914,4 +960,167 @@ srs_error_t SrsFlvVodStreamDecoder::seek2(int64_t offset)
     return err;
 }
 
+ISrsFlvVodIndexHandler::ISrsFlvVodIndexHandler()
+{
+}
+
+ISrsFlvVodIndexHandler::~ISrsFlvVodIndexHandler()
+{
+}
+
+SrsFlvVodIndex::SrsFlvVodIndex()
+{
+    memset(header_, 0, sizeof(header_));
+}
+
+SrsFlvVodIndex::~SrsFlvVodIndex()
+{
+}
+
+srs_error_t SrsFlvVodIndex::initialize(SrsFileReader* fr, ISrsFlvVodIndexHandler* handler)
+{
+    srs_error_t err = srs_success;
+    
+    int64_t size = fr->filesize();
+    if (size < (int64_t)sizeof(header_)) {
+        return srs_error_new(ERROR_KERNEL_FLV_HEADER, "flv file too small, size=%" PRId64, size);
+    }
+    
+    ssize_t nread = 0;
+    fr->seek2(0);
+    if ((err = fr->read(header_, sizeof(header_), &nread)) != srs_success) {
+        return srs_error_wrap(err, "read flv header");
+    }
+    if (nread != (ssize_t)sizeof(header_)) {
+        return srs_error_new(ERROR_KERNEL_FLV_HEADER, "read flv header %d bytes", (int)nread);
+    }
+    
+    // The sync points of video and audio, use audio only when no video.
+    std::vector<uint32_t> atimes;
+    std::vector<int64_t> aoffsets;
+    bool got_video = false, video_sh = false, audio_sh = false;
+    
+    // Read the tag header with the first 2bytes of body, which is enough to identify the
+    // keyframe and sequence header, so only one read for each tag.
+    char buf[SRS_FLV_TAG_HEADER_SIZE + 2];
+    
+    // The smallest tag, without body, is 11bytes header and 4bytes previous tag size.
+    int64_t pos = sizeof(header_);
+    for (int nn_tags = 1; pos + SRS_FLV_TAG_HEADER_SIZE + SRS_FLV_PREVIOUS_TAG_SIZE <= size; nn_tags++) {
+        if (handler && (nn_tags % SRS_FLV_VOD_INDEX_YIELD_TAGS) == 0 && (err = handler->on_scan_tags(pos)) != srs_success) {
+            return srs_error_wrap(err, "scan at %" PRId64, pos);
+        }
+
+        if (fr->seek2(pos) != pos) {
+            return srs_error_new(ERROR_SYSTEM_FILE_SEEK, "seek to %" PRId64, pos);
+        }
+        if ((err = fr->read(buf, sizeof(buf), &nread)) != srs_success) {
+            return srs_error_wrap(err, "read tag at %" PRId64, pos);
+        }
+        if (nread != (ssize_t)sizeof(buf)) {
+            break;
+        }
+        
+        SrsBuffer stream(buf, SRS_FLV_TAG_HEADER_SIZE);
+        int8_t tag_type = stream.read_1bytes() & 0x1f;
+        int32_t data_size = stream.read_3bytes();
+        uint32_t time = (uint32_t)stream.read_3bytes();
+        time |= ((uint32_t)(uint8_t)stream.read_1bytes()) << 24;
+        
+        int64_t tag_size = SRS_FLV_TAG_HEADER_SIZE + data_size + SRS_FLV_PREVIOUS_TAG_SIZE;
+        if (pos + tag_size > size) {
+            break;
+        }
+        
+        char* body = buf + SRS_FLV_TAG_HEADER_SIZE;
+        int nb_body = srs_min(data_size, 2);
+        
+        bool is_sh = false;
+        if (tag_type == RTMP_MSG_VideoMessage) {
+            got_video = true;
+            if (SrsFlvVideo::sh(body, nb_body)) {
+                is_sh = !video_sh;
+                video_sh = true;
+            } else if (SrsFlvVideo::keyframe(body, nb_body)) {
+                times_.push_back(time);
+                offsets_.push_back(pos);
+            }
+        } else if (tag_type == RTMP_MSG_AudioMessage) {
+            if (SrsFlvAudio::sh(body, nb_body)) {
+                is_sh = !audio_sh;
+                audio_sh = true;
+            } else if (!got_video) {
+                atimes.push_back(time);
+                aoffsets.push_back(pos);
+            }
+        }
+        
+        // Cache the whole tag of sequence header, to send without reading file.
+        if (is_sh) {
+            size_t start = sh_.size();
+            sh_.resize(start + tag_size);
+            fr->seek2(pos);
+            if ((err = fr->read(&sh_[start], tag_size, &nread)) != srs_success) {
+                return srs_error_wrap(err, "read sequence header at %" PRId64, pos);
+            }
+            if (nread != (ssize_t)tag_size) {
+                return srs_error_new(ERROR_SYSTEM_FILE_READ, "read sequence header %d of %" PRId64, (int)nread, tag_size);
+            }
+        }
+        
+        pos += tag_size;
+    }
+    
+    if (!got_video) {
+        times_.swap(atimes);
+        offsets_.swap(aoffsets);
+    }
+    
+    return err;
+}
+
+char* SrsFlvVodIndex::header()
+{
+    return header_;
+}
+
+vector<char>& SrsFlvVodIndex::sequence_header()
+{
+    return sh_;
+}
+
+int SrsFlvVodIndex::nb_sync_points()
+{
+    return (int)offsets_.size();
+}
+
+srs_error_t SrsFlvVodIndex::seek(uint64_t ms, int64_t* poffset)
+{
+    srs_error_t err = srs_success;
+    
+    if (offsets_.empty()) {
+        return srs_error_new(ERROR_HTTP_REMUX_OFFSET_OVERFLOW, "no sync point to seek %" PRId64 "ms", ms);
+    }
+    
+    // The timestamp in flv tag is 32bits, clamp to avoid overflow.
+    uint32_t time = (uint32_t)srs_min(ms, (uint64_t)0xffffffff);
+    
+    vector<uint32_t>::iterator it = std::upper_bound(times_.begin(), times_.end(), time);
+    size_t index = (it == times_.begin()) ? 0 : (size_t)(it - times_.begin() - 1);
+    
+    *poffset = offsets_[index];
+    return err;
+}
+
+int64_t SrsFlvVodIndex::snap(int64_t offset)
+{
+    if (offsets_.empty()) {
+        return offset;
+    }
+    
+    vector<int64_t>::iterator it = std::upper_bound(offsets_.begin(), offsets_.end(), offset);
+    size_t index = (it == offsets_.begin()) ? 0 : (size_t)(it - offsets_.begin() - 1);
+    
+    return offsets_[index];
+}
 
@@ -284,6 +284,12 @@ private:
         int size;
         // The reference count
         int shared_count;
+        // The FLV tag header and previous tag size, shared by FLV writers, for example, HTTP-FLV viewers.
+        char flv_tag[SRS_FLV_TAG_HEADER_SIZE + SRS_FLV_PREVIOUS_TAG_SIZE];
+        // The timestamp of FLV tag header, -1 if not cached.
+        int64_t flv_timestamp;
+        // The time when message is received, 0 if not stamped, for latency stat.
+        srs_utime_t ingress;
     public:
         SrsSharedPtrPayload();
         virtual ~SrsSharedPtrPayload();
@@ -324,6 +330,16 @@ public:
     // generate the chunk header to cache.
     // @return the size of header.
     virtual int chunk_header(char* cache, int nb_cache, bool c0);
+public:
+    // Get the FLV tag cache in shared payload, the 11 bytes tag header and 4 bytes previous tag size.
+    // @param pready Whether the cache is ready for the timestamp, or the caller should fill it.
+    // @return NULL if the cache is used by other timestamp, for example, the consumer with different jitter.
+    virtual char* flv_tag_cache(bool* pready);
+public:
+    // Stamp the time when message is received, shared by all copies, for latency stat.
+    virtual void set_ingress(srs_utime_t v);
+    // Get the ingress time, 0 if not stamped.
+    virtual srs_utime_t ingress();
 public:
     // copy current shared ptr message, use ref-count.
     // @remark, assert object is created.
@@ -452,5 +468,51 @@ public:
     virtual srs_error_t seek2(int64_t offset);
 };
 
+// The keyframe index of flv file, built once by scanning the tags, for vod seeking.
+// @remark The sync points are video keyframes, or audio frames for pure audio file.
+// The handler for building the index of flv file.
+class ISrsFlvVodIndexHandler
+{
+public:
+    ISrsFlvVodIndexHandler();
+    virtual ~ISrsFlvVodIndexHandler();
+public:
+    // When scanned a number of tags, to yield to other coroutines, because scanning a large file
+    // might take seconds.
+    virtual srs_error_t on_scan_tags(int64_t pos) = 0;
+};
+
+class SrsFlvVodIndex
+{
+private:
+    // The flv header, 9bytes header and 4bytes previous tag size.
+    char header_[13];
+    // The sequence header tags, each with its previous tag size.
+    std::vector<char> sh_;
+    // The timestamp in ms and the start offset of tag, of each sync point.
+    std::vector<uint32_t> times_;
+    std::vector<int64_t> offsets_;
+public:
+    SrsFlvVodIndex();
+    virtual ~SrsFlvVodIndex();
+public:
+    // Build the index by scanning the tags of file, only the sequence header is read entirely.
+    // @remark The incomplete tag at the end is ignored, for example, the file is still writing.
+    // @remark User must free the @param fr, the index never close/free it.
+    // @param handler The optional handler to yield when scanning, NULL to ignore.
+    virtual srs_error_t initialize(SrsFileReader* fr, ISrsFlvVodIndexHandler* handler = NULL);
+public:
+    // Get the flv header of 13bytes.
+    virtual char* header();
+    // Get the sequence header tags, maybe empty for codec without sequence header.
+    virtual std::vector<char>& sequence_header();
+    virtual int nb_sync_points();
+    // Find the sync point at or before the time in ms, or the first one.
+    virtual srs_error_t seek(uint64_t ms, int64_t* poffset);
+    // Snap the byte offset to the sync point at or before it, or the first one.
+    // @remark Keep the offset if no sync point, like the previous behavior.
+    virtual int64_t snap(int64_t offset);
+};
+
 #endif
 
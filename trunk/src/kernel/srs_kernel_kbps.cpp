@@ -6,6 +6,8 @@
 
 #include <srs_kernel_kbps.hpp>
 
+#include <string.h>
+
 #include <srs_kernel_utility.hpp>
 
 SrsRateSample::SrsRateSample()
@@ -91,6 +93,112 @@ int SrsPps::r10s()
     return sample_10s_.rate;
 }
 
+SrsLatencyHistogram::SrsLatencyHistogram()
+{
+    reset();
+}
+
+SrsLatencyHistogram::~SrsLatencyHistogram()
+{
+}
+
+void SrsLatencyHistogram::record(srs_utime_t v)
+{
+    if (v < 0) {
+        return;
+    }
+
+    buckets_[index_of(v)]++;
+
+    if (!count_ || v < min_) {
+        min_ = v;
+    }
+    if (v > max_) {
+        max_ = v;
+    }
+    sum_ += v;
+    count_++;
+}
+
+void SrsLatencyHistogram::reset()
+{
+    memset(buckets_, 0, sizeof(buckets_));
+    count_ = 0;
+    min_ = max_ = sum_ = 0;
+}
+
+int64_t SrsLatencyHistogram::count()
+{
+    return count_;
+}
+
+srs_utime_t SrsLatencyHistogram::min()
+{
+    return min_;
+}
+
+srs_utime_t SrsLatencyHistogram::max()
+{
+    return max_;
+}
+
+srs_utime_t SrsLatencyHistogram::mean()
+{
+    return count_ ? sum_ / count_ : 0;
+}
+
+srs_utime_t SrsLatencyHistogram::percentile(double p)
+{
+    if (!count_) {
+        return 0;
+    }
+
+    // The rank of value, from 1 to count.
+    int64_t rank = (int64_t)(p / 100.0 * count_ + 0.5);
+    rank = srs_max(1, srs_min(rank, count_));
+
+    int64_t nn = 0;
+    for (int i = 0; i < SRS_LATENCY_BUCKETS; i++) {
+        nn += buckets_[i];
+        if (nn >= rank) {
+            srs_utime_t v = (i + 1 < SRS_LATENCY_BUCKETS) ? lowest_of(i + 1) - 1 : max_;
+            return srs_min(v, max_);
+        }
+    }
+
+    return max_;
+}
+
+int SrsLatencyHistogram::index_of(srs_utime_t v)
+{
+    uint64_t u = (uint64_t)v;
+    if (u >= (1ULL << SRS_LATENCY_MAX_BITS)) {
+        return SRS_LATENCY_BUCKETS - 1;
+    }
+
+    // The small value is linear, each value is a bucket.
+    if (u < (1ULL << SRS_LATENCY_SUB_BITS)) {
+        return (int)u;
+    }
+
+    // For value in [2^msb, 2^(msb+1)), shift it to the sub-buckets in [2^SUB, 2^(SUB+1)).
+    int msb = 63 - __builtin_clzll(u);
+    int shift = msb - SRS_LATENCY_SUB_BITS;
+    int sub = (int)(u >> shift) - (1 << SRS_LATENCY_SUB_BITS);
+    return ((shift + 1) << SRS_LATENCY_SUB_BITS) + sub;
+}
+
+srs_utime_t SrsLatencyHistogram::lowest_of(int index)
+{
+    if (index < (1 << SRS_LATENCY_SUB_BITS)) {
+        return index;
+    }
+
+    int shift = (index >> SRS_LATENCY_SUB_BITS) - 1;
+    int sub = index & ((1 << SRS_LATENCY_SUB_BITS) - 1);
+    return (srs_utime_t)(((1 << SRS_LATENCY_SUB_BITS) + sub)) << shift;
+}
+
 SrsWallClock::SrsWallClock()
 {
 }
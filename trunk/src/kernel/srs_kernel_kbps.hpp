@@ -55,6 +55,44 @@ public:
     int r10s();
 };
 
+// The sub-buckets of each power of 2 for latency histogram, 2^4=16 sub-buckets,
+// so the relative error is less than 1/16, about 6%.
+#define SRS_LATENCY_SUB_BITS 4
+// The max latency in us, 2^32us is about 71 minutes, larger value is clamped.
+#define SRS_LATENCY_MAX_BITS 32
+#define SRS_LATENCY_BUCKETS ((SRS_LATENCY_MAX_BITS - SRS_LATENCY_SUB_BITS + 1) << SRS_LATENCY_SUB_BITS)
+
+// The HDR-style histogram for latency in us, with log-linear buckets, that is, each
+// power of 2 is divided into linear sub-buckets, so it's fixed memory and O(1) to record,
+// and the percentile is in a bounded relative error.
+class SrsLatencyHistogram
+{
+private:
+    int64_t buckets_[SRS_LATENCY_BUCKETS];
+    int64_t count_;
+    srs_utime_t min_;
+    srs_utime_t max_;
+    srs_utime_t sum_;
+public:
+    SrsLatencyHistogram();
+    virtual ~SrsLatencyHistogram();
+public:
+    // Record a latency in us, the negative value is ignored.
+    void record(srs_utime_t v);
+    void reset();
+    int64_t count();
+    srs_utime_t min();
+    srs_utime_t max();
+    srs_utime_t mean();
+    // Get the latency at percentile, for example, 99 for p99.
+    // @return The highest equivalent value of the bucket, which is not larger than max.
+    srs_utime_t percentile(double p);
+public:
+    // Get the bucket index of value, and the lowest value of bucket.
+    static int index_of(srs_utime_t v);
+    static srs_utime_t lowest_of(int index);
+};
+
 /**
  * A time source to provide wall clock.
  */
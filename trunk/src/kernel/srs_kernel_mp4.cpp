@@ -15,8 +15,10 @@
 #include <srs_kernel_buffer.hpp>
 
 #include <string.h>
+#include <limits.h>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
 using namespace std;
 
 // For CentOS 6 or C++98, @see https://github.com/ossrs/srs/issues/2815
@@ -1650,6 +1652,11 @@ void SrsMp4MovieExtendsBox::set_trex(SrsMp4TrackExtendsBox* v)
     boxes.push_back(v);
 }
 
+void SrsMp4MovieExtendsBox::add_trex(SrsMp4TrackExtendsBox* v)
+{
+    boxes.push_back(v);
+}
+
 SrsMp4TrackExtendsBox::SrsMp4TrackExtendsBox()
 {
     type = SrsMp4BoxTypeTREX;
@@ -5637,6 +5644,242 @@ srs_error_t SrsMp4Decoder::do_load_next_box(SrsMp4Box** ppbox, uint32_t required
     return err;
 }
 
+SrsMp4ObjectType srs_mp4_audio_object_type(SrsAudioCodecId acodec, SrsAudioSampleRate sample_rate)
+{
+    switch (acodec) {
+    case SrsAudioCodecIdAAC:
+        return SrsMp4ObjectTypeAac;
+    case SrsAudioCodecIdMP3:
+        return (srs_flv_srates[sample_rate] > 24000) ? SrsMp4ObjectTypeMp1a : SrsMp4ObjectTypeMp3;  // 11172 - 3
+    default:
+        return SrsMp4ObjectTypeForbidden;
+    }
+}
+
+SrsMp4MoovTracks::SrsMp4MoovTracks()
+{
+    vtid = atid = 0;
+    vduration = aduration = 0;
+    width = height = 0;
+    avcc = NULL;
+    acodec = SrsAudioCodecIdForbidden;
+    sample_rate = SrsAudioSampleRateForbidden;
+    sound_bits = SrsAudioSampleBitsForbidden;
+    channels = SrsAudioChannelsForbidden;
+    asc = NULL;
+}
+
+void srs_mp4_build_moov(SrsMp4MovieBox* moov, const SrsMp4MoovTracks& tracks, bool fragmented)
+{
+    SrsMp4MovieHeaderBox* mvhd = new SrsMp4MovieHeaderBox();
+    moov->set_mvhd(mvhd);
+    
+    uint64_t duration = fragmented ? 0 : srs_max(tracks.vduration, tracks.aduration);
+    uint64_t video_duration = fragmented ? 0 : tracks.vduration;
+    uint64_t audio_duration = fragmented ? 0 : tracks.aduration;
+    
+    mvhd->timescale = 1000; // Use tbn ms.
+    mvhd->duration_in_tbn = duration;
+    mvhd->next_track_ID = srs_max(tracks.vtid, tracks.atid) + 1;
+    
+    SrsMp4MovieExtendsBox* mvex = NULL;
+    if (fragmented) {
+        mvex = new SrsMp4MovieExtendsBox();
+    }
+    
+    if (tracks.vtid) {
+        SrsMp4TrackBox* trak = new SrsMp4TrackBox();
+        moov->add_trak(trak);
+        
+        if (!fragmented) {
+            SrsMp4EditBox* edts = new SrsMp4EditBox();
+            trak->set_edts(edts);
+            
+            SrsMp4EditListBox* elst = new SrsMp4EditListBox();
+            edts->set_elst(elst);
+            elst->version = 0;
+            
+            SrsMp4ElstEntry entry;
+            entry.segment_duration = duration;
+            entry.media_rate_integer = 1;
+            elst->entries.push_back(entry);
+        }
+        
+        SrsMp4TrackHeaderBox* tkhd = new SrsMp4TrackHeaderBox();
+        trak->set_tkhd(tkhd);
+        
+        tkhd->track_ID = tracks.vtid;
+        tkhd->duration = video_duration;
+        tkhd->width = (tracks.width << 16);
+        tkhd->height = (tracks.height << 16);
+        
+        SrsMp4MediaBox* mdia = new SrsMp4MediaBox();
+        trak->set_mdia(mdia);
+        
+        SrsMp4MediaHeaderBox* mdhd = new SrsMp4MediaHeaderBox();
+        mdia->set_mdhd(mdhd);
+        
+        mdhd->timescale = 1000;
+        mdhd->duration = video_duration;
+        mdhd->set_language0('u');
+        mdhd->set_language1('n');
+        mdhd->set_language2('d');
+        
+        SrsMp4HandlerReferenceBox* hdlr = new SrsMp4HandlerReferenceBox();
+        mdia->set_hdlr(hdlr);
+        
+        hdlr->handler_type = SrsMp4HandlerTypeVIDE;
+        hdlr->name = "VideoHandler";
+        
+        SrsMp4MediaInformationBox* minf = new SrsMp4MediaInformationBox();
+        mdia->set_minf(minf);
+        
+        SrsMp4VideoMeidaHeaderBox* vmhd = new SrsMp4VideoMeidaHeaderBox();
+        minf->set_vmhd(vmhd);
+        
+        SrsMp4DataInformationBox* dinf = new SrsMp4DataInformationBox();
+        minf->set_dinf(dinf);
+        
+        SrsMp4DataReferenceBox* dref = new SrsMp4DataReferenceBox();
+        dinf->set_dref(dref);
+        
+        SrsMp4DataEntryBox* url = new SrsMp4DataEntryUrlBox();
+        dref->append(url);
+        
+        SrsMp4SampleTableBox* stbl = new SrsMp4SampleTableBox();
+        minf->set_stbl(stbl);
+        
+        SrsMp4SampleDescriptionBox* stsd = new SrsMp4SampleDescriptionBox();
+        stbl->set_stsd(stsd);
+        
+        SrsMp4VisualSampleEntry* avc1 = new SrsMp4VisualSampleEntry();
+        stsd->append(avc1);
+        
+        avc1->width = tracks.width;
+        avc1->height = tracks.height;
+        avc1->data_reference_index = 1;
+        
+        SrsMp4AvccBox* avcC = new SrsMp4AvccBox();
+        avc1->set_avcC(avcC);
+        
+        avcC->avc_config = *tracks.avcc;
+        
+        // For fMP4, the sample tables are empty, samples are in moof.
+        if (fragmented) {
+            stbl->set_stts(new SrsMp4DecodingTime2SampleBox());
+            stbl->set_stsc(new SrsMp4Sample2ChunkBox());
+            stbl->set_stsz(new SrsMp4SampleSizeBox());
+            stbl->set_stco(new SrsMp4ChunkOffsetBox());
+            
+            SrsMp4TrackExtendsBox* trex = new SrsMp4TrackExtendsBox();
+            mvex->add_trex(trex);
+            
+            trex->track_ID = tracks.vtid;
+            trex->default_sample_description_index = 1;
+        }
+    }
+    
+    if (tracks.atid) {
+        SrsMp4TrackBox* trak = new SrsMp4TrackBox();
+        moov->add_trak(trak);
+        
+        SrsMp4TrackHeaderBox* tkhd = new SrsMp4TrackHeaderBox();
+        tkhd->volume = 0x0100;
+        trak->set_tkhd(tkhd);
+        
+        tkhd->track_ID = tracks.atid;
+        tkhd->duration = audio_duration;
+        
+        SrsMp4MediaBox* mdia = new SrsMp4MediaBox();
+        trak->set_mdia(mdia);
+        
+        SrsMp4MediaHeaderBox* mdhd = new SrsMp4MediaHeaderBox();
+        mdia->set_mdhd(mdhd);
+        
+        mdhd->timescale = 1000;
+        mdhd->duration = audio_duration;
+        mdhd->set_language0('u');
+        mdhd->set_language1('n');
+        mdhd->set_language2('d');
+        
+        SrsMp4HandlerReferenceBox* hdlr = new SrsMp4HandlerReferenceBox();
+        mdia->set_hdlr(hdlr);
+        
+        hdlr->handler_type = SrsMp4HandlerTypeSOUN;
+        hdlr->name = "SoundHandler";
+        
+        SrsMp4MediaInformationBox* minf = new SrsMp4MediaInformationBox();
+        mdia->set_minf(minf);
+        
+        SrsMp4SoundMeidaHeaderBox* smhd = new SrsMp4SoundMeidaHeaderBox();
+        minf->set_smhd(smhd);
+        
+        SrsMp4DataInformationBox* dinf = new SrsMp4DataInformationBox();
+        minf->set_dinf(dinf);
+        
+        SrsMp4DataReferenceBox* dref = new SrsMp4DataReferenceBox();
+        dinf->set_dref(dref);
+        
+        SrsMp4DataEntryBox* url = new SrsMp4DataEntryUrlBox();
+        dref->append(url);
+        
+        SrsMp4SampleTableBox* stbl = new SrsMp4SampleTableBox();
+        minf->set_stbl(stbl);
+        
+        SrsMp4SampleDescriptionBox* stsd = new SrsMp4SampleDescriptionBox();
+        stbl->set_stsd(stsd);
+        
+        SrsMp4AudioSampleEntry* mp4a = new SrsMp4AudioSampleEntry();
+        mp4a->data_reference_index = 1;
+        mp4a->samplerate = uint32_t(srs_flv_srates[tracks.sample_rate]) << 16;
+        if (tracks.sound_bits == SrsAudioSampleBits16bit) {
+            mp4a->samplesize = 16;
+        } else {
+            mp4a->samplesize = 8;
+        }
+        if (tracks.channels == SrsAudioChannelsStereo) {
+            mp4a->channelcount = 2;
+        } else {
+            mp4a->channelcount = 1;
+        }
+        stsd->append(mp4a);
+        
+        SrsMp4EsdsBox* esds = new SrsMp4EsdsBox();
+        mp4a->set_esds(esds);
+        
+        SrsMp4ES_Descriptor* es = esds->es;
+        es->ES_ID = 0x02;
+        
+        SrsMp4DecoderConfigDescriptor& desc = es->decConfigDescr;
+        desc.objectTypeIndication = srs_mp4_audio_object_type(tracks.acodec, tracks.sample_rate);
+        desc.streamType = SrsMp4StreamTypeAudioStream;
+        srs_freep(desc.decSpecificInfo);
+        
+        if (SrsMp4ObjectTypeAac == desc.objectTypeIndication) {
+            SrsMp4DecoderSpecificInfo* asc = new SrsMp4DecoderSpecificInfo();
+            desc.decSpecificInfo = asc;
+            asc->asc = *tracks.asc;
+        }
+        
+        if (fragmented) {
+            stbl->set_stts(new SrsMp4DecodingTime2SampleBox());
+            stbl->set_stsc(new SrsMp4Sample2ChunkBox());
+            stbl->set_stsz(new SrsMp4SampleSizeBox());
+            stbl->set_stco(new SrsMp4ChunkOffsetBox());
+            
+            SrsMp4TrackExtendsBox* trex = new SrsMp4TrackExtendsBox();
+            mvex->add_trex(trex);
+            
+            trex->track_ID = tracks.atid;
+            trex->default_sample_description_index = 1;
+        }
+    }
+    
+    if (mvex) {
+        moov->set_mvex(mvex);
+    }
+}
+
 SrsMp4Encoder::SrsMp4Encoder()
 {
     wsio = NULL;
@@ -5803,171 +6046,27 @@ srs_error_t SrsMp4Encoder::flush()
         SrsMp4MovieBox* moov = new SrsMp4MovieBox();
         SrsAutoFree(SrsMp4MovieBox, moov);
         
-        SrsMp4MovieHeaderBox* mvhd = new SrsMp4MovieHeaderBox();
-        moov->set_mvhd(mvhd);
-        
-        mvhd->timescale = 1000; // Use tbn ms.
-        mvhd->duration_in_tbn = srs_max(vduration, aduration);
-        mvhd->next_track_ID = 1; // Starts from 1, increase when use it.
-        
+        // The track id starts from 1, video first.
+        SrsMp4MoovTracks tracks;
+        uint32_t tid = 1;
         if (nb_videos || !pavcc.empty()) {
-            SrsMp4TrackBox* trak = new SrsMp4TrackBox();
-            moov->add_trak(trak);
-
-            SrsMp4EditBox* edts = new SrsMp4EditBox();
-            trak->set_edts(edts);
-
-            SrsMp4EditListBox* elst = new SrsMp4EditListBox();
-            edts->set_elst(elst);
-            elst->version = 0;
-
-            SrsMp4ElstEntry entry;
-            entry.segment_duration = mvhd->duration_in_tbn;
-            entry.media_rate_integer = 1;
-            elst->entries.push_back(entry);
-            
-            SrsMp4TrackHeaderBox* tkhd = new SrsMp4TrackHeaderBox();
-            trak->set_tkhd(tkhd);
-            
-            tkhd->track_ID = mvhd->next_track_ID++;
-            tkhd->duration = vduration;
-            tkhd->width = (width << 16);
-            tkhd->height = (height << 16);
-            
-            SrsMp4MediaBox* mdia = new SrsMp4MediaBox();
-            trak->set_mdia(mdia);
-            
-            SrsMp4MediaHeaderBox* mdhd = new SrsMp4MediaHeaderBox();
-            mdia->set_mdhd(mdhd);
-            
-            mdhd->timescale = 1000;
-            mdhd->duration = vduration;
-            mdhd->set_language0('u');
-            mdhd->set_language1('n');
-            mdhd->set_language2('d');
-            
-            SrsMp4HandlerReferenceBox* hdlr = new SrsMp4HandlerReferenceBox();
-            mdia->set_hdlr(hdlr);
-            
-            hdlr->handler_type = SrsMp4HandlerTypeVIDE;
-            hdlr->name = "VideoHandler";
-            
-            SrsMp4MediaInformationBox* minf = new SrsMp4MediaInformationBox();
-            mdia->set_minf(minf);
-            
-            SrsMp4VideoMeidaHeaderBox* vmhd = new SrsMp4VideoMeidaHeaderBox();
-            minf->set_vmhd(vmhd);
-            
-            SrsMp4DataInformationBox* dinf = new SrsMp4DataInformationBox();
-            minf->set_dinf(dinf);
-            
-            SrsMp4DataReferenceBox* dref = new SrsMp4DataReferenceBox();
-            dinf->set_dref(dref);
-            
-            SrsMp4DataEntryBox* url = new SrsMp4DataEntryUrlBox();
-            dref->append(url);
-            
-            SrsMp4SampleTableBox* stbl = new SrsMp4SampleTableBox();
-            minf->set_stbl(stbl);
-            
-            SrsMp4SampleDescriptionBox* stsd = new SrsMp4SampleDescriptionBox();
-            stbl->set_stsd(stsd);
-            
-            SrsMp4VisualSampleEntry* avc1 = new SrsMp4VisualSampleEntry();
-            stsd->append(avc1);
-            
-            avc1->width = width;
-            avc1->height = height;
-            avc1->data_reference_index = 1;
-            
-            SrsMp4AvccBox* avcC = new SrsMp4AvccBox();
-            avc1->set_avcC(avcC);
-            
-            avcC->avc_config = pavcc;
+            tracks.vtid = tid++;
         }
-        
         if (nb_audios || !pasc.empty()) {
-            SrsMp4TrackBox* trak = new SrsMp4TrackBox();
-            moov->add_trak(trak);
-            
-            SrsMp4TrackHeaderBox* tkhd = new SrsMp4TrackHeaderBox();
-            tkhd->volume = 0x0100;
-            trak->set_tkhd(tkhd);
-            
-            tkhd->track_ID = mvhd->next_track_ID++;
-            tkhd->duration = aduration;
-            
-            SrsMp4MediaBox* mdia = new SrsMp4MediaBox();
-            trak->set_mdia(mdia);
-            
-            SrsMp4MediaHeaderBox* mdhd = new SrsMp4MediaHeaderBox();
-            mdia->set_mdhd(mdhd);
-            
-            mdhd->timescale = 1000;
-            mdhd->duration = aduration;
-            mdhd->set_language0('u');
-            mdhd->set_language1('n');
-            mdhd->set_language2('d');
-            
-            SrsMp4HandlerReferenceBox* hdlr = new SrsMp4HandlerReferenceBox();
-            mdia->set_hdlr(hdlr);
-            
-            hdlr->handler_type = SrsMp4HandlerTypeSOUN;
-            hdlr->name = "SoundHandler";
-            
-            SrsMp4MediaInformationBox* minf = new SrsMp4MediaInformationBox();
-            mdia->set_minf(minf);
-            
-            SrsMp4SoundMeidaHeaderBox* smhd = new SrsMp4SoundMeidaHeaderBox();
-            minf->set_smhd(smhd);
-            
-            SrsMp4DataInformationBox* dinf = new SrsMp4DataInformationBox();
-            minf->set_dinf(dinf);
-            
-            SrsMp4DataReferenceBox* dref = new SrsMp4DataReferenceBox();
-            dinf->set_dref(dref);
-            
-            SrsMp4DataEntryBox* url = new SrsMp4DataEntryUrlBox();
-            dref->append(url);
-            
-            SrsMp4SampleTableBox* stbl = new SrsMp4SampleTableBox();
-            minf->set_stbl(stbl);
-            
-            SrsMp4SampleDescriptionBox* stsd = new SrsMp4SampleDescriptionBox();
-            stbl->set_stsd(stsd);
-            
-            SrsMp4AudioSampleEntry* mp4a = new SrsMp4AudioSampleEntry();
-            mp4a->data_reference_index = 1;
-            mp4a->samplerate = uint32_t(srs_flv_srates[sample_rate]) << 16;
-            if (sound_bits == SrsAudioSampleBits16bit) {
-                mp4a->samplesize = 16;
-            } else {
-                mp4a->samplesize = 8;
-            }
-            if (channels == SrsAudioChannelsStereo) {
-                mp4a->channelcount = 2;
-            } else {
-                mp4a->channelcount = 1;
-            }
-            stsd->append(mp4a);
-            
-            SrsMp4EsdsBox* esds = new SrsMp4EsdsBox();
-            mp4a->set_esds(esds);
-            
-            SrsMp4ES_Descriptor* es = esds->es;
-            es->ES_ID = 0x02;
-            
-            SrsMp4DecoderConfigDescriptor& desc = es->decConfigDescr;
-            desc.objectTypeIndication = get_audio_object_type();
-            desc.streamType = SrsMp4StreamTypeAudioStream;
-            srs_freep(desc.decSpecificInfo);
-            
-            if (SrsMp4ObjectTypeAac == desc.objectTypeIndication) {
-                SrsMp4DecoderSpecificInfo* asc = new SrsMp4DecoderSpecificInfo();
-                desc.decSpecificInfo = asc;
-                asc->asc = pasc;
-            }
+            tracks.atid = tid++;
         }
+        tracks.vduration = vduration;
+        tracks.aduration = aduration;
+        tracks.width = width;
+        tracks.height = height;
+        tracks.avcc = &pavcc;
+        tracks.acodec = acodec;
+        tracks.sample_rate = sample_rate;
+        tracks.sound_bits = sound_bits;
+        tracks.channels = channels;
+        tracks.asc = &pasc;
+        
+        srs_mp4_build_moov(moov, tracks, false);
         
         if ((err = samples->write(moov)) != srs_success) {
             return srs_error_wrap(err, "write samples");
@@ -6095,88 +6194,554 @@ srs_error_t SrsMp4Encoder::do_write_sample(SrsMp4Sample* ps, uint8_t* sample, ui
     return err;
 }
 
-SrsMp4ObjectType SrsMp4Encoder::get_audio_object_type()
+SrsMp4FragmentedEncoder::SrsMp4FragmentedEncoder()
 {
-    switch (acodec) {
-    case SrsAudioCodecIdAAC:
-        return SrsMp4ObjectTypeAac;
-    case SrsAudioCodecIdMP3:
-        return (srs_flv_srates[sample_rate] > 24000) ? SrsMp4ObjectTypeMp1a : SrsMp4ObjectTypeMp3;  // 11172 - 3
-    default:
-        return SrsMp4ObjectTypeForbidden;
-    }
-}
-
-SrsMp4M2tsInitEncoder::SrsMp4M2tsInitEncoder()
+    wsio = NULL;
+    fragment = 0;
+    finalize_ = false;
+    sequence_number = 1;
+    moov_written = false;
+    vtid = atid = 0;
+    moov_offset = 0;
+    fragment_dts = 0;
+    nb_videos = nb_audios = 0;
+    vduration = aduration = 0;
+    
+    acodec = SrsAudioCodecIdForbidden;
+    sample_rate = SrsAudioSampleRateForbidden;
+    sound_bits = SrsAudioSampleBitsForbidden;
+    channels = SrsAudioChannelsForbidden;
+    vcodec = SrsVideoCodecIdForbidden;
+    width = height = 0;
+}
+
+SrsMp4FragmentedEncoder::~SrsMp4FragmentedEncoder()
 {
-    writer = NULL;
+    vector<SrsMp4Sample*>::iterator it;
+    for (it = videos.begin(); it != videos.end(); ++it) {
+        SrsMp4Sample* sample = *it;
+        srs_freep(sample);
+    }
+    for (it = audios.begin(); it != audios.end(); ++it) {
+        SrsMp4Sample* sample = *it;
+        srs_freep(sample);
+    }
 }
 
-SrsMp4M2tsInitEncoder::~SrsMp4M2tsInitEncoder()
+srs_error_t SrsMp4FragmentedEncoder::initialize(ISrsWriteSeeker* ws, srs_utime_t duration, bool finalize)
 {
+    wsio = ws;
+    fragment = duration;
+    finalize_ = finalize;
+    return srs_success;
 }
 
-srs_error_t SrsMp4M2tsInitEncoder::initialize(ISrsWriter* w)
+srs_error_t SrsMp4FragmentedEncoder::write_sample(
+    SrsFormat* format, SrsMp4HandlerType ht, uint16_t ft, uint16_t ct, uint32_t dts, uint32_t pts,
+    uint8_t* sample, uint32_t nb_sample
+) {
+    srs_error_t err = srs_success;
+    
+    // For SPS/PPS or ASC, copy it to moov.
+    bool vsh = (ht == SrsMp4HandlerTypeVIDE) && (ct == (uint16_t)SrsVideoAvcFrameTraitSequenceHeader);
+    bool ash = (ht == SrsMp4HandlerTypeSOUN) && (ct == (uint16_t)SrsAudioAacFrameTraitSequenceHeader);
+    if (vsh || ash) {
+        return copy_sequence_header(format, vsh, sample, nb_sample);
+    }
+    
+    bool video = (ht == SrsMp4HandlerTypeVIDE);
+    if (!video && ht != SrsMp4HandlerTypeSOUN) {
+        return err;
+    }
+    
+    // Ignore the sample when no sequence header, or the track is not in moov.
+    if (video && (pavcc.empty() || (moov_written && !vtid))) {
+        return err;
+    }
+    if (!video && ((pasc.empty() && acodec != SrsAudioCodecIdMP3) || (moov_written && !atid))) {
+        return err;
+    }
+    
+    // The video track must start with keyframe.
+    bool keyframe = video && ft == (uint16_t)SrsVideoAvcFrameTypeKeyFrame;
+    if (video && !nb_videos && videos.empty() && !keyframe) {
+        return err;
+    }
+    
+    // Reap the fragment when duration exceed, at keyframe if has video.
+    bool has_video = moov_written ? (vtid != 0) : !pavcc.empty();
+    bool has_samples = !videos.empty() || !audios.empty();
+    if (has_samples && dts > fragment_dts && srs_utime_t(dts - fragment_dts) * SRS_UTIME_MILLISECONDS >= fragment) {
+        if (!has_video || keyframe) {
+            if ((err = write_fragment(keyframe ? dts : 0)) != srs_success) {
+                return srs_error_wrap(err, "write fragment");
+            }
+        }
+    }
+    
+    SrsMp4Sample* ps = new SrsMp4Sample();
+    if (video) {
+        ps->type = SrsFrameTypeVideo;
+        ps->frame_type = (SrsVideoAvcFrameType)ft;
+        ps->index = nb_videos++;
+        vduration = dts;
+    } else {
+        ps->type = SrsFrameTypeAudio;
+        ps->index = nb_audios++;
+        aduration = dts;
+    }
+    ps->tbn = 1000;
+    ps->dts = dts;
+    ps->pts = pts;
+    
+    // We should copy the sample data, which is shared ptr from video/audio message.
+    ps->data = new uint8_t[nb_sample];
+    memcpy(ps->data, sample, nb_sample);
+    ps->nb_data = nb_sample;
+    
+    if (videos.empty() && audios.empty()) {
+        fragment_dts = dts;
+    }
+    
+    if (video) {
+        videos.push_back(ps);
+    } else {
+        audios.push_back(ps);
+    }
+    
+    return err;
+}
+
+srs_error_t SrsMp4FragmentedEncoder::flush()
 {
-    writer = w;
+    srs_error_t err = srs_success;
+    
+    if (!videos.empty() || !audios.empty()) {
+        if ((err = write_fragment(0)) != srs_success) {
+            return srs_error_wrap(err, "write fragment");
+        }
+    }
+    
+    if (!moov_written) {
+        return srs_error_new(ERROR_MP4_ILLEGAL_MOOV, "Missing audio and video track");
+    }
+    
+    if (finalize_ && (err = do_finalize()) != srs_success) {
+        return srs_error_wrap(err, "finalize");
+    }
+    
+    return err;
+}
+
+srs_error_t SrsMp4FragmentedEncoder::copy_sequence_header(SrsFormat* format, bool vsh, uint8_t* sample, uint32_t nb_sample)
+{
+    if (vsh && !pavcc.empty()) {
+        if (nb_sample == (uint32_t)pavcc.size() && srs_bytes_equals(sample, &pavcc[0], (int)pavcc.size())) {
+            return srs_success;
+        }
+        
+        return srs_error_new(ERROR_MP4_AVCC_CHANGE, "doesn't support avcc change");
+    }
+    
+    if (!vsh && !pasc.empty()) {
+        if (nb_sample == (uint32_t)pasc.size() && srs_bytes_equals(sample, &pasc[0], (int)pasc.size())) {
+            return srs_success;
+        }
+        
+        return srs_error_new(ERROR_MP4_ASC_CHANGE, "doesn't support asc change");
+    }
+    
+    if (vsh) {
+        pavcc = std::vector<char>(sample, sample + nb_sample);
+        if (format && format->vcodec) {
+            width = format->vcodec->width;
+            height = format->vcodec->height;
+        }
+    }
+    
+    if (!vsh) {
+        pasc = std::vector<char>(sample, sample + nb_sample);
+    }
+    
     return srs_success;
 }
 
-srs_error_t SrsMp4M2tsInitEncoder::write(SrsFormat* format, bool video, int tid)
+srs_error_t SrsMp4FragmentedEncoder::write_moov()
 {
     srs_error_t err = srs_success;
     
+    // The tracks are determined by the sequence headers, when write the first fragment.
+    uint32_t tid = 1;
+    if (!pavcc.empty()) {
+        vtid = tid++;
+    }
+    if (!pasc.empty() || acodec == SrsAudioCodecIdMP3) {
+        atid = tid++;
+    }
+    
     // Write ftyp box.
     if (true) {
         SrsMp4FileTypeBox* ftyp = new SrsMp4FileTypeBox();
         SrsAutoFree(SrsMp4FileTypeBox, ftyp);
-
+        
         ftyp->major_brand = SrsMp4BoxBrandISO5;
         ftyp->minor_version = 512;
         ftyp->set_compatible_brands(SrsMp4BoxBrandISO6, SrsMp4BoxBrandMP41);
-
-        if ((err = srs_mp4_write_box(writer, ftyp)) != srs_success) {
+        
+        if ((err = srs_mp4_write_box(wsio, ftyp)) != srs_success) {
             return srs_error_wrap(err, "write ftyp");
         }
     }
     
-    // Write moov.
+    // Write moov with mvex, but without samples.
     if (true) {
+        if ((err = wsio->lseek(0, SEEK_CUR, &moov_offset)) != srs_success) {
+            return srs_error_wrap(err, "seek to moov");
+        }
+        
         SrsMp4MovieBox* moov = new SrsMp4MovieBox();
         SrsAutoFree(SrsMp4MovieBox, moov);
+        
+        build_moov(moov, true);
+        
+        if ((err = srs_mp4_write_box(wsio, moov)) != srs_success) {
+            return srs_error_wrap(err, "write moov");
+        }
+    }
+    
+    moov_written = true;
+    
+    return err;
+}
 
-        SrsMp4MovieHeaderBox* mvhd = new SrsMp4MovieHeaderBox();
-        moov->set_mvhd(mvhd);
+srs_error_t SrsMp4FragmentedEncoder::write_fragment(uint64_t next_video_dts)
+{
+    srs_error_t err = srs_success;
+    
+    if (!moov_written && (err = write_moov()) != srs_success) {
+        return srs_error_wrap(err, "write moov");
+    }
+    
+    if (!videos.empty()) {
+        err = write_track_fragment(videos, vtid, next_video_dts);
+    }
+    if (err == srs_success && !audios.empty()) {
+        err = write_track_fragment(audios, atid, 0);
+    }
+    
+    // Free the samples of fragment, even when error.
+    vector<SrsMp4Sample*>::iterator it;
+    for (it = videos.begin(); it != videos.end(); ++it) {
+        SrsMp4Sample* sample = *it;
+        srs_freep(sample);
+    }
+    for (it = audios.begin(); it != audios.end(); ++it) {
+        SrsMp4Sample* sample = *it;
+        srs_freep(sample);
+    }
+    videos.clear();
+    audios.clear();
+    
+    if (err != srs_success) {
+        return srs_error_wrap(err, "write track fragment");
+    }
+    
+    return err;
+}
+
+srs_error_t SrsMp4FragmentedEncoder::write_track_fragment(vector<SrsMp4Sample*>& samples, uint32_t tid, uint64_t next_dts)
+{
+    srs_error_t err = srs_success;
+    
+    SrsMp4MovieFragmentBox* moof = new SrsMp4MovieFragmentBox();
+    SrsAutoFree(SrsMp4MovieFragmentBox, moof);
+    
+    SrsMp4MovieFragmentHeaderBox* mfhd = new SrsMp4MovieFragmentHeaderBox();
+    moof->set_mfhd(mfhd);
+    
+    mfhd->sequence_number = sequence_number++;
+    
+    SrsMp4TrackFragmentBox* traf = new SrsMp4TrackFragmentBox();
+    moof->set_traf(traf);
+    
+    SrsMp4TrackFragmentHeaderBox* tfhd = new SrsMp4TrackFragmentHeaderBox();
+    traf->set_tfhd(tfhd);
+    
+    tfhd->track_id = tid;
+    tfhd->flags = SrsMp4TfhdFlagsDefaultBaseIsMoof;
+    
+    SrsMp4TrackFragmentDecodeTimeBox* tfdt = new SrsMp4TrackFragmentDecodeTimeBox();
+    traf->set_tfdt(tfdt);
+    
+    tfdt->version = 1;
+    tfdt->base_media_decode_time = samples[0]->dts;
+    
+    SrsMp4TrackFragmentRunBox* trun = new SrsMp4TrackFragmentRunBox();
+    traf->set_trun(trun);
+    
+    trun->flags = SrsMp4TrunFlagsDataOffset | SrsMp4TrunFlagsSampleDuration
+        | SrsMp4TrunFlagsSampleSize | SrsMp4TrunFlagsSampleFlag | SrsMp4TrunFlagsSampleCtsOffset;
+    
+    uint64_t mdat_bytes = 0;
+    vector<iovec> iovs(samples.size());
+    for (int i = 0; i < (int)samples.size(); i++) {
+        SrsMp4Sample* sample = samples[i];
+        SrsMp4TrunEntry* entry = new SrsMp4TrunEntry(trun);
         
-        mvhd->timescale = 1000; // Use tbn ms.
-        mvhd->duration_in_tbn = 0;
-        mvhd->next_track_ID = tid;
+        // The duration is the delta to next sample, or the previous duration for the last one.
+        uint64_t dts = (i < (int)samples.size() - 1) ? samples[i + 1]->dts : next_dts;
+        if (dts >= sample->dts) {
+            entry->sample_duration = (uint32_t)(dts - sample->dts);
+        } else if (!trun->entries.empty()) {
+            entry->sample_duration = trun->entries.back()->sample_duration;
+        }
         
-        if (video) {
-            SrsMp4TrackBox* trak = new SrsMp4TrackBox();
-            moov->add_trak(trak);
-            
-            SrsMp4TrackHeaderBox* tkhd = new SrsMp4TrackHeaderBox();
-            trak->set_tkhd(tkhd);
-            
-            tkhd->track_ID = mvhd->next_track_ID++;
-            tkhd->duration = 0;
-            tkhd->width = (format->vcodec->width << 16);
-            tkhd->height = (format->vcodec->height << 16);
-            
-            SrsMp4MediaBox* mdia = new SrsMp4MediaBox();
-            trak->set_mdia(mdia);
+        // The sample_depends_on is 2 for keyframe, or 1 with sample_is_non_sync_sample.
+        if (sample->type == SrsFrameTypeAudio || sample->frame_type == SrsVideoAvcFrameTypeKeyFrame) {
+            entry->sample_flags = 0x02000000;
+        } else {
+            entry->sample_flags = 0x01010000;
+        }
+        
+        entry->sample_size = sample->nb_data;
+        entry->sample_composition_time_offset = (int64_t)(sample->pts - sample->dts);
+        if (entry->sample_composition_time_offset < 0) {
+            trun->version = 1;
+        }
+        
+        trun->entries.push_back(entry);
+        
+        iovs[i].iov_base = sample->data;
+        iovs[i].iov_len = sample->nb_data;
+        mdat_bytes += sample->nb_data;
+    }
+    
+    SrsMp4MediaDataBox* mdat = new SrsMp4MediaDataBox();
+    SrsAutoFree(SrsMp4MediaDataBox, mdat);
+    
+    mdat->nb_data = mdat_bytes;
+    
+    // @remark Remember the data_offset of turn is size(moof)+header(mdat).
+    int moof_bytes = moof->nb_bytes();
+    trun->data_offset = (int32_t)(moof_bytes + mdat->sz_header());
+    
+    off_t offset = 0;
+    if ((err = wsio->lseek(0, SEEK_CUR, &offset)) != srs_success) {
+        return srs_error_wrap(err, "seek to moof");
+    }
+    
+    if ((err = srs_mp4_write_box(wsio, moof)) != srs_success) {
+        return srs_error_wrap(err, "write moof");
+    }
+    
+    // Write the mdat header, then the samples.
+    if (true) {
+        int nb_data = mdat->sz_header();
+        std::vector<char> data(nb_data);
+        
+        SrsBuffer* buffer = new SrsBuffer(&data[0], nb_data);
+        SrsAutoFree(SrsBuffer, buffer);
+        
+        if ((err = mdat->encode(buffer)) != srs_success) {
+            return srs_error_wrap(err, "encode mdat");
+        }
+        
+        if ((err = wsio->write(&data[0], nb_data, NULL)) != srs_success) {
+            return srs_error_wrap(err, "write mdat");
+        }
+    }
+    
+    if ((err = wsio->writev(&iovs[0], (int)iovs.size(), NULL)) != srs_success) {
+        return srs_error_wrap(err, "write samples");
+    }
+    
+    // Build the compact index for finalize.
+    if (finalize_) {
+        moof_offsets.push_back(offset);
+        
+        uint64_t sample_offset = offset + trun->data_offset;
+        for (int i = 0; i < (int)samples.size(); i++) {
+            SrsMp4Sample* sample = samples[i];
             
-            SrsMp4MediaHeaderBox* mdhd = new SrsMp4MediaHeaderBox();
-            mdia->set_mdhd(mdhd);
+            SrsMp4SampleIndex index;
+            index.offset = sample_offset;
+            index.nb_data = sample->nb_data;
+            index.dts = (uint32_t)sample->dts;
+            index.cts = (int32_t)(sample->pts - sample->dts);
+            index.type = (uint8_t)sample->type;
+            index.keyframe = (sample->frame_type == SrsVideoAvcFrameTypeKeyFrame);
+            indexes.push_back(index);
             
-            mdhd->timescale = 1000;
-            mdhd->duration = 0;
-            mdhd->set_language0('u');
-            mdhd->set_language1('n');
-            mdhd->set_language2('d');
+            sample_offset += sample->nb_data;
+        }
+    }
+    
+    return err;
+}
+
+srs_error_t SrsMp4FragmentedEncoder::do_finalize()
+{
+    srs_error_t err = srs_success;
+    
+    // Append the progressive moov to the end of file.
+    if (true) {
+        SrsMp4SampleManager* samples = new SrsMp4SampleManager();
+        SrsAutoFree(SrsMp4SampleManager, samples);
+        
+        uint32_t nb_videos = 0, nb_audios = 0;
+        vector<SrsMp4SampleIndex>::iterator it;
+        for (it = indexes.begin(); it != indexes.end(); ++it) {
+            SrsMp4SampleIndex& index = *it;
             
-            SrsMp4HandlerReferenceBox* hdlr = new SrsMp4HandlerReferenceBox();
+            SrsMp4Sample* ps = new SrsMp4Sample();
+            ps->type = (SrsFrameType)index.type;
+            ps->index = (ps->type == SrsFrameTypeVideo) ? nb_videos++ : nb_audios++;
+            ps->offset = (off_t)index.offset;
+            ps->tbn = 1000;
+            ps->dts = index.dts;
+            ps->pts = (int64_t)index.dts + index.cts;
+            ps->frame_type = index.keyframe ? SrsVideoAvcFrameTypeKeyFrame : SrsVideoAvcFrameTypeInterFrame;
+            ps->nb_data = index.nb_data;
+            samples->append(ps);
+        }
+        
+        SrsMp4MovieBox* moov = new SrsMp4MovieBox();
+        SrsAutoFree(SrsMp4MovieBox, moov);
+        
+        build_moov(moov, false);
+        
+        if ((err = samples->write(moov)) != srs_success) {
+            return srs_error_wrap(err, "write samples");
+        }
+        
+        if ((err = wsio->lseek(0, SEEK_END, NULL)) != srs_success) {
+            return srs_error_wrap(err, "seek to end");
+        }
+        
+        if ((err = srs_mp4_write_box(wsio, moov)) != srs_success) {
+            return srs_error_wrap(err, "write moov");
+        }
+    }
+    
+    // Rewrite the fMP4 moov and moofs to free box. The moov is rewritten first, so the
+    // file is a valid progressive MP4 even if we crash when rewriting the moofs.
+    if (true) {
+        char data[4];
+        SrsBuffer buffer(data, sizeof(data));
+        buffer.write_4bytes(SrsMp4BoxTypeFREE);
+        
+        vector<off_t> offsets;
+        offsets.push_back(moov_offset);
+        offsets.insert(offsets.end(), moof_offsets.begin(), moof_offsets.end());
+        
+        vector<off_t>::iterator it;
+        for (it = offsets.begin(); it != offsets.end(); ++it) {
+            // Skip the 4 bytes size of box.
+            if ((err = wsio->lseek(*it + 4, SEEK_SET, NULL)) != srs_success) {
+                return srs_error_wrap(err, "seek to box %" PRId64, (int64_t)*it);
+            }
+            
+            if ((err = wsio->write(data, sizeof(data), NULL)) != srs_success) {
+                return srs_error_wrap(err, "write free");
+            }
+        }
+    }
+    
+    indexes.clear();
+    moof_offsets.clear();
+    
+    return err;
+}
+
+void SrsMp4FragmentedEncoder::build_moov(SrsMp4MovieBox* moov, bool fragmented)
+{
+    SrsMp4MoovTracks tracks;
+    tracks.vtid = vtid;
+    tracks.atid = atid;
+    tracks.vduration = vduration;
+    tracks.aduration = aduration;
+    tracks.width = width;
+    tracks.height = height;
+    tracks.avcc = &pavcc;
+    tracks.acodec = acodec;
+    tracks.sample_rate = sample_rate;
+    tracks.sound_bits = sound_bits;
+    tracks.channels = channels;
+    tracks.asc = &pasc;
+    
+    srs_mp4_build_moov(moov, tracks, fragmented);
+}
+
+SrsMp4M2tsInitEncoder::SrsMp4M2tsInitEncoder()
+{
+    writer = NULL;
+}
+
+SrsMp4M2tsInitEncoder::~SrsMp4M2tsInitEncoder()
+{
+}
+
+srs_error_t SrsMp4M2tsInitEncoder::initialize(ISrsWriter* w)
+{
+    writer = w;
+    return srs_success;
+}
+
+srs_error_t SrsMp4M2tsInitEncoder::write(SrsFormat* format, bool video, int tid)
+{
+    srs_error_t err = srs_success;
+    
+    // Write ftyp box.
+    if (true) {
+        SrsMp4FileTypeBox* ftyp = new SrsMp4FileTypeBox();
+        SrsAutoFree(SrsMp4FileTypeBox, ftyp);
+
+        ftyp->major_brand = SrsMp4BoxBrandISO5;
+        ftyp->minor_version = 512;
+        ftyp->set_compatible_brands(SrsMp4BoxBrandISO6, SrsMp4BoxBrandMP41);
+
+        if ((err = srs_mp4_write_box(writer, ftyp)) != srs_success) {
+            return srs_error_wrap(err, "write ftyp");
+        }
+    }
+    
+    // Write moov.
+    if (true) {
+        SrsMp4MovieBox* moov = new SrsMp4MovieBox();
+        SrsAutoFree(SrsMp4MovieBox, moov);
+
+        SrsMp4MovieHeaderBox* mvhd = new SrsMp4MovieHeaderBox();
+        moov->set_mvhd(mvhd);
+        
+        mvhd->timescale = 1000; // Use tbn ms.
+        mvhd->duration_in_tbn = 0;
+        mvhd->next_track_ID = tid;
+        
+        if (video) {
+            SrsMp4TrackBox* trak = new SrsMp4TrackBox();
+            moov->add_trak(trak);
+            
+            SrsMp4TrackHeaderBox* tkhd = new SrsMp4TrackHeaderBox();
+            trak->set_tkhd(tkhd);
+            
+            tkhd->track_ID = mvhd->next_track_ID++;
+            tkhd->duration = 0;
+            tkhd->width = (format->vcodec->width << 16);
+            tkhd->height = (format->vcodec->height << 16);
+            
+            SrsMp4MediaBox* mdia = new SrsMp4MediaBox();
+            trak->set_mdia(mdia);
+            
+            SrsMp4MediaHeaderBox* mdhd = new SrsMp4MediaHeaderBox();
+            mdia->set_mdhd(mdhd);
+            
+            mdhd->timescale = 1000;
+            mdhd->duration = 0;
+            mdhd->set_language0('u');
+            mdhd->set_language1('n');
+            mdhd->set_language2('d');
+            
+            SrsMp4HandlerReferenceBox* hdlr = new SrsMp4HandlerReferenceBox();
             mdia->set_hdlr(hdlr);
             
             hdlr->handler_type = SrsMp4HandlerTypeVIDE;
@@ -6361,190 +6926,771 @@ SrsMp4M2tsSegmentEncoder::SrsMp4M2tsSegmentEncoder()
 
 SrsMp4M2tsSegmentEncoder::~SrsMp4M2tsSegmentEncoder()
 {
-    srs_freep(samples);
+    srs_freep(samples);
+}
+
+srs_error_t SrsMp4M2tsSegmentEncoder::initialize(ISrsWriter* w, uint32_t sequence, srs_utime_t basetime, uint32_t tid)
+{
+    srs_error_t err = srs_success;
+    
+    writer = w;
+    track_id = tid;
+    sequence_number = sequence;
+    decode_basetime = basetime;
+    
+    // Write styp box.
+    if (true) {
+        SrsMp4SegmentTypeBox* styp = new SrsMp4SegmentTypeBox();
+        SrsAutoFree(SrsMp4SegmentTypeBox, styp);
+        
+        styp->major_brand = SrsMp4BoxBrandMSDH;
+        styp->minor_version = 0;
+        styp->set_compatible_brands(SrsMp4BoxBrandMSDH, SrsMp4BoxBrandMSIX);
+
+        // Used for sidx to calcalute the referenced size.
+        styp_bytes = styp->nb_bytes();
+
+        if ((err = srs_mp4_write_box(writer, styp)) != srs_success) {
+            return srs_error_wrap(err, "write styp");
+        }
+    }
+
+    return err;
+}
+
+srs_error_t SrsMp4M2tsSegmentEncoder::write_sample(SrsMp4HandlerType ht,
+    uint16_t ft, uint32_t dts, uint32_t pts, uint8_t* sample, uint32_t nb_sample
+) {
+    srs_error_t err = srs_success;
+    
+    SrsMp4Sample* ps = new SrsMp4Sample();
+    
+    if (ht == SrsMp4HandlerTypeVIDE) {
+        ps->type = SrsFrameTypeVideo;
+        ps->frame_type = (SrsVideoAvcFrameType)ft;
+        ps->index = nb_videos++;
+    } else if (ht == SrsMp4HandlerTypeSOUN) {
+        ps->type = SrsFrameTypeAudio;
+        ps->index = nb_audios++;
+    } else {
+        srs_freep(ps);
+        return err;
+    }
+    
+    ps->tbn = 1000;
+    ps->dts = dts;
+    ps->pts = pts;
+
+    // We should copy the sample data, which is shared ptr from video/audio message.
+    // Furthermore, we do free the data when freeing the sample.
+    ps->data = new uint8_t[nb_sample];
+    memcpy(ps->data, sample, nb_sample);
+    ps->nb_data = nb_sample;
+    
+    // Append to manager to build the moof.
+    samples->append(ps);
+    
+    mdat_bytes += nb_sample;
+    
+    return err;
+}
+
+srs_error_t SrsMp4M2tsSegmentEncoder::flush(uint64_t& dts)
+{
+    srs_error_t err = srs_success;
+    
+    if (!nb_audios && !nb_videos) {
+        return srs_error_new(ERROR_MP4_ILLEGAL_MOOF, "Missing audio and video track");
+    }
+
+    // Although the sidx is not required to start play DASH, but it's required for AV sync.
+    SrsMp4SegmentIndexBox* sidx = new SrsMp4SegmentIndexBox();
+    SrsAutoFree(SrsMp4SegmentIndexBox, sidx);
+    if (true) {
+        sidx->version = 1;
+        sidx->reference_id = 1;
+        sidx->timescale = 1000;
+        sidx->earliest_presentation_time = uint64_t(decode_basetime / sidx->timescale);
+
+        uint64_t duration = 0;
+        if (samples && !samples->samples.empty()) {
+            SrsMp4Sample* first = samples->samples[0];
+            SrsMp4Sample* last = samples->samples[samples->samples.size() - 1];
+            duration = srs_max(0, last->dts - first->dts);
+        }
+
+        SrsMp4SegmentIndexEntry entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.subsegment_duration = duration;
+        entry.starts_with_SAP = 1;
+        sidx->entries.push_back(entry);
+    }
+
+    // Create a mdat box.
+    // its payload will be writen by samples,
+    // and we will update its header(size) when flush.
+    SrsMp4MediaDataBox* mdat = new SrsMp4MediaDataBox();
+    SrsAutoFree(SrsMp4MediaDataBox, mdat);
+
+    // Write moof.
+    if (true) {
+        SrsMp4MovieFragmentBox* moof = new SrsMp4MovieFragmentBox();
+        SrsAutoFree(SrsMp4MovieFragmentBox, moof);
+        
+        SrsMp4MovieFragmentHeaderBox* mfhd = new SrsMp4MovieFragmentHeaderBox();
+        moof->set_mfhd(mfhd);
+        
+        mfhd->sequence_number = sequence_number;
+        
+        SrsMp4TrackFragmentBox* traf = new SrsMp4TrackFragmentBox();
+        moof->set_traf(traf);
+        
+        SrsMp4TrackFragmentHeaderBox* tfhd = new SrsMp4TrackFragmentHeaderBox();
+        traf->set_tfhd(tfhd);
+        
+        tfhd->track_id = track_id;
+        tfhd->flags = SrsMp4TfhdFlagsDefaultBaseIsMoof;
+        
+        SrsMp4TrackFragmentDecodeTimeBox* tfdt = new SrsMp4TrackFragmentDecodeTimeBox();
+        traf->set_tfdt(tfdt);
+        
+        tfdt->version = 1;
+        tfdt->base_media_decode_time = srsu2ms(decode_basetime);
+        
+        SrsMp4TrackFragmentRunBox* trun = new SrsMp4TrackFragmentRunBox();
+        traf->set_trun(trun);
+        
+        if ((err = samples->write(moof, dts)) != srs_success) {
+            return srs_error_wrap(err, "write samples");
+        }
+        
+        // @remark Remember the data_offset of turn is size(moof)+header(mdat), not including styp or sidx.
+        int moof_bytes = moof->nb_bytes();
+        trun->data_offset = (int32_t)(moof_bytes + mdat->sz_header());
+        mdat->nb_data = mdat_bytes;
+
+        // Update the size of sidx.
+        SrsMp4SegmentIndexEntry* entry = &sidx->entries[0];
+        entry->referenced_size = moof_bytes + mdat->nb_bytes();
+        if ((err = srs_mp4_write_box(writer, sidx)) != srs_success) {
+            return srs_error_wrap(err, "write sidx");
+        }
+
+        if ((err = srs_mp4_write_box(writer, moof)) != srs_success) {
+            return srs_error_wrap(err, "write moof");
+        }
+    }
+    
+    // Write mdat.
+    if (true) {
+        int nb_data = mdat->sz_header();
+        uint8_t* data = new uint8_t[nb_data];
+        SrsAutoFreeA(uint8_t, data);
+        
+        SrsBuffer* buffer = new SrsBuffer((char*)data, nb_data);
+        SrsAutoFree(SrsBuffer, buffer);
+        
+        if ((err = mdat->encode(buffer)) != srs_success) {
+            return srs_error_wrap(err, "encode mdat");
+        }
+        
+        // TODO: FIXME: Ensure all bytes are writen.
+        if ((err = writer->write(data, nb_data, NULL)) != srs_success) {
+            return srs_error_wrap(err, "write mdat");
+        }
+        
+        vector<SrsMp4Sample*>::iterator it;
+        for (it = samples->samples.begin(); it != samples->samples.end(); ++it) {
+            SrsMp4Sample* sample = *it;
+            
+            // TODO: FIXME: Ensure all bytes are writen.
+            if ((err = writer->write(sample->data, sample->nb_data, NULL)) != srs_success) {
+                return srs_error_wrap(err, "write sample");
+            }
+        }
+    }
+
+    return err;
+}
+
+
+SrsMp4VodTrack::SrsMp4VodTrack(SrsFrameType t)
+{
+    type = t;
+    timescale = 0;
+}
+
+SrsMp4VodTrack::~SrsMp4VodTrack()
+{
+}
+
+uint32_t SrsMp4VodTrack::nb_samples()
+{
+    return (uint32_t)offsets.size();
+}
+
+uint64_t SrsMp4VodTrack::dts_ms(uint32_t index)
+{
+    return dts[index] * 1000 / timescale;
+}
+
+uint32_t SrsMp4VodTrack::find(uint64_t ms)
+{
+    uint64_t target = ms * timescale / 1000;
+    
+    vector<uint64_t>::iterator end = dts.begin() + nb_samples();
+    vector<uint64_t>::iterator it = std::upper_bound(dts.begin(), end, target);
+    if (it == dts.begin()) {
+        return 0;
+    }
+    
+    return (uint32_t)(it - dts.begin() - 1);
+}
+
+uint32_t SrsMp4VodTrack::find_sync(uint32_t index)
+{
+    if (syncs.empty()) {
+        return index;
+    }
+    
+    // Use the first sync sample, if no sync sample before it.
+    vector<uint32_t>::iterator it = std::upper_bound(syncs.begin(), syncs.end(), index);
+    if (it == syncs.begin()) {
+        return syncs.front();
+    }
+    
+    return *(it - 1);
+}
+
+// Clone the box by encode and decode it.
+srs_error_t srs_mp4_clone_box(SrsMp4Box* box, SrsMp4Box** ppbox)
+{
+    srs_error_t err = srs_success;
+    
+    int nb_data = (int)box->nb_bytes();
+    std::vector<char> data(nb_data);
+    
+    SrsBuffer buffer(&data[0], nb_data);
+    if ((err = box->encode(&buffer)) != srs_success) {
+        return srs_error_wrap(err, "encode box");
+    }
+    
+    buffer.skip(-1 * buffer.pos());
+    if ((err = SrsMp4Box::discovery(&buffer, ppbox)) != srs_success) {
+        return srs_error_wrap(err, "discovery box");
+    }
+    
+    if ((err = (*ppbox)->decode(&buffer)) != srs_success) {
+        srs_freep(*ppbox);
+        return srs_error_wrap(err, "decode box");
+    }
+    
+    return err;
+}
+
+SrsMp4VodIndex::SrsMp4VodIndex()
+{
+    video = NULL;
+    audio = NULL;
+}
+
+SrsMp4VodIndex::~SrsMp4VodIndex()
+{
+    srs_freep(video);
+    srs_freep(audio);
+}
+
+srs_error_t SrsMp4VodIndex::initialize(char* data, int64_t size)
+{
+    srs_error_t err = srs_success;
+    
+    // Discovery the ftyp and moov, skip the mdat.
+    int64_t moov_pos = -1;
+    uint64_t moov_size = 0;
+    for (int64_t pos = 0; pos + 8 <= size;) {
+        SrsBuffer buffer(data + pos, 16);
+        uint64_t box_size = (uint32_t)buffer.read_4bytes();
+        SrsMp4BoxType type = (SrsMp4BoxType)buffer.read_4bytes();
+        if (box_size == SRS_MP4_USE_LARGE_SIZE) {
+            if (pos + 16 > size) {
+                break;
+            }
+            box_size = (uint64_t)buffer.read_8bytes();
+        } else if (box_size == 0) {
+            box_size = (uint64_t)(size - pos);
+        }
+        
+        if (box_size < 8 || box_size > (uint64_t)(size - pos)) {
+            return srs_error_new(ERROR_MP4_BOX_OVERFLOW, "box %#x overflow, size=%" PRId64 ", pos=%" PRId64,
+                (uint32_t)type, box_size, pos);
+        }
+        
+        if (type == SrsMp4BoxTypeFTYP) {
+            ftyp = std::vector<char>(data + pos, data + pos + box_size);
+        } else if (type == SrsMp4BoxTypeMOOV) {
+            moov_pos = pos;
+            moov_size = box_size;
+        }
+        
+        pos += box_size;
+    }
+    
+    if (moov_pos < 0) {
+        return srs_error_new(ERROR_MP4_ILLEGAL_MOOV, "no moov");
+    }
+    if (moov_size > (uint64_t)INT_MAX) {
+        return srs_error_new(ERROR_MP4_MOOV_OVERFLOW, "moov overflow, size=%" PRId64, moov_size);
+    }
+    
+    SrsMp4Box* box = NULL;
+    SrsBuffer buffer(data + moov_pos, (int)moov_size);
+    if ((err = SrsMp4Box::discovery(&buffer, &box)) != srs_success) {
+        return srs_error_wrap(err, "discovery moov");
+    }
+    
+    SrsMp4MovieBox* moov = dynamic_cast<SrsMp4MovieBox*>(box);
+    SrsAutoFree(SrsMp4MovieBox, moov);
+    
+    if ((err = moov->decode(&buffer)) != srs_success) {
+        return srs_error_wrap(err, "decode moov");
+    }
+    
+    if (moov->mvex() || !moov->mvhd()) {
+        return srs_error_new(ERROR_MP4_ILLEGAL_MOOV, "fMP4 or no mvhd");
+    }
+    
+    SrsMp4TrackBox* vide = moov->video();
+    if (vide) {
+        video = new SrsMp4VodTrack(SrsFrameTypeVideo);
+        if ((err = load_track(vide, video)) != srs_success) {
+            return srs_error_wrap(err, "load video");
+        }
+    }
+    
+    SrsMp4TrackBox* soun = moov->audio();
+    if (soun) {
+        audio = new SrsMp4VodTrack(SrsFrameTypeAudio);
+        if ((err = load_track(soun, audio)) != srs_success) {
+            return srs_error_wrap(err, "load audio");
+        }
+    }
+    
+    if (!video && !audio) {
+        return srs_error_new(ERROR_MP4_ILLEGAL_TRACK, "no track");
+    }
+    
+    // Check the samples, to make sure never read out of the file.
+    SrsMp4VodTrack* tracks[] = {video, audio};
+    for (int i = 0; i < 2; i++) {
+        SrsMp4VodTrack* track = tracks[i];
+        for (uint32_t j = 0; track && j < track->nb_samples(); j++) {
+            if (track->offsets[j] + track->sizes[j] > (uint64_t)size) {
+                return srs_error_new(ERROR_MP4_ILLEGAL_SAMPLES, "sample %d overflow, offset=%" PRId64 ", size=%d, file=%" PRId64,
+                    j, track->offsets[j], track->sizes[j], size);
+            }
+        }
+    }
+    
+    if ((err = build_skeleton(moov)) != srs_success) {
+        return srs_error_wrap(err, "build skeleton");
+    }
+    
+    return err;
+}
+
+uint64_t SrsMp4VodIndex::duration()
+{
+    uint64_t v = 0;
+    if (video) {
+        v = srs_max(v, video->dts_ms(video->nb_samples()));
+    }
+    if (audio) {
+        v = srs_max(v, audio->dts_ms(audio->nb_samples()));
+    }
+    return v;
 }
 
-srs_error_t SrsMp4M2tsSegmentEncoder::initialize(ISrsWriter* w, uint32_t sequence, srs_utime_t basetime, uint32_t tid)
+srs_error_t SrsMp4VodIndex::seek(uint64_t ms, std::vector<char>& header, uint64_t* pstart, uint64_t* pend)
 {
     srs_error_t err = srs_success;
     
-    writer = w;
-    track_id = tid;
-    sequence_number = sequence;
-    decode_basetime = basetime;
+    // Start from the keyframe of video, and the audio after it.
+    uint32_t vstart = 0, astart = 0;
+    if (video) {
+        vstart = video->find_sync(video->find(ms));
+        ms = video->dts_ms(vstart);
+    }
+    if (audio) {
+        astart = audio->find(ms);
+        if (video && audio->dts_ms(astart) < ms && astart + 1 < audio->nb_samples()) {
+            astart++;
+        }
+    }
     
-    // Write styp box.
-    if (true) {
-        SrsMp4SegmentTypeBox* styp = new SrsMp4SegmentTypeBox();
-        SrsAutoFree(SrsMp4SegmentTypeBox, styp);
+    // The range of samples in original file, which is the payload of mdat.
+    uint64_t begin = UINT64_MAX, end = 0, nb_samples = 0;
+    SrsMp4VodTrack* tracks[] = {video, audio};
+    uint32_t starts[] = {vstart, astart};
+    for (int i = 0; i < 2; i++) {
+        SrsMp4VodTrack* track = tracks[i];
+        for (uint32_t j = starts[i]; track && j < track->nb_samples(); j++) {
+            begin = srs_min(begin, track->offsets[j]);
+            end = srs_max(end, track->offsets[j] + track->sizes[j]);
+            nb_samples++;
+        }
+    }
+    
+    // Use co64 if the offset maybe overflow, each sample consumes at most 44 bytes of tables.
+    uint64_t headroom = ftyp.size() + skeleton.size() + 16 + 44 * nb_samples;
+    bool large = (end - begin + headroom > 0xffffffff);
+    
+    SrsMp4Box* box = NULL;
+    SrsBuffer buffer(&skeleton[0], (int)skeleton.size());
+    if ((err = SrsMp4Box::discovery(&buffer, &box)) != srs_success) {
+        return srs_error_wrap(err, "discovery moov");
+    }
+    
+    SrsMp4MovieBox* moov = dynamic_cast<SrsMp4MovieBox*>(box);
+    SrsAutoFree(SrsMp4MovieBox, moov);
+    
+    if ((err = moov->decode(&buffer)) != srs_success) {
+        return srs_error_wrap(err, "decode moov");
+    }
+    
+    SrsMp4MovieHeaderBox* mvhd = moov->mvhd();
+    mvhd->duration_in_tbn = 0;
+    
+    SrsMp4TrackBox* traks[] = {moov->video(), moov->audio()};
+    for (int i = 0; i < 2; i++) {
+        SrsMp4VodTrack* track = tracks[i];
+        if (!track) {
+            continue;
+        }
         
-        styp->major_brand = SrsMp4BoxBrandMSDH;
-        styp->minor_version = 0;
-        styp->set_compatible_brands(SrsMp4BoxBrandMSDH, SrsMp4BoxBrandMSIX);
-
-        // Used for sidx to calcalute the referenced size.
-        styp_bytes = styp->nb_bytes();
-
-        if ((err = srs_mp4_write_box(writer, styp)) != srs_success) {
-            return srs_error_wrap(err, "write styp");
+        SrsMp4TrackBox* trak = traks[i];
+        if ((err = write_track(trak, track, starts[i], begin, large)) != srs_success) {
+            return srs_error_wrap(err, "write track");
         }
+        
+        uint64_t duration = track->dts[track->nb_samples()] - track->dts[starts[i]];
+        trak->mdhd()->duration = duration;
+        trak->tkhd()->duration = duration * mvhd->timescale / track->timescale;
+        mvhd->duration_in_tbn = srs_max(mvhd->duration_in_tbn, trak->tkhd()->duration);
     }
-
+    
+    SrsMp4MediaDataBox* mdat = new SrsMp4MediaDataBox();
+    SrsAutoFree(SrsMp4MediaDataBox, mdat);
+    
+    mdat->nb_data = end - begin;
+    mdat->update_size();
+    
+    // Now we know the size of moov, then the base offset of samples.
+    uint64_t moov_size = moov->nb_bytes();
+    uint64_t base = ftyp.size() + moov_size + mdat->sz_header();
+    for (int i = 0; i < 2; i++) {
+        SrsMp4SampleTableBox* stbl = traks[i] ? traks[i]->stbl() : NULL;
+        SrsMp4ChunkOffsetBox* stco = stbl ? stbl->stco() : NULL;
+        SrsMp4ChunkLargeOffsetBox* co64 = stbl ? stbl->co64() : NULL;
+        for (uint32_t j = 0; stco && j < stco->entry_count; j++) {
+            stco->entries[j] += (uint32_t)base;
+        }
+        for (uint32_t j = 0; co64 && j < co64->entry_count; j++) {
+            co64->entries[j] += base;
+        }
+    }
+    
+    header.resize((size_t)base);
+    memcpy(&header[0], &ftyp[0], ftyp.size());
+    
+    if (true) {
+        SrsBuffer buffer(&header[ftyp.size()], (int)(base - ftyp.size()));
+        if ((err = moov->encode(&buffer)) != srs_success) {
+            return srs_error_wrap(err, "encode moov");
+        }
+        if ((err = mdat->encode(&buffer)) != srs_success) {
+            return srs_error_wrap(err, "encode mdat");
+        }
+    }
+    
+    *pstart = begin;
+    *pend = end;
+    
     return err;
 }
 
-srs_error_t SrsMp4M2tsSegmentEncoder::write_sample(SrsMp4HandlerType ht,
-    uint16_t ft, uint32_t dts, uint32_t pts, uint8_t* sample, uint32_t nb_sample
-) {
+srs_error_t SrsMp4VodIndex::load_track(SrsMp4TrackBox* trak, SrsMp4VodTrack* track)
+{
     srs_error_t err = srs_success;
     
-    SrsMp4Sample* ps = new SrsMp4Sample();
+    SrsMp4SampleTableBox* stbl = trak->stbl();
+    SrsMp4MediaHeaderBox* mdhd = trak->mdhd();
+    SrsMp4ChunkOffsetBox* stco = stbl ? stbl->stco() : NULL;
+    SrsMp4ChunkLargeOffsetBox* co64 = stbl ? stbl->co64() : NULL;
+    SrsMp4SampleSizeBox* stsz = trak->stsz();
+    SrsMp4Sample2ChunkBox* stsc = trak->stsc();
+    SrsMp4DecodingTime2SampleBox* stts = trak->stts();
+    SrsMp4CompositionTime2SampleBox* ctts = trak->ctts();
+    SrsMp4SyncSampleBox* stss = trak->stss();
     
-    if (ht == SrsMp4HandlerTypeVIDE) {
-        ps->type = SrsFrameTypeVideo;
-        ps->frame_type = (SrsVideoAvcFrameType)ft;
-        ps->index = nb_videos++;
-    } else if (ht == SrsMp4HandlerTypeSOUN) {
-        ps->type = SrsFrameTypeAudio;
-        ps->index = nb_audios++;
-    } else {
-        srs_freep(ps);
-        return err;
+    if (!mdhd || !mdhd->timescale || (!stco && !co64) || !stsz || !stsc || !stsc->entry_count || !stts) {
+        return srs_error_new(ERROR_MP4_ILLEGAL_TRACK, "illegal track, empty mdhd/stco/stsz/stsc/stts, type=%d", trak->track_type());
     }
     
-    ps->tbn = 1000;
-    ps->dts = dts;
-    ps->pts = pts;
-
-    // We should copy the sample data, which is shared ptr from video/audio message.
-    // Furthermore, we do free the data when freeing the sample.
-    ps->data = new uint8_t[nb_sample];
-    memcpy(ps->data, sample, nb_sample);
-    ps->nb_data = nb_sample;
+    track->timescale = mdhd->timescale;
     
-    // Append to manager to build the moof.
-    samples->append(ps);
+    uint32_t nb_samples = stsz->sample_count;
+    track->offsets.reserve(nb_samples);
+    track->sizes.reserve(nb_samples);
+    track->dts.reserve(nb_samples + 1);
     
-    mdat_bytes += nb_sample;
+    // The offset and size of samples.
+    stsc->initialize_counter();
+    uint32_t nb_chunks = stco ? stco->entry_count : co64->entry_count;
+    for (uint32_t ci = 0; ci < nb_chunks; ci++) {
+        uint64_t offset = stco ? stco->entries[ci] : co64->entries[ci];
+        
+        SrsMp4StscEntry* stsc_entry = stsc->on_chunk(ci);
+        for (uint32_t i = 0; i < stsc_entry->samples_per_chunk; i++) {
+            uint32_t sample_size = 0;
+            if ((err = stsz->get_sample_size((uint32_t)track->sizes.size(), &sample_size)) != srs_success) {
+                return srs_error_wrap(err, "stsz get sample size");
+            }
+            
+            track->offsets.push_back(offset);
+            track->sizes.push_back(sample_size);
+            offset += sample_size;
+        }
+    }
+    
+    // The dts of samples, and the end of track.
+    uint64_t dts = 0;
+    for (size_t i = 0; i < stts->entries.size(); i++) {
+        SrsMp4SttsEntry& entry = stts->entries[i];
+        for (uint32_t j = 0; j < entry.sample_count; j++) {
+            track->dts.push_back(dts);
+            dts += entry.sample_delta;
+        }
+    }
+    track->dts.push_back(dts);
+    
+    // The composition time offset of samples.
+    for (size_t i = 0; ctts && i < ctts->entries.size(); i++) {
+        SrsMp4CttsEntry& entry = ctts->entries[i];
+        for (uint32_t j = 0; j < entry.sample_count; j++) {
+            track->cts.push_back((int32_t)entry.sample_offset);
+        }
+    }
+    
+    // If the sync sample box is not present, every sample is a sync sample.
+    for (uint32_t i = 0; stss && i < stss->entry_count; i++) {
+        if (stss->sample_numbers[i] > 0) {
+            track->syncs.push_back(stss->sample_numbers[i] - 1);
+        }
+    }
+    
+    if (track->nb_samples() == 0 || track->nb_samples() != nb_samples || track->dts.size() != nb_samples + 1
+        || (!track->cts.empty() && track->cts.size() != nb_samples)) {
+        return srs_error_new(ERROR_MP4_ILLEGAL_SAMPLES, "illegal samples, stsz=%d, stco=%d, stts=%d, ctts=%d",
+            nb_samples, track->nb_samples(), (int)track->dts.size() - 1, (int)track->cts.size());
+    }
     
     return err;
 }
 
-srs_error_t SrsMp4M2tsSegmentEncoder::flush(uint64_t& dts)
+srs_error_t SrsMp4VodIndex::build_skeleton(SrsMp4MovieBox* moov)
 {
     srs_error_t err = srs_success;
     
-    if (!nb_audios && !nb_videos) {
-        return srs_error_new(ERROR_MP4_ILLEGAL_MOOF, "Missing audio and video track");
-    }
-
-    // Although the sidx is not required to start play DASH, but it's required for AV sync.
-    SrsMp4SegmentIndexBox* sidx = new SrsMp4SegmentIndexBox();
-    SrsAutoFree(SrsMp4SegmentIndexBox, sidx);
-    if (true) {
-        sidx->version = 1;
-        sidx->reference_id = 1;
-        sidx->timescale = 1000;
-        sidx->earliest_presentation_time = uint64_t(decode_basetime / sidx->timescale);
-
-        uint64_t duration = 0;
-        if (samples && !samples->samples.empty()) {
-            SrsMp4Sample* first = samples->samples[0];
-            SrsMp4Sample* last = samples->samples[samples->samples.size() - 1];
-            duration = srs_max(0, last->dts - first->dts);
+    SrsMp4MovieBox* skel = new SrsMp4MovieBox();
+    SrsAutoFree(SrsMp4MovieBox, skel);
+    
+    SrsMp4Box* boxes[] = {moov->mvhd(), moov->video(), moov->audio()};
+    for (int i = 0; i < 3; i++) {
+        SrsMp4Box* box = boxes[i];
+        if (!box) {
+            continue;
         }
-
-        SrsMp4SegmentIndexEntry entry;
-        memset(&entry, 0, sizeof(entry));
-        entry.subsegment_duration = duration;
-        entry.starts_with_SAP = 1;
-        sidx->entries.push_back(entry);
-    }
-
-    // Create a mdat box.
-    // its payload will be writen by samples,
-    // and we will update its header(size) when flush.
-    SrsMp4MediaDataBox* mdat = new SrsMp4MediaDataBox();
-    SrsAutoFree(SrsMp4MediaDataBox, mdat);
-
-    // Write moof.
-    if (true) {
-        SrsMp4MovieFragmentBox* moof = new SrsMp4MovieFragmentBox();
-        SrsAutoFree(SrsMp4MovieFragmentBox, moof);
         
-        SrsMp4MovieFragmentHeaderBox* mfhd = new SrsMp4MovieFragmentHeaderBox();
-        moof->set_mfhd(mfhd);
-        
-        mfhd->sequence_number = sequence_number;
-        
-        SrsMp4TrackFragmentBox* traf = new SrsMp4TrackFragmentBox();
-        moof->set_traf(traf);
+        // Remove the edts and sample tables, which are built when seeking.
+        SrsMp4TrackBox* trak = dynamic_cast<SrsMp4TrackBox*>(box);
+        if (trak) {
+            SrsMp4SampleTableBox* stbl = trak->stbl();
+            stbl->remove(SrsMp4BoxTypeSTTS);
+            stbl->remove(SrsMp4BoxTypeCTTS);
+            stbl->remove(SrsMp4BoxTypeSTSS);
+            stbl->remove(SrsMp4BoxTypeSTSC);
+            stbl->remove(SrsMp4BoxTypeSTSZ);
+            stbl->remove(SrsMp4BoxTypeSTCO);
+            stbl->remove(SrsMp4BoxTypeCO64);
+            trak->remove(SrsMp4BoxTypeEDTS);
+        }
         
-        SrsMp4TrackFragmentHeaderBox* tfhd = new SrsMp4TrackFragmentHeaderBox();
-        traf->set_tfhd(tfhd);
+        SrsMp4Box* cloned = NULL;
+        if ((err = srs_mp4_clone_box(box, &cloned)) != srs_success) {
+            return srs_error_wrap(err, "clone box");
+        }
+        skel->append(cloned);
+    }
+    
+    skeleton.resize((size_t)skel->nb_bytes());
+    
+    SrsBuffer buffer(&skeleton[0], (int)skeleton.size());
+    if ((err = skel->encode(&buffer)) != srs_success) {
+        return srs_error_wrap(err, "encode skeleton");
+    }
+    
+    // Use the default ftyp if not exists.
+    if (ftyp.empty()) {
+        SrsMp4FileTypeBox* box = new SrsMp4FileTypeBox();
+        SrsAutoFree(SrsMp4FileTypeBox, box);
         
-        tfhd->track_id = track_id;
-        tfhd->flags = SrsMp4TfhdFlagsDefaultBaseIsMoof;
+        box->major_brand = SrsMp4BoxBrandISOM;
+        box->minor_version = 512;
+        box->set_compatible_brands(SrsMp4BoxBrandISOM, SrsMp4BoxBrandISO2, SrsMp4BoxBrandAVC1, SrsMp4BoxBrandMP41);
         
-        SrsMp4TrackFragmentDecodeTimeBox* tfdt = new SrsMp4TrackFragmentDecodeTimeBox();
-        traf->set_tfdt(tfdt);
+        ftyp.resize((size_t)box->nb_bytes());
         
-        tfdt->version = 1;
-        tfdt->base_media_decode_time = srsu2ms(decode_basetime);
+        SrsBuffer buffer(&ftyp[0], (int)ftyp.size());
+        if ((err = box->encode(&buffer)) != srs_success) {
+            return srs_error_wrap(err, "encode ftyp");
+        }
+    }
+    
+    return err;
+}
+
+srs_error_t SrsMp4VodIndex::write_track(SrsMp4TrackBox* trak, SrsMp4VodTrack* track, uint32_t start, uint64_t begin, bool large)
+{
+    srs_error_t err = srs_success;
+    
+    SrsMp4SampleTableBox* stbl = trak->stbl();
+    uint32_t nb_samples = track->nb_samples() - start;
+    
+    // The dts, as delta of samples.
+    if (true) {
+        SrsMp4DecodingTime2SampleBox* stts = new SrsMp4DecodingTime2SampleBox();
+        stbl->set_stts(stts);
         
-        SrsMp4TrackFragmentRunBox* trun = new SrsMp4TrackFragmentRunBox();
-        traf->set_trun(trun);
+        SrsMp4SttsEntry entry;
+        for (uint32_t i = start; i < track->nb_samples(); i++) {
+            uint32_t delta = (uint32_t)(track->dts[i + 1] - track->dts[i]);
+            if (entry.sample_count && entry.sample_delta != delta) {
+                stts->entries.push_back(entry);
+                entry.sample_count = 0;
+            }
+            entry.sample_delta = delta;
+            entry.sample_count++;
+        }
+        stts->entries.push_back(entry);
+    }
+    
+    // The cts, only for video with B frames.
+    if (!track->cts.empty()) {
+        SrsMp4CompositionTime2SampleBox* ctts = new SrsMp4CompositionTime2SampleBox();
+        stbl->set_ctts(ctts);
         
-        if ((err = samples->write(moof, dts)) != srs_success) {
-            return srs_error_wrap(err, "write samples");
+        SrsMp4CttsEntry entry;
+        for (uint32_t i = start; i < track->nb_samples(); i++) {
+            int64_t offset = track->cts[i];
+            if (offset < 0) {
+                ctts->version = 0x01;
+            }
+            if (entry.sample_count && entry.sample_offset != offset) {
+                ctts->entries.push_back(entry);
+                entry.sample_count = 0;
+            }
+            entry.sample_offset = offset;
+            entry.sample_count++;
         }
+        ctts->entries.push_back(entry);
+    }
+    
+    // The sync samples, the first one is always sync sample.
+    if (!track->syncs.empty()) {
+        vector<uint32_t>::iterator it = std::lower_bound(track->syncs.begin(), track->syncs.end(), start);
         
-        // @remark Remember the data_offset of turn is size(moof)+header(mdat), not including styp or sidx.
-        int moof_bytes = moof->nb_bytes();
-        trun->data_offset = (int32_t)(moof_bytes + mdat->sz_header());
-        mdat->nb_data = mdat_bytes;
-
-        // Update the size of sidx.
-        SrsMp4SegmentIndexEntry* entry = &sidx->entries[0];
-        entry->referenced_size = moof_bytes + mdat->nb_bytes();
-        if ((err = srs_mp4_write_box(writer, sidx)) != srs_success) {
-            return srs_error_wrap(err, "write sidx");
+        SrsMp4SyncSampleBox* stss = new SrsMp4SyncSampleBox();
+        stbl->set_stss(stss);
+        
+        stss->entry_count = (uint32_t)(track->syncs.end() - it);
+        stss->sample_numbers = new uint32_t[stss->entry_count];
+        for (uint32_t i = 0; it != track->syncs.end(); ++it, i++) {
+            stss->sample_numbers[i] = *it - start + 1;
         }
-
-        if ((err = srs_mp4_write_box(writer, moof)) != srs_success) {
-            return srs_error_wrap(err, "write moof");
+    }
+    
+    // The samples in the same chunk, when continuous in file.
+    vector<uint64_t> chunks;
+    vector<SrsMp4StscEntry> stsc_entries;
+    if (true) {
+        uint32_t samples_per_chunk = 0;
+        for (uint32_t i = start; i <= track->nb_samples(); i++) {
+            bool continuous = i > start && i < track->nb_samples()
+                && track->offsets[i] == track->offsets[i - 1] + track->sizes[i - 1];
+            if (continuous) {
+                samples_per_chunk++;
+                continue;
+            }
+            
+            // Finish the previous chunk, merge to the stsc entry if same samples.
+            if (samples_per_chunk) {
+                if (stsc_entries.empty() || stsc_entries.back().samples_per_chunk != samples_per_chunk) {
+                    SrsMp4StscEntry entry;
+                    entry.first_chunk = (uint32_t)chunks.size();
+                    entry.samples_per_chunk = samples_per_chunk;
+                    entry.sample_description_index = 1;
+                    stsc_entries.push_back(entry);
+                }
+            }
+            
+            if (i < track->nb_samples()) {
+                chunks.push_back(track->offsets[i] - begin);
+                samples_per_chunk = 1;
+            }
         }
     }
     
-    // Write mdat.
     if (true) {
-        int nb_data = mdat->sz_header();
-        uint8_t* data = new uint8_t[nb_data];
-        SrsAutoFreeA(uint8_t, data);
-        
-        SrsBuffer* buffer = new SrsBuffer((char*)data, nb_data);
-        SrsAutoFree(SrsBuffer, buffer);
+        SrsMp4Sample2ChunkBox* stsc = new SrsMp4Sample2ChunkBox();
+        stbl->set_stsc(stsc);
         
-        if ((err = mdat->encode(buffer)) != srs_success) {
-            return srs_error_wrap(err, "encode mdat");
+        stsc->entry_count = (uint32_t)stsc_entries.size();
+        stsc->entries = new SrsMp4StscEntry[stsc->entry_count];
+        for (uint32_t i = 0; i < stsc->entry_count; i++) {
+            stsc->entries[i] = stsc_entries[i];
         }
+    }
+    
+    if (true) {
+        SrsMp4SampleSizeBox* stsz = new SrsMp4SampleSizeBox();
+        stbl->set_stsz(stsz);
         
-        // TODO: FIXME: Ensure all bytes are writen.
-        if ((err = writer->write(data, nb_data, NULL)) != srs_success) {
-            return srs_error_wrap(err, "write mdat");
+        stsz->sample_size = 0;
+        stsz->sample_count = nb_samples;
+        stsz->entry_sizes = new uint32_t[nb_samples];
+        memcpy(stsz->entry_sizes, &track->sizes[start], nb_samples * sizeof(uint32_t));
+    }
+    
+    // The chunk offset relative to the begin, user should add the base offset.
+    if (large) {
+        SrsMp4ChunkLargeOffsetBox* co64 = new SrsMp4ChunkLargeOffsetBox();
+        stbl->set_co64(co64);
+        
+        co64->entry_count = (uint32_t)chunks.size();
+        co64->entries = new uint64_t[co64->entry_count];
+        for (uint32_t i = 0; i < co64->entry_count; i++) {
+            co64->entries[i] = chunks[i];
         }
+    } else {
+        SrsMp4ChunkOffsetBox* stco = new SrsMp4ChunkOffsetBox();
+        stbl->set_stco(stco);
         
-        vector<SrsMp4Sample*>::iterator it;
-        for (it = samples->samples.begin(); it != samples->samples.end(); ++it) {
-            SrsMp4Sample* sample = *it;
-            
-            // TODO: FIXME: Ensure all bytes are writen.
-            if ((err = writer->write(sample->data, sample->nb_data, NULL)) != srs_success) {
-                return srs_error_wrap(err, "write sample");
-            }
+        stco->entry_count = (uint32_t)chunks.size();
+        stco->entries = new uint32_t[stco->entry_count];
+        for (uint32_t i = 0; i < stco->entry_count; i++) {
+            stco->entries[i] = (uint32_t)chunks[i];
         }
     }
-
+    
     return err;
 }
-
@@ -708,6 +708,8 @@ public:
     // Get the track extends box.
     virtual SrsMp4TrackExtendsBox* trex();
     virtual void set_trex(SrsMp4TrackExtendsBox* v);
+    // Add a track extends box, for fMP4 with multiple tracks.
+    virtual void add_trex(SrsMp4TrackExtendsBox* v);
 };
 
 // 8.8.3 Track Extends Box(trex)
@@ -2016,6 +2018,37 @@ private:
     virtual srs_error_t do_load_next_box(SrsMp4Box** ppbox, uint32_t required_box_type);
 };
 
+// The tracks of MP4 muxer, to build the moov box.
+struct SrsMp4MoovTracks
+{
+    // The track id of video and audio, zero if no such track.
+    uint32_t vtid;
+    uint32_t atid;
+    // The duration of each track in ms.
+    uint64_t vduration;
+    uint64_t aduration;
+    // The video codec info, the avcc is the AVCDecoderConfigurationRecord.
+    uint32_t width;
+    uint32_t height;
+    const std::vector<char>* avcc;
+    // The audio codec info, the asc is the AudioSpecificConfig, maybe empty for MP3.
+    SrsAudioCodecId acodec;
+    SrsAudioSampleRate sample_rate;
+    SrsAudioSampleBits sound_bits;
+    SrsAudioChannels channels;
+    const std::vector<char>* asc;
+    
+    SrsMp4MoovTracks();
+};
+
+// Get the object type of audio codec, for esds.
+extern SrsMp4ObjectType srs_mp4_audio_object_type(SrsAudioCodecId acodec, SrsAudioSampleRate sample_rate);
+
+// Build the moov box with the tracks, without sample tables, for the progressive and fragmented
+// MP4 muxers. If fragmented, the duration is zero, the sample tables are empty and the mvex with
+// trex of each track is added, or the edts is added for video track.
+extern void srs_mp4_build_moov(SrsMp4MovieBox* moov, const SrsMp4MoovTracks& tracks, bool fragmented);
+
 // The MP4 muxer.
 class SrsMp4Encoder
 {
@@ -2080,7 +2113,112 @@ public:
 private:
     virtual srs_error_t copy_sequence_header(SrsFormat* format, bool vsh, uint8_t* sample, uint32_t nb_sample);
     virtual srs_error_t do_write_sample(SrsMp4Sample* ps, uint8_t* sample, uint32_t nb_sample);
-    virtual SrsMp4ObjectType get_audio_object_type();
+};
+
+// The compact index of a sample, to build the moov when finalize the fMP4.
+struct SrsMp4SampleIndex
+{
+    // The offset of sample in file.
+    uint64_t offset;
+    // The size of sample.
+    uint32_t nb_data;
+    // The dts in ms.
+    uint32_t dts;
+    // The pts-dts in ms.
+    int32_t cts;
+    // The type of sample, audio or video.
+    uint8_t type;
+    // Whether video keyframe.
+    uint8_t keyframe;
+};
+
+// The fragmented MP4 muxer, to write a fMP4 file with A/V tracks, for DVR.
+// The moov with mvex is written first, then the samples of each fragment are cached and
+// written in moof and mdat, so the memory is bounded by the fragment duration, and the
+// file is always playable, even when it's still being written or the server crashed.
+// @remark Optionally, we can finalize the file to a progressive MP4, by appending a moov
+//      with sample tables, and rewriting the type of fMP4 moov and moof to free box.
+class SrsMp4FragmentedEncoder
+{
+private:
+    ISrsWriteSeeker* wsio;
+    // The duration of fragment, reap the fragment when exceed it, at keyframe if has video.
+    srs_utime_t fragment;
+    // Whether build the index to finalize the fMP4 to progressive MP4.
+    bool finalize_;
+    // The sequence number of moof, starts from 1.
+    uint32_t sequence_number;
+    // Whether the fMP4 moov is written.
+    bool moov_written;
+    // The track id of video and audio, 0 if no such track in moov.
+    uint32_t vtid;
+    uint32_t atid;
+    // The offset of fMP4 moov and moofs, we rewrite them to free box when finalize.
+    off_t moov_offset;
+    std::vector<off_t> moof_offsets;
+    // The samples of current fragment, with data copied.
+    std::vector<SrsMp4Sample*> videos;
+    std::vector<SrsMp4Sample*> audios;
+    // The dts of first sample in current fragment, in ms.
+    uint64_t fragment_dts;
+    uint32_t nb_videos;
+    uint32_t nb_audios;
+    // The duration of each track in ms, which is also the dts of last sample.
+    uint64_t vduration;
+    uint64_t aduration;
+    // The index of all samples, only build when finalize.
+    std::vector<SrsMp4SampleIndex> indexes;
+public:
+    // The audio codec of first track, generally there is zero or one track.
+    // Forbidden if no audio stream.
+    SrsAudioCodecId acodec;
+    // The audio sample rate.
+    SrsAudioSampleRate sample_rate;
+    // The audio sound bits.
+    SrsAudioSampleBits sound_bits;
+    // The audio sound type.
+    SrsAudioChannels channels;
+private:
+    // For AAC, the asc in esds box.
+    std::vector<char> pasc;
+public:
+    // The video codec of first track, generally there is zero or one track.
+    // Forbidden if no video stream.
+    SrsVideoCodecId vcodec;
+private:
+    // For H.264/AVC, the avcc contains the sps/pps.
+    std::vector<char> pavcc;
+    // The size width/height of video.
+    uint32_t width;
+    uint32_t height;
+public:
+    SrsMp4FragmentedEncoder();
+    virtual ~SrsMp4FragmentedEncoder();
+public:
+    // Initialize the encoder with a writer and seeker ws.
+    // @param ws The underlayer io writer and seeker, user must manage it.
+    // @param duration The duration of each fragment.
+    // @param finalize Whether finalize to progressive MP4 when flush, which requires a compact index.
+    virtual srs_error_t initialize(ISrsWriteSeeker* ws, srs_utime_t duration, bool finalize);
+    // Write a sample to fMP4, see SrsMp4Encoder::write_sample.
+    // @remark The sample is cached in current fragment, and written when fragment is reaped.
+    virtual srs_error_t write_sample(SrsFormat* format, SrsMp4HandlerType ht, uint16_t ft, uint16_t ct,
+        uint32_t dts, uint32_t pts, uint8_t* sample, uint32_t nb_sample);
+    // Flush the encoder, to write the last fragment, and finalize to progressive MP4 if required.
+    virtual srs_error_t flush();
+private:
+    virtual srs_error_t copy_sequence_header(SrsFormat* format, bool vsh, uint8_t* sample, uint32_t nb_sample);
+    // Write the ftyp and moov with mvex, before the first fragment.
+    virtual srs_error_t write_moov();
+    // Write the cached samples as a fragment, a pair of moof and mdat for each track.
+    // @param next_video_dts The dts of the keyframe which starts next fragment, 0 if unknown.
+    virtual srs_error_t write_fragment(uint64_t next_video_dts);
+    // @param next_dts The dts of next sample in track, 0 if unknown.
+    virtual srs_error_t write_track_fragment(std::vector<SrsMp4Sample*>& samples, uint32_t tid, uint64_t next_dts);
+    // Append the progressive moov, then rewrite the fMP4 moov and moofs to free box.
+    virtual srs_error_t do_finalize();
+    // Build the moov with the traks, without sample tables.
+    virtual void build_moov(SrsMp4MovieBox* moov, bool fragmented);
 };
 
 // A fMP4 encoder, to write the init.mp4 with sequence header.
@@ -2133,6 +2271,69 @@ public:
     virtual srs_error_t flush(uint64_t& dts);
 };
 
+// The columnar sample index of a track, for MP4 VOD.
+// @remark We use flat arrays rather than SrsMp4Sample objects, to cache index of large files.
+class SrsMp4VodTrack
+{
+public:
+    SrsFrameType type;
+    // The timescale of track, in mdhd.
+    uint32_t timescale;
+    // The offset of samples in file.
+    std::vector<uint64_t> offsets;
+    // The size of samples.
+    std::vector<uint32_t> sizes;
+    // The dts of samples in timescale, with an extra one which is the end of track.
+    std::vector<uint64_t> dts;
+    // The pts-dts of samples in timescale, empty if no ctts.
+    std::vector<int32_t> cts;
+    // The index of sync samples, starts from 0, empty if all samples are sync.
+    std::vector<uint32_t> syncs;
+public:
+    SrsMp4VodTrack(SrsFrameType t);
+    virtual ~SrsMp4VodTrack();
+public:
+    // Get the number of samples.
+    virtual uint32_t nb_samples();
+    // Get the dts in ms of sample.
+    virtual uint64_t dts_ms(uint32_t index);
+    // Find the last sample whose dts is not after the time in ms.
+    virtual uint32_t find(uint64_t ms);
+    // Find the sync sample which is not after the sample.
+    virtual uint32_t find_sync(uint32_t index);
+};
+
+// The index of MP4 file for VOD, to seek and remux from any keyframe.
+// For example, http://server/file.mp4?start=10.5, we build the ftyp, moov and mdat header
+// for samples from the keyframe before 10.5s, then send the samples in original file.
+class SrsMp4VodIndex
+{
+private:
+    std::vector<char> ftyp;
+    // The moov with mvhd and tracks, but without sample tables, to build moov when seeking.
+    std::vector<char> skeleton;
+    SrsMp4VodTrack* video;
+    SrsMp4VodTrack* audio;
+public:
+    SrsMp4VodIndex();
+    virtual ~SrsMp4VodIndex();
+public:
+    // Build the index from the whole file in memory, generally it's mmaped.
+    virtual srs_error_t initialize(char* data, int64_t size);
+    // Get the duration in ms.
+    virtual uint64_t duration();
+    // Seek to the keyframe before the time in ms, build the header of a new MP4 file.
+    // @param header The output ftyp, moov and mdat header of new file.
+    // @param pstart The output start offset of samples in original file.
+    // @param pend The output end offset of samples in original file, the mdat is [start, end).
+    virtual srs_error_t seek(uint64_t ms, std::vector<char>& header, uint64_t* pstart, uint64_t* pend);
+private:
+    virtual srs_error_t load_track(SrsMp4TrackBox* trak, SrsMp4VodTrack* track);
+    virtual srs_error_t build_skeleton(SrsMp4MovieBox* moov);
+    // Build the sample tables from the start sample, the chunk offset is relative to begin.
+    virtual srs_error_t write_track(SrsMp4TrackBox* trak, SrsMp4VodTrack* track, uint32_t start, uint64_t begin, bool large);
+};
+
 // LCOV_EXCL_START
 /////////////////////////////////////////////////////////////////////////////////
 // MP4 dumps functions.
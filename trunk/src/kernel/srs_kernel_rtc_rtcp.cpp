@@ -8,6 +8,7 @@
 
 #include <srs_kernel_error.hpp>
 #include <srs_kernel_log.hpp>
+#include <srs_kernel_utility.hpp>
 
 #include <arpa/inet.h>
 using namespace std;
@@ -494,7 +495,7 @@ uint32_t SrsRtcpRR::get_rb_ssrc() const
 
 float SrsRtcpRR::get_lost_rate() const
 {
-    return rb_.fraction_lost / 256;
+    return rb_.fraction_lost / 256.0;
 }
 
 uint32_t SrsRtcpRR::get_lost_packets() const
@@ -833,11 +834,107 @@ srs_error_t SrsRtcpTWCC::decode(SrsBuffer *buffer)
     }
 
     payload_len_ = (header_.length + 1) * 4 - sizeof(SrsRtcpHeader) - 4;
+    if (payload_len_ < 0 || payload_len_ > (int)sizeof(payload_) || !buffer->require(payload_len_)) {
+        return srs_error_new(ERROR_RTC_RTCP, "invalid twcc payload=%d, left=%d", payload_len_, buffer->left());
+    }
     buffer->read_bytes((char *)payload_, payload_len_);
 
+    // Ignore the malformed feedback, which should never break the other RTCP packets of compound.
+    SrsBuffer payload((char*)payload_, payload_len_);
+    if ((err = do_decode(&payload)) != srs_success) {
+        statuses_.clear();
+        srs_freep(err);
+    }
+
+    return err;
+}
+
+srs_error_t SrsRtcpTWCC::do_decode(SrsBuffer *buffer)
+{
+    srs_error_t err = srs_success;
+
+    encoded_chucks_.clear();
+    pkt_deltas_.clear();
+    statuses_.clear();
+
+    if (!buffer->require(12)) {
+        return srs_error_new(ERROR_RTC_RTCP, "require 12 bytes, left=%d", buffer->left());
+    }
+
+    media_ssrc_ = buffer->read_4bytes();
+    base_sn_ = buffer->read_2bytes();
+    uint16_t status_count = buffer->read_2bytes();
+    // The reference time is a signed 24 bits integer, in multiples of 64ms.
+    reference_time_ = buffer->read_3bytes();
+    if (reference_time_ & 0x800000) {
+        reference_time_ |= 0xff000000;
+    }
+    fb_pkt_count_ = buffer->read_1bytes();
+
+    // Decode the chunks to symbols, each symbol is the status of a packet:
+    //      0: Packet not received, 1: Packet received, small delta, 2: Packet received, large or negative delta.
+    std::vector<uint8_t> symbols;
+    while ((int)symbols.size() < status_count) {
+        if (!buffer->require(kTwccFbChunkBytes)) {
+            return srs_error_new(ERROR_RTC_RTCP, "require chunk, statuses=%d/%d", (int)symbols.size(), status_count);
+        }
+
+        uint16_t chunk = buffer->read_2bytes();
+        encoded_chucks_.push_back(chunk);
+
+        int left = status_count - (int)symbols.size();
+        if ((chunk & 0x8000) == 0) {
+            // Run length chunk.
+            uint8_t symbol = (chunk >> 13) & 0x03;
+            int run = srs_min(chunk & kTwccFbMaxRunLength, left);
+            symbols.insert(symbols.end(), run, symbol);
+        } else if ((chunk & 0x4000) == 0) {
+            // Status vector chunk, with 1 bit symbols.
+            for (int i = 0; i < kTwccFbOneBitElements && i < left; i++) {
+                symbols.push_back((chunk >> (kTwccFbOneBitElements - 1 - i)) & 0x01);
+            }
+        } else {
+            // Status vector chunk, with 2 bits symbols.
+            for (int i = 0; i < kTwccFbTwoBitElements && i < left; i++) {
+                symbols.push_back((chunk >> (2 * (kTwccFbTwoBitElements - 1 - i))) & 0x03);
+            }
+        }
+    }
+
+    // Decode the deltas of received packets, in multiples of 250us.
+    srs_utime_t recv_time = (srs_utime_t)reference_time_ * kTwccFbTimeMultiplier;
+    for (int i = 0; i < (int)symbols.size(); i++) {
+        SrsRtcpTWCCStatus status;
+        status.sn = base_sn_ + i;
+        status.received = false;
+        status.recv_time = 0;
+
+        uint8_t symbol = symbols.at(i);
+        if (symbol == 1 || symbol == 2) {
+            int nn = (symbol == 1) ? 1 : kTwccFbLargeRecvDeltaBytes;
+            if (!buffer->require(nn)) {
+                return srs_error_new(ERROR_RTC_RTCP, "require delta, sn=%u", status.sn);
+            }
+
+            int16_t delta = (symbol == 1) ? (int16_t)(uint8_t)buffer->read_1bytes() : (int16_t)buffer->read_2bytes();
+            pkt_deltas_.push_back((uint16_t)delta);
+
+            recv_time += (srs_utime_t)delta * kTwccFbDeltaUnit;
+            status.received = true;
+            status.recv_time = recv_time;
+        }
+
+        statuses_.push_back(status);
+    }
+
     return err;
 }
 
+const vector<SrsRtcpTWCCStatus>& SrsRtcpTWCC::get_statuses() const
+{
+    return statuses_;
+}
+
 uint64_t SrsRtcpTWCC::nb_bytes()
 {
     return kMaxUDPDataSize;
@@ -1229,12 +1326,21 @@ vector<uint16_t> SrsRtcpNack::get_lost_sns() const
     for(set<uint16_t, SrsSeqCompareLess>::iterator it = lost_sns_.begin(); it != lost_sns_.end(); ++it) {
         sn.push_back(*it);
     }
+    for (int i = 0; i < (int)chunks_.size(); i++) {
+        const SrsPidBlp& chunk = chunks_.at(i);
+        sn.push_back(chunk.pid);
+        for (int j = 0; j < 16; j++) {
+            if (chunk.blp & (1 << j)) {
+                sn.push_back(chunk.pid + j + 1);
+            }
+        }
+    }
     return sn;
 }
 
 bool SrsRtcpNack::empty()
 {
-    return lost_sns_.empty();
+    return lost_sns_.empty() && chunks_.empty();
 }
 
 void SrsRtcpNack::set_media_ssrc(uint32_t ssrc)
@@ -1247,6 +1353,15 @@ void SrsRtcpNack::add_lost_sn(uint16_t sn)
     lost_sns_.insert(sn);
 }
 
+void SrsRtcpNack::add_lost_chunk(uint16_t pid, uint16_t blp)
+{
+    SrsPidBlp chunk;
+    chunk.pid = pid;
+    chunk.blp = blp;
+    chunk.in_use = true;
+    chunks_.push_back(chunk);
+}
+
 srs_error_t SrsRtcpNack::decode(SrsBuffer *buffer)
 {
     /*
@@ -1361,6 +1476,7 @@ srs_error_t SrsRtcpNack::encode(SrsBuffer *buffer)
         if(chunk.in_use) {
             chunks.push_back(chunk);
         }
+        chunks.insert(chunks.end(), chunks_.begin(), chunks_.end());
 
         header_.length = 2 + chunks.size();
         if(srs_success != (err = encode_header(buffer))) {
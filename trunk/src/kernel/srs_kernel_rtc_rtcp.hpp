@@ -247,6 +247,16 @@ public:
 #define kTwccFbLargeRecvDeltaBytes	2
 #define kTwccFbMaxBitElements 		kTwccFbOneBitElements
 
+// The status of a packet in the received TWCC feedback, for sender to estimate the bandwidth.
+struct SrsRtcpTWCCStatus
+{
+    // The transport-wide sequence number.
+    uint16_t sn;
+    bool received;
+    // The receive time in us, which is the reference time plus the deltas, only valid when received.
+    srs_utime_t recv_time;
+};
+
 class SrsRtcpTWCC : public SrsRtcpCommon
 {
 private:
@@ -270,6 +280,9 @@ private:
 
     int pkt_len;
     uint16_t next_base_sn_;
+
+    // The statuses of packets, decoded from the feedback.
+    std::vector<SrsRtcpTWCCStatus> statuses_;
 private:
     void clear();
     srs_utime_t calculate_delta_us(srs_utime_t ts, srs_utime_t last);
@@ -302,6 +315,8 @@ public:
 
     srs_error_t recv_packet(uint16_t sn, srs_utime_t ts);
     bool need_feedback();
+    // Get the statuses of packets in order of sequence number, after decode.
+    const std::vector<SrsRtcpTWCCStatus>& get_statuses() const;
 
 // interface ISrsCodec
 public:
@@ -310,6 +325,7 @@ public:
     virtual srs_error_t encode(SrsBuffer *buffer);   
 private:
     srs_error_t do_encode(SrsBuffer *buffer);
+    srs_error_t do_decode(SrsBuffer *buffer);
 };
 
 class SrsRtcpNack : public SrsRtcpCommon
@@ -323,6 +339,8 @@ private:
 
     uint32_t media_ssrc_;
     std::set<uint16_t, SrsSeqCompareLess> lost_sns_;
+    // The packed chunks, encoded after the chunks of lost sns.
+    std::vector<SrsPidBlp> chunks_;
 public:
     SrsRtcpNack(uint32_t sender_ssrc = 0);
     virtual ~SrsRtcpNack();
@@ -333,6 +351,8 @@ public:
 
     void set_media_ssrc(uint32_t ssrc);
     void add_lost_sn(uint16_t sn);
+    // Add a packed generic NACK, the lost pid and the bitmask of following 16 lost packets.
+    void add_lost_chunk(uint16_t pid, uint16_t blp);
 // interface ISrsCodec
 public:
     virtual srs_error_t decode(SrsBuffer *buffer);
@@ -124,6 +124,58 @@ srs_error_t srs_rtp_fast_parse_twcc(char* buf, int size, uint8_t twcc_id, uint16
     return err;
 }
 
+srs_error_t srs_rtp_fast_parse_rid(char* buf, int size, uint8_t rid_id, std::string& rid)
+{
+    srs_error_t err = srs_success;
+
+    if (size < 12 + 4) {
+        return srs_error_new(ERROR_RTC_RTP_MUXER, "required %d bytes, actual %d", 12 + 4, size);
+    }
+
+    uint8_t first = buf[0];
+    bool extension = (first & 0x10);
+    uint8_t cc = (first & 0x0F);
+    if (!extension) {
+        return srs_error_new(ERROR_RTC_RTP, "no extension in rtp");
+    }
+
+    char* p = buf + 12 + 4 * cc;
+    if (p + 4 > buf + size) {
+        return srs_error_new(ERROR_RTC_RTP_MUXER, "required %d bytes, actual %d", 12 + 4 * cc + 4, size);
+    }
+
+    uint16_t profile = ntohs(*((uint16_t*)p));
+    if (0xBEDE != profile) {
+        return srs_error_new(ERROR_RTC_RTP_MUXER, "no support this type(0x%02x) extension", profile);
+    }
+
+    char* end = p + 4 + ntohs(*((uint16_t*)(p + 2))) * 4;
+    if (end > buf + size) {
+        return srs_error_new(ERROR_RTC_RTP_MUXER, "required %d bytes, actual %d", (int)(end - buf), size);
+    }
+
+    for (p += 4; p < end;) {
+        uint8_t v = *p++;
+        if (0 == v) {
+            continue;
+        }
+
+        uint8_t id = (v & 0xF0) >> 4;
+        uint8_t len = (v & 0x0F) + 1;
+        if (p + len > end) {
+            break;
+        }
+
+        if (id == rid_id) {
+            rid = std::string(p, len);
+            return err;
+        }
+        p += len;
+    }
+
+    return srs_error_new(ERROR_RTC_RTP, "no rid extension id=%u", rid_id);
+}
+
 // If value is newer than pre_value，return true; otherwise false
 bool srs_seq_is_newer(uint16_t value, uint16_t pre_value)
 {
@@ -763,6 +815,7 @@ SrsRtpPacket::SrsRtpPacket()
     cached_payload_size = 0;
     decode_handler = NULL;
     avsync_time_ = -1;
+    ingress_ = 0;
 
     ++_srs_pps_objs_rtps->sugar;
 }
@@ -837,6 +890,7 @@ SrsRtpPacket* SrsRtpPacket::copy()
     cp->decode_handler = decode_handler;
 
     cp->avsync_time_ = avsync_time_;
+    cp->ingress_ = ingress_;
 
     return cp;
 }
@@ -1020,6 +1074,74 @@ ISrsRtpPayloader* SrsRtpRawPayload::copy()
     return cp;
 }
 
+SrsRtpRedPayload::SrsRtpRedPayload()
+{
+    block_pt = 0;
+    block = NULL;
+}
+
+SrsRtpRedPayload::~SrsRtpRedPayload()
+{
+    srs_freep(block);
+}
+
+uint64_t SrsRtpRedPayload::nb_bytes()
+{
+    return 1 + (block ? block->nb_bytes() : 0);
+}
+
+srs_error_t SrsRtpRedPayload::encode(SrsBuffer* buf)
+{
+    srs_error_t err = srs_success;
+
+    if (!buf->require(1)) {
+        return srs_error_new(ERROR_RTC_RTP_MUXER, "requires %d bytes", 1);
+    }
+
+    // The F bit is 0, for the last(primary) block.
+    buf->write_1bytes(block_pt & 0x7f);
+
+    if (block && (err = block->encode(buf)) != srs_success) {
+        return srs_error_wrap(err, "encode block");
+    }
+
+    return err;
+}
+
+srs_error_t SrsRtpRedPayload::decode(SrsBuffer* buf)
+{
+    srs_error_t err = srs_success;
+
+    if (!buf->require(1)) {
+        return srs_error_new(ERROR_RTC_RTP_MUXER, "requires %d bytes", 1);
+    }
+
+    // Only support the primary block.
+    uint8_t v = buf->read_1bytes();
+    if ((v & 0x80) != 0) {
+        return srs_error_new(ERROR_RTC_RTP_MUXER, "redundant block 0x%x", v);
+    }
+    block_pt = v & 0x7f;
+
+    srs_freep(block);
+    block = new SrsRtpRawPayload();
+    if ((err = block->decode(buf)) != srs_success) {
+        return srs_error_wrap(err, "decode block");
+    }
+
+    return err;
+}
+
+ISrsRtpPayloader* SrsRtpRedPayload::copy()
+{
+    SrsRtpRedPayload* cp = new SrsRtpRedPayload();
+
+    cp->block_pt = block_pt;
+    cp->block = block ? block->copy() : NULL;
+
+    return cp;
+}
+
 SrsRtpRawNALUs::SrsRtpRawNALUs()
 {
     cursor = 0;
@@ -48,6 +48,8 @@ class SrsRtpExtensionTypes;
 uint32_t srs_rtp_fast_parse_ssrc(char* buf, int size);
 uint8_t srs_rtp_fast_parse_pt(char* buf, int size);
 srs_error_t srs_rtp_fast_parse_twcc(char* buf, int size, uint8_t twcc_id, uint16_t& twcc_sn);
+// Fast parse the RID(RTP stream id) extension, which is a string, for simulcast.
+srs_error_t srs_rtp_fast_parse_rid(char* buf, int size, uint8_t rid_id, std::string& rid);
 
 // The "distance" between two uint16 number, for example:
 //      distance(prev_value=3, value=5) === (int16_t)(uint16_t)((uint16_t)3-(uint16_t)5) === -2
@@ -252,6 +254,7 @@ enum SrsRtspPacketPayloadType
     SrsRtspPacketPayloadTypeFUA,
     SrsRtspPacketPayloadTypeNALU,
     SrsRtspPacketPayloadTypeSTAP,
+    SrsRtspPacketPayloadTypeRED,
     SrsRtspPacketPayloadTypeUnknown,
 };
 
@@ -296,6 +299,8 @@ private:
     ISrsRtspPacketDecodeHandler* decode_handler;
 private:
     int64_t avsync_time_;
+    // The time when packet is received, 0 if not stamped, for latency stat.
+    srs_utime_t ingress_;
 public:
     SrsRtpPacket();
     virtual ~SrsRtpPacket();
@@ -312,7 +317,7 @@ public:
     void enable_twcc_decode() { header.enable_twcc_decode(); } // SrsRtpPacket::enable_twcc_decode
     // Get and set the payload of packet.
     // @remark Note that return NULL if no payload.
-    void set_payload(ISrsRtpPayloader* p, SrsRtspPacketPayloadType pt) { payload_ = p; payload_type_ = pt; }
+    void set_payload(ISrsRtpPayloader* p, SrsRtspPacketPayloadType pt) { payload_ = p; payload_type_ = pt; cached_payload_size = 0; }
     ISrsRtpPayloader* payload() { return payload_; }
     // Set the padding of RTP packet.
     void set_padding(int size);
@@ -333,6 +338,8 @@ public:
     bool is_keyframe();
     void set_avsync_time(int64_t avsync_time) { avsync_time_ = avsync_time; }
     int64_t get_avsync_time() const { return avsync_time_; }
+    void set_ingress(srs_utime_t v) { ingress_ = v; }
+    srs_utime_t ingress() const { return ingress_; }
 };
 
 // Single payload data.
@@ -354,6 +361,26 @@ public:
     virtual ISrsRtpPayloader* copy();
 };
 
+// The RED payload with only the primary block, to send media and FEC in the same stream.
+// @see https://datatracker.ietf.org/doc/html/rfc2198#section-3
+class SrsRtpRedPayload : public ISrsRtpPayloader
+{
+public:
+    // The payload type of block, for example, the media or ULPFEC.
+    uint8_t block_pt;
+    // The payload of block, owned by RED payload.
+    ISrsRtpPayloader* block;
+public:
+    SrsRtpRedPayload();
+    virtual ~SrsRtpRedPayload();
+// interface ISrsRtpPayloader
+public:
+    virtual uint64_t nb_bytes();
+    virtual srs_error_t encode(SrsBuffer* buf);
+    virtual srs_error_t decode(SrsBuffer* buf);
+    virtual ISrsRtpPayloader* copy();
+};
+
 // Multiple NALUs, automatically insert 001 between NALUs.
 class SrsRtpRawNALUs : public ISrsRtpPayloader
 {
@@ -3135,6 +3135,11 @@ srs_error_t SrsTsTransmuxer::write_video(int64_t timestamp, char* data, int size
     return flush_video();
 }
 
+void SrsTsTransmuxer::reset_pat_pmt()
+{
+    context->reset();
+}
+
 srs_error_t SrsTsTransmuxer::flush_audio()
 {
     srs_error_t err = srs_success;
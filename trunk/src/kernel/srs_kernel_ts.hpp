@@ -1324,6 +1324,8 @@ public:
     // @remark assert data is not NULL.
     virtual srs_error_t write_audio(int64_t timestamp, char* data, int size);
     virtual srs_error_t write_video(int64_t timestamp, char* data, int size);
+    // Write the PAT/PMT again before the next frame, so that a viewer could start from it.
+    virtual void reset_pat_pmt();
 private:
     virtual srs_error_t flush_audio();
     virtual srs_error_t flush_video();
@@ -42,6 +42,9 @@ using namespace std;
 #include <srs_app_rtc_conn.hpp>
 #include <srs_app_rtc_server.hpp>
 #endif
+#ifdef SRS_FFMPEG_FIT
+#include <srs_app_rtc_codec.hpp>
+#endif
 
 #ifdef SRS_SRT
 #include <srs_protocol_srt.hpp>
@@ -473,6 +476,13 @@ srs_error_t run_in_thread_pool()
         return srs_error_wrap(err, "start async log thread");
     }
 
+#ifdef SRS_FFMPEG_FIT
+    // Run the audio transcode threads, to transcode audio for RTC bridges, avoiding block the hybrid thread.
+    if ((err = _srs_audio_workers->start(_srs_config->get_threads_audio_transcoders())) != srs_success) {
+        return srs_error_wrap(err, "start audio transcode threads");
+    }
+#endif
+
     // Start the hybrid service worker thread, for RTMP and RTC server, etc.
     if ((err = _srs_thread_pool->execute("hybrid", run_hybrid_server, (void*)NULL)) != srs_success) {
         return srs_error_wrap(err, "start hybrid server thread");
@@ -410,6 +410,11 @@ void SrsHttpClient::set_recv_timeout(srs_utime_t tm)
     recv_timeout = tm;
 }
 
+int64_t SrsHttpClient::get_recv_bytes()
+{
+    return transport? transport->get_recv_bytes() : 0;
+}
+
 void SrsHttpClient::kbps_sample(const char* label, int64_t age)
 {
     kbps->sample();
@@ -102,6 +102,8 @@ public:
     virtual srs_error_t get(std::string path, std::string req, ISrsHttpMessage** ppmsg);
 public:
     virtual void set_recv_timeout(srs_utime_t tm);
+    // Get the bytes received by the transport, zero if not connected.
+    virtual int64_t get_recv_bytes();
 public:
     virtual void kbps_sample(const char* label, int64_t age);
 private:
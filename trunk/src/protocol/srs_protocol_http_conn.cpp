@@ -32,7 +32,6 @@ SrsHttpParser::SrsHttpParser()
 SrsHttpParser::~SrsHttpParser()
 {
     srs_freep(buffer);
-    srs_freep(header);
 }
 
 srs_error_t SrsHttpParser::initialize(enum http_parser_type type)
@@ -75,10 +74,9 @@ srs_error_t SrsHttpParser::parse_message(ISrsReader* reader, ISrsHttpMessage** p
     // The body that we have read from cache.
     p_body_start = p_header_tail = NULL;
     // We must reset the field name and value, because we may get a partial value in on_header_value.
-    field_name = field_value = "";
-    // The header of the request.
-    srs_freep(header);
-    header = new SrsHttpHeader();
+    field_name.clear();
+    field_value.clear();
+    url.clear();
 
     // Reset parser for each message.
     // If the request is large, such as the fifth message at @utest ProtocolHTTPTest.ParsingLargeMessages,
@@ -93,17 +91,21 @@ srs_error_t SrsHttpParser::parse_message(ISrsReader* reader, ISrsHttpMessage** p
     // callback object ptr.
     parser.data = (void*)this;
     
+    // Parse the header to msg directly, to avoid copying the header.
+    SrsHttpMessage* msg = new SrsHttpMessage(reader, buffer);
+    header = msg->header();
+    
     // do parse
-    if ((err = parse_message_imp(reader)) != srs_success) {
+    err = parse_message_imp(reader);
+    header = NULL;
+    if (err != srs_success) {
+        srs_freep(msg);
         return srs_error_wrap(err, "parse message");
     }
-    
-    // create msg
-    SrsHttpMessage* msg = new SrsHttpMessage(reader, buffer);
 
     // Initialize the basic information.
     msg->set_basic(hp_header.type, hp_header.method, hp_header.status_code, hp_header.content_length);
-    msg->set_header(header, http_should_keep_alive(&hp_header));
+    msg->set_header(msg->header(), http_should_keep_alive(&hp_header));
     // For HTTP response, no url.
     if (type_ != HTTP_RESPONSE && (err = msg->set_url(url, jsonp)) != srs_success) {
         srs_freep(msg);
@@ -124,9 +126,15 @@ srs_error_t SrsHttpParser::parse_message_imp(ISrsReader* reader)
         if (buffer->size() > 0) {
             ssize_t consumed = http_parser_execute(&parser, &settings, buffer->bytes(), buffer->size());
 
-            // The error is set in http_errno.
-            enum http_errno code;
-	        if ((code = HTTP_PARSER_ERRNO(&parser)) != HPE_OK) {
+            // The error is set in http_errno, and the parser is paused when header completed.
+            enum http_errno code = HTTP_PARSER_ERRNO(&parser);
+            if (code == HPE_PAUSED) {
+                http_parser_pause(&parser, 0);
+                code = HPE_OK;
+                // The parser is paused at the last LF of header, which is not consumed.
+                consumed++;
+            }
+	        if (code != HPE_OK) {
 	            return srs_error_new(ERROR_HTTP_PARSE_HEADER, "parse %dB, nparsed=%d, err=%d/%s %s",
 	                buffer->size(), (int)consumed, code, http_errno_name(code), http_errno_description(code));
 	        }
@@ -195,6 +203,9 @@ int SrsHttpParser::on_headers_complete(http_parser* parser)
     // When we got the body start event, we will update it to much precious position.
     obj->p_body_start = obj->buffer->bytes() + obj->buffer->size();
 
+    // Pause the parser, never parse the body or the next pipelined message, which overwrites the url and header.
+    http_parser_pause(parser, 1);
+
     srs_info("***HEADERS COMPLETE***");
     
     // see http_parser.c:1570, return 1 to skip body.
@@ -220,7 +231,7 @@ int SrsHttpParser::on_url(http_parser* parser, const char* at, size_t length)
     srs_assert(obj);
     
     if (length > 0) {
-        obj->url = string(at, (int)length);
+        obj->url.append(at, (int)length);
     }
 
     // When header parsed, we must save the position of start for body,
@@ -331,7 +342,9 @@ void SrsHttpMessage::set_basic(uint8_t type, uint8_t method, uint16_t status, in
 
 void SrsHttpMessage::set_header(SrsHttpHeader* header, bool keep_alive)
 {
-    _header = *header;
+    if (header != &_header) {
+        _header = *header;
+    }
     _keep_alive = keep_alive;
 
     // whether chunked.
@@ -750,8 +763,17 @@ srs_error_t SrsHttpResponseWriter::write(char* data, int size)
         write_header(SRS_CONSTS_HTTP_OK);
     }
     
+    // For content length, send the header and body in one packet, because the delayed ACK of peer stalls the
+    // body for about 40ms if send in two packets, which is the bottleneck of keep-alive and pipelined requests.
+    string hb;
+    bool merge = !header_sent && content_length != -1 && data && size > 0;
+
     // whatever header is wrote, we should try to send header.
-    if ((err = send_header(data, size)) != srs_success) {
+    if (merge) {
+        if ((err = build_header(data, size, hb)) != srs_success) {
+            return srs_error_wrap(err, "build header");
+        }
+    } else if ((err = send_header(data, size)) != srs_success) {
         return srs_error_wrap(err, "send header");
     }
     
@@ -768,7 +790,16 @@ srs_error_t SrsHttpResponseWriter::write(char* data, int size)
     
     // directly send with content length
     if (content_length != -1) {
-        return skt->write((void*)data, size, NULL);
+        if (!merge) {
+            return skt->write((void*)data, size, NULL);
+        }
+        
+        iovec iovs[2];
+        iovs[0].iov_base = (char*)hb.data();
+        iovs[0].iov_len = hb.length();
+        iovs[1].iov_base = data;
+        iovs[1].iov_len = size;
+        return skt->writev(iovs, 2, NULL);
     }
     
     // send in chunked encoding.
@@ -872,6 +903,37 @@ srs_error_t SrsHttpResponseWriter::writev(const iovec* iov, int iovcnt, ssize_t*
     return err;
 }
 
+srs_error_t SrsHttpResponseWriter::sendfile(int fd, int64_t offset, int64_t size, bool* psent)
+{
+    srs_error_t err = srs_success;
+    
+    *psent = false;
+    
+    // Only the plaintext TCP supports sendfile, while the TLS connection must encrypt data in userspace.
+    ISrsFileSender* sender = dynamic_cast<ISrsFileSender*>(skt);
+    
+    // The chunked encoding requires the chunk header, so use sendfile only for content length.
+    if (!sender || !header_wrote || content_length == -1 || size <= 0) {
+        return err;
+    }
+    
+    if ((err = send_header(NULL, 0)) != srs_success) {
+        return srs_error_wrap(err, "send header");
+    }
+    
+    written += size;
+    if (written > content_length) {
+        return srs_error_new(ERROR_HTTP_CONTENT_LENGTH, "overflow writen=%" PRId64 ", max=%" PRId64, written, content_length);
+    }
+    
+    if ((err = sender->sendfile(fd, offset, size, NULL)) != srs_success) {
+        return srs_error_wrap(err, "sendfile offset=%" PRId64 ", size=%" PRId64, offset, size);
+    }
+    
+    *psent = true;
+    return err;
+}
+
 void SrsHttpResponseWriter::write_header(int code)
 {
     if (header_wrote) {
@@ -893,6 +955,19 @@ srs_error_t SrsHttpResponseWriter::send_header(char* data, int size)
     if (header_sent) {
         return err;
     }
+    
+    std::string buf;
+    if ((err = build_header(data, size, buf)) != srs_success) {
+        return srs_error_wrap(err, "build header");
+    }
+    
+    return skt->write((void*)buf.c_str(), buf.length(), NULL);
+}
+
+srs_error_t SrsHttpResponseWriter::build_header(char* data, int size, std::string& buf)
+{
+    srs_error_t err = srs_success;
+    
     header_sent = true;
     
     std::stringstream ss;
@@ -934,8 +1009,9 @@ srs_error_t SrsHttpResponseWriter::send_header(char* data, int size)
     // header_eof
     ss << SRS_HTTP_CRLF;
     
-    std::string buf = ss.str();
-    return skt->write((void*)buf.c_str(), buf.length(), NULL);
+    buf = ss.str();
+    
+    return err;
 }
 
 SrsHttpResponseReader::SrsHttpResponseReader(SrsHttpMessage* msg, ISrsReader* reader, SrsFastStream* body)
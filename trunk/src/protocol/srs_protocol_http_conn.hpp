@@ -37,6 +37,7 @@ private:
     SrsHttpParseState state;
     http_parser hp_header;
     std::string url;
+    // The header of message in parsing, owned by the message.
     SrsHttpHeader* header;
     enum http_parser_type type_;
 private:
@@ -235,8 +236,12 @@ public:
     virtual SrsHttpHeader* header();
     virtual srs_error_t write(char* data, int size);
     virtual srs_error_t writev(const iovec* iov, int iovcnt, ssize_t* pnwrite);
+    virtual srs_error_t sendfile(int fd, int64_t offset, int64_t size, bool* psent);
     virtual void write_header(int code);
     virtual srs_error_t send_header(char* data, int size);
+private:
+    // Generate the header to buf, and mark the header as sent.
+    virtual srs_error_t build_header(char* data, int size, std::string& buf);
 };
 
 // Response reader use st socket.
@@ -469,6 +469,13 @@ srs_error_t SrsHttpFileServer::serve_file(ISrsHttpResponseWriter* w, ISrsHttpMes
 
 srs_error_t SrsHttpFileServer::serve_flv_file(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, string fullpath)
 {
+    // for time based seeking, for example, x.flv?starttime=10.5
+    std::string seek = r->query_get("starttime");
+    if (!seek.empty() && ::atof(seek.c_str()) > 0) {
+        return serve_flv_seek(w, r, fullpath, srs_utime_t(::atof(seek.c_str()) * SRS_UTIME_SECONDS));
+    }
+    
+    // for byte based seeking, for example, x.flv?start=10240
     std::string start = r->query_get("start");
     if (start.empty()) {
         return serve_file(w, r, fullpath);
@@ -484,6 +491,12 @@ srs_error_t SrsHttpFileServer::serve_flv_file(ISrsHttpResponseWriter* w, ISrsHtt
 
 srs_error_t SrsHttpFileServer::serve_mp4_file(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, string fullpath)
 {
+    // for time based seeking, for example, x.mp4?start=10.5
+    std::string seek = r->query_get("start");
+    if (!seek.empty() && ::atof(seek.c_str()) > 0) {
+        return serve_mp4_seek(w, r, fullpath, srs_utime_t(::atof(seek.c_str()) * SRS_UTIME_SECONDS));
+    }
+    
     // for flash to request mp4 range in query string.
     std::string range = r->query_get("range");
     // or, use bytes to request range.
@@ -538,6 +551,12 @@ srs_error_t SrsHttpFileServer::serve_flv_stream(ISrsHttpResponseWriter* w, ISrsH
     return serve_file(w, r, fullpath);
 }
 
+srs_error_t SrsHttpFileServer::serve_flv_seek(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, string fullpath, srs_utime_t start)
+{
+    // @remark For common http file server, we don't support stream request, please use SrsVodStream instead.
+    return serve_file(w, r, fullpath);
+}
+
 srs_error_t SrsHttpFileServer::serve_mp4_stream(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, string fullpath, int64_t start, int64_t end)
 {
     // @remark For common http file server, we don't support stream request, please use SrsVodStream instead.
@@ -545,6 +564,12 @@ srs_error_t SrsHttpFileServer::serve_mp4_stream(ISrsHttpResponseWriter* w, ISrsH
     return serve_file(w, r, fullpath);
 }
 
+srs_error_t SrsHttpFileServer::serve_mp4_seek(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, string fullpath, srs_utime_t start)
+{
+    // @remark For common http file server, we don't support stream request, please use SrsVodStream instead.
+    return serve_file(w, r, fullpath);
+}
+
 srs_error_t SrsHttpFileServer::serve_m3u8_ctx(ISrsHttpResponseWriter * w, ISrsHttpMessage * r, std::string fullpath)
 {
     // @remark For common http file server, we don't support stream request, please use SrsVodStream instead.
@@ -556,6 +581,18 @@ srs_error_t SrsHttpFileServer::copy(ISrsHttpResponseWriter* w, SrsFileReader* fs
 {
     srs_error_t err = srs_success;
     
+    // Send in zero-copy if possible, for example, the plaintext TCP connection.
+    bool sent = false;
+    int fd = fs->get_fd();
+    int64_t offset = fs->tellg();
+    if (fd >= 0 && size > 0 && (err = w->sendfile(fd, offset, size, &sent)) != srs_success) {
+        return srs_error_wrap(err, "sendfile offset=%" PRId64 ", size=%" PRId64, offset, size);
+    }
+    if (sent) {
+        fs->seek2(offset + size);
+        return err;
+    }
+    
     int64_t left = size;
     char* buf = new char[SRS_HTTP_TS_SEND_BUFFER_SIZE];
     SrsAutoFreeA(char, buf);
@@ -596,6 +633,166 @@ ISrsHttpMatchHijacker::~ISrsHttpMatchHijacker()
 {
 }
 
+SrsHttpMuxTrieNode::SrsHttpMuxTrieNode()
+{
+    entry = NULL;
+}
+
+SrsHttpMuxTrieNode::~SrsHttpMuxTrieNode()
+{
+    std::map<char, SrsHttpMuxTrieNode*>::iterator it;
+    for (it = children.begin(); it != children.end(); ++it) {
+        SrsHttpMuxTrieNode* node = it->second;
+        srs_freep(node);
+    }
+    children.clear();
+}
+
+SrsHttpMuxTrie::SrsHttpMuxTrie()
+{
+    root = new SrsHttpMuxTrieNode();
+    nn_entries = 0;
+}
+
+SrsHttpMuxTrie::~SrsHttpMuxTrie()
+{
+    srs_freep(root);
+}
+
+void SrsHttpMuxTrie::insert(string pattern, SrsHttpMuxEntry* entry)
+{
+    srs_assert(!pattern.empty() && entry);
+
+    SrsHttpMuxTrieNode* node = root;
+    size_t pos = 0;
+
+    while (pos < pattern.length()) {
+        std::map<char, SrsHttpMuxTrieNode*>::iterator it = node->children.find(pattern.at(pos));
+
+        // No child shares the prefix, create a leaf for the rest of pattern.
+        if (it == node->children.end()) {
+            SrsHttpMuxTrieNode* leaf = new SrsHttpMuxTrieNode();
+            leaf->label = pattern.substr(pos);
+            leaf->entry = entry;
+            node->children[pattern.at(pos)] = leaf;
+            nn_entries++;
+            return;
+        }
+
+        // Find the common prefix of pattern and label of child.
+        SrsHttpMuxTrieNode* child = it->second;
+        size_t n = 0;
+        while (n < child->label.length() && pos + n < pattern.length() && child->label.at(n) == pattern.at(pos + n)) {
+            n++;
+        }
+
+        // Split the child if pattern diverges inside its label, for example, insert /live/a when
+        // there is /live/b, the child /live/b is split to /live/ and b.
+        if (n < child->label.length()) {
+            SrsHttpMuxTrieNode* mid = new SrsHttpMuxTrieNode();
+            mid->label = child->label.substr(0, n);
+            child->label = child->label.substr(n);
+            mid->children[child->label.at(0)] = child;
+            it->second = mid;
+            child = mid;
+        }
+
+        node = child;
+        pos += n;
+    }
+
+    if (!node->entry) {
+        nn_entries++;
+    }
+    node->entry = entry;
+}
+
+SrsHttpMuxEntry* SrsHttpMuxTrie::remove(string pattern)
+{
+    SrsHttpMuxTrieNode* parent = NULL;
+    SrsHttpMuxTrieNode* node = root;
+    size_t pos = 0;
+
+    while (pos < pattern.length()) {
+        std::map<char, SrsHttpMuxTrieNode*>::iterator it = node->children.find(pattern.at(pos));
+        if (it == node->children.end()) {
+            return NULL;
+        }
+
+        SrsHttpMuxTrieNode* child = it->second;
+        if (pattern.compare(pos, child->label.length(), child->label) != 0) {
+            return NULL;
+        }
+
+        parent = node;
+        node = child;
+        pos += child->label.length();
+    }
+
+    SrsHttpMuxEntry* entry = node->entry;
+    if (!entry || node == root) {
+        return NULL;
+    }
+    node->entry = NULL;
+    nn_entries--;
+
+    // Remove the leaf, then the parent might be compressed with its only child.
+    if (node->children.empty()) {
+        parent->children.erase(node->label.at(0));
+        srs_freep(node);
+        node = parent;
+    }
+
+    // Merge the internal node with its only child, to keep the trie compressed.
+    if (node != root && !node->entry && node->children.size() == 1) {
+        SrsHttpMuxTrieNode* child = node->children.begin()->second;
+        node->label += child->label;
+        node->entry = child->entry;
+        node->children.clear();
+        node->children.swap(child->children);
+        srs_freep(child);
+    }
+
+    return entry;
+}
+
+SrsHttpMuxEntry* SrsHttpMuxTrie::match(const string& path)
+{
+    SrsHttpMuxEntry* matched = NULL;
+
+    SrsHttpMuxTrieNode* node = root;
+    size_t pos = 0;
+
+    while (pos < path.length()) {
+        std::map<char, SrsHttpMuxTrieNode*>::iterator it = node->children.find(path.at(pos));
+        if (it == node->children.end()) {
+            break;
+        }
+
+        SrsHttpMuxTrieNode* child = it->second;
+        if (path.compare(pos, child->label.length(), child->label) != 0) {
+            break;
+        }
+
+        node = child;
+        pos += child->label.length();
+
+        // The pattern is path[0, pos), which matches exactly, or matches any if endswith '/'.
+        // Because we walk down the trie, the later one is always the longer pattern.
+        SrsHttpMuxEntry* entry = node->entry;
+        if (entry && entry->enabled && (pos == path.length() || path.at(pos - 1) == '/')) {
+            matched = entry;
+        }
+    }
+
+    return matched;
+}
+
+int SrsHttpMuxTrie::size()
+{
+    return nn_entries;
+}
+
 ISrsHttpServeMux::ISrsHttpServeMux()
 {
 }
@@ -606,10 +803,13 @@ ISrsHttpServeMux::~ISrsHttpServeMux()
 
 SrsHttpServeMux::SrsHttpServeMux()
 {
+    trie = new SrsHttpMuxTrie();
 }
 
 SrsHttpServeMux::~SrsHttpServeMux()
 {
+    srs_freep(trie);
+
     std::map<std::string, SrsHttpMuxEntry*>::iterator it;
     for (it = entries.begin(); it != entries.end(); ++it) {
         SrsHttpMuxEntry* entry = it->second;
@@ -683,6 +883,7 @@ srs_error_t SrsHttpServeMux::handle(std::string pattern, ISrsHttpHandler* handle
             srs_freep(exists);
         }
         entries[pattern] = entry;
+        trie->insert(pattern, entry);
     }
     
     // Helpful behavior:
@@ -708,12 +909,39 @@ srs_error_t SrsHttpServeMux::handle(std::string pattern, ISrsHttpHandler* handle
             entry->handler->entry = entry;
             
             entries[rpattern] = entry;
+            trie->insert(rpattern, entry);
         }
     }
     
     return srs_success;
 }
 
+void SrsHttpServeMux::unhandle(std::string pattern)
+{
+    std::map<std::string, SrsHttpMuxEntry*>::iterator it = entries.find(pattern);
+    if (it == entries.end() || !it->second->explicit_match) {
+        return;
+    }
+
+    SrsHttpMuxEntry* entry = it->second;
+    entries.erase(it);
+    trie->remove(pattern);
+    srs_freep(entry);
+
+    // Remove the implicit redirect for /tree, if pattern is /tree/.
+    if (pattern != "/" && pattern.at(pattern.length() - 1) == '/') {
+        std::string rpattern = pattern.substr(0, pattern.length() - 1);
+
+        it = entries.find(rpattern);
+        if (it != entries.end() && !it->second->explicit_match) {
+            entry = it->second;
+            entries.erase(it);
+            trie->remove(rpattern);
+            srs_freep(entry);
+        }
+    }
+}
+
 srs_error_t SrsHttpServeMux::serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r)
 {
     srs_error_t err = srs_success;
@@ -773,57 +1001,14 @@ srs_error_t SrsHttpServeMux::match(ISrsHttpMessage* r, ISrsHttpHandler** ph)
         path = r->host() + path;
     }
     
-    int nb_matched = 0;
-    ISrsHttpHandler* h = NULL;
-    
-    std::map<std::string, SrsHttpMuxEntry*>::iterator it;
-    for (it = entries.begin(); it != entries.end(); ++it) {
-        std::string pattern = it->first;
-        SrsHttpMuxEntry* entry = it->second;
-        
-        if (!entry->enabled) {
-            continue;
-        }
-        
-        if (!path_match(pattern, path)) {
-            continue;
-        }
-        
-        if (!h || (int)pattern.length() > nb_matched) {
-            nb_matched = (int)pattern.length();
-            h = entry->handler;
-        }
-    }
-    
-    *ph = h;
+    // Match the longest pattern by trie, rather than walk all patterns, because there
+    // might be lots of streams mounted, see SrsHttpStreamServer::hijack.
+    SrsHttpMuxEntry* entry = trie->match(path);
+    *ph = entry? entry->handler : NULL;
     
     return srs_success;
 }
 
-bool SrsHttpServeMux::path_match(string pattern, string path)
-{
-    if (pattern.empty()) {
-        return false;
-    }
-    
-    int n = (int)pattern.length();
-    
-    // not endswith '/', exactly match.
-    if (pattern.at(n - 1) != '/') {
-        return pattern == path;
-    }
-    
-    // endswith '/', match any,
-    // for example, '/api/' match '/api/[N]'
-    if ((int)path.length() >= n) {
-        if (memcmp(pattern.data(), path.data(), n) == 0) {
-            return true;
-        }
-    }
-    
-    return false;
-}
-
 SrsHttpCorsMux::SrsHttpCorsMux()
 {
     next = NULL;
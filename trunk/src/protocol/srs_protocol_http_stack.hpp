@@ -184,6 +184,9 @@ public:
     // for the HTTP FLV, to writev to improve performance.
     // @see https://github.com/ossrs/srs/issues/405
     virtual srs_error_t writev(const iovec* iov, int iovcnt, ssize_t* pnwrite) = 0;
+    // Send size bytes of file fd from offset in zero-copy, for example, sendfile over TCP.
+    // @param psent, false if not supported, for example, TLS or chunked, user should copy the file.
+    virtual srs_error_t sendfile(int fd, int64_t offset, int64_t size, bool* psent) = 0;
     
     // WriteHeader sends an HTTP response header with status code.
     // If WriteHeader is not called explicitly, the first call to Write
@@ -280,20 +283,27 @@ private:
     virtual void set_path_check(_pfn_srs_path_exists pfn);
 public:
     virtual srs_error_t serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r);
-private:
+protected:
     // Serve the file by specified path
     virtual srs_error_t serve_file(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, std::string fullpath);
+private:
     virtual srs_error_t serve_flv_file(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, std::string fullpath);
     virtual srs_error_t serve_mp4_file(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, std::string fullpath);
     virtual srs_error_t serve_m3u8_file(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, std::string fullpath);
 protected:
     // When access flv file with x.flv?start=xxx
     virtual srs_error_t serve_flv_stream(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, std::string fullpath, int64_t offset);
+    // When access flv file with x.flv?starttime=seconds
+    // @param start the start time to seek, response from the keyframe before it.
+    virtual srs_error_t serve_flv_seek(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, std::string fullpath, srs_utime_t start);
     // When access mp4 file with x.mp4?range=start-end
     // @param start the start offset in bytes.
     // @param end the end offset in bytes. -1 to end of file.
     // @remark response data in [start, end].
     virtual srs_error_t serve_mp4_stream(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, std::string fullpath, int64_t start, int64_t end);
+    // When access mp4 file with x.mp4?start=seconds
+    // @param start the start time to seek, remux from the keyframe before it.
+    virtual srs_error_t serve_mp4_seek(ISrsHttpResponseWriter* w, ISrsHttpMessage* r, std::string fullpath, srs_utime_t start);
     // For HLS protocol.
     // When the request url, like as "http://127.0.0.1:8080/live/livestream.m3u8", 
     // returns the response like as "http://127.0.0.1:8080/live/livestream.m3u8?hls_ctx=12345678" .
@@ -336,6 +346,43 @@ public:
     virtual srs_error_t hijack(ISrsHttpMessage* request, ISrsHttpHandler** ph) = 0;
 };
 
+// The node of radix trie for mux, the label is the compressed path segment.
+class SrsHttpMuxTrieNode
+{
+public:
+    std::string label;
+    // The entry if a pattern ends at this node, NULL for internal node.
+    SrsHttpMuxEntry* entry;
+    // The children, indexed by the first byte of label.
+    std::map<char, SrsHttpMuxTrieNode*> children;
+public:
+    SrsHttpMuxTrieNode();
+    virtual ~SrsHttpMuxTrieNode();
+};
+
+// The radix trie to match the path to the longest pattern, in O(path length),
+// no matter how many streams are mounted. Note that it does not own the entries.
+class SrsHttpMuxTrie
+{
+private:
+    SrsHttpMuxTrieNode* root;
+    int nn_entries;
+public:
+    SrsHttpMuxTrie();
+    virtual ~SrsHttpMuxTrie();
+public:
+    // Insert the entry for pattern, replace the exists one.
+    virtual void insert(std::string pattern, SrsHttpMuxEntry* entry);
+    // Remove the pattern, return the removed entry or NULL if not found.
+    virtual SrsHttpMuxEntry* remove(std::string pattern);
+    // Match the path, return the enabled entry of the longest pattern, or NULL.
+    // The pattern not endswith '/' must match exactly, while pattern endswith '/' matches
+    // any path starts with it, for example, '/api/' match '/api/[N]'.
+    virtual SrsHttpMuxEntry* match(const std::string& path);
+    // The number of patterns in trie.
+    virtual int size();
+};
+
 // The server mux, all http server should implements it.
 class ISrsHttpServeMux
 {
@@ -378,6 +425,8 @@ class SrsHttpServeMux : public ISrsHttpServeMux
 private:
     // The pattern handler, to handle the http request.
     std::map<std::string, SrsHttpMuxEntry*> entries;
+    // The trie of patterns to match the entry, whose entries are owned by entries.
+    SrsHttpMuxTrie* trie;
     // The vhost handler.
     // When find the handler to process the request,
     // append the matched vhost when pattern not starts with /,
@@ -401,6 +450,9 @@ public:
     // Handle registers the handler for the given pattern.
     // If a handler already exists for pattern, Handle panics.
     virtual srs_error_t handle(std::string pattern, ISrsHttpHandler* handler);
+    // Remove the explicit handler for pattern, and its implicit redirect if any.
+    // @remark The handler is freed, so user must make sure it's not serving any request.
+    virtual void unhandle(std::string pattern);
 // Interface ISrsHttpServeMux
 public:
     virtual srs_error_t serve_http(ISrsHttpResponseWriter* w, ISrsHttpMessage* r);
@@ -408,7 +460,6 @@ public:
     virtual srs_error_t find_handler(ISrsHttpMessage* r, ISrsHttpHandler** ph);
 private:
     virtual srs_error_t match(ISrsHttpMessage* r, ISrsHttpHandler** ph);
-    virtual bool path_match(std::string pattern, std::string path);
 };
 
 // The filter http mux, directly serve the http CORS requests,
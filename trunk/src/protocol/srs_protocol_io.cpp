@@ -38,3 +38,11 @@ ISrsProtocolReadWriter::~ISrsProtocolReadWriter()
 {
 }
 
+ISrsFileSender::ISrsFileSender()
+{
+}
+
+ISrsFileSender::~ISrsFileSender()
+{
+}
+
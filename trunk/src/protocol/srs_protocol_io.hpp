@@ -104,5 +104,20 @@ public:
     virtual ~ISrsProtocolReadWriter();
 };
 
+/**
+ * The writer which sends file without copying to userspace, for example, sendfile over TCP.
+ * @remark The TLS connection never supports it, because the data must be encrypted in userspace.
+ */
+class ISrsFileSender
+{
+public:
+    ISrsFileSender();
+    virtual ~ISrsFileSender();
+public:
+    // Send size bytes of file fd from offset, the file offset is not changed.
+    // @param nwrite, the actual sent bytes, ignore if NULL.
+    virtual srs_error_t sendfile(int fd, int64_t offset, int64_t size, ssize_t* nwrite) = 0;
+};
+
 #endif
 
@@ -32,11 +32,14 @@
 ////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////
-// @see: https://github.com/udp/json-parser
+
+// The max depth of JSON object and array to parse, to avoid stack overflow of coroutine.
+#define SRS_JSON_MAX_DEPTH 64
 
 class SrsAmf0Any;
 class SrsJsonArray;
 class SrsJsonObject;
+class SrsJsonWriter;
 
 class SrsJsonAny
 {
@@ -77,6 +80,8 @@ public:
     virtual SrsJsonArray* to_array();
 public:
     virtual std::string dumps();
+    // Dumps to the writer, which is faster for large tree.
+    virtual void dumps(SrsJsonWriter* w);
     virtual SrsAmf0Any* to_amf0();
 public:
     static SrsJsonAny* str(const char* value = NULL);
@@ -90,7 +95,8 @@ public:
 public:
     // Read json tree from string.
     // @return json object. NULL if error.
-    static SrsJsonAny* loads(std::string str);
+    static SrsJsonAny* loads(const std::string& str);
+    static SrsJsonAny* loads(const char* data, int size);
 };
 
 class SrsJsonObject : public SrsJsonAny
@@ -111,11 +117,10 @@ public:
     // @remark: max index is count().
     virtual SrsJsonAny* value_at(int index);
 public:
-    virtual std::string dumps();
     virtual SrsAmf0Any* to_amf0();
 public:
-    virtual SrsJsonObject* set(std::string key, SrsJsonAny* value);
-    virtual SrsJsonAny* get_property(std::string name);
+    virtual SrsJsonObject* set(const std::string& key, SrsJsonAny* value);
+    virtual SrsJsonAny* get_property(const std::string& name);
     virtual SrsJsonAny* ensure_property_string(std::string name);
     virtual SrsJsonAny* ensure_property_integer(std::string name);
     virtual SrsJsonAny* ensure_property_number(std::string name);
@@ -143,7 +148,6 @@ public:
     // alias to add.
     virtual SrsJsonArray* append(SrsJsonAny* value);
 public:
-    virtual std::string dumps();
     virtual SrsAmf0Any* to_amf0();
 };
 
@@ -152,4 +156,51 @@ public:
 ////////////////////////////////////////////////////////////////////////
 // JSON encode, please use JSON.dumps() to encode json object.
 
+// The streaming JSON encoder, which writes to a growable buffer directly, without
+// building the tree of SrsJsonAny, for large responses such as the clients of API.
+// The comma between values is written automatically. For example:
+//      SrsJsonWriter w;
+//      w.begin_object();
+//      w.key("code")->integer(0);
+//      w.key("streams")->begin_array();
+//      w.begin_object()->key("name")->str("livestream")->end_object();
+//      w.end_array();
+//      w.end_object();
+//      std::string json = w.data(); // {"code":0,"streams":[{"name":"livestream"}]}
+class SrsJsonWriter
+{
+private:
+    std::string buf_;
+    // For each level of object or array, whether there is a value, so we need a comma.
+    std::vector<bool> commas_;
+    // Whether the key is written, so the value should follow it without comma.
+    bool keyed_;
+public:
+    SrsJsonWriter();
+    virtual ~SrsJsonWriter();
+public:
+    SrsJsonWriter* begin_object();
+    SrsJsonWriter* end_object();
+    SrsJsonWriter* begin_array();
+    SrsJsonWriter* end_array();
+    SrsJsonWriter* key(const char* k);
+    SrsJsonWriter* key(const char* k, int size);
+    SrsJsonWriter* str(const std::string& v);
+    SrsJsonWriter* str(const char* v, int size);
+    SrsJsonWriter* integer(int64_t v);
+    SrsJsonWriter* number(double v);
+    SrsJsonWriter* boolean(bool v);
+    SrsJsonWriter* null();
+    // Write the raw JSON value, for example, dumped by SrsJsonAny.
+    SrsJsonWriter* raw(const std::string& json);
+public:
+    // Get the JSON in buffer.
+    const std::string& data();
+    // Reset the buffer for reuse, the capacity is kept.
+    void reset();
+private:
+    void next_value();
+    void write_string(const char* v, int size);
+};
+
 #endif
@@ -9,7 +9,9 @@
 #include <stdarg.h>
 #include <sys/time.h>
 #include <unistd.h>
+#include <string.h>
 #include <sstream>
+#include <vector>
 using namespace std;
 
 #include <srs_kernel_error.hpp>
@@ -45,6 +47,54 @@ void _srs_context_destructor(void* arg)
     srs_freep(cid);
 }
 
+// The fixed buffer of context id for each coroutine, never freed but recycled when coroutine
+// terminated, because the signal handler might read it when coroutine is terminating.
+static char _srs_context_default_buffer[SRS_CONTEXT_ID_BUFFER_SIZE];
+static int _srs_context_buffer_key = -1;
+static std::vector<char*> _srs_context_free_buffers;
+void _srs_context_buffer_destructor(void* arg)
+{
+    _srs_context_free_buffers.push_back((char*)arg);
+}
+
+void srs_context_update_buffer(const SrsContextId& v)
+{
+    char* buf = _srs_context_default_buffer;
+    
+    if (srs_thread_self()) {
+        if (_srs_context_buffer_key < 0) {
+            int r0 = srs_key_create(&_srs_context_buffer_key, _srs_context_buffer_destructor);
+            srs_assert(r0 == 0);
+        }
+        
+        buf = (char*)srs_thread_getspecific(_srs_context_buffer_key);
+        if (!buf) {
+            if (_srs_context_free_buffers.empty()) {
+                buf = new char[SRS_CONTEXT_ID_BUFFER_SIZE];
+            } else {
+                buf = _srs_context_free_buffers.back();
+                _srs_context_free_buffers.pop_back();
+            }
+            
+            int r0 = srs_thread_setspecific(_srs_context_buffer_key, buf);
+            srs_assert(r0 == 0);
+        }
+    }
+    
+    int size = srs_min((int)strlen(v.c_str()), SRS_CONTEXT_ID_BUFFER_SIZE);
+    memcpy(buf, v.c_str(), size);
+    memset(buf + size, 0, SRS_CONTEXT_ID_BUFFER_SIZE - size);
+}
+
+const char* srs_context_id_buffer()
+{
+    char* buf = NULL;
+    if (srs_thread_self()) {
+        buf = (char*)srs_thread_getspecific(_srs_context_buffer_key);
+    }
+    return buf? buf : _srs_context_default_buffer;
+}
+
 const SrsContextId& SrsThreadContext::get_id()
 {
     ++_srs_pps_cids_get->sugar;
@@ -65,6 +115,8 @@ const SrsContextId& SrsThreadContext::set_id(const SrsContextId& v)
 {
     ++_srs_pps_cids_set->sugar;
 
+    srs_context_update_buffer(v);
+    
     if (!srs_thread_self()) {
         _srs_context_default = v;
         return v;
@@ -32,6 +32,14 @@ public:
     virtual void clear_cid();
 };
 
+// The size of context id buffer, see srs_context_id_buffer.
+#define SRS_CONTEXT_ID_BUFFER_SIZE 16
+
+// Get the context id of current coroutine, in a fixed buffer which is updated by set_id, and it's
+// async-signal-safe, for example, for the signal handler of CPU profiler.
+// @remark The buffer is zero-padded, and NOT null-terminated when it's full.
+extern const char* srs_context_id_buffer();
+
 // The context restore stores the context and restore it when done.
 // Usage:
 //      SrsContextRestore(_srs_context->get_id());
@@ -6,6 +6,8 @@
 
 #include <srs_protocol_rtc_stun.hpp>
 
+#include <string.h>
+
 using namespace std;
 
 #include <openssl/dh.h>
@@ -174,6 +176,16 @@ void SrsStunPacket::set_mapped_port(const uint32_t& port)
 }
 
 srs_error_t SrsStunPacket::decode(const char* buf, const int nb_buf)
+{
+    return do_decode(buf, nb_buf, true);
+}
+
+srs_error_t SrsStunPacket::decode_fast(const char* buf, const int nb_buf)
+{
+    return do_decode(buf, nb_buf, false);
+}
+
+srs_error_t SrsStunPacket::do_decode(const char* buf, const int nb_buf, bool with_username)
 {
     srs_error_t err = srs_success;
 
@@ -186,7 +198,7 @@ srs_error_t SrsStunPacket::decode(const char* buf, const int nb_buf)
 
     message_type = stream->read_2bytes();
     uint16_t message_len = stream->read_2bytes();
-    string magic_cookie = stream->read_string(4);
+    stream->skip(4); // magic cookie
     transcation_id = stream->read_string(12);
 
     if (nb_buf != 20 + message_len) {
@@ -201,14 +213,24 @@ srs_error_t SrsStunPacket::decode(const char* buf, const int nb_buf)
             return srs_error_new(ERROR_RTC_STUN, "invalid stun packet");
         }
 
-        string val = stream->read_string(len);
+        // Only parse the username, others are flags.
+        string val;
+        if (type == Username && with_username) {
+            val = stream->read_string(len);
+        } else {
+            stream->skip(len);
+        }
+
         // padding
         if (len % 4 != 0) {
-            stream->read_string(4 - (len % 4));
+            stream->skip(srs_min(4 - (len % 4), stream->left()));
         }
 
         switch (type) {
             case Username: {
+                if (!with_username) {
+                    break;
+                }
                 username = val;
                 size_t p = val.find(":");
                 if (p != string::npos) {
@@ -364,3 +386,115 @@ string SrsStunPacket::encode_fingerprint(uint32_t crc32)
 
     return string(stream->data(), stream->pos());
 }
+
+SrsStunBindingResponder::SrsStunBindingResponder()
+{
+    hmac_ = NULL;
+    response_ = NULL;
+    size_ = 0;
+    offset_mapped_ = offset_integrity_ = offset_fingerprint_ = 0;
+}
+
+SrsStunBindingResponder::~SrsStunBindingResponder()
+{
+    if (hmac_) {
+        HMAC_CTX_free(hmac_);
+    }
+    srs_freepa(response_);
+}
+
+srs_error_t SrsStunBindingResponder::initialize(const string& username, const string& pwd)
+{
+    srs_error_t err = srs_success;
+
+    if ((hmac_ = HMAC_CTX_new()) == NULL) {
+        return srs_error_new(ERROR_RTC_STUN, "hmac init faied");
+    }
+
+    if (HMAC_Init_ex(hmac_, pwd.data(), (int)pwd.size(), EVP_sha1(), NULL) <= 0) {
+        return srs_error_new(ERROR_RTC_STUN, "hmac init faied");
+    }
+
+    // The size of username attribute, with padding.
+    int nn_username = 4 + (int)username.size();
+    nn_username += (4 - nn_username % 4) % 4;
+
+    offset_mapped_ = 20 + nn_username;
+    offset_integrity_ = offset_mapped_ + 12;
+    offset_fingerprint_ = offset_integrity_ + 24;
+    size_ = offset_fingerprint_ + 8;
+
+    response_ = new char[size_];
+    memset(response_, 0, size_);
+
+    SrsBuffer stream(response_, size_);
+    stream.write_2bytes(BindingResponse);
+    stream.write_2bytes(size_ - 20);
+    stream.write_4bytes(kStunMagicCookie);
+    stream.skip(12); // transaction id
+
+    stream.write_2bytes(Username);
+    stream.write_2bytes(username.size());
+    stream.write_string(username);
+    stream.skip(offset_mapped_ - stream.pos()); // padding
+
+    stream.write_2bytes(XorMappedAddress);
+    stream.write_2bytes(8);
+    stream.write_1bytes(0); // ignore this bytes
+    stream.write_1bytes(1); // ipv4 family
+    stream.skip(6); // port and address
+
+    stream.write_2bytes(MessageIntegrity);
+    stream.write_2bytes(20);
+    stream.skip(20);
+
+    stream.write_2bytes(Fingerprint);
+    stream.write_2bytes(4);
+
+    return err;
+}
+
+srs_error_t SrsStunBindingResponder::encode(const string& transcation_id, uint32_t address, uint16_t port, SrsBuffer* stream)
+{
+    srs_error_t err = srs_success;
+
+    if (transcation_id.size() != 12) {
+        return srs_error_new(ERROR_RTC_STUN, "invalid transaction id size=%d", (int)transcation_id.size());
+    }
+
+    if (!stream->require(size_)) {
+        return srs_error_new(ERROR_RTC_STUN, "requires %d only %d bytes", size_, stream->left());
+    }
+
+    char* p = stream->head();
+    memcpy(p, response_, size_);
+    memcpy(p + 8, transcation_id.data(), 12);
+
+    SrsBuffer buf(p, size_);
+    buf.skip(offset_mapped_ + 6);
+    buf.write_2bytes(port ^ (kStunMagicCookie >> 16));
+    buf.write_4bytes(address ^ kStunMagicCookie);
+
+    // The length for MESSAGE-INTEGRITY should include it, but not the FINGERPRINT.
+    p[2] = ((offset_fingerprint_ - 20) & 0x0000FF00) >> 8;
+    p[3] = ((offset_fingerprint_ - 20) & 0x000000FF);
+
+    // Reuse the key of HMAC.
+    unsigned int nn_hmac = 0;
+    if (HMAC_Init_ex(hmac_, NULL, 0, NULL, NULL) <= 0
+        || HMAC_Update(hmac_, (const unsigned char*)p, offset_integrity_) <= 0
+        || HMAC_Final(hmac_, (unsigned char*)p + offset_integrity_ + 4, &nn_hmac) <= 0) {
+        return srs_error_new(ERROR_RTC_STUN, "hmac encode failed");
+    }
+
+    p[2] = ((size_ - 20) & 0x0000FF00) >> 8;
+    p[3] = ((size_ - 20) & 0x000000FF);
+
+    uint32_t crc32 = srs_crc32_ieee(p, offset_fingerprint_, 0) ^ 0x5354554E;
+    buf.skip(offset_fingerprint_ + 4 - buf.pos());
+    buf.write_4bytes(crc32);
+
+    stream->skip(size_);
+
+    return err;
+}
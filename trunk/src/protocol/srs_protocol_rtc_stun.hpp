@@ -14,6 +14,7 @@
 #include <srs_kernel_error.hpp>
 
 class SrsBuffer;
+struct hmac_ctx_st;
 
 // @see: https://tools.ietf.org/html/rfc5389
 // The magic cookie field MUST contain the fixed value 0x2112A442 in network byte order
@@ -95,8 +96,11 @@ public:
     void set_mapped_address(const uint32_t& addr);
     void set_mapped_port(const uint32_t& port);
     srs_error_t decode(const char* buf, const int nb_buf);
+    // Decode the packet without username, for the packet from a known session.
+    srs_error_t decode_fast(const char* buf, const int nb_buf);
     srs_error_t encode(const std::string& pwd, SrsBuffer* stream);
 private:
+    srs_error_t do_decode(const char* buf, const int nb_buf, bool with_username);
     srs_error_t encode_binding_response(const std::string& pwd, SrsBuffer* stream);
     std::string encode_username();
     std::string encode_mapped_address();
@@ -104,4 +108,29 @@ private:
     std::string encode_fingerprint(uint32_t crc32);
 };
 
+// The STUN binding response of a session, which is always the same except the transaction id and the
+// mapped address, so we cache the response and the HMAC key, then patch the fields for each request,
+// to avoid building the attributes and setting up the HMAC for each consent freshness check.
+class SrsStunBindingResponder
+{
+private:
+    // The HMAC-SHA1 context with the key, which is the ICE pwd.
+    hmac_ctx_st* hmac_;
+    // The response with the username, XOR-MAPPED-ADDRESS, MESSAGE-INTEGRITY and FINGERPRINT.
+    char* response_;
+    int size_;
+    // The offset of attributes to patch.
+    int offset_mapped_;
+    int offset_integrity_;
+    int offset_fingerprint_;
+public:
+    SrsStunBindingResponder();
+    virtual ~SrsStunBindingResponder();
+public:
+    // Initialize by the username of request, and the ICE pwd of us.
+    srs_error_t initialize(const std::string& username, const std::string& pwd);
+    // Write the response of request with transaction id, for peer address and port.
+    srs_error_t encode(const std::string& transcation_id, uint32_t address, uint16_t port, SrsBuffer* stream);
+};
+
 #endif
@@ -10,6 +10,13 @@
 #include <fcntl.h>
 #include <sys/socket.h>
 #include <netdb.h>
+#include <poll.h>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+#ifdef SRS_OSX
+#include <sys/uio.h>
+#endif
 using namespace std;
 
 #include <srs_core_autofree.hpp>
@@ -21,6 +28,9 @@ using namespace std;
 // nginx also set to 512
 #define SERVER_LISTEN_BACKLOG 512
 
+// The max bytes for each sendfile, then yield to other coroutines.
+#define SRS_SENDFILE_CHUNK_SIZE (256 * 1024)
+
 #ifdef __linux__
 #include <sys/epoll.h>
 
@@ -629,6 +639,65 @@ srs_error_t SrsStSocket::writev(const iovec *iov, int iov_size, ssize_t* nwrite)
     return err;
 }
 
+srs_error_t SrsStSocket::sendfile(int fd, int64_t offset, int64_t size, ssize_t* nwrite)
+{
+    srs_error_t err = srs_success;
+    
+    int osfd = srs_netfd_fileno(stfd);
+    int64_t left = size;
+    
+    while (left > 0) {
+        ssize_t nb_write = -1;
+        int64_t max_write = srs_min(left, SRS_SENDFILE_CHUNK_SIZE);
+#if defined(__linux__)
+        off_t pos = (off_t)offset;
+        nb_write = ::sendfile(osfd, fd, &pos, (size_t)max_write);
+#elif defined(SRS_OSX)
+        off_t len = (off_t)max_write;
+        if (::sendfile(fd, osfd, (off_t)offset, &len, NULL, 0) == 0 || (errno == EAGAIN && len > 0)) {
+            nb_write = (ssize_t)len;
+        }
+#else
+        errno = ENOSYS;
+#endif
+        
+        if (nb_write > 0) {
+            offset += nb_write;
+            left -= nb_write;
+            sbytes += nb_write;
+            
+            // Yield for each chunk, to serve other connections when peer is fast.
+            srs_thread_yield();
+            continue;
+        }
+        
+        if (nb_write == 0) {
+            return srs_error_new(ERROR_SOCKET_WRITE, "sendfile eof, offset=%" PRId64 ", left=%" PRId64, offset, left);
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN) {
+            return srs_error_new(ERROR_SOCKET_WRITE, "sendfile offset=%" PRId64 ", left=%" PRId64, offset, left);
+        }
+        
+        // The socket is non-blocking, wait for it to be writable.
+        st_utime_t timeout = (stm == SRS_UTIME_NO_TIMEOUT) ? ST_UTIME_NO_TIMEOUT : (st_utime_t)stm;
+        if (st_netfd_poll((st_netfd_t)stfd, POLLOUT, timeout) < 0) {
+            if (errno == ETIME) {
+                return srs_error_new(ERROR_SOCKET_TIMEOUT, "sendfile timeout %d ms", srsu2msi(stm));
+            }
+            return srs_error_new(ERROR_SOCKET_WRITE, "sendfile poll");
+        }
+    }
+    
+    if (nwrite) {
+        *nwrite = (ssize_t)(size - left);
+    }
+    
+    return err;
+}
+
 SrsTcpClient::SrsTcpClient(string h, int p, srs_utime_t tm)
 {
     stfd = NULL;
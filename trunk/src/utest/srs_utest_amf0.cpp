@@ -14,6 +14,7 @@ using namespace std;
 #include <srs_protocol_amf0.hpp>
 #include <srs_core_autofree.hpp>
 #include <srs_protocol_json.hpp>
+#include <srs_kernel_utility.hpp>
 #include <srs_kernel_buffer.hpp>
 using namespace srs_internal;
 
@@ -2841,3 +2842,157 @@ VOID TEST(ProtocolJSONTest, ParseSpecial)
     }
 }
 
+
+VOID TEST(ProtocolJSONTest, Writer)
+{
+    if (true) {
+        SrsJsonWriter w;
+        w.begin_object()->end_object();
+        EXPECT_STREQ("{}", w.data().c_str());
+
+        w.reset();
+        w.begin_array()->end_array();
+        EXPECT_STREQ("[]", w.data().c_str());
+    }
+
+    // Should be the same as dumps of SrsJsonObject.
+    if (true) {
+        SrsJsonObject* obj = SrsJsonAny::object();
+        SrsAutoFree(SrsJsonObject, obj);
+
+        obj->set("code", SrsJsonAny::integer(0));
+        obj->set("name", SrsJsonAny::str("livestream"));
+        obj->set("alive", SrsJsonAny::number(10.5));
+        obj->set("active", SrsJsonAny::boolean(true));
+        obj->set("video", SrsJsonAny::null());
+
+        SrsJsonArray* arr = SrsJsonAny::array();
+        obj->set("arr", arr);
+        arr->append(SrsJsonAny::integer(-1));
+        arr->append(SrsJsonAny::str("he\"llo"));
+
+        SrsJsonObject* sub = SrsJsonAny::object();
+        arr->append(sub);
+        sub->set("id", SrsJsonAny::integer(100));
+
+        SrsJsonWriter w;
+        w.begin_object();
+        w.key("code")->integer(0);
+        w.key("name")->str("livestream");
+        w.key("alive")->number(10.5);
+        w.key("active")->boolean(true);
+        w.key("video")->null();
+        w.key("arr")->begin_array();
+        w.integer(-1)->str("he\"llo");
+        w.begin_object()->key("id")->integer(100)->end_object();
+        w.end_array();
+        w.end_object();
+
+        EXPECT_STREQ(obj->dumps().c_str(), w.data().c_str());
+    }
+
+    if (true) {
+        SrsJsonWriter w;
+        w.begin_array();
+        w.str("he\\llo")->str("he\nllo")->str("he\tllo")->str("he\rllo")->str("he\bllo")->str("he\fllo");
+        w.str(string("he\x01llo", 6));
+        w.str("hello\xE8\xA7\x86\xE9\xA2\x91");
+        w.raw("{\"id\":1}");
+        w.end_array();
+        EXPECT_STREQ("[\"he\\\\llo\",\"he\\nllo\",\"he\\tllo\",\"he\\rllo\",\"he\\bllo\",\"he\\fllo\","
+            "\"he\\u0001llo\",\"hello\xE8\xA7\x86\xE9\xA2\x91\",{\"id\":1}]", w.data().c_str());
+    }
+
+    // The writer output should be parsed by SrsJsonAny.
+    if (true) {
+        SrsJsonWriter w;
+        w.begin_object()->key("streams")->begin_array();
+        for (int i = 0; i < 3; i++) {
+            w.begin_object()->key("id")->integer(i)->key("url")->str("/live/livestream")->end_object();
+        }
+        w.end_array()->key("next")->integer(0)->end_object();
+
+        SrsJsonAny* p = SrsJsonAny::loads(w.data());
+        ASSERT_TRUE(p && p->is_object());
+        SrsAutoFree(SrsJsonAny, p);
+
+        SrsJsonAny* streams = p->to_object()->get_property("streams");
+        ASSERT_TRUE(streams && streams->is_array());
+        EXPECT_EQ(3, streams->to_array()->count());
+    }
+}
+
+VOID TEST(ProtocolJSONTest, ParseValues)
+{
+    if (true) {
+        SrsJsonAny* p = SrsJsonAny::loads("{\"a\":-12,\"b\":0.5,\"c\":1e3,\"d\":-2.5E-1,\"e\":9007199254740993,\"f\":0}");
+        ASSERT_TRUE(p && p->is_object());
+        SrsAutoFree(SrsJsonAny, p);
+
+        SrsJsonObject* obj = p->to_object();
+        EXPECT_EQ(-12, obj->get_property("a")->to_integer());
+        EXPECT_EQ(0.5, obj->get_property("b")->to_number());
+        EXPECT_EQ(1000.0, obj->get_property("c")->to_number());
+        EXPECT_EQ(-0.25, obj->get_property("d")->to_number());
+        EXPECT_EQ(9007199254740993LL, obj->get_property("e")->to_integer());
+        EXPECT_EQ(0, obj->get_property("f")->to_integer());
+    }
+
+    // The escaped and unicode chars.
+    if (true) {
+        SrsJsonAny* p = SrsJsonAny::loads("[\"a\\\"b\\\\c\\/d\\r\\n\", \"\\u0041\\u00e9\\u4e2d\", \"\\ud83d\\ude00\"]");
+        ASSERT_TRUE(p && p->is_array());
+        SrsAutoFree(SrsJsonAny, p);
+
+        SrsJsonArray* arr = p->to_array();
+        EXPECT_STREQ("a\"b\\c/d\r\n", arr->at(0)->to_str().c_str());
+        EXPECT_STREQ("A\xC3\xA9\xE4\xB8\xAD", arr->at(1)->to_str().c_str());
+        EXPECT_STREQ("\xF0\x9F\x98\x80", arr->at(2)->to_str().c_str());
+    }
+
+    // The duplicated key, the last one wins.
+    if (true) {
+        SrsJsonAny* p = SrsJsonAny::loads("\xEF\xBB\xBF {\"id\":1, \"id\":2} \r\n");
+        ASSERT_TRUE(p && p->is_object());
+        SrsAutoFree(SrsJsonAny, p);
+
+        EXPECT_EQ(1, p->to_object()->count());
+        EXPECT_EQ(2, p->to_object()->get_property("id")->to_integer());
+    }
+
+    // The dumps should be parsed to the same one.
+    if (true) {
+        string json = "{\"code\":0,\"arr\":[1,\"x\",null,true,false,{},[]],\"obj\":{\"v\":1.50}}";
+        SrsJsonAny* p = SrsJsonAny::loads(json);
+        ASSERT_TRUE(p != NULL);
+        SrsAutoFree(SrsJsonAny, p);
+        EXPECT_STREQ(json.c_str(), p->dumps().c_str());
+    }
+
+    // Invalid JSON.
+    const char* invalids[] = {
+        "", " ", "{", "}", "[1,", "[1 2]", "{\"a\" 1}", "{\"a\":}", "{a:1}", "{\"a\":1,}", "[1,]",
+        "01", "1.", ".5", "-", "1e", "tru", "nul", "\"abc", "\"\\u12\"", "\"\\ud83d\"", "{} x", "[] []",
+        "\"\\ude00\"", "\"\\ude00\\ud83d\"", "\"\\ud83d\\u0041\"", "\"\\ud83d\\ud83d\"", "\"a\nb\"", "\"a\tb\"",
+        "\"\x01\"",
+    };
+    for (int i = 0; i < (int)(sizeof(invalids) / sizeof(const char*)); i++) {
+        SrsJsonAny* p = SrsJsonAny::loads(invalids[i]);
+        EXPECT_TRUE(p == NULL) << invalids[i];
+        srs_freep(p);
+    }
+
+    // Too deep.
+    if (true) {
+        string json = string(SRS_JSON_MAX_DEPTH, '[') + string(SRS_JSON_MAX_DEPTH, ']');
+        SrsJsonAny* p = SrsJsonAny::loads(json);
+        EXPECT_TRUE(p != NULL);
+        srs_freep(p);
+
+        json = string(SRS_JSON_MAX_DEPTH + 1, '[') + string(SRS_JSON_MAX_DEPTH + 1, ']');
+        p = SrsJsonAny::loads(json);
+        EXPECT_TRUE(p == NULL);
+        srs_freep(p);
+    }
+}
+
@@ -9,6 +9,7 @@ using namespace std;
 
 #include <srs_kernel_error.hpp>
 #include <srs_app_fragment.hpp>
+#include <srs_app_dvr.hpp>
 #include <srs_app_security.hpp>
 #include <srs_app_config.hpp>
 
@@ -16,6 +17,16 @@ using namespace std;
 #include <srs_protocol_conn.hpp>
 #include <srs_app_conn.hpp>
 #include <srs_app_threads.hpp>
+#include <srs_app_http_stream.hpp>
+#include <srs_app_http_hooks.hpp>
+#include <srs_app_http_client.hpp>
+#include <srs_protocol_json.hpp>
+#include <srs_app_statistic.hpp>
+#include <srs_app_metrics.hpp>
+#include <srs_app_profiler.hpp>
+#include <srs_protocol_rtmp_stack.hpp>
+#include <srs_kernel_flv.hpp>
+#include <srs_protocol_utility.hpp>
 #include <srs_core_autofree.hpp>
 
 class MockIDResource : public ISrsResource
@@ -477,6 +488,71 @@ VOID TEST(AppFragmentTest, CheckDuration)
 	}
 }
 
+extern srs_writev_t _srs_writev_fn;
+
+ssize_t mock_dvr_writev(int /*fildes*/, const iovec* /*iov*/, int /*iovcnt*/)
+{
+    errno = ENOSPC;
+    return -1;
+}
+
+class MockDvrPlan : public SrsDvrPlan
+{
+public:
+    int nn_reaped;
+public:
+    MockDvrPlan() {
+        nn_reaped = 0;
+    }
+    virtual srs_error_t on_reap_segment() {
+        nn_reaped++;
+        return srs_success;
+    }
+};
+
+VOID TEST(AppDvrTest, CloseFlushFailed)
+{
+    srs_error_t err;
+
+    MockDvrPlan plan;
+    string path = _srs_tmp_file_prefix + "dvr.flv";
+
+    // The buffered bytes are flushed when close, never reap the truncated segment if failed.
+    if (true) {
+        SrsDvrFlvSegmenter s;
+        s.plan = &plan;
+        s.fragment->set_path(path);
+        HELPER_EXPECT_SUCCESS(s.fs->set_iobuf_size(4096));
+        HELPER_EXPECT_SUCCESS(s.fs->open(s.fragment->tmppath()));
+        HELPER_EXPECT_SUCCESS(s.fs->write((void*)"FLV", 3, NULL));
+
+        srs_writev_t ow = _srs_writev_fn;
+        _srs_writev_fn = mock_dvr_writev;
+        HELPER_EXPECT_FAILED(s.close());
+        _srs_writev_fn = ow;
+
+        EXPECT_FALSE(s.fs->is_open());
+        EXPECT_EQ(0, plan.nn_reaped);
+        EXPECT_FALSE(srs_path_exists(path));
+        ::unlink(s.fragment->tmppath().c_str());
+    }
+
+    // Reap the segment when flushed.
+    if (true) {
+        SrsDvrFlvSegmenter s;
+        s.plan = &plan;
+        s.fragment->set_path(path);
+        HELPER_EXPECT_SUCCESS(s.fs->set_iobuf_size(4096));
+        HELPER_EXPECT_SUCCESS(s.fs->open(s.fragment->tmppath()));
+        HELPER_EXPECT_SUCCESS(s.fs->write((void*)"FLV", 3, NULL));
+
+        HELPER_EXPECT_SUCCESS(s.close());
+        EXPECT_EQ(1, plan.nn_reaped);
+        EXPECT_TRUE(srs_path_exists(path));
+        ::unlink(path.c_str());
+    }
+}
+
 VOID TEST(AppSecurity, CheckSecurity)
 {
     srs_error_t err;
@@ -835,3 +911,800 @@ VOID TEST(AppLocklessQueue, CoverAll)
     }
 }
 
+
+SrsBufferChunk* mock_buffer_chunk(const char* data, int64_t timestamp, bool sync)
+{
+    SrsBufferChunk* chunk = new SrsBufferChunk();
+    chunk->create((char*)data, (int)strlen(data));
+    chunk->timestamp = timestamp;
+    chunk->sync = sync;
+    return chunk;
+}
+
+void mock_buffer_chunks_free(vector<SrsBufferChunk*>& chunks)
+{
+    for (int i = 0; i < (int)chunks.size(); i++) {
+        SrsBufferChunk* chunk = chunks.at(i);
+        srs_freep(chunk);
+    }
+    chunks.clear();
+}
+
+VOID TEST(AppBufferChunkTest, SharedPayload)
+{
+    SrsBufferChunk* chunk = mock_buffer_chunk("hello", 10, true);
+    SrsBufferChunk* copy = chunk->copy();
+    EXPECT_EQ(chunk->data(), copy->data());
+    EXPECT_EQ(5, copy->size());
+    EXPECT_EQ(10, copy->timestamp);
+    EXPECT_TRUE(copy->sync);
+
+    // The payload is still available after the source chunk is freed.
+    srs_freep(chunk);
+    EXPECT_EQ("hello", string(copy->data(), copy->size()));
+    srs_freep(copy);
+}
+
+VOID TEST(AppBufferChunkTest, JoinLatestSync)
+{
+    SrsBufferChunkQueue queue(0);
+
+    // Wait for sync chunk.
+    queue.append(mock_buffer_chunk("a", 0, false));
+    if (true) {
+        int64_t seq = -1;
+        vector<SrsBufferChunk*> chunks;
+        queue.fetch(&seq, 10, chunks);
+        EXPECT_EQ(-1, seq);
+        EXPECT_TRUE(chunks.empty());
+    }
+
+    queue.append(mock_buffer_chunk("b", 10, true));
+    queue.append(mock_buffer_chunk("c", 20, false));
+    queue.append(mock_buffer_chunk("d", 30, true));
+    queue.append(mock_buffer_chunk("e", 40, false));
+
+    // Join at the latest sync chunk.
+    if (true) {
+        int64_t seq = -1;
+        vector<SrsBufferChunk*> chunks;
+        queue.fetch(&seq, 10, chunks);
+        ASSERT_EQ(2, (int)chunks.size());
+        EXPECT_EQ("d", string(chunks.at(0)->data(), chunks.at(0)->size()));
+        EXPECT_EQ("e", string(chunks.at(1)->data(), chunks.at(1)->size()));
+        EXPECT_EQ(5, seq);
+        mock_buffer_chunks_free(chunks);
+
+        // No more chunks.
+        queue.fetch(&seq, 10, chunks);
+        EXPECT_TRUE(chunks.empty());
+
+        // Fetch the next chunk, in limit.
+        queue.append(mock_buffer_chunk("f", 50, false));
+        queue.append(mock_buffer_chunk("g", 60, false));
+        queue.fetch(&seq, 1, chunks);
+        ASSERT_EQ(1, (int)chunks.size());
+        EXPECT_EQ("f", string(chunks.at(0)->data(), chunks.at(0)->size()));
+        EXPECT_EQ(6, seq);
+        mock_buffer_chunks_free(chunks);
+    }
+
+    // Join again if viewer is ahead of queue, for example, the encoder is restarted.
+    if (true) {
+        int64_t seq = 100;
+        vector<SrsBufferChunk*> chunks;
+        queue.fetch(&seq, 10, chunks);
+        ASSERT_EQ(4, (int)chunks.size());
+        EXPECT_EQ("d", string(chunks.at(0)->data(), chunks.at(0)->size()));
+        EXPECT_EQ(7, seq);
+        mock_buffer_chunks_free(chunks);
+    }
+}
+
+VOID TEST(AppBufferChunkTest, JoinWindowAndShrink)
+{
+    // For audio stream, join from the oldest sync chunk in window.
+    if (true) {
+        SrsBufferChunkQueue queue(100 * SRS_UTIME_MILLISECONDS);
+        for (int i = 0; i < 10; i++) {
+            queue.append(mock_buffer_chunk("a", i * 50, true));
+        }
+
+        int64_t seq = -1;
+        vector<SrsBufferChunk*> chunks;
+        queue.fetch(&seq, 100, chunks);
+        ASSERT_EQ(3, (int)chunks.size());
+        EXPECT_EQ(350, chunks.at(0)->timestamp);
+        mock_buffer_chunks_free(chunks);
+    }
+
+    // Drop the chunks out of window, but keep chunks from the latest sync chunk.
+    if (true) {
+        SrsBufferChunkQueue queue(0);
+        queue.append(mock_buffer_chunk("a", 0, true));
+        queue.append(mock_buffer_chunk("b", 1000, false));
+        queue.append(mock_buffer_chunk("c", 2000, true));
+        queue.append(mock_buffer_chunk("d", 9000, false));
+        EXPECT_EQ(2, queue.size());
+
+        // The slow viewer joins again from sync chunk.
+        int64_t seq = 1;
+        vector<SrsBufferChunk*> chunks;
+        queue.fetch(&seq, 100, chunks);
+        ASSERT_EQ(2, (int)chunks.size());
+        EXPECT_EQ("c", string(chunks.at(0)->data(), chunks.at(0)->size()));
+        EXPECT_EQ(4, seq);
+        mock_buffer_chunks_free(chunks);
+    }
+
+    // Drop the chunks when timestamp jumps.
+    if (true) {
+        SrsBufferChunkQueue queue(0);
+        queue.append(mock_buffer_chunk("a", 9000, false));
+        queue.append(mock_buffer_chunk("b", 0, false));
+        EXPECT_EQ(1, queue.size());
+    }
+}
+
+VOID TEST(AppBufferChunkTest, SharedEncoderTS)
+{
+    srs_error_t err;
+
+    SrsRequest req;
+    SrsBufferSharedEncoder enc("/live/livestream.ts", NULL, &req, NULL);
+    HELPER_ASSERT_SUCCESS(enc.initialize());
+    EXPECT_TRUE(enc.header().empty());
+
+    // Pure audio, each chunk starts with PAT/PMT.
+    for (int i = 0; i < 2; i++) {
+        SrsMessageHeader h;
+        h.initialize_audio(4, 10 * i, 1);
+
+        SrsSharedPtrMessage sh;
+        uint8_t shb[] = {0xaf, 0x00, 0x12, 0x10};
+        char* p = new char[sizeof(shb)];
+        memcpy(p, shb, sizeof(shb));
+        HELPER_ASSERT_SUCCESS(sh.create(&h, p, sizeof(shb)));
+
+        SrsSharedPtrMessage raw;
+        uint8_t rawb[] = {0xaf, 0x01, 0x21, 0x10};
+        p = new char[sizeof(rawb)];
+        memcpy(p, rawb, sizeof(rawb));
+        HELPER_ASSERT_SUCCESS(raw.create(&h, p, sizeof(rawb)));
+
+        SrsSharedPtrMessage* msgs[] = {&sh, &raw};
+        HELPER_ASSERT_SUCCESS(enc.encode(msgs, 2));
+    }
+
+    int64_t seq = -1;
+    vector<SrsBufferChunk*> chunks;
+    HELPER_ASSERT_SUCCESS(enc.fetch(&seq, 10, chunks));
+    ASSERT_EQ(1, (int)chunks.size());
+
+    // The chunk starts with PAT.
+    SrsBufferChunk* chunk = chunks.at(0);
+    EXPECT_TRUE(chunk->sync);
+    EXPECT_EQ(10, chunk->timestamp);
+    ASSERT_EQ(3 * 188, chunk->size());
+    EXPECT_EQ(0x47, (uint8_t)chunk->data()[0]);
+    EXPECT_EQ(0x40, (uint8_t)chunk->data()[1]);
+    EXPECT_EQ(0x00, (uint8_t)chunk->data()[2]);
+    mock_buffer_chunks_free(chunks);
+}
+
+VOID TEST(AppBufferChunkTest, SharedEncoderMP3)
+{
+    srs_error_t err;
+
+    SrsRequest req;
+    SrsBufferSharedEncoder enc("/live/livestream.mp3", NULL, &req, NULL);
+    HELPER_ASSERT_SUCCESS(enc.initialize());
+
+    // The ID3 header is written by viewer before chunks.
+    EXPECT_EQ(20, (int)enc.header().length());
+    EXPECT_EQ("ID3", enc.header().substr(0, 3));
+
+    SrsMessageHeader h;
+    h.initialize_audio(4, 10, 1);
+
+    SrsSharedPtrMessage msg;
+    uint8_t b[] = {0x2f, 0xff, 0xfb, 0x90};
+    char* p = new char[sizeof(b)];
+    memcpy(p, b, sizeof(b));
+    HELPER_ASSERT_SUCCESS(msg.create(&h, p, sizeof(b)));
+
+    SrsSharedPtrMessage* msgs[] = {&msg};
+    HELPER_ASSERT_SUCCESS(enc.encode(msgs, 1));
+
+    int64_t seq = -1;
+    vector<SrsBufferChunk*> chunks;
+    HELPER_ASSERT_SUCCESS(enc.fetch(&seq, 10, chunks));
+    ASSERT_EQ(1, (int)chunks.size());
+    EXPECT_TRUE(chunks.at(0)->sync);
+    EXPECT_EQ(3, chunks.at(0)->size());
+    mock_buffer_chunks_free(chunks);
+}
+
+VOID TEST(AppHttpHooksTest, LatencyHistogram)
+{
+    SrsHttpHookStat stat;
+    stat.update(1 * SRS_UTIME_MILLISECONDS, true);
+    stat.update(5 * SRS_UTIME_MILLISECONDS, true);
+    stat.update(120 * SRS_UTIME_MILLISECONDS, false);
+    stat.update(3 * SRS_UTIME_SECONDS, true);
+
+    EXPECT_EQ(4, stat.nn_requests);
+    EXPECT_EQ(1, stat.nn_errors);
+    EXPECT_EQ(1, stat.latency[0]);
+    EXPECT_EQ(1, stat.latency[1]);
+    EXPECT_EQ(1, stat.latency[5]);
+    EXPECT_EQ(1, stat.latency[SRS_HOOK_LATENCY_BUCKETS - 1]);
+
+    SrsJsonObject* obj = stat.dumps();
+    SrsAutoFree(SrsJsonObject, obj);
+    EXPECT_EQ(4, obj->get_property("requests")->to_integer());
+    EXPECT_EQ(SRS_HOOK_LATENCY_BUCKETS, obj->get_property("latency")->to_array()->count());
+}
+
+VOID TEST(AppHttpHooksTest, VerdictCache)
+{
+    srs_error_t err = srs_success;
+
+    SrsHttpHooksDispatcher d;
+    EXPECT_FALSE(d.verdict("allow", &err));
+
+    d.update_verdict("allow", srs_success, 10 * SRS_UTIME_SECONDS);
+    EXPECT_TRUE(d.verdict("allow", &err));
+    EXPECT_TRUE(err == srs_success);
+
+    // The denied verdict, which returns the same error code.
+    if (true) {
+        srs_error_t r0 = srs_error_new(ERROR_RESPONSE_CODE, "denied");
+        d.update_verdict("deny", r0, 10 * SRS_UTIME_SECONDS);
+        srs_freep(r0);
+
+        EXPECT_TRUE(d.verdict("deny", &err));
+        EXPECT_EQ(ERROR_RESPONSE_CODE, srs_error_code(err));
+        srs_freep(err);
+    }
+
+    // The expired verdict.
+    d.update_verdict("expired", srs_success, -1 * SRS_UTIME_SECONDS);
+    EXPECT_FALSE(d.verdict("expired", &err));
+    EXPECT_FALSE(d.verdict("expired", &err));
+
+    // The stat is created when fetch.
+    SrsHttpHookStat* stat = d.stat("on_play");
+    EXPECT_TRUE(stat == d.stat("on_play"));
+    EXPECT_TRUE(stat != d.stat("on_stop"));
+}
+
+VOID TEST(AppHttpHooksTest, RetryStaleConnection)
+{
+    srs_error_t err = srs_error_wrap(srs_error_new(ERROR_SOCKET_WRITE, "write"), "http: write");
+    EXPECT_TRUE(srs_http_hooks_is_stale(err, true, true));
+    EXPECT_FALSE(srs_http_hooks_is_stale(err, false, false));
+    srs_freep(err);
+
+    // Closed by server before any response.
+    err = srs_error_wrap(srs_error_new(ERROR_SOCKET_READ, "read"), "http: parse response");
+    EXPECT_TRUE(srs_http_hooks_is_stale(err, true, false));
+    EXPECT_FALSE(srs_http_hooks_is_stale(err, true, true));
+    srs_freep(err);
+
+    // The server might be handling the request, never retry.
+    err = srs_error_wrap(srs_error_new(ERROR_SOCKET_TIMEOUT, "timeout"), "http: parse response");
+    EXPECT_FALSE(srs_http_hooks_is_stale(err, true, false));
+    srs_freep(err);
+}
+
+VOID TEST(AppHttpHooksTest, PoolReuseClient)
+{
+    srs_error_t err;
+
+    SrsHttpHookPool pool("http", "127.0.0.1", 8085);
+
+    SrsHttpClient* c0 = NULL; bool reused = true;
+    HELPER_ASSERT_SUCCESS(pool.acquire(2, &c0, &reused));
+    EXPECT_FALSE(reused);
+
+    SrsHttpClient* c1 = NULL;
+    HELPER_ASSERT_SUCCESS(pool.acquire(2, &c1, &reused));
+    EXPECT_FALSE(reused);
+    EXPECT_TRUE(c0 != c1);
+    EXPECT_EQ(2, pool.busy());
+
+    // Keep c0 alive, close c1.
+    pool.release(c0, true);
+    pool.release(c1, false);
+    EXPECT_EQ(0, pool.busy());
+    EXPECT_EQ(1, pool.idles());
+
+    SrsHttpClient* c2 = NULL;
+    HELPER_ASSERT_SUCCESS(pool.acquire(2, &c2, &reused));
+    EXPECT_TRUE(reused);
+    EXPECT_TRUE(c0 == c2);
+    EXPECT_EQ(0, pool.idles());
+
+    pool.release(c2, true);
+    pool.reset();
+    EXPECT_EQ(0, pool.idles());
+}
+
+VOID TEST(AppStatisticTest, TableCompact)
+{
+    SrsStatisticTable<SrsStatisticClient> t;
+    SrsStatisticClient clients[200];
+    for (int i = 0; i < 200; i++) {
+        t.insert(&clients[i]);
+        EXPECT_EQ(i + 1, (int)clients[i].seq);
+        EXPECT_EQ(i, clients[i].slot);
+    }
+    EXPECT_EQ(200, t.size());
+
+    // Remove the even ones, leave holes.
+    for (int i = 0; i < 100; i += 2) {
+        t.remove(&clients[i]);
+    }
+    EXPECT_EQ(150, t.size());
+    EXPECT_EQ(200, t.slots());
+    EXPECT_TRUE(t.at(0) == NULL);
+    EXPECT_EQ(1, t.after(1));
+
+    // Remove again should be ignored.
+    t.remove(&clients[0]);
+    EXPECT_EQ(150, t.size());
+
+    // Compact when more than half are holes.
+    for (int i = 100; i < 200; i += 2) {
+        t.remove(&clients[i]);
+    }
+    EXPECT_EQ(100, t.size());
+    EXPECT_EQ(200, t.slots());
+    t.remove(&clients[1]);
+    EXPECT_EQ(99, t.size());
+    EXPECT_EQ(99, t.slots());
+    for (int i = 0; i < t.slots(); i++) {
+        EXPECT_EQ(i, t.at(i)->slot);
+    }
+
+    // The seq is kept after compact, for cursor.
+    EXPECT_EQ(4, (int)t.at(0)->seq);
+    EXPECT_EQ(0, t.after(2));
+    EXPECT_EQ(1, t.after(4));
+    EXPECT_EQ(99, t.after(200));
+}
+
+VOID TEST(AppStatisticTest, PageByCursor)
+{
+    srs_error_t err;
+
+    SrsStatistic* stat = new SrsStatistic();
+    SrsAutoFree(SrsStatistic, stat);
+
+    SrsRequest req;
+    req.vhost = "__defaultVhost__";
+    req.app = "live";
+    req.stream = "livestream";
+    req.ip = "127.0.0.1";
+
+    for (int i = 0; i < 25; i++) {
+        HELPER_EXPECT_SUCCESS(stat->on_client(srs_int2str(i), &req, NULL, SrsRtmpConnPlay));
+    }
+    EXPECT_EQ(25, stat->nb_clients());
+    EXPECT_EQ(1, stat->nb_streams());
+
+    // Dumps the first page, by cursor.
+    SrsStatisticPage page;
+    page.by_cursor = true;
+    page.fields = srs_stat_client_fields("id, ip");
+
+    SrsJsonWriter w;
+    stat->dumps_clients(&w, &page);
+    EXPECT_EQ(10, (int)page.next);
+    EXPECT_EQ(0, (int)w.data().find("[{\"id\":\"0\",\"ip\":\"127.0.0.1\"},{\"id\":\"1\","));
+
+    // Remove clients before and after cursor, the next page is stable.
+    stat->on_disconnect("5");
+    stat->on_disconnect("10");
+    stat->on_disconnect("11");
+
+    page.cursor = page.next;
+    w.reset();
+    stat->dumps_clients(&w, &page);
+    EXPECT_EQ(22, (int)page.next);
+    EXPECT_EQ(0, (int)w.data().find("[{\"id\":\"12\","));
+
+    // The last page, no more.
+    page.cursor = page.next;
+    w.reset();
+    stat->dumps_clients(&w, &page);
+    EXPECT_EQ(0, (int)page.next);
+    EXPECT_STREQ("[{\"id\":\"22\",\"ip\":\"127.0.0.1\"},{\"id\":\"23\",\"ip\":\"127.0.0.1\"},{\"id\":\"24\",\"ip\":\"127.0.0.1\"}]",
+        w.data().c_str());
+
+    // Page by start index, skip the holes.
+    SrsStatisticPage spage;
+    spage.start = 8;
+    spage.count = 2;
+    spage.fields = SrsStatisticClientFieldId;
+    w.reset();
+    stat->dumps_clients(&w, &spage);
+    EXPECT_STREQ("[{\"id\":\"9\"},{\"id\":\"12\"}]", w.data().c_str());
+    EXPECT_EQ(13, (int)spage.next);
+
+    // Should be the same as the tree dumps.
+    SrsStatisticPage all;
+    all.count = 100;
+    w.reset();
+    stat->dumps_clients(&w, &all);
+
+    SrsJsonArray* arr = SrsJsonAny::array();
+    SrsAutoFree(SrsJsonArray, arr);
+    HELPER_EXPECT_SUCCESS(stat->dumps_clients(arr, 0, 100));
+    EXPECT_EQ(22, arr->count());
+    EXPECT_EQ(w.data().length(), arr->dumps().length());
+
+    // The stream fields.
+    EXPECT_EQ(SRS_STAT_FIELDS_ALL, srs_stat_stream_fields(""));
+    EXPECT_EQ(SrsStatisticStreamFieldName | SrsStatisticStreamFieldClients, srs_stat_stream_fields("name,clients,unknown"));
+
+    SrsStatisticPage spage2;
+    spage2.fields = srs_stat_stream_fields("name,clients");
+    w.reset();
+    stat->dumps_streams(&w, &spage2);
+    EXPECT_STREQ("[{\"name\":\"livestream\",\"clients\":22}]", w.data().c_str());
+}
+
+VOID TEST(AppStatisticTest, Latency)
+{
+    srs_error_t err;
+
+    SrsStatistic* stat = new SrsStatistic();
+    SrsAutoFree(SrsStatistic, stat);
+
+    SrsRequest req;
+    req.vhost = "__defaultVhost__";
+    req.app = "live";
+    req.stream = "livestream";
+    stat->on_stream_publish(&req, "pub");
+
+    // No latency object by default.
+    SrsStatisticPage page;
+    page.fields = srs_stat_stream_fields("name,latency");
+    SrsJsonWriter w;
+    stat->dumps_streams(&w, &page);
+    EXPECT_STREQ("[{\"name\":\"livestream\"}]", w.data().c_str());
+
+    SrsStatisticLatency* latency = stat->latency(&req, SrsStatisticLatencyTypeRtmp);
+    EXPECT_TRUE(latency != NULL);
+    EXPECT_EQ(latency, stat->latency(&req, SrsStatisticLatencyTypeRtmp));
+
+    // Record the message with ingress time.
+    SrsStatisticLatencyRecorder recorder;
+    recorder.latency_ = latency;
+
+    SrsSharedPtrMessage msg;
+    HELPER_EXPECT_SUCCESS(msg.create(NULL, new char[1], 1));
+    msg.set_ingress(srs_update_system_time() - 10 * SRS_UTIME_MILLISECONDS);
+
+    SrsSharedPtrMessage* msgs[] = {&msg, &msg};
+    recorder.on_dequeue(msgs, 2);
+    EXPECT_EQ(2, latency->queue.count());
+    EXPECT_EQ(0, latency->send.count());
+    EXPECT_GE(latency->queue.min(), 10 * SRS_UTIME_MILLISECONDS);
+
+    recorder.on_sent();
+    EXPECT_EQ(2, latency->send.count());
+    EXPECT_EQ(1, latency->jitter.count());
+
+    // The packet without ingress time is ignored.
+    recorder.on_dequeue(0);
+    recorder.on_dequeue(srs_update_system_time());
+    recorder.on_discard();
+    recorder.on_sent();
+    EXPECT_EQ(3, latency->queue.count());
+    EXPECT_EQ(2, latency->send.count());
+
+    w.reset();
+    stat->dumps_streams(&w, &page);
+    EXPECT_EQ(0, (int)w.data().find("[{\"name\":\"livestream\",\"latency\":{\"rtmp\":{\"queue\":{\"count\":3,"));
+    EXPECT_TRUE(w.data().find("\"http\"") == string::npos);
+}
+
+static int mock_stat_count(const string& data, const string& sub)
+{
+    int n = 0;
+    for (size_t pos = data.find(sub); pos != string::npos; pos = data.find(sub, pos + sub.length())) {
+        n++;
+    }
+    return n;
+}
+
+VOID TEST(AppStatisticTest, DumpsClientsByCursor)
+{
+    srs_error_t err;
+
+    SrsStatistic* stat = new SrsStatistic();
+    SrsAutoFree(SrsStatistic, stat);
+
+    SrsRequest req;
+    req.vhost = "__defaultVhost__";
+    req.app = "live";
+    req.ip = "127.0.0.1";
+    req.tcUrl = "rtmp://127.0.0.1/live";
+
+    int nn_clients = 1000;
+    for (int i = 0; i < nn_clients; i++) {
+        req.stream = "livestream" + srs_int2str(i % 100);
+        HELPER_EXPECT_SUCCESS(stat->on_client(srs_int2str(i), &req, NULL, SrsRtmpConnPlay));
+    }
+
+    // Dump all clients by tree of JSON objects.
+    string tree;
+    if (true) {
+        SrsJsonArray* arr = SrsJsonAny::array();
+        SrsAutoFree(SrsJsonArray, arr);
+        HELPER_EXPECT_SUCCESS(stat->dumps_clients(arr, 0, nn_clients));
+        tree = arr->dumps();
+    }
+    EXPECT_EQ(nn_clients, mock_stat_count(tree, "{\"id\":"));
+
+    // Dump all clients by writer, which is the same as tree.
+    SrsJsonWriter w;
+    SrsStatisticPage page;
+    page.count = nn_clients;
+    stat->dumps_clients(&w, &page);
+    EXPECT_EQ(tree.length(), w.data().length());
+    EXPECT_EQ(nn_clients, mock_stat_count(w.data(), "{\"id\":"));
+
+    // Poll all clients by cursor, each client in a page only once.
+    int nn_pages = 0, nn_polled = 0;
+    page.by_cursor = true;
+    page.count = 100;
+    for (page.cursor = 0;;) {
+        w.reset();
+        stat->dumps_clients(&w, &page);
+        nn_pages++;
+        nn_polled += mock_stat_count(w.data(), "{\"id\":");
+        if (!page.next) break;
+        page.cursor = page.next;
+    }
+    EXPECT_EQ(nn_clients, nn_polled);
+    EXPECT_EQ(nn_clients / 100, nn_pages);
+}
+
+VOID TEST(AppMetricsTest, CounterAndGauge)
+{
+    SrsMetrics metrics;
+    metrics.set_const_labels(srs_metrics_label("label", "cn-beijing"));
+
+    SrsMetric* c = metrics.counter("srs_test_total", "The test counter.");
+    EXPECT_TRUE(c == metrics.counter("srs_test_total", "The test counter."));
+    c->get()->inc();
+    c->get()->inc(2);
+
+    SrsMetric* g = metrics.gauge("srs_test_clients", "The test gauge.");
+    g->with(srs_metrics_label("stream", "live\"s\\1\n"))->set(10);
+
+    EXPECT_STREQ("# HELP srs_test_total The test counter.\n"
+        "# TYPE srs_test_total counter\n"
+        "srs_test_total{label=\"cn-beijing\"} 3\n"
+        "# HELP srs_test_clients The test gauge.\n"
+        "# TYPE srs_test_clients gauge\n"
+        "srs_test_clients{label=\"cn-beijing\",stream=\"live\\\"s\\\\1\\n\"} 10\n",
+        metrics.dumps().c_str());
+}
+
+VOID TEST(AppMetricsTest, Histogram)
+{
+    SrsMetrics metrics;
+
+    vector<double> bounds;
+    bounds.push_back(0.01);
+    bounds.push_back(0.1);
+    SrsMetric* h = metrics.histogram("srs_test_seconds", "The test histogram.", bounds);
+
+    SrsMetricSeries* s = h->with(srs_metrics_label("action", "on_play"));
+    s->observe(0.005);
+    s->observe(0.01);
+    s->observe(0.05);
+    s->observe(1);
+
+    EXPECT_STREQ("# HELP srs_test_seconds The test histogram.\n"
+        "# TYPE srs_test_seconds histogram\n"
+        "srs_test_seconds_bucket{action=\"on_play\",le=\"0.01\"} 2\n"
+        "srs_test_seconds_bucket{action=\"on_play\",le=\"0.1\"} 3\n"
+        "srs_test_seconds_bucket{action=\"on_play\",le=\"+Inf\"} 4\n"
+        "srs_test_seconds_sum{action=\"on_play\"} 1.065\n"
+        "srs_test_seconds_count{action=\"on_play\"} 4\n",
+        metrics.dumps().c_str());
+}
+
+VOID TEST(AppMetricsTest, MaxSeries)
+{
+    SrsMetrics metrics;
+    metrics.set_max_series(2);
+
+    SrsMetric* g = metrics.gauge("srs_test_clients", "The test gauge.");
+    g->with(srs_metrics_label("stream", "s0"))->inc(1);
+    g->with(srs_metrics_label("stream", "s1"))->inc(2);
+    // Exceed the max series, aggregate to the overflow series.
+    g->with(srs_metrics_label("stream", "s2"))->inc(3);
+    g->with(srs_metrics_label("stream", "s3"))->inc(4);
+    EXPECT_EQ(3, g->size());
+
+    EXPECT_STREQ("# HELP srs_test_clients The test gauge.\n"
+        "# TYPE srs_test_clients gauge\n"
+        "srs_test_clients{stream=\"s0\"} 1\n"
+        "srs_test_clients{stream=\"s1\"} 2\n"
+        "srs_test_clients{overflow=\"true\"} 7\n",
+        metrics.dumps().c_str());
+
+    // The collected metric is reset before collecting.
+    g->reset();
+    EXPECT_EQ(0, g->size());
+    EXPECT_STREQ("", metrics.dumps().c_str());
+}
+
+class MockMetricsCollector : public ISrsMetricsCollector
+{
+public:
+    int nn_collected;
+public:
+    MockMetricsCollector() {
+        nn_collected = 0;
+    }
+    virtual void collect(SrsMetrics* metrics) {
+        nn_collected++;
+        metrics->gauge("srs_test_collected", "The test collected.")->get()->set(nn_collected);
+    }
+};
+
+VOID TEST(AppMetricsTest, Collector)
+{
+    srs_error_t err;
+
+    SrsMetrics metrics;
+    MockMetricsCollector collector;
+
+    metrics.subscribe(&collector);
+    metrics.subscribe(&collector);
+    EXPECT_STREQ("# HELP srs_test_collected The test collected.\n"
+        "# TYPE srs_test_collected gauge\n"
+        "srs_test_collected 1\n",
+        metrics.dumps().c_str());
+
+    metrics.unsubscribe(&collector);
+    metrics.dumps();
+    EXPECT_EQ(1, collector.nn_collected);
+
+    // Collect the streams of statistic.
+    SrsStatistic* stat = new SrsStatistic();
+    SrsAutoFree(SrsStatistic, stat);
+
+    SrsRequest req;
+    req.vhost = "__defaultVhost__"; req.app = "live"; req.stream = "livestream";
+    stat->on_stream_publish(&req, "pub");
+    HELPER_EXPECT_SUCCESS(stat->on_video_frames(&req, 10));
+
+    SrsMetrics m2;
+    m2.subscribe(stat);
+    string data = m2.dumps();
+    EXPECT_TRUE(data.find("srs_streams 1\n") != string::npos);
+    EXPECT_TRUE(data.find("srs_stream_frames_total{vhost=\"__defaultVhost__\",app=\"live\",stream=\"livestream\"} 10\n") != string::npos);
+
+    // The counters of overflow series never decrease, when streams closed or series freed.
+    m2.set_max_series(1);
+    SrsRequest r2, r3, r4;
+    r2.vhost = r3.vhost = r4.vhost = "__defaultVhost__"; r2.app = r3.app = r4.app = "live";
+    r2.stream = "s2"; r3.stream = "s3"; r4.stream = "s4";
+    stat->on_stream_publish(&r2, "pub2");
+    stat->on_stream_publish(&r3, "pub3");
+    HELPER_EXPECT_SUCCESS(stat->on_video_frames(&r2, 5));
+    HELPER_EXPECT_SUCCESS(stat->on_video_frames(&r3, 7));
+    data = m2.dumps();
+    EXPECT_TRUE(data.find("srs_stream_frames_total{vhost=\"__defaultVhost__\",app=\"live\",stream=\"livestream\"} 10\n") != string::npos);
+    EXPECT_TRUE(data.find("srs_stream_frames_total{overflow=\"true\"} 12\n") != string::npos);
+
+    // The series is freed, but the streams in overflow series never get their own series.
+    stat->on_stream_close(&req);
+    data = m2.dumps();
+    EXPECT_TRUE(data.find("stream=\"livestream\"") == string::npos);
+    EXPECT_TRUE(data.find("stream=\"s2\"") == string::npos);
+    EXPECT_TRUE(data.find("srs_stream_frames_total{overflow=\"true\"} 12\n") != string::npos);
+
+    // The new stream gets the freed series, and the closed stream is still in overflow series.
+    stat->on_stream_publish(&r4, "pub4");
+    HELPER_EXPECT_SUCCESS(stat->on_video_frames(&r4, 1));
+    stat->on_stream_close(&r2);
+    data = m2.dumps();
+    EXPECT_TRUE(data.find("srs_stream_frames_total{vhost=\"__defaultVhost__\",app=\"live\",stream=\"s4\"} 1\n") != string::npos);
+    EXPECT_TRUE(data.find("srs_stream_frames_total{overflow=\"true\"} 12\n") != string::npos);
+}
+
+VOID TEST(AppProfilerTest, Symbols)
+{
+    srs_error_t err;
+
+    SrsCpuSymbols symbols;
+    HELPER_EXPECT_SUCCESS(symbols.load("/proc/self/exe"));
+    EXPECT_TRUE(symbols.size() > 0);
+
+    // Resolve the address in the function, the name is demangled.
+    string name = symbols.resolve((void*)((char*)srs_int2str + 1));
+    EXPECT_EQ(0, (int)name.find("srs_int2str"));
+
+    // Resolve the address of shared library by dladdr.
+    EXPECT_FALSE(symbols.resolve((void*)::strlen).empty());
+}
+
+static int64_t mock_profiler_busy_loop(srs_utime_t duration)
+{
+    int64_t v = 0;
+    srs_utime_t starttime = srs_update_system_time();
+    while (srs_update_system_time() - starttime < duration) {
+        for (int i = 0; i < 10000; i++) {
+            v += i * i;
+        }
+    }
+    return v;
+}
+
+VOID TEST(AppProfilerTest, Sampling)
+{
+    srs_error_t err;
+
+    SrsCpuProfiler p;
+    HELPER_EXPECT_FAILED(p.start(0, 1 * SRS_UTIME_SECONDS));
+    HELPER_EXPECT_FAILED(p.start(SRS_PROFILER_MAX_HZ + 1, 1 * SRS_UTIME_SECONDS));
+    HELPER_EXPECT_FAILED(p.start(100, 0));
+
+    // The samples are attributed to the context id.
+    SrsContextRestore(_srs_context->get_id());
+    _srs_context->set_id(SrsContextId().set_value("mockcid"));
+
+    HELPER_EXPECT_SUCCESS(p.start(SRS_PROFILER_MAX_HZ, 1 * SRS_UTIME_SECONDS));
+    EXPECT_TRUE(p.running());
+    HELPER_EXPECT_FAILED(p.start(SRS_PROFILER_MAX_HZ, 1 * SRS_UTIME_SECONDS));
+
+    // Only one profiler is running, because the signal is global.
+    SrsCpuProfiler p2;
+    HELPER_EXPECT_FAILED(p2.start(SRS_PROFILER_MAX_HZ, 1 * SRS_UTIME_SECONDS));
+
+    mock_profiler_busy_loop(200 * SRS_UTIME_MILLISECONDS);
+    p.stop();
+    EXPECT_FALSE(p.running());
+    EXPECT_TRUE(p.nn_samples() > 0);
+
+    string folded;
+    p.dumps(folded, false);
+    EXPECT_TRUE(folded.find("mock_profiler_busy_loop") != string::npos);
+    EXPECT_TRUE(folded.find(" ") != string::npos);
+    EXPECT_EQ('\n', folded.at(folded.length() - 1));
+
+    // The context id is the root frame.
+    folded.clear();
+    p.dumps(folded, true);
+    EXPECT_TRUE(folded.find(";mock_profiler_busy_loop") != string::npos);
+    EXPECT_EQ(0, (int)folded.find("mockcid;"));
+}
+
+VOID TEST(AppProfilerTest, ContextIdBuffer)
+{
+    SrsContextRestore(_srs_context->get_id());
+
+    // The buffer is updated by set_id, and zero-padded.
+    _srs_context->set_id(SrsContextId().set_value("abc"));
+    const char* buf = srs_context_id_buffer();
+    EXPECT_STREQ("abc", buf);
+    EXPECT_EQ(0, buf[SRS_CONTEXT_ID_BUFFER_SIZE - 1]);
+
+    // The buffer is fixed for coroutine, and not null-terminated when full.
+    _srs_context->set_id(SrsContextId().set_value("0123456789abcdefghij"));
+    EXPECT_EQ(buf, srs_context_id_buffer());
+    EXPECT_EQ("0123456789abcdef", string(buf, SRS_CONTEXT_ID_BUFFER_SIZE));
+
+    _srs_context->set_id(SrsContextId().set_value("xyz"));
+    EXPECT_STREQ("xyz", buf);
+}
@@ -1291,6 +1291,21 @@ VOID TEST(ConfigMainTest, CheckConf_vhost_dvr)
         MockSrsConfig conf;
         HELPER_ASSERT_FAILED(conf.parse(_MIN_OK_CONF "vhost v{dvr{time_jitters full;}}"));
     }
+
+    if (true) {
+        MockSrsConfig conf;
+        HELPER_ASSERT_SUCCESS(conf.parse(_MIN_OK_CONF "vhost v{dvr{dvr_buffer 64; dvr_fallocate 16; dvr_direct_io on;}}"));
+    }
+
+    if (true) {
+        MockSrsConfig conf;
+        HELPER_ASSERT_SUCCESS(conf.parse(_MIN_OK_CONF "vhost v{dvr{dvr_fragment 2; dvr_finalize on;}}"));
+    }
+
+    if (true) {
+        MockSrsConfig conf;
+        HELPER_ASSERT_FAILED(conf.parse(_MIN_OK_CONF "vhost v{dvr{dvr_buffers 64;}}"));
+    }
 }
 
 VOID TEST(ConfigMainTest, CheckConf_vhost_ingest)
@@ -2071,6 +2086,28 @@ VOID TEST(ConfigUnitTest, CheckDefaultValuesVhost)
 	    EXPECT_EQ(10 * SRS_UTIME_SECONDS, conf.get_dvr_duration("v"));
     }
 
+    if (true) {
+	    HELPER_ASSERT_SUCCESS(conf.parse(_MIN_OK_CONF));
+	    EXPECT_EQ(0, conf.get_dvr_buffer(""));
+	    EXPECT_EQ(0, conf.get_dvr_fallocate(""));
+	    EXPECT_FALSE(conf.get_dvr_direct_io(""));
+
+	    HELPER_ASSERT_SUCCESS(conf.parse(_MIN_OK_CONF "vhost v{dvr{dvr_buffer 64; dvr_fallocate 16; dvr_direct_io on;}}"));
+	    EXPECT_EQ(64 * 1024, conf.get_dvr_buffer("v"));
+	    EXPECT_EQ(16 * 1024 * 1024, conf.get_dvr_fallocate("v"));
+	    EXPECT_TRUE(conf.get_dvr_direct_io("v"));
+    }
+
+    if (true) {
+	    HELPER_ASSERT_SUCCESS(conf.parse(_MIN_OK_CONF));
+	    EXPECT_EQ(0, conf.get_dvr_fragment(""));
+	    EXPECT_FALSE(conf.get_dvr_finalize(""));
+
+	    HELPER_ASSERT_SUCCESS(conf.parse(_MIN_OK_CONF "vhost v{dvr{dvr_fragment 1.5; dvr_finalize on;}}"));
+	    EXPECT_EQ(1500 * SRS_UTIME_MILLISECONDS, conf.get_dvr_fragment("v"));
+	    EXPECT_TRUE(conf.get_dvr_finalize("v"));
+    }
+
     if (true) {
 	    HELPER_ASSERT_SUCCESS(conf.parse(_MIN_OK_CONF));
 	    EXPECT_EQ(0, (int)conf.get_hls_dispose(""));
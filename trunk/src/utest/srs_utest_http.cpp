@@ -104,6 +104,11 @@ srs_error_t MockResponseWriter::writev(const iovec* iov, int iovcnt, ssize_t* pn
     return w->writev(iov, iovcnt, pnwrite);
 }
 
+srs_error_t MockResponseWriter::sendfile(int fd, int64_t offset, int64_t size, bool* psent)
+{
+    return w->sendfile(fd, offset, size, psent);
+}
+
 void MockResponseWriter::write_header(int code)
 {
     w->write_header(code);
@@ -987,6 +992,225 @@ VOID TEST(ProtocolHTTPTest, HTTPServerMuxerBasic)
     }
 }
 
+VOID TEST(ProtocolHTTPTest, HTTPServerMuxerTrie)
+{
+    SrsHttpMuxEntry e0, e1, e2, e3;
+
+    // Split and compress the nodes when insert and remove.
+    if (true) {
+        SrsHttpMuxTrie t;
+        t.insert("/live/livestream.flv", &e0);
+        t.insert("/live/livestream.ts", &e1);
+        t.insert("/live/", &e2);
+        t.insert("/", &e3);
+        EXPECT_EQ(4, t.size());
+
+        EXPECT_TRUE(&e0 == t.match("/live/livestream.flv"));
+        EXPECT_TRUE(&e1 == t.match("/live/livestream.ts"));
+        EXPECT_TRUE(&e2 == t.match("/live/livestream.mp3"));
+        EXPECT_TRUE(&e2 == t.match("/live/livestream.flv2"));
+        EXPECT_TRUE(&e2 == t.match("/live/"));
+        EXPECT_TRUE(&e3 == t.match("/live"));
+        EXPECT_TRUE(&e3 == t.match("/index.html"));
+        EXPECT_TRUE(NULL == t.match(""));
+        EXPECT_TRUE(NULL == t.match("live/"));
+
+        // Replace the exists one.
+        t.insert("/live/livestream.ts", &e0);
+        EXPECT_EQ(4, t.size());
+        EXPECT_TRUE(&e0 == t.match("/live/livestream.ts"));
+
+        EXPECT_TRUE(&e0 == t.remove("/live/livestream.ts"));
+        EXPECT_TRUE(NULL == t.remove("/live/livestream.ts"));
+        EXPECT_TRUE(NULL == t.remove("/live/livestream"));
+        EXPECT_TRUE(NULL == t.remove("/none"));
+        EXPECT_EQ(3, t.size());
+        EXPECT_TRUE(&e2 == t.match("/live/livestream.ts"));
+
+        EXPECT_TRUE(&e2 == t.remove("/live/"));
+        EXPECT_TRUE(&e3 == t.match("/live/livestream.ts"));
+        EXPECT_TRUE(&e0 == t.match("/live/livestream.flv"));
+
+        EXPECT_TRUE(&e3 == t.remove("/"));
+        EXPECT_TRUE(NULL == t.match("/live/livestream.ts"));
+        EXPECT_TRUE(&e0 == t.match("/live/livestream.flv"));
+
+        EXPECT_TRUE(&e0 == t.remove("/live/livestream.flv"));
+        EXPECT_EQ(0, t.size());
+        EXPECT_TRUE(NULL == t.match("/live/livestream.flv"));
+
+        // Reuse the trie after all removed.
+        t.insert("/live/livestream.flv", &e1);
+        EXPECT_TRUE(&e1 == t.match("/live/livestream.flv"));
+    }
+
+    // Fallback to the shorter pattern, if the longer one is disabled.
+    if (true) {
+        SrsHttpMuxTrie t;
+        t.insert("/", &e0);
+        t.insert("/live/", &e1);
+        t.insert("/live/livestream.flv", &e2);
+
+        e2.enabled = false;
+        EXPECT_TRUE(&e1 == t.match("/live/livestream.flv"));
+
+        e1.enabled = false;
+        EXPECT_TRUE(&e0 == t.match("/live/livestream.flv"));
+
+        e1.enabled = e2.enabled = true;
+        EXPECT_TRUE(&e2 == t.match("/live/livestream.flv"));
+    }
+
+    // Vhost patterns, which not starts with /.
+    if (true) {
+        SrsHttpMuxTrie t;
+        t.insert("ossrs.net/live/livestream.flv", &e0);
+        t.insert("ossrs.net/", &e1);
+        t.insert("/live/livestream.flv", &e2);
+
+        EXPECT_TRUE(&e0 == t.match("ossrs.net/live/livestream.flv"));
+        EXPECT_TRUE(&e1 == t.match("ossrs.net/live/livestream.ts"));
+        EXPECT_TRUE(&e2 == t.match("/live/livestream.flv"));
+        EXPECT_TRUE(NULL == t.match("ossrs.com/live/livestream.flv"));
+    }
+}
+
+VOID TEST(ProtocolHTTPTest, HTTPServerMuxerUnhandle)
+{
+    srs_error_t err;
+
+    if (true) {
+        SrsHttpServeMux s;
+        HELPER_ASSERT_SUCCESS(s.initialize());
+
+        MockHttpHandler* h0 = new MockHttpHandler("Hello, world!");
+        HELPER_ASSERT_SUCCESS(s.handle("/", h0));
+
+        MockHttpHandler* h1 = new MockHttpHandler("Done");
+        HELPER_ASSERT_SUCCESS(s.handle("/api/", h1));
+
+        // Ignore the implicit redirect, and the pattern not exists.
+        s.unhandle("/api");
+        s.unhandle("/none");
+
+        if (true) {
+            MockResponseWriter w;
+            SrsHttpMessage r(NULL, NULL);
+            HELPER_ASSERT_SUCCESS(r.set_url("/api", false));
+
+            HELPER_ASSERT_SUCCESS(s.serve_http(&w, &r));
+            EXPECT_EQ(SRS_CONSTS_HTTP_Found, w.w->status);
+        }
+
+        // Remove the handler with its implicit redirect.
+        s.unhandle("/api/");
+
+        if (true) {
+            MockResponseWriter w;
+            SrsHttpMessage r(NULL, NULL);
+            HELPER_ASSERT_SUCCESS(r.set_url("/api/v1/versions", false));
+
+            HELPER_ASSERT_SUCCESS(s.serve_http(&w, &r));
+            __MOCK_HTTP_EXPECT_STREQ(200, "Hello, world!", w);
+        }
+
+        if (true) {
+            MockResponseWriter w;
+            SrsHttpMessage r(NULL, NULL);
+            HELPER_ASSERT_SUCCESS(r.set_url("/api", false));
+
+            HELPER_ASSERT_SUCCESS(s.serve_http(&w, &r));
+            __MOCK_HTTP_EXPECT_STREQ(200, "Hello, world!", w);
+        }
+
+        // Mount it again.
+        h1 = new MockHttpHandler("Done");
+        HELPER_ASSERT_SUCCESS(s.handle("/api/", h1));
+
+        if (true) {
+            MockResponseWriter w;
+            SrsHttpMessage r(NULL, NULL);
+            HELPER_ASSERT_SUCCESS(r.set_url("/api/v1/versions", false));
+
+            HELPER_ASSERT_SUCCESS(s.serve_http(&w, &r));
+            __MOCK_HTTP_EXPECT_STREQ(200, "Done", w);
+        }
+    }
+}
+
+// Match by walking all patterns, the way of mux before trie.
+SrsHttpMuxEntry* mock_http_linear_match(std::map<std::string, SrsHttpMuxEntry*>& entries, const std::string& path)
+{
+    int nb_matched = 0;
+    SrsHttpMuxEntry* matched = NULL;
+
+    std::map<std::string, SrsHttpMuxEntry*>::iterator it;
+    for (it = entries.begin(); it != entries.end(); ++it) {
+        const std::string& pattern = it->first;
+        int n = (int)pattern.length();
+
+        bool ok = false;
+        if (pattern.at(n - 1) != '/') {
+            ok = (pattern == path);
+        } else {
+            ok = ((int)path.length() >= n && memcmp(pattern.data(), path.data(), n) == 0);
+        }
+
+        if (ok && (!matched || n > nb_matched)) {
+            nb_matched = n;
+            matched = it->second;
+        }
+    }
+
+    return matched;
+}
+
+VOID TEST(ProtocolHTTPTest, HTTPServerMuxerTrieLinear)
+{
+    const int nn_mounts = 5000;
+
+    SrsHttpMuxEntry* entries = new SrsHttpMuxEntry[nn_mounts];
+    SrsAutoFreeA(SrsHttpMuxEntry, entries);
+
+    std::vector<std::string> patterns;
+    std::map<std::string, SrsHttpMuxEntry*> linear;
+    SrsHttpMuxTrie t;
+
+    // Mount the streams, with apps, vhosts and templates.
+    for (int i = 0; i < nn_mounts; i++) {
+        char buf[128];
+        if (i % 10 == 0) {
+            snprintf(buf, sizeof(buf), "ossrs%d.net/live%d/", i / 10, i % 37);
+        } else {
+            snprintf(buf, sizeof(buf), "/live%d/livestream%d.%s", i % 37, i, (i % 3)? "flv" : "ts");
+        }
+        std::string pattern = buf;
+
+        patterns.push_back(pattern);
+        linear[pattern] = &entries[i];
+        t.insert(pattern, &entries[i]);
+    }
+    EXPECT_EQ(nn_mounts, t.size());
+
+    // Match by trie, which should be the same as linear.
+    for (int i = 0; i < nn_mounts; i += 7) {
+        const std::string& path = patterns[i];
+        EXPECT_TRUE(t.match(path) != NULL);
+        EXPECT_TRUE(mock_http_linear_match(linear, path) == t.match(path));
+        EXPECT_TRUE(mock_http_linear_match(linear, path + "x") == t.match(path + "x"));
+    }
+
+    // Unmount and mount again all streams.
+    for (int i = 0; i < nn_mounts; i++) {
+        EXPECT_TRUE(&entries[i] == t.remove(patterns[i]));
+    }
+    EXPECT_EQ(0, t.size());
+    for (int i = 0; i < nn_mounts; i++) {
+        t.insert(patterns[i], &entries[i]);
+    }
+    EXPECT_EQ(nn_mounts, t.size());
+}
+
 VOID TEST(ProtocolHTTPTest, HTTPServerMuxerCORS)
 {
     srs_error_t err;
@@ -1140,6 +1364,44 @@ VOID TEST(ProtocolHTTPTest, VodStreamHandlers)
         EXPECT_STREQ(ev.c_str(), av.c_str());
     }
 
+    // Seek flv by time, response from the keyframe, with the cached sequence header.
+    if (true) {
+        SrsHttpMuxEntry e;
+        e.pattern = "/";
+
+        MockSrsFileWriter fw;
+        SrsFlvTransmuxer enc;
+        HELPER_ASSERT_SUCCESS(fw.open(""));
+        HELPER_ASSERT_SUCCESS(enc.initialize(&fw));
+        HELPER_ASSERT_SUCCESS(enc.write_header());
+
+        char vsh[] = {(char)0x17, (char)0x00, (char)0x00, (char)0x00, (char)0x00, (char)0x01};
+        char key[] = {(char)0x17, (char)0x01, (char)0x00, (char)0x00, (char)0x00, (char)0x65};
+        HELPER_ASSERT_SUCCESS(enc.write_video(0, vsh, sizeof(vsh)));
+        HELPER_ASSERT_SUCCESS(enc.write_video(0, key, sizeof(key)));
+        int64_t key1 = fw.tellg();
+        HELPER_ASSERT_SUCCESS(enc.write_video(2000, key, sizeof(key)));
+
+        SrsVodStream h("/tmp");
+        h.set_fs_factory(new MockFileReaderFactory(fw.str()));
+        h.set_path_check(_mock_srs_path_always_exists);
+        h.entry = &e;
+
+        for (int i = 0; i < 2; i++) {
+            MockResponseWriter w;
+            SrsHttpMessage r(NULL, NULL);
+            HELPER_ASSERT_SUCCESS(r.set_url("/index.flv?starttime=2.5", false));
+            HELPER_ASSERT_SUCCESS(h.serve_http(&w, &r));
+
+            // The flv header, sequence header and the last keyframe.
+            string flv = fw.str();
+            string expect = flv.substr(0, (size_t)(13 + 11 + sizeof(vsh) + 4)) + flv.substr((size_t)key1);
+            string av = HELPER_BUFFER2STR(&w.io.out_buffer);
+            ASSERT_TRUE(av.length() >= expect.length());
+            EXPECT_TRUE(av.substr(av.length() - expect.length()) == expect);
+        }
+    }
+
     if (true) {
         SrsHttpMuxEntry e;
         e.pattern = "/";
@@ -1893,6 +2155,83 @@ VOID TEST(ProtocolHTTPTest, ParsingLargeMessages)
     }
 }
 
+VOID TEST(ProtocolHTTPTest, ParsingPipelinedMessages)
+{
+    srs_error_t err;
+
+    // The url is split into two reads, for example, the last request in buffer.
+    if (true) {
+        MockMSegmentsReader r; SrsHttpParser hp;
+        HELPER_ASSERT_SUCCESS(hp.initialize(HTTP_REQUEST));
+        r.in_bytes.push_back("GET /api/v1/vers");
+        r.in_bytes.push_back("ions HTTP/1.1\r\nHost: ossrs.net\r\n\r\n");
+
+        ISrsHttpMessage* msg = NULL; SrsAutoFree(ISrsHttpMessage, msg); HELPER_ASSERT_SUCCESS(hp.parse_message(&r, &msg));
+        EXPECT_STREQ("/api/v1/versions", msg->path().c_str());
+        EXPECT_STREQ("ossrs.net", msg->host().c_str());
+    }
+
+    // Pipelined requests in one packet.
+    if (true) {
+        MockBufferIO io; SrsHttpParser hp;
+        HELPER_ASSERT_SUCCESS(hp.initialize(HTTP_REQUEST));
+        io.append("GET /a HTTP/1.1\r\nHost: a.com\r\n\r\nGET /b?v=1 HTTP/1.1\r\nHost: b.com\r\n\r\n");
+
+        if (true) {
+            ISrsHttpMessage* msg = NULL; SrsAutoFree(ISrsHttpMessage, msg); HELPER_ASSERT_SUCCESS(hp.parse_message(&io, &msg));
+            EXPECT_STREQ("/a", msg->path().c_str());
+            EXPECT_STREQ("a.com", msg->host().c_str());
+            EXPECT_TRUE(msg->is_keep_alive());
+        }
+
+        if (true) {
+            ISrsHttpMessage* msg = NULL; SrsAutoFree(ISrsHttpMessage, msg); HELPER_ASSERT_SUCCESS(hp.parse_message(&io, &msg));
+            EXPECT_STREQ("/b", msg->path().c_str());
+            EXPECT_STREQ("b.com", msg->host().c_str());
+            EXPECT_STREQ("1", msg->query_get("v").c_str());
+        }
+    }
+
+    // Pipelined requests with body.
+    if (true) {
+        MockBufferIO io; SrsHttpParser hp;
+        HELPER_ASSERT_SUCCESS(hp.initialize(HTTP_REQUEST));
+        io.append("POST /a HTTP/1.1\r\nContent-Length: 5\r\n\r\nHelloGET /b HTTP/1.1\r\n\r\n");
+
+        if (true) {
+            ISrsHttpMessage* msg = NULL; SrsAutoFree(ISrsHttpMessage, msg); HELPER_ASSERT_SUCCESS(hp.parse_message(&io, &msg));
+            EXPECT_STREQ("/a", msg->path().c_str());
+            EXPECT_EQ(5, msg->content_length());
+            string body; HELPER_ASSERT_SUCCESS(msg->body_read_all(body));
+            EXPECT_STREQ("Hello", body.c_str());
+        }
+
+        if (true) {
+            ISrsHttpMessage* msg = NULL; SrsAutoFree(ISrsHttpMessage, msg); HELPER_ASSERT_SUCCESS(hp.parse_message(&io, &msg));
+            EXPECT_STREQ("/b", msg->path().c_str());
+        }
+    }
+
+    // Pipelined chunked request.
+    if (true) {
+        MockBufferIO io; SrsHttpParser hp;
+        HELPER_ASSERT_SUCCESS(hp.initialize(HTTP_REQUEST));
+        io.append("POST /a HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nHello\r\n0\r\n\r\nGET /b HTTP/1.1\r\n\r\n");
+
+        if (true) {
+            ISrsHttpMessage* msg = NULL; SrsAutoFree(ISrsHttpMessage, msg); HELPER_ASSERT_SUCCESS(hp.parse_message(&io, &msg));
+            EXPECT_STREQ("/a", msg->path().c_str());
+            string body; HELPER_ASSERT_SUCCESS(msg->body_read_all(body));
+            EXPECT_STREQ("Hello", body.c_str());
+        }
+
+        if (true) {
+            ISrsHttpMessage* msg = NULL; SrsAutoFree(ISrsHttpMessage, msg); HELPER_ASSERT_SUCCESS(hp.parse_message(&io, &msg));
+            EXPECT_STREQ("/b", msg->path().c_str());
+        }
+    }
+}
+
 VOID TEST(ProtocolHTTPTest, ParseUri)
 {
     srs_error_t err;
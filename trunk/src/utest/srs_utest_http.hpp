@@ -32,6 +32,7 @@ public:
     virtual SrsHttpHeader* header();
     virtual srs_error_t write(char* data, int size);
     virtual srs_error_t writev(const iovec* iov, int iovcnt, ssize_t* pnwrite);
+    virtual srs_error_t sendfile(int fd, int64_t offset, int64_t size, bool* psent);
     virtual void write_header(int code);
 public:
     virtual srs_error_t filter(SrsHttpHeader* h);
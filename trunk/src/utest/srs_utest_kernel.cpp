@@ -201,6 +201,27 @@ srs_error_t MockSrsFileWriter::write(void* buf, size_t count, ssize_t* pnwrite)
     return uf->write(buf, count, pnwrite);
 }
 
+srs_error_t MockSrsFileWriter::writev(const iovec* iov, int iovcnt, ssize_t* pnwrite)
+{
+    srs_error_t err = srs_success;
+
+    ssize_t nn_wrote = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        const iovec* piov = iov + i;
+        ssize_t this_nwrite = 0;
+        if ((err = write(piov->iov_base, piov->iov_len, &this_nwrite)) != srs_success) {
+            return srs_error_wrap(err, "write file");
+        }
+        nn_wrote += this_nwrite;
+    }
+
+    if (pnwrite) {
+        *pnwrite = nn_wrote;
+    }
+
+    return err;
+}
+
 srs_error_t MockSrsFileWriter::lseek(off_t offset, int whence, off_t* seeked)
 {
     if (error_offset >= 0 && offset > error_offset) {
@@ -1606,6 +1627,159 @@ VOID TEST(KernelFLVTest, CoverFLVVodError)
     }
 }
 
+class MockFlvVodIndexHandler : public ISrsFlvVodIndexHandler
+{
+public:
+	int nn_scans;
+	bool fail;
+public:
+	MockFlvVodIndexHandler() {
+		nn_scans = 0;
+		fail = false;
+	}
+	virtual ~MockFlvVodIndexHandler() {
+	}
+public:
+	virtual srs_error_t on_scan_tags(int64_t /*pos*/) {
+		nn_scans++;
+		return fail? srs_error_new(-1, "mock scan") : srs_success;
+	}
+};
+
+VOID TEST(KernelFLVTest, CoverFLVVodIndex)
+{
+	srs_error_t err;
+
+	// Should fail for invalid flv.
+	if (true) {
+		MockSrsFileReader r("Hello", 5);
+		SrsFlvVodIndex index;
+		HELPER_EXPECT_FAILED(index.initialize(&r));
+	}
+
+	MockSrsFileWriter fs;
+	SrsFlvTransmuxer enc;
+	HELPER_EXPECT_SUCCESS(fs.open(""));
+	HELPER_EXPECT_SUCCESS(enc.initialize(&fs));
+	HELPER_EXPECT_SUCCESS(enc.write_header());
+
+	char ash[] = {(char)0xaf, (char)0x00, (char)0x12, (char)0x10};
+	char vsh[] = {(char)0x17, (char)0x00, (char)0x00, (char)0x00, (char)0x00, (char)0x01};
+	char aframe[] = {(char)0xaf, (char)0x01, (char)0x21};
+	char key[] = {(char)0x17, (char)0x01, (char)0x00, (char)0x00, (char)0x00, (char)0x65};
+	char inter[] = {(char)0x27, (char)0x01, (char)0x00, (char)0x00, (char)0x00, (char)0x41};
+
+	HELPER_EXPECT_SUCCESS(enc.write_audio(0, ash, sizeof(ash)));
+	HELPER_EXPECT_SUCCESS(enc.write_video(0, vsh, sizeof(vsh)));
+	int64_t key0 = fs.tellg();
+	HELPER_EXPECT_SUCCESS(enc.write_video(0, key, sizeof(key)));
+	HELPER_EXPECT_SUCCESS(enc.write_audio(20, aframe, sizeof(aframe)));
+	HELPER_EXPECT_SUCCESS(enc.write_video(40, inter, sizeof(inter)));
+	int64_t key1 = fs.tellg();
+	HELPER_EXPECT_SUCCESS(enc.write_video(1000, key, sizeof(key)));
+	HELPER_EXPECT_SUCCESS(enc.write_audio(1020, aframe, sizeof(aframe)));
+
+	if (true) {
+		MockSrsFileReader r(fs.data(), (int)fs.filesize());
+		SrsFlvVodIndex index;
+		HELPER_EXPECT_SUCCESS(index.initialize(&r));
+		EXPECT_TRUE(srs_bytes_equals(fs.data(), index.header(), 13));
+		EXPECT_EQ(2, index.nb_sync_points());
+
+		// The sequence header tags, each with previous tag size.
+		EXPECT_EQ(key0 - 13, (int64_t)index.sequence_header().size());
+		EXPECT_TRUE(srs_bytes_equals(fs.data() + 13, &index.sequence_header()[0], (int)(key0 - 13)));
+
+		int64_t offset = 0;
+		HELPER_EXPECT_SUCCESS(index.seek(0, &offset));
+		EXPECT_EQ(key0, offset);
+		HELPER_EXPECT_SUCCESS(index.seek(999, &offset));
+		EXPECT_EQ(key0, offset);
+		HELPER_EXPECT_SUCCESS(index.seek(1000, &offset));
+		EXPECT_EQ(key1, offset);
+		HELPER_EXPECT_SUCCESS(index.seek(100000, &offset));
+		EXPECT_EQ(key1, offset);
+
+		EXPECT_EQ(key0, index.snap(13));
+		EXPECT_EQ(key0, index.snap(key1 - 1));
+		EXPECT_EQ(key1, index.snap(key1));
+		EXPECT_EQ(key1, index.snap(key1 + 5));
+	}
+
+	// The incomplete tag at the end is ignored.
+	if (true) {
+		MockSrsFileReader r(fs.data(), (int)key1 + 16);
+		SrsFlvVodIndex index;
+		HELPER_EXPECT_SUCCESS(index.initialize(&r));
+		EXPECT_EQ(1, index.nb_sync_points());
+	}
+
+	// The audio frames are sync points for pure audio.
+	if (true) {
+		MockSrsFileWriter fs;
+		SrsFlvTransmuxer enc;
+		HELPER_EXPECT_SUCCESS(fs.open(""));
+		HELPER_EXPECT_SUCCESS(enc.initialize(&fs));
+		HELPER_EXPECT_SUCCESS(enc.write_header(false, true));
+		HELPER_EXPECT_SUCCESS(enc.write_audio(0, ash, sizeof(ash)));
+		HELPER_EXPECT_SUCCESS(enc.write_audio(0, aframe, sizeof(aframe)));
+		HELPER_EXPECT_SUCCESS(enc.write_audio(20, aframe, sizeof(aframe)));
+
+		MockSrsFileReader r(fs.data(), (int)fs.filesize());
+		SrsFlvVodIndex index;
+		HELPER_EXPECT_SUCCESS(index.initialize(&r));
+		EXPECT_EQ(2, index.nb_sync_points());
+
+		int64_t offset = 0;
+		HELPER_EXPECT_SUCCESS(index.seek(30, &offset));
+		EXPECT_EQ(fs.filesize() - 11 - (int)sizeof(aframe) - 4, offset);
+	}
+
+	// No sync point to seek.
+	if (true) {
+		MockSrsFileWriter fs;
+		SrsFlvTransmuxer enc;
+		HELPER_EXPECT_SUCCESS(fs.open(""));
+		HELPER_EXPECT_SUCCESS(enc.initialize(&fs));
+		HELPER_EXPECT_SUCCESS(enc.write_header());
+
+		MockSrsFileReader r(fs.data(), (int)fs.filesize());
+		SrsFlvVodIndex index;
+		HELPER_EXPECT_SUCCESS(index.initialize(&r));
+		EXPECT_EQ(0, index.nb_sync_points());
+		EXPECT_TRUE(index.sequence_header().empty());
+		EXPECT_EQ(100, index.snap(100));
+
+		int64_t offset = 0;
+		HELPER_EXPECT_FAILED(index.seek(0, &offset));
+	}
+
+	// Yield by handler when scanning lots of tags.
+	if (true) {
+		MockSrsFileWriter fs;
+		SrsFlvTransmuxer enc;
+		HELPER_EXPECT_SUCCESS(fs.open(""));
+		HELPER_EXPECT_SUCCESS(enc.initialize(&fs));
+		HELPER_EXPECT_SUCCESS(enc.write_header(false, true));
+		for (int i = 0; i < 3000; i++) {
+			HELPER_EXPECT_SUCCESS(enc.write_audio(i * 20, aframe, sizeof(aframe)));
+		}
+
+		MockSrsFileReader r(fs.data(), (int)fs.filesize());
+		MockFlvVodIndexHandler handler;
+		SrsFlvVodIndex index;
+		HELPER_EXPECT_SUCCESS(index.initialize(&r, &handler));
+		EXPECT_EQ(3000, index.nb_sync_points());
+		EXPECT_EQ(2, handler.nn_scans);
+
+		// Stop scanning if handler failed.
+		handler.fail = true;
+		SrsFlvVodIndex index2;
+		HELPER_EXPECT_FAILED(index2.initialize(&r, &handler));
+		EXPECT_EQ(3, handler.nn_scans);
+	}
+}
+
 /**
 * test the stream utility, access pos
 */
@@ -4089,6 +4263,109 @@ VOID TEST(KernelFileWriterTest, WriteSpecialCase)
 	}
 }
 
+VOID TEST(KernelFileWriterTest, WriteWithIOBuffer)
+{
+	srs_error_t err;
+
+	// Should fail to set iobuf when opened.
+	if (true) {
+		SrsFileWriter f;
+		HELPER_EXPECT_SUCCESS(f.open("/dev/null"));
+		HELPER_EXPECT_FAILED(f.set_iobuf_size(4096));
+	}
+
+	// Coalesce small writes to iobuf, and position is tracked in userspace.
+	if (true) {
+		string path = _srs_tmp_file_prefix + "iobuf.flv";
+		SrsFileWriter f;
+		HELPER_EXPECT_SUCCESS(f.set_iobuf_size(100));
+		f.set_preallocate(1024 * 1024);
+		HELPER_EXPECT_SUCCESS(f.open(path));
+
+		ssize_t nn = 0;
+		HELPER_EXPECT_SUCCESS(f.write((void*)"Hello", 5, &nn));
+		EXPECT_EQ(5, nn);
+		EXPECT_EQ(5, f.tellg());
+
+		iovec iovs[2];
+		iovs[0].iov_base = (void*)"World";
+		iovs[0].iov_len = 5;
+		iovs[1].iov_base = (void*)"!";
+		iovs[1].iov_len = 1;
+		HELPER_EXPECT_SUCCESS(f.writev(iovs, 2, &nn));
+		EXPECT_EQ(6, nn);
+
+		off_t seeked = 0;
+		HELPER_EXPECT_SUCCESS(f.lseek(0, SEEK_CUR, &seeked));
+		EXPECT_EQ(11, seeked);
+
+		// Large write exceed the iobuf, coalesce to one writev.
+		char large[8192];
+		memset(large, 'x', sizeof(large));
+		HELPER_EXPECT_SUCCESS(f.write(large, sizeof(large), &nn));
+		EXPECT_EQ(8192, nn);
+		EXPECT_EQ(11 + 8192, f.tellg());
+
+		// Seek to update the header, then back to the end.
+		f.seek2(0);
+		HELPER_EXPECT_SUCCESS(f.write((void*)"J", 1, NULL));
+		f.seek2(11 + 8192);
+		HELPER_EXPECT_SUCCESS(f.write((void*)"End", 3, NULL));
+		f.close();
+
+		SrsFileReader r;
+		HELPER_EXPECT_SUCCESS(r.open(path));
+		EXPECT_EQ(11 + 8192 + 3, r.filesize());
+
+		char buf[16];
+		HELPER_EXPECT_SUCCESS(r.read(buf, 11, NULL));
+		EXPECT_TRUE(srs_bytes_equals(buf, (void*)"JelloWorld!", 11));
+		::unlink(path.c_str());
+	}
+}
+
+VOID TEST(KernelFileMmapTest, OpenAndMap)
+{
+	srs_error_t err;
+
+	// Should fail for not exists file.
+	if (true) {
+		SrsFileMmap f;
+		HELPER_EXPECT_FAILED(f.open(_srs_tmp_file_prefix + "not-exists.mp4"));
+	}
+
+	// Empty file is not mapped.
+	if (true) {
+		string path = _srs_tmp_file_prefix + "mmap-empty.mp4";
+		SrsFileWriter w;
+		HELPER_EXPECT_SUCCESS(w.open(path));
+		w.close();
+
+		SrsFileMmap f;
+		HELPER_EXPECT_SUCCESS(f.open(path));
+		EXPECT_EQ(0, f.size());
+		EXPECT_TRUE(f.data() == NULL);
+		::unlink(path.c_str());
+	}
+
+	if (true) {
+		string path = _srs_tmp_file_prefix + "mmap.mp4";
+		SrsFileWriter w;
+		HELPER_EXPECT_SUCCESS(w.open(path));
+		HELPER_EXPECT_SUCCESS(w.write((void*)"HelloWorld", 10, NULL));
+		w.close();
+
+		SrsFileMmap f;
+		HELPER_EXPECT_SUCCESS(f.open(path));
+		HELPER_EXPECT_FAILED(f.open(path));
+		EXPECT_EQ(10, f.size());
+		EXPECT_TRUE(f.mtime() > 0);
+		EXPECT_TRUE(f.inode() > 0);
+		EXPECT_TRUE(srs_bytes_equals(f.data(), (void*)"HelloWorld", 10));
+		::unlink(path.c_str());
+	}
+}
+
 VOID TEST(KernelFileReaderTest, WriteSpecialCase)
 {
 	srs_error_t err;
@@ -4296,6 +4573,155 @@ VOID TEST(KernelFLVTest, CoverSharedPtrMessage)
 	}
 }
 
+VOID TEST(KernelFLVTest, CoverSharedFlvTag)
+{
+    srs_error_t err;
+
+    SrsMessageHeader h;
+    h.initialize_video(4, 0x1234, 1);
+    SrsSharedPtrMessage msg;
+    HELPER_EXPECT_SUCCESS(msg.create(&h, new char[4], 4));
+    memcpy(msg.payload, "\x17\x01\x00\x00", 4);
+
+    // The first writer generates the tag header, which is shared by others.
+    MockSrsFileWriter w0, w1, w2;
+    if (true) {
+        SrsFlvTransmuxer m;
+        HELPER_EXPECT_SUCCESS(m.initialize(&w0));
+        SrsSharedPtrMessage* msgs = &msg;
+        HELPER_EXPECT_SUCCESS(m.write_tags(&msgs, 1));
+
+        bool ready = false;
+        EXPECT_TRUE(msg.flv_tag_cache(&ready) != NULL);
+        EXPECT_TRUE(ready);
+    }
+    if (true) {
+        SrsFlvTransmuxer m;
+        HELPER_EXPECT_SUCCESS(m.initialize(&w1));
+        SrsSharedPtrMessage* copy = msg.copy();
+        SrsAutoFree(SrsSharedPtrMessage, copy);
+        HELPER_EXPECT_SUCCESS(m.write_tags(&copy, 1));
+    }
+    ASSERT_EQ(SRS_FLV_TAG_HEADER_SIZE + 4 + SRS_FLV_PREVIOUS_TAG_SIZE, (int)w0.str().length());
+    EXPECT_EQ(w0.str(), w1.str());
+    EXPECT_EQ(0x09, (uint8_t)w0.data()[0]);
+    EXPECT_EQ(0x12, (uint8_t)w0.data()[5]);
+    EXPECT_EQ(0x34, (uint8_t)w0.data()[6]);
+    EXPECT_EQ(15, (uint8_t)w0.data()[18]);
+
+    // The consumer with different timestamp, generate the tag header itself.
+    if (true) {
+        SrsFlvTransmuxer m;
+        HELPER_EXPECT_SUCCESS(m.initialize(&w2));
+        SrsSharedPtrMessage* copy = msg.copy();
+        SrsAutoFree(SrsSharedPtrMessage, copy);
+        copy->timestamp = 0x5678;
+
+        bool ready = false;
+        EXPECT_TRUE(copy->flv_tag_cache(&ready) == NULL);
+
+        HELPER_EXPECT_SUCCESS(m.write_tags(&copy, 1));
+    }
+    ASSERT_EQ(w0.str().length(), w2.str().length());
+    EXPECT_EQ(0x56, (uint8_t)w2.data()[5]);
+    EXPECT_EQ(0x78, (uint8_t)w2.data()[6]);
+    EXPECT_EQ(w0.str().substr(7), w2.str().substr(7));
+}
+
+// Write the copies of messages to a FLV viewer, with timestamp delta.
+srs_error_t mock_flv_viewer(MockSrsFileWriter* w, SrsSharedPtrMessage** msgs, int count, int delta)
+{
+    srs_error_t err = srs_success;
+
+    if ((err = w->open("")) != srs_success) {
+        return srs_error_wrap(err, "open");
+    }
+
+    SrsFlvTransmuxer viewer;
+    if ((err = viewer.initialize(w)) != srs_success) {
+        return srs_error_wrap(err, "init");
+    }
+
+    // Copy the messages for viewer, like the consumer.
+    std::vector<SrsSharedPtrMessage*> copies;
+    for (int i = 0; i < count; i++) {
+        SrsSharedPtrMessage* copy = msgs[i]->copy();
+        copy->timestamp += delta;
+        copies.push_back(copy);
+    }
+
+    err = viewer.write_tags(&copies[0], count);
+
+    for (int i = 0; i < (int)copies.size(); i++) {
+        srs_freep(copies[i]);
+    }
+
+    return err;
+}
+
+VOID TEST(KernelFLVTest, SharedFlvTag)
+{
+    srs_error_t err;
+
+    // A batch of messages, like the merged-write of a viewer.
+    const int count = 10;
+    SrsSharedPtrMessage* msgs[count];
+    for (int i = 0; i < count; i++) {
+        SrsMessageHeader h;
+        if (i % 3) {
+            h.initialize_audio(4, i * 20, 1);
+        } else {
+            h.initialize_video(5, i * 20, 1);
+        }
+
+        char* payload = new char[h.payload_length];
+        memset(payload, i, h.payload_length);
+
+        msgs[i] = new SrsSharedPtrMessage();
+        HELPER_EXPECT_SUCCESS(msgs[i]->create(&h, payload, h.payload_length));
+    }
+
+    // The viewers with the same timestamp, share the tag header, write the same bytes.
+    MockSrsFileWriter w0, w1;
+    HELPER_EXPECT_SUCCESS(mock_flv_viewer(&w0, msgs, count, 0));
+    HELPER_EXPECT_SUCCESS(mock_flv_viewer(&w1, msgs, count, 0));
+    ASSERT_EQ(w0.filesize(), w1.filesize());
+    EXPECT_TRUE(srs_bytes_equals(w0.data(), w1.data(), (int)w0.filesize()));
+
+    // The viewer with different timestamp, for example, the jitter, never use the shared tag header.
+    MockSrsFileWriter w2;
+    HELPER_EXPECT_SUCCESS(mock_flv_viewer(&w2, msgs, count, 100));
+    ASSERT_EQ(w0.filesize(), w2.filesize());
+
+    // Parse the tags, the type, size and previous tag size are the same, the timestamp is per viewer.
+    SrsBuffer b0(w0.data(), (int)w0.filesize());
+    SrsBuffer b2(w2.data(), (int)w2.filesize());
+    for (int i = 0; i < count; i++) {
+        SrsSharedPtrMessage* msg = msgs[i];
+        for (int j = 0; j < 2; j++) {
+            SrsBuffer* b = j? &b2 : &b0;
+            ASSERT_TRUE(b->require(SRS_FLV_TAG_HEADER_SIZE + msg->size + SRS_FLV_PREVIOUS_TAG_SIZE));
+
+            EXPECT_EQ(msg->is_audio()? 8 : 9, b->read_1bytes());
+            EXPECT_EQ(msg->size, b->read_3bytes());
+            int32_t timestamp = b->read_3bytes();
+            timestamp |= (int32_t)(uint8_t)b->read_1bytes() << 24;
+            EXPECT_EQ(msg->timestamp + (j? 100 : 0), timestamp);
+            EXPECT_EQ(0, b->read_3bytes());
+
+            EXPECT_TRUE(srs_bytes_equals(msg->payload, b->head(), msg->size));
+            b->skip(msg->size);
+            EXPECT_EQ(SRS_FLV_TAG_HEADER_SIZE + msg->size, b->read_4bytes());
+        }
+    }
+    EXPECT_TRUE(b0.empty());
+    EXPECT_TRUE(b2.empty());
+
+    for (int i = 0; i < count; i++) {
+        srs_freep(msgs[i]);
+    }
+}
+
 VOID TEST(KernelMp3Test, CoverAll)
 {
 	srs_error_t err;
@@ -4988,6 +5414,209 @@ VOID TEST(KernelMP4Test, CoverMP4All)
 	}
 }
 
+VOID TEST(KernelMP4Test, CoverMP4FragmentedCodec)
+{
+	srs_error_t err;
+
+    uint8_t vsh[] = {
+        0x17, 0x00, 0x00, 0x00, 0x00, 0x01, 0x64, 0x00, 0x20, 0xff, 0xe1, 0x00, 0x19, 0x67, 0x64, 0x00, 0x20, 0xac, 0xd9, 0x40, 0xc0, 0x29, 0xb0, 0x11, 0x00, 0x00, 0x03, 0x00, 0x01, 0x00, 0x00, 0x03, 0x00, 0x32, 0x0f, 0x18, 0x31, 0x96, 0x01, 0x00, 0x05, 0x68, 0xeb, 0xec, 0xb2, 0x2c
+    };
+    uint8_t ash[] = {
+        0xaf, 0x00, 0x12, 0x10
+    };
+    uint8_t video[] = {
+        0x17, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x65, 0x88, 0x84, 0x00, 0x33
+    };
+    uint8_t audio[] = {
+        0xaf, 0x01, 0x21, 0x11, 0x45, 0x00, 0x14, 0x50, 0x01, 0x46, 0xf3, 0xf1, 0x0a, 0x5a, 0x5e
+    };
+
+    for (int finalize = 0; finalize < 2; finalize++) {
+        MockSrsFileWriter f;
+
+        // The fMP4 encoder, a fragment for each second.
+        if (true) {
+            SrsMp4FragmentedEncoder enc; SrsFormat fmt;
+            HELPER_EXPECT_SUCCESS(enc.initialize(&f, 1 * SRS_UTIME_SECONDS, finalize));
+            HELPER_EXPECT_SUCCESS(fmt.initialize());
+
+            HELPER_EXPECT_SUCCESS(fmt.on_video(0, (char*)vsh, sizeof(vsh)));
+            HELPER_EXPECT_SUCCESS(enc.write_sample(
+                &fmt, SrsMp4HandlerTypeVIDE, fmt.video->frame_type, fmt.video->avc_packet_type, 0, 0, (uint8_t*)fmt.raw, fmt.nb_raw
+            ));
+
+            HELPER_EXPECT_SUCCESS(fmt.on_audio(0, (char*)ash, sizeof(ash)));
+            enc.acodec = SrsAudioCodecIdAAC;
+            HELPER_EXPECT_SUCCESS(enc.write_sample(
+                &fmt, SrsMp4HandlerTypeSOUN, 0x00, fmt.audio->aac_packet_type, 0, 0, (uint8_t*)fmt.raw, fmt.nb_raw
+            ));
+
+            for (int i = 0; i < 3; i++) {
+                uint32_t dts = i * 1000;
+                HELPER_EXPECT_SUCCESS(fmt.on_video(dts, (char*)video, sizeof(video)));
+                HELPER_EXPECT_SUCCESS(enc.write_sample(
+                    &fmt, SrsMp4HandlerTypeVIDE, fmt.video->frame_type, fmt.video->avc_packet_type, dts, dts, (uint8_t*)fmt.raw, fmt.nb_raw
+                ));
+
+                HELPER_EXPECT_SUCCESS(fmt.on_audio(dts, (char*)audio, sizeof(audio)));
+                HELPER_EXPECT_SUCCESS(enc.write_sample(
+                    &fmt, SrsMp4HandlerTypeSOUN, 0x00, fmt.audio->aac_packet_type, dts, dts, (uint8_t*)fmt.raw, fmt.nb_raw
+                ));
+            }
+
+            // The fragments are written before flush.
+            EXPECT_NE(string::npos, f.str().find("moof"));
+
+            HELPER_EXPECT_SUCCESS(enc.flush());
+        }
+
+        // Without finalize, it's a fMP4 file with mvex and moofs.
+        if (!finalize) {
+            string v = f.str();
+            EXPECT_NE(string::npos, v.find("mvex"));
+            EXPECT_NE(string::npos, v.find("moof"));
+            continue;
+        }
+
+        // Finalized to progressive MP4, the moofs are rewritten to free boxes.
+        EXPECT_EQ(string::npos, f.str().find("moof"));
+
+        MockSrsFileReader fr((const char*)f.data(), f.filesize());
+        SrsMp4Decoder dec; HELPER_EXPECT_SUCCESS(dec.initialize(&fr));
+
+        SrsMp4HandlerType ht; uint16_t ft, ct; uint32_t dts, pts, nb_sample; uint8_t* sample = NULL;
+
+        // Sequence header.
+        HELPER_EXPECT_SUCCESS(dec.read_sample(&ht, &ft, &ct, &dts, &pts, &sample, &nb_sample));
+        EXPECT_EQ(41, (int)nb_sample); EXPECT_EQ(SrsMp4HandlerTypeVIDE, ht); EXPECT_EQ(SrsAudioAacFrameTraitSequenceHeader, ct);
+        srs_freepa(sample);
+
+        HELPER_EXPECT_SUCCESS(dec.read_sample(&ht, &ft, &ct, &dts, &pts, &sample, &nb_sample));
+        EXPECT_EQ(2, (int)nb_sample); EXPECT_EQ(SrsMp4HandlerTypeSOUN, ht); EXPECT_EQ(SrsAudioAacFrameTraitSequenceHeader, ct);
+        srs_freepa(sample);
+
+        // Frames of each fragment.
+        for (int i = 0; i < 3; i++) {
+            HELPER_EXPECT_SUCCESS(dec.read_sample(&ht, &ft, &ct, &dts, &pts, &sample, &nb_sample));
+            EXPECT_EQ(i * 1000, (int)dts); EXPECT_EQ(9, (int)nb_sample); EXPECT_EQ(SrsMp4HandlerTypeVIDE, ht);
+            EXPECT_EQ(0x65, sample[4]);
+            srs_freepa(sample);
+
+            HELPER_EXPECT_SUCCESS(dec.read_sample(&ht, &ft, &ct, &dts, &pts, &sample, &nb_sample));
+            EXPECT_EQ(i * 1000, (int)dts); EXPECT_EQ(13, (int)nb_sample); EXPECT_EQ(SrsMp4HandlerTypeSOUN, ht);
+            EXPECT_EQ(0x21, sample[0]);
+            srs_freepa(sample);
+        }
+    }
+}
+
+VOID TEST(KernelMP4Test, CoverMP4VodIndexSeek)
+{
+	srs_error_t err;
+
+    uint8_t vsh[] = {
+        0x17, 0x00, 0x00, 0x00, 0x00, 0x01, 0x64, 0x00, 0x20, 0xff, 0xe1, 0x00, 0x19, 0x67, 0x64, 0x00, 0x20, 0xac, 0xd9, 0x40, 0xc0, 0x29, 0xb0, 0x11, 0x00, 0x00, 0x03, 0x00, 0x01, 0x00, 0x00, 0x03, 0x00, 0x32, 0x0f, 0x18, 0x31, 0x96, 0x01, 0x00, 0x05, 0x68, 0xeb, 0xec, 0xb2, 0x2c
+    };
+    uint8_t ash[] = {
+        0xaf, 0x00, 0x12, 0x10
+    };
+    uint8_t keyframe[] = {
+        0x17, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x65, 0x88, 0x84, 0x00, 0x33
+    };
+    uint8_t interframe[] = {
+        0x27, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x41, 0x9a, 0x21, 0x6c
+    };
+    uint8_t audio[] = {
+        0xaf, 0x01, 0x21, 0x11, 0x45, 0x00, 0x14, 0x50, 0x01, 0x46, 0xf3, 0xf1, 0x0a, 0x5a, 0x5e
+    };
+
+    // A MP4 file of 2s, keyframe for each second, audio and video for each 100ms.
+    MockSrsFileWriter f;
+    if (true) {
+        SrsMp4Encoder enc; SrsFormat fmt;
+        HELPER_EXPECT_SUCCESS(enc.initialize(&f));
+        HELPER_EXPECT_SUCCESS(fmt.initialize());
+
+        HELPER_EXPECT_SUCCESS(fmt.on_video(0, (char*)vsh, sizeof(vsh)));
+        HELPER_EXPECT_SUCCESS(enc.write_sample(
+            &fmt, SrsMp4HandlerTypeVIDE, fmt.video->frame_type, fmt.video->avc_packet_type, 0, 0, (uint8_t*)fmt.raw, fmt.nb_raw
+        ));
+
+        HELPER_EXPECT_SUCCESS(fmt.on_audio(0, (char*)ash, sizeof(ash)));
+        HELPER_EXPECT_SUCCESS(enc.write_sample(
+            &fmt, SrsMp4HandlerTypeSOUN, 0x00, fmt.audio->aac_packet_type, 0, 0, (uint8_t*)fmt.raw, fmt.nb_raw
+        ));
+
+        for (int i = 0; i < 20; i++) {
+            uint32_t dts = i * 100;
+            if ((i % 10) == 0) {
+                HELPER_EXPECT_SUCCESS(fmt.on_video(dts, (char*)keyframe, sizeof(keyframe)));
+            } else {
+                HELPER_EXPECT_SUCCESS(fmt.on_video(dts, (char*)interframe, sizeof(interframe)));
+            }
+            HELPER_EXPECT_SUCCESS(enc.write_sample(
+                &fmt, SrsMp4HandlerTypeVIDE, fmt.video->frame_type, fmt.video->avc_packet_type, dts, dts, (uint8_t*)fmt.raw, fmt.nb_raw
+            ));
+
+            HELPER_EXPECT_SUCCESS(fmt.on_audio(dts, (char*)audio, sizeof(audio)));
+            HELPER_EXPECT_SUCCESS(enc.write_sample(
+                &fmt, SrsMp4HandlerTypeSOUN, 0x00, fmt.audio->aac_packet_type, dts, dts, (uint8_t*)fmt.raw, fmt.nb_raw
+            ));
+        }
+
+        enc.acodec = SrsAudioCodecIdAAC;
+        HELPER_EXPECT_SUCCESS(enc.flush());
+    }
+
+    SrsMp4VodIndex index;
+    HELPER_ASSERT_SUCCESS(index.initialize(f.data(), f.filesize()));
+    EXPECT_EQ(2000, (int)index.duration());
+
+    // Seek to 1.5s, should start from the keyframe at 1s.
+    string v;
+    if (true) {
+        std::vector<char> header;
+        uint64_t start = 0, end = 0;
+        HELPER_ASSERT_SUCCESS(index.seek(1500, header, &start, &end));
+        EXPECT_TRUE(start < end && end <= (uint64_t)f.filesize());
+
+        v.append(&header[0], header.size());
+        v.append(f.data() + start, end - start);
+    }
+
+    MockSrsFileReader fr(v.data(), (int)v.length());
+    SrsMp4Decoder dec; HELPER_ASSERT_SUCCESS(dec.initialize(&fr));
+
+    SrsMp4HandlerType ht; uint16_t ft, ct; uint32_t dts, pts, nb_sample; uint8_t* sample = NULL;
+
+    // Sequence header.
+    HELPER_EXPECT_SUCCESS(dec.read_sample(&ht, &ft, &ct, &dts, &pts, &sample, &nb_sample));
+    EXPECT_EQ(41, (int)nb_sample); EXPECT_EQ(SrsMp4HandlerTypeVIDE, ht);
+    srs_freepa(sample);
+
+    HELPER_EXPECT_SUCCESS(dec.read_sample(&ht, &ft, &ct, &dts, &pts, &sample, &nb_sample));
+    EXPECT_EQ(2, (int)nb_sample); EXPECT_EQ(SrsMp4HandlerTypeSOUN, ht);
+    srs_freepa(sample);
+
+    // The samples from keyframe, the timestamp starts from 0.
+    for (int i = 0; i < 10; i++) {
+        HELPER_EXPECT_SUCCESS(dec.read_sample(&ht, &ft, &ct, &dts, &pts, &sample, &nb_sample));
+        EXPECT_EQ(SrsMp4HandlerTypeVIDE, ht); EXPECT_EQ(i * 100, (int)dts);
+        if (i == 0) {
+            EXPECT_EQ(SrsVideoAvcFrameTypeKeyFrame, ft); EXPECT_EQ(9, (int)nb_sample); EXPECT_EQ(0x65, sample[4]);
+        } else {
+            EXPECT_EQ(SrsVideoAvcFrameTypeInterFrame, ft); EXPECT_EQ(8, (int)nb_sample); EXPECT_EQ(0x41, sample[4]);
+        }
+        srs_freepa(sample);
+
+        HELPER_EXPECT_SUCCESS(dec.read_sample(&ht, &ft, &ct, &dts, &pts, &sample, &nb_sample));
+        EXPECT_EQ(SrsMp4HandlerTypeSOUN, ht); EXPECT_EQ(i * 100, (int)dts); EXPECT_EQ(13, (int)nb_sample);
+        srs_freepa(sample);
+    }
+
+    HELPER_EXPECT_FAILED(dec.read_sample(&ht, &ft, &ct, &dts, &pts, &sample, &nb_sample));
+}
+
 VOID TEST(KernelMP4Test, CoverMP4CodecSingleFrame)
 {
 	srs_error_t err;
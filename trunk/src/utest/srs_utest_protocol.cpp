@@ -6455,3 +6455,69 @@ VOID TEST(ProtocolKbpsTest, WriteLargeIOVs)
     }
 }
 
+VOID TEST(ProtocolKbpsTest, LatencyHistogram)
+{
+    // The bucket of value, and the lowest value of bucket.
+    if (true) {
+        for (srs_utime_t v = 0; v < 16; v++) {
+            EXPECT_EQ(v, SrsLatencyHistogram::index_of(v));
+            EXPECT_EQ(v, SrsLatencyHistogram::lowest_of((int)v));
+        }
+
+        EXPECT_EQ(16, SrsLatencyHistogram::index_of(16));
+        EXPECT_EQ(17, SrsLatencyHistogram::index_of(17));
+        EXPECT_EQ(32, SrsLatencyHistogram::index_of(32));
+        EXPECT_EQ(32, SrsLatencyHistogram::index_of(33));
+        EXPECT_EQ(33, SrsLatencyHistogram::index_of(34));
+
+        for (int i = 0; i < SRS_LATENCY_BUCKETS; i++) {
+            EXPECT_EQ(i, SrsLatencyHistogram::index_of(SrsLatencyHistogram::lowest_of(i)));
+        }
+
+        // Clamp the large value to the last bucket.
+        EXPECT_EQ(SRS_LATENCY_BUCKETS - 1, SrsLatencyHistogram::index_of(1LL << 40));
+    }
+
+    // The error of bucket is less than 1/16.
+    if (true) {
+        for (srs_utime_t v = 16; v < 100 * SRS_UTIME_SECONDS; v = v * 3 / 2 + 7) {
+            int i = SrsLatencyHistogram::index_of(v);
+            srs_utime_t lo = SrsLatencyHistogram::lowest_of(i);
+            srs_utime_t hi = SrsLatencyHistogram::lowest_of(i + 1);
+            EXPECT_LE(lo, v);
+            EXPECT_GT(hi, v);
+            EXPECT_LE(hi - lo, lo / 16 + 1);
+        }
+    }
+
+    if (true) {
+        SrsLatencyHistogram h;
+        EXPECT_EQ(0, h.count());
+        EXPECT_EQ(0, h.percentile(99));
+
+        h.record(-1);
+        EXPECT_EQ(0, h.count());
+
+        for (int i = 1; i <= 100; i++) {
+            h.record(i * SRS_UTIME_MILLISECONDS);
+        }
+        EXPECT_EQ(100, h.count());
+        EXPECT_EQ(1 * SRS_UTIME_MILLISECONDS, h.min());
+        EXPECT_EQ(100 * SRS_UTIME_MILLISECONDS, h.max());
+        EXPECT_EQ(50500, h.mean());
+
+        srs_utime_t p50 = h.percentile(50);
+        EXPECT_GE(p50, 50 * SRS_UTIME_MILLISECONDS);
+        EXPECT_LE(p50, 50 * SRS_UTIME_MILLISECONDS * 17 / 16);
+
+        srs_utime_t p99 = h.percentile(99);
+        EXPECT_GE(p99, 99 * SRS_UTIME_MILLISECONDS);
+        EXPECT_LE(p99, 100 * SRS_UTIME_MILLISECONDS);
+        EXPECT_EQ(100 * SRS_UTIME_MILLISECONDS, h.percentile(100));
+
+        h.reset();
+        EXPECT_EQ(0, h.count());
+        EXPECT_EQ(0, h.max());
+    }
+}
+
@@ -12,8 +12,16 @@
 #include <srs_kernel_rtc_rtp.hpp>
 #include <srs_app_rtc_source.hpp>
 #include <srs_app_rtc_conn.hpp>
+#include <srs_app_rtc_bwe.hpp>
+#include <srs_app_rtc_fec.hpp>
+#include <srs_app_rtc_sdp.hpp>
 #include <srs_kernel_codec.hpp>
 #include <srs_app_conn.hpp>
+#include <srs_protocol_format.hpp>
+#include <srs_protocol_rtc_stun.hpp>
+#ifdef SRS_FFMPEG_FIT
+#include <srs_app_rtc_codec.hpp>
+#endif
 
 #include <srs_utest_service.hpp>
 
@@ -1199,6 +1207,177 @@ VOID TEST(KernelRTCTest, SrsRtcpNack)
     EXPECT_EQ(actual_lost_sn.size(), req_lost_sns.size());
 }
 
+VOID TEST(KernelRTCTest, SrsRtcpTWCC)
+{
+    srs_error_t err;
+
+    // Packet 101 and 104 are lost, 103 is received with large delta.
+    SrsRtcpTWCC encoder(0x0A);
+    encoder.set_media_ssrc(0x0B);
+    encoder.set_feedback_count(3);
+    HELPER_EXPECT_SUCCESS(encoder.recv_packet(100, 64000 * 1000));
+    HELPER_EXPECT_SUCCESS(encoder.recv_packet(102, 64000 * 1000 + 5 * 1000));
+    HELPER_EXPECT_SUCCESS(encoder.recv_packet(103, 64000 * 1000 + 200 * 1000));
+    HELPER_EXPECT_SUCCESS(encoder.recv_packet(105, 64000 * 1000 + 210 * 1000));
+
+    char buf[kRtcpPacketSize];
+    SrsBuffer stream(buf, sizeof(buf));
+    HELPER_EXPECT_SUCCESS(encoder.encode(&stream));
+
+    SrsRtcpTWCC decoder;
+    SrsBuffer b(buf, stream.pos());
+    HELPER_EXPECT_SUCCESS(decoder.decode(&b));
+    EXPECT_EQ(0x0B, (int)decoder.get_media_ssrc());
+    EXPECT_EQ(100, decoder.get_base_sn());
+    EXPECT_EQ(3, decoder.get_feedback_count());
+
+    const vector<SrsRtcpTWCCStatus>& statuses = decoder.get_statuses();
+    ASSERT_EQ(6, (int)statuses.size());
+    EXPECT_TRUE(statuses[0].received);
+    EXPECT_FALSE(statuses[1].received);
+    EXPECT_TRUE(statuses[2].received);
+    EXPECT_TRUE(statuses[3].received);
+    EXPECT_FALSE(statuses[4].received);
+    EXPECT_TRUE(statuses[5].received);
+    EXPECT_EQ(105, statuses[5].sn);
+
+    // The receive time is in 250us, relative to the first packet.
+    EXPECT_EQ(5 * 1000, statuses[2].recv_time - statuses[0].recv_time);
+    EXPECT_EQ(200 * 1000, statuses[3].recv_time - statuses[0].recv_time);
+    EXPECT_EQ(210 * 1000, statuses[5].recv_time - statuses[0].recv_time);
+
+    // The malformed feedback is ignored, without statuses.
+    if (true) {
+        uint8_t bad[] = {0x8f, 0xcd, 0x00, 0x04, 0, 0, 0, 0x0a, 0, 0, 0, 0x0b, 0x00, 0x64, 0x00, 0x20, 0, 0, 0, 0};
+        SrsBuffer b((char*)bad, sizeof(bad));
+        SrsRtcpTWCC twcc;
+        HELPER_EXPECT_SUCCESS(twcc.decode(&b));
+        EXPECT_TRUE(twcc.get_statuses().empty());
+    }
+}
+
+VOID TEST(KernelRTCTest, SendSideBwe)
+{
+    // Increase when no loss and no overuse.
+    if (true) {
+        SrsRtcSendSideBwe bwe;
+        bwe.set_bitrate_range(SRS_RTC_BWE_MIN_BITRATE, 10 * 1000 * 1000);
+        EXPECT_EQ(SRS_RTC_BWE_START_BITRATE, bwe.bitrate());
+
+        srs_utime_t now = 1000 * SRS_UTIME_SECONDS;
+        for (int i = 0; i < 10; i++) {
+            vector<SrsRtcpTWCCStatus> statuses;
+            for (int j = 0; j < 100; j++) {
+                uint16_t sn = bwe.next_sn();
+                srs_utime_t t = now + j * SRS_UTIME_MILLISECONDS;
+                bwe.on_sent(sn, 1200, t);
+
+                SrsRtcpTWCCStatus status;
+                status.sn = sn;
+                status.received = true;
+                status.recv_time = t + 20 * SRS_UTIME_MILLISECONDS;
+                statuses.push_back(status);
+            }
+            now += 100 * SRS_UTIME_MILLISECONDS;
+            bwe.on_feedback(statuses, now);
+        }
+
+        EXPECT_EQ(SrsRtcBweUsageNormal, bwe.usage());
+        EXPECT_EQ(0, bwe.loss());
+        EXPECT_GT(bwe.bitrate(), SRS_RTC_BWE_START_BITRATE);
+        EXPECT_NEAR(9600 * 1000, bwe.acked_bitrate(), 100 * 1000);
+    }
+
+    // Decrease when loss.
+    if (true) {
+        SrsRtcSendSideBwe bwe;
+        srs_utime_t now = 1000 * SRS_UTIME_SECONDS;
+        vector<SrsRtcpTWCCStatus> statuses;
+        for (int j = 0; j < 100; j++) {
+            uint16_t sn = bwe.next_sn();
+            bwe.on_sent(sn, 1200, now + j * SRS_UTIME_MILLISECONDS);
+
+            SrsRtcpTWCCStatus status;
+            status.sn = sn;
+            status.received = (j % 4) != 0;
+            status.recv_time = now + j * SRS_UTIME_MILLISECONDS;
+            statuses.push_back(status);
+        }
+        bwe.on_feedback(statuses, now + 100 * SRS_UTIME_MILLISECONDS);
+
+        EXPECT_EQ(25, bwe.loss());
+        EXPECT_LT(bwe.bitrate(), SRS_RTC_BWE_START_BITRATE);
+    }
+
+    // Decrease when the queuing delay keeps increasing.
+    if (true) {
+        SrsRtcSendSideBwe bwe;
+        srs_utime_t now = 1000 * SRS_UTIME_SECONDS, recv = now;
+        for (int i = 0; i < 3; i++) {
+            vector<SrsRtcpTWCCStatus> statuses;
+            for (int j = 0; j < 50; j++) {
+                uint16_t sn = bwe.next_sn();
+                bwe.on_sent(sn, 1200, now + j * SRS_UTIME_MILLISECONDS);
+
+                // The receive interval is larger than send interval, the link is congested.
+                SrsRtcpTWCCStatus status;
+                status.sn = sn;
+                status.received = true;
+                status.recv_time = recv + j * 2 * SRS_UTIME_MILLISECONDS;
+                statuses.push_back(status);
+            }
+            now += 50 * SRS_UTIME_MILLISECONDS;
+            recv += 100 * SRS_UTIME_MILLISECONDS;
+            bwe.on_feedback(statuses, now);
+        }
+
+        EXPECT_EQ(SrsRtcBweUsageOveruse, bwe.usage());
+        EXPECT_LT(bwe.bitrate(), bwe.acked_bitrate());
+    }
+
+    // Ignore the unknown packets.
+    if (true) {
+        SrsRtcSendSideBwe bwe;
+        vector<SrsRtcpTWCCStatus> statuses;
+        SrsRtcpTWCCStatus status;
+        status.sn = 100;
+        status.received = false;
+        status.recv_time = 0;
+        statuses.push_back(status);
+        bwe.on_feedback(statuses, 1000 * SRS_UTIME_SECONDS);
+
+        EXPECT_EQ(0, bwe.loss());
+        EXPECT_EQ(SRS_RTC_BWE_START_BITRATE, bwe.bitrate());
+    }
+}
+
+VOID TEST(KernelRTCTest, Pacer)
+{
+    SrsRtcPacer pacer;
+
+    // Never wait if disabled.
+    EXPECT_EQ(0, pacer.consume(100000, 0));
+
+    // 8Mbps, about 1000 bytes per ms, burst is 10ms.
+    pacer.set_rate(8 * 1000 * 1000);
+    srs_utime_t now = 1000 * SRS_UTIME_SECONDS;
+    EXPECT_EQ(0, pacer.consume(1000, now));
+
+    now += 20 * SRS_UTIME_MILLISECONDS;
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(0, pacer.consume(1000, now));
+    }
+    EXPECT_EQ(1 * SRS_UTIME_MILLISECONDS, pacer.consume(1000, now));
+    EXPECT_EQ(2 * SRS_UTIME_MILLISECONDS, pacer.consume(1000, now));
+
+    // Send directly if wait too long, and clamp the debt to the max delay.
+    EXPECT_EQ(0, pacer.consume(1000 * 1000, now));
+    EXPECT_EQ(0, pacer.consume(1000, now));
+
+    now += 150 * SRS_UTIME_MILLISECONDS;
+    EXPECT_EQ(51 * SRS_UTIME_MILLISECONDS, pacer.consume(1000, now));
+}
+
 VOID TEST(KernelRTCTest, SyncTimestampBySenderReportDuplicated)
 {
     SrsRtcConnection s(NULL, SrsContextId()); 
@@ -1274,3 +1453,1162 @@ VOID TEST(KernelRTCTest, SyncTimestampBySenderReportDuplicated)
     }
 }
 
+
+VOID TEST(KernelRTCTest, SimulcastSdpRid)
+{
+    srs_error_t err;
+
+    if (true) {
+        SrsMediaDesc desc("video");
+        HELPER_EXPECT_SUCCESS(desc.parse_line("a=rid:h send"));
+        HELPER_EXPECT_SUCCESS(desc.parse_line("a=rid:m send"));
+        HELPER_EXPECT_SUCCESS(desc.parse_line("a=rid:l send"));
+        HELPER_EXPECT_SUCCESS(desc.parse_line("a=simulcast:send l;~m;h"));
+        ASSERT_EQ(3, (int)desc.rids_.size());
+        EXPECT_STREQ("l", desc.rids_.at(0).c_str());
+        EXPECT_STREQ("m", desc.rids_.at(1).c_str());
+        EXPECT_STREQ("h", desc.rids_.at(2).c_str());
+    }
+
+    if (true) {
+        // The alternative is ignored, and the rid not in simulcast is appended.
+        SrsMediaDesc desc("video");
+        HELPER_EXPECT_SUCCESS(desc.parse_line("a=rid:a send"));
+        HELPER_EXPECT_SUCCESS(desc.parse_line("a=rid:b send"));
+        HELPER_EXPECT_SUCCESS(desc.parse_line("a=rid:c send"));
+        HELPER_EXPECT_SUCCESS(desc.parse_line("a=simulcast:send b,c"));
+        ASSERT_EQ(3, (int)desc.rids_.size());
+        EXPECT_STREQ("b", desc.rids_.at(0).c_str());
+        EXPECT_STREQ("a", desc.rids_.at(1).c_str());
+        EXPECT_STREQ("c", desc.rids_.at(2).c_str());
+    }
+
+    if (true) {
+        SrsMediaDesc desc("video");
+        HELPER_EXPECT_FAILED(desc.parse_line("a=rid:h sendrecv"));
+        HELPER_EXPECT_FAILED(desc.parse_line("a=simulcast:sendrecv h"));
+    }
+}
+
+VOID TEST(KernelRTCTest, SimulcastFastParseRid)
+{
+    srs_error_t err;
+
+    // RTP header with one-byte extension, the id 1 with 2 bytes, the rid id 3 with "hi".
+    uint8_t buf[] = {
+        0x90, 0x66, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x64,
+        0xBE, 0xDE, 0x00, 0x02, 0x11, 0xAA, 0xBB, 0x31, 0x68, 0x69, 0x00, 0x00,
+    };
+
+    if (true) {
+        std::string rid;
+        HELPER_EXPECT_SUCCESS(srs_rtp_fast_parse_rid((char*)buf, sizeof(buf), 3, rid));
+        EXPECT_STREQ("hi", rid.c_str());
+    }
+
+    if (true) {
+        std::string rid;
+        HELPER_EXPECT_FAILED(srs_rtp_fast_parse_rid((char*)buf, sizeof(buf), 5, rid));
+        HELPER_EXPECT_FAILED(srs_rtp_fast_parse_rid((char*)buf, 18, 3, rid));
+    }
+
+    if (true) {
+        std::string rid;
+        buf[0] = 0x80;
+        HELPER_EXPECT_FAILED(srs_rtp_fast_parse_rid((char*)buf, sizeof(buf), 3, rid));
+    }
+}
+
+SrsRtcSimulcastLayer mock_simulcast_layer(uint32_t ssrc, int kbps, srs_utime_t now)
+{
+    SrsRtcSimulcastLayer layer;
+    layer.ssrc = ssrc;
+    layer.kbps = kbps;
+    layer.last_packet = now;
+    layer.bytes = 0;
+    layer.starttime = now;
+    return layer;
+}
+
+SrsRtpPacket* mock_simulcast_packet(uint32_t ssrc, uint16_t seq, uint32_t ts, bool keyframe)
+{
+    SrsRtpPacket* pkt = new SrsRtpPacket();
+    pkt->header.set_ssrc(ssrc);
+    pkt->header.set_sequence(seq);
+    pkt->header.set_timestamp(ts);
+    pkt->frame_type = SrsFrameTypeVideo;
+    pkt->nalu_type = keyframe ? SrsAvcNaluTypeIDR : SrsAvcNaluTypeNonIDR;
+    return pkt;
+}
+
+VOID TEST(KernelRTCTest, SimulcastLayerSelector)
+{
+    srs_utime_t now = 100 * SRS_UTIME_SECONDS;
+
+    vector<SrsRtcSimulcastLayer> layers;
+    layers.push_back(mock_simulcast_layer(300, 2000, now));
+    layers.push_back(mock_simulcast_layer(100, 200, now));
+    layers.push_back(mock_simulcast_layer(200, 600, now));
+
+    if (true) {
+        // Choose the highest layer if no estimation.
+        SrsRtcLayerSelector s;
+        EXPECT_EQ(300, (int)s.select(layers, 0, false, now));
+        EXPECT_EQ(300, (int)s.target());
+        EXPECT_EQ(0, (int)s.current());
+    }
+
+    if (true) {
+        // Choose the highest layer under the estimation, or the lowest one.
+        SrsRtcLayerSelector s;
+        EXPECT_EQ(200, (int)s.select(layers, 1000 * 1000, false, now));
+
+        SrsRtcLayerSelector s2;
+        EXPECT_EQ(100, (int)s2.select(layers, 50 * 1000, false, now));
+    }
+
+    if (true) {
+        // Ignore the layer without packets for a while.
+        vector<SrsRtcSimulcastLayer> v = layers;
+        v.at(0).last_packet = now - 10 * SRS_UTIME_SECONDS;
+
+        SrsRtcLayerSelector s;
+        EXPECT_EQ(200, (int)s.select(v, 0, false, now));
+    }
+
+    if (true) {
+        SrsRtcLayerSelector s;
+        EXPECT_EQ(200, (int)s.select(layers, 1000 * 1000, false, now));
+
+        // Drop all packets before the keyframe of target.
+        SrsRtpPacket* pkt = mock_simulcast_packet(200, 10, 9000, false);
+        SrsAutoFree(SrsRtpPacket, pkt);
+        EXPECT_FALSE(s.on_rtp(pkt, now));
+
+        SrsRtpPacket* pkt2 = mock_simulcast_packet(100, 20, 1000, true);
+        SrsAutoFree(SrsRtpPacket, pkt2);
+        EXPECT_FALSE(s.on_rtp(pkt2, now));
+
+        // Switch to target at keyframe.
+        SrsRtpPacket* pkt3 = mock_simulcast_packet(200, 11, 9000, true);
+        SrsAutoFree(SrsRtpPacket, pkt3);
+        EXPECT_TRUE(s.on_rtp(pkt3, now));
+        EXPECT_EQ(200, (int)s.current());
+        EXPECT_EQ(11, pkt3->header.get_sequence());
+        EXPECT_EQ(9000, (int)pkt3->header.get_timestamp());
+
+        // Never select again in a second.
+        EXPECT_EQ(0, (int)s.select(layers, 100 * 1000, true, now + 100 * SRS_UTIME_MILLISECONDS));
+
+        // Switch down when congested, keep forwarding current layer until keyframe of target.
+        now += 2 * SRS_UTIME_SECONDS;
+        EXPECT_EQ(100, (int)s.select(layers, 100 * 1000, true, now));
+
+        SrsRtpPacket* pkt4 = mock_simulcast_packet(200, 12, 9000 + 180000, false);
+        SrsAutoFree(SrsRtpPacket, pkt4);
+        EXPECT_TRUE(s.on_rtp(pkt4, now));
+
+        // The sequence and timestamp is continuous after switched.
+        SrsRtpPacket* pkt5 = mock_simulcast_packet(100, 500, 50000, true);
+        SrsAutoFree(SrsRtpPacket, pkt5);
+        EXPECT_TRUE(s.on_rtp(pkt5, now + 40 * SRS_UTIME_MILLISECONDS));
+        EXPECT_EQ(100, (int)s.current());
+        EXPECT_EQ(13, pkt5->header.get_sequence());
+        EXPECT_EQ(9000 + 180000 + 3600, (int)pkt5->header.get_timestamp());
+
+        SrsRtpPacket* pkt6 = mock_simulcast_packet(100, 501, 53600, false);
+        SrsAutoFree(SrsRtpPacket, pkt6);
+        EXPECT_TRUE(s.on_rtp(pkt6, now));
+        EXPECT_EQ(14, pkt6->header.get_sequence());
+        EXPECT_EQ(9000 + 180000 + 7200, (int)pkt6->header.get_timestamp());
+
+        SrsRtpPacket* pkt7 = mock_simulcast_packet(200, 13, 9000 + 183600, true);
+        SrsAutoFree(SrsRtpPacket, pkt7);
+        EXPECT_FALSE(s.on_rtp(pkt7, now));
+    }
+
+    if (true) {
+        // Never switch down if not congested, but probe the higher layer after a while.
+        for (int i = 0; i < (int)layers.size(); i++) {
+            layers.at(i).last_packet = now + 2 * SRS_UTIME_SECONDS;
+        }
+
+        SrsRtcLayerSelector s;
+        EXPECT_EQ(100, (int)s.select(layers, 100 * 1000, false, now));
+        SrsRtpPacket* pkt = mock_simulcast_packet(100, 1, 0, true);
+        SrsAutoFree(SrsRtpPacket, pkt);
+        EXPECT_TRUE(s.on_rtp(pkt, now));
+
+        EXPECT_EQ(0, (int)s.select(layers, 10 * 1000, false, now + 2 * SRS_UTIME_SECONDS));
+
+        now += 10 * SRS_UTIME_SECONDS;
+        for (int i = 0; i < (int)layers.size(); i++) {
+            layers.at(i).last_packet = now;
+        }
+        EXPECT_EQ(200, (int)s.select(layers, 100 * 1000, false, now));
+    }
+}
+
+VOID TEST(KernelRTCTest, SimulcastSourceLayers)
+{
+    SrsRtcSource source;
+
+    SrsRtcSourceDescription* desc = new SrsRtcSourceDescription();
+    SrsAutoFree(SrsRtcSourceDescription, desc);
+
+    const char* rids[] = {"l", "m", "h"};
+    for (int i = 0; i < 3; i++) {
+        SrsRtcTrackDescription* track = new SrsRtcTrackDescription();
+        track->type_ = "video";
+        track->rid_ = rids[i];
+        desc->video_track_descs_.push_back(track);
+    }
+    source.set_stream_desc(desc);
+
+    ASSERT_EQ(3, (int)source.layers().size());
+    EXPECT_STREQ("m", source.layers().at(1).rid.c_str());
+    EXPECT_EQ(0, (int)source.layers().at(1).ssrc);
+
+    source.bind_layer("m", 200);
+    EXPECT_EQ(200, (int)source.layers().at(1).ssrc);
+    EXPECT_EQ(200, (int)source.stream_desc_->video_track_descs_.at(1)->ssrc_);
+
+    // Ignore the unknown rid.
+    source.bind_layer("x", 300);
+    EXPECT_EQ(0, (int)source.layers().at(2).ssrc);
+
+    if (true) {
+        SrsRtcTrackDescription track;
+        track.type_ = "video";
+        track.rid_ = "h";
+        SrsRtcVideoRecvTrack recv(NULL, &track);
+        EXPECT_FALSE(recv.bind_rid("m", 300));
+        EXPECT_TRUE(recv.bind_rid("h", 300));
+        EXPECT_EQ(300, (int)recv.track_desc_->ssrc_);
+        EXPECT_FALSE(recv.bind_rid("h", 400));
+    }
+}
+
+VOID TEST(KernelRTCTest, NackForReceiverQueue)
+{
+    if (true) {
+        SrsRtpRingBuffer rtp(1000);
+        SrsRtpNackForReceiver nack(&rtp, 1000 * 2 / 3);
+        EXPECT_EQ(1024, nack.capacity_);
+
+        nack.insert(100, 110);
+        EXPECT_EQ(10, (int)nack.size());
+        EXPECT_TRUE(nack.find(105) != NULL);
+        EXPECT_TRUE(nack.find(105 + 1024) == NULL);
+        EXPECT_TRUE(nack.find(110) == NULL);
+
+        nack.remove(105);
+        nack.remove(105);
+        EXPECT_EQ(9, (int)nack.size());
+        EXPECT_TRUE(nack.find(105) == NULL);
+
+        // Insert the lost packet again, should reset it.
+        nack.insert(109, 110);
+        EXPECT_EQ(9, (int)nack.size());
+    }
+
+    if (true) {
+        // Drop the oldest lost packets out of window.
+        SrsRtpRingBuffer rtp(100);
+        SrsRtpNackForReceiver nack(&rtp, 100 * 2 / 3);
+        EXPECT_EQ(128, nack.capacity_);
+
+        nack.insert(10, 12);
+        nack.insert(100, 101);
+        EXPECT_EQ(3, (int)nack.size());
+
+        nack.insert(138, 139);
+        EXPECT_EQ(3, (int)nack.size());
+        EXPECT_TRUE(nack.find(10) == NULL);
+        EXPECT_TRUE(nack.find(11) != NULL);
+
+        // Ignore the too old packet.
+        nack.insert(5, 6);
+        EXPECT_EQ(3, (int)nack.size());
+        EXPECT_TRUE(nack.find(5) == NULL);
+    }
+
+    if (true) {
+        // The queue is full, clear it.
+        SrsRtpRingBuffer rtp(100);
+        SrsRtpNackForReceiver nack(&rtp, 100 * 2 / 3);
+        nack.insert(0, 10000);
+        EXPECT_EQ(128, (int)nack.size());
+        nack.check_queue_size();
+        EXPECT_EQ(0, (int)nack.size());
+        EXPECT_TRUE(nack.find(9999) == NULL);
+    }
+}
+
+VOID TEST(KernelRTCTest, NackForReceiverSeqs)
+{
+    srs_error_t err;
+
+    if (true) {
+        SrsRtpRingBuffer rtp(1000);
+        SrsRtpNackForReceiver nack(&rtp, 1000 * 2 / 3);
+        nack.opts_.first_nack_interval = 0;
+        nack.opts_.nack_check_interval = 0;
+
+        nack.insert(100, 110);
+        nack.remove(105);
+        nack.insert(200, 201);
+
+        SrsRtcpNack seqs(1);
+        uint32_t timeout_nacks = 0;
+        nack.get_nack_seqs(seqs, timeout_nacks);
+        EXPECT_EQ(0, (int)timeout_nacks);
+        EXPECT_EQ(2, (int)seqs.chunks_.size());
+        EXPECT_EQ(100, seqs.chunks_.at(0).pid);
+        EXPECT_EQ(0x1ef, seqs.chunks_.at(0).blp);
+        EXPECT_EQ(200, seqs.chunks_.at(1).pid);
+        EXPECT_EQ(0, seqs.chunks_.at(1).blp);
+        EXPECT_EQ(10, (int)seqs.get_lost_sns().size());
+
+        // Never request again in the interval.
+        SrsRtcpNack seqs2(1);
+        nack.get_nack_seqs(seqs2, timeout_nacks);
+        EXPECT_TRUE(seqs2.empty());
+
+        // Drop the lost packets which are too old.
+        for (int i = 100; i <= 110; i++) {
+            SrsRtpNackInfo* info = nack.find(i);
+            if (info) {
+                info->generate_time_ -= 10 * SRS_UTIME_SECONDS;
+            }
+        }
+        nack.get_nack_seqs(seqs2, timeout_nacks);
+        EXPECT_EQ(9, (int)timeout_nacks);
+        EXPECT_EQ(1, (int)nack.size());
+        EXPECT_EQ(200, nack.head_);
+    }
+
+    if (true) {
+        // The sequence flips back, encode and decode it.
+        SrsRtpRingBuffer rtp(1000);
+        SrsRtpNackForReceiver nack(&rtp, 1000 * 2 / 3);
+        nack.opts_.first_nack_interval = 0;
+        nack.opts_.nack_check_interval = 0;
+
+        nack.insert(65530, 20);
+
+        SrsRtcpNack seqs(1);
+        seqs.set_media_ssrc(100);
+        uint32_t timeout_nacks = 0;
+        nack.get_nack_seqs(seqs, timeout_nacks);
+        ASSERT_EQ(2, (int)seqs.chunks_.size());
+        EXPECT_EQ(65530, seqs.chunks_.at(0).pid);
+        EXPECT_EQ(0xffff, seqs.chunks_.at(0).blp);
+        EXPECT_EQ(11, seqs.chunks_.at(1).pid);
+        EXPECT_EQ(0xff, seqs.chunks_.at(1).blp);
+
+        char buf[kRtcpPacketSize];
+        SrsBuffer b(buf, sizeof(buf));
+        HELPER_EXPECT_SUCCESS(seqs.encode(&b));
+
+        SrsRtcpNack decoded;
+        SrsBuffer b2(buf, b.pos());
+        HELPER_EXPECT_SUCCESS(decoded.decode(&b2));
+        EXPECT_EQ(100, (int)decoded.get_media_ssrc());
+
+        vector<uint16_t> sns = decoded.get_lost_sns();
+        ASSERT_EQ(26, (int)sns.size());
+        EXPECT_EQ(65530, sns.at(0));
+        EXPECT_EQ(0, sns.at(6));
+        EXPECT_EQ(19, sns.at(25));
+    }
+}
+
+SrsRtpPacket* mock_history_packet(uint32_t ssrc, uint16_t seq, uint32_t ts, const char* data)
+{
+    SrsRtpPacket* pkt = new SrsRtpPacket();
+    pkt->header.set_ssrc(ssrc);
+    pkt->header.set_sequence(seq);
+    pkt->header.set_timestamp(ts);
+    pkt->header.set_payload_type(96);
+    pkt->frame_type = SrsFrameTypeVideo;
+
+    int size = (int)strlen(data);
+    SrsRtpRawPayload* raw = new SrsRtpRawPayload();
+    raw->payload = pkt->wrap((char*)data, size);
+    raw->nn_payload = size;
+    pkt->set_payload(raw, SrsRtspPacketPayloadTypeRaw);
+    return pkt;
+}
+
+VOID TEST(KernelRTCTest, NACKSharedHistory)
+{
+    SrsRtpPacketHistory history;
+
+    if (true) {
+        SrsRtpPacket* pkt = mock_history_packet(100, 10, 9000, "hello");
+        SrsAutoFree(SrsRtpPacket, pkt);
+        history.put(pkt);
+
+        SrsRtpPacket* pkt2 = mock_history_packet(200, 20, 18000, "world");
+        SrsAutoFree(SrsRtpPacket, pkt2);
+        history.put(pkt2);
+    }
+
+    EXPECT_TRUE(history.fetch(100, 10) != NULL);
+    EXPECT_TRUE(history.fetch(200, 20) != NULL);
+    EXPECT_TRUE(history.fetch(100, 20) == NULL);
+    EXPECT_TRUE(history.fetch(300, 10) == NULL);
+    // The sequence must match exactly.
+    EXPECT_TRUE(history.fetch(100, 1010) == NULL);
+
+    SrsRtcConnection s(NULL, SrsContextId());
+    SrsRtcTrackDescription ds;
+    ds.type_ = "video";
+    ds.ssrc_ = 1000;
+
+    if (true) {
+        SrsRtcVideoSendTrack track(&s, &ds);
+        track.set_history(&history);
+
+        // The player rewrites the sequence and timestamp, for example, simulcast.
+        SrsRtpPacket* pkt = mock_history_packet(100, 10, 9000, "hello");
+        pkt->header.set_ssrc(1000);
+        pkt->header.set_sequence(500);
+        pkt->header.set_timestamp(3600);
+
+        // The packet is never kept by track.
+        SrsRtpPacket* p = pkt;
+        EXPECT_TRUE(track.on_nack(&p, 100, 10) == srs_success);
+        EXPECT_TRUE(p == pkt);
+        srs_freep(pkt);
+
+        EXPECT_TRUE(track.fetch_history_packet(10) == NULL);
+        EXPECT_TRUE(track.fetch_history_packet(500 + 1024) == NULL);
+
+        SrsRtpPacket* cp = track.fetch_history_packet(500);
+        SrsAutoFree(SrsRtpPacket, cp);
+        ASSERT_TRUE(cp != NULL);
+        EXPECT_EQ(1000, (int)cp->header.get_ssrc());
+        EXPECT_EQ(500, cp->header.get_sequence());
+        EXPECT_EQ(3600, (int)cp->header.get_timestamp());
+        EXPECT_EQ(5, (int)cp->payload()->nb_bytes());
+    }
+
+    if (true) {
+        srs_error_t err;
+
+        ds.rtx_ = new SrsRtxPayloadDes(97, 96);
+        ds.rtx_ssrc_ = 2000;
+        SrsRtcVideoSendTrack track(&s, &ds);
+
+        SrsRtpPacket* pkt = mock_history_packet(1000, 500, 3600, "hello");
+        SrsAutoFree(SrsRtpPacket, pkt);
+
+        SrsRtpPacket* rtx = NULL;
+        HELPER_EXPECT_SUCCESS(track.build_rtx(pkt, &rtx));
+        SrsAutoFree(SrsRtpPacket, rtx);
+        EXPECT_EQ(2000, (int)rtx->header.get_ssrc());
+        EXPECT_EQ(0, rtx->header.get_sequence());
+        EXPECT_EQ(97, rtx->header.get_payload_type());
+        EXPECT_EQ(3600, (int)rtx->header.get_timestamp());
+
+        // The payload is the original sequence and payload.
+        SrsRtpRawPayload* raw = dynamic_cast<SrsRtpRawPayload*>(rtx->payload());
+        ASSERT_TRUE(raw != NULL);
+        ASSERT_EQ(7, raw->nn_payload);
+        EXPECT_EQ(0x01, (uint8_t)raw->payload[0]);
+        EXPECT_EQ(0xf4, (uint8_t)raw->payload[1]);
+        EXPECT_EQ(0, memcmp(raw->payload + 2, "hello", 5));
+
+        SrsRtpPacket* rtx2 = NULL;
+        HELPER_EXPECT_SUCCESS(track.build_rtx(pkt, &rtx2));
+        SrsAutoFree(SrsRtpPacket, rtx2);
+        EXPECT_EQ(1, rtx2->header.get_sequence());
+
+        // The RTX payload type.
+        SrsMediaPayloadType pt = ((SrsRtxPayloadDes*)ds.rtx_)->generate_media_payload_type();
+        EXPECT_STREQ("apt=96", pt.format_specific_param_.c_str());
+    }
+}
+
+VOID TEST(KernelRTCTest, FecXor)
+{
+    uint8_t a[19], b[19], c[19];
+    for (int i = 0; i < 19; i++) {
+        a[i] = c[i] = (uint8_t)i;
+        b[i] = (uint8_t)(0xf0 + i);
+    }
+
+    srs_rtp_fec_xor(a, b, 19);
+    for (int i = 0; i < 19; i++) {
+        EXPECT_EQ((uint8_t)(i ^ (0xf0 + i)), a[i]);
+    }
+
+    srs_rtp_fec_xor(a, b, 19);
+    EXPECT_EQ(0, memcmp(a, c, 19));
+}
+
+VOID TEST(KernelRTCTest, FecRedPayload)
+{
+    srs_error_t err;
+
+    SrsRtpPacket* pkt = mock_history_packet(100, 10, 9000, "hello");
+    SrsAutoFree(SrsRtpPacket, pkt);
+
+    SrsRtpRedPayload* red = new SrsRtpRedPayload();
+    red->block_pt = pkt->header.get_payload_type();
+    red->block = pkt->payload();
+    pkt->set_payload(red, SrsRtspPacketPayloadTypeRED);
+    pkt->header.set_payload_type(100);
+    EXPECT_EQ(12 + 1 + 5, (int)pkt->nb_bytes());
+
+    char buf[1500];
+    SrsBuffer b(buf, sizeof(buf));
+    HELPER_EXPECT_SUCCESS(pkt->encode(&b));
+    EXPECT_EQ(18, b.pos());
+    EXPECT_EQ(100, buf[1] & 0x7f);
+    EXPECT_EQ(96, buf[12]);
+    EXPECT_EQ(0, memcmp(buf + 13, "hello", 5));
+
+    SrsRtpRedPayload* cp = dynamic_cast<SrsRtpRedPayload*>(red->copy());
+    SrsAutoFree(SrsRtpRedPayload, cp);
+    EXPECT_EQ(96, cp->block_pt);
+    EXPECT_EQ(6, (int)cp->nb_bytes());
+
+    SrsRtpRedPayload decoded;
+    SrsBuffer b2(buf + 12, 6);
+    HELPER_EXPECT_SUCCESS(decoded.decode(&b2));
+    EXPECT_EQ(96, decoded.block_pt);
+    EXPECT_EQ(5, (int)decoded.block->nb_bytes());
+}
+
+VOID TEST(KernelRTCTest, FecAdaptiveGroup)
+{
+    SrsRtpUlpfecEncoder enc;
+    EXPECT_FALSE(enc.enabled());
+
+    // Smoothed loss is 0.05, about 10 packets to lose one, so 10 packets in group.
+    enc.on_loss(0.1);
+    EXPECT_TRUE(enc.enabled());
+    EXPECT_EQ(10, enc.group());
+
+    // Smoothed loss is 0.075.
+    enc.on_loss(0.1);
+    EXPECT_EQ(6, enc.group());
+
+    // At least 2 packets.
+    enc.on_loss(1.0);
+    EXPECT_EQ(2, enc.group());
+
+    // Disable FEC when loss is down.
+    for (int i = 0; i < 10; i++) {
+        enc.on_loss(0);
+    }
+    EXPECT_FALSE(enc.enabled());
+    EXPECT_FALSE(enc.is_ready(true));
+
+    // At most 16 packets.
+    enc.on_loss(0.011);
+    EXPECT_EQ(16, enc.group());
+}
+
+int mock_fec_marshal(uint16_t seq, uint32_t ts, bool marker, const char* data, char* buf)
+{
+    SrsRtpPacket* pkt = mock_history_packet(100, seq, ts, data);
+    SrsAutoFree(SrsRtpPacket, pkt);
+    pkt->header.set_marker(marker);
+
+    SrsBuffer b(buf, 1500);
+    srs_error_t err = pkt->encode(&b);
+    srs_freep(err);
+    return b.pos();
+}
+
+VOID TEST(KernelRTCTest, FecUlpfecRecover)
+{
+    srs_error_t err;
+
+    SrsRtpUlpfecEncoder enc;
+    enc.on_loss(0.25);
+    EXPECT_EQ(4, enc.group());
+
+    char p0[1500], p1[1500], p2[1500];
+    int n0 = mock_fec_marshal(10, 9000, false, "hello", p0);
+    int n1 = mock_fec_marshal(11, 9000, false, "world!!!", p1);
+    int n2 = mock_fec_marshal(12, 9000, true, "srs", p2);
+
+    HELPER_EXPECT_SUCCESS(enc.protect(10, p0, n0));
+    EXPECT_FALSE(enc.is_ready(false));
+    HELPER_EXPECT_SUCCESS(enc.protect(11, p1, n1));
+    HELPER_EXPECT_SUCCESS(enc.protect(12, p2, n2));
+    // Ready at end of frame, for more than half of group.
+    EXPECT_FALSE(enc.is_ready(false));
+    EXPECT_TRUE(enc.is_ready(true));
+    EXPECT_EQ(14 + 8, enc.nb_bytes());
+
+    char fec[1500];
+    SrsBuffer b(fec, sizeof(fec));
+    HELPER_EXPECT_SUCCESS(enc.encode(&b));
+    EXPECT_EQ(22, b.pos());
+    EXPECT_EQ(0, enc.count());
+
+    // The FEC header and ULP header.
+    SrsBuffer r(fec, 22);
+    uint8_t byte0 = r.read_1bytes();
+    uint8_t byte1 = r.read_1bytes();
+    EXPECT_EQ(0, byte0 & 0xc0);
+    EXPECT_EQ(10, r.read_2bytes());
+    EXPECT_EQ(9000 ^ 9000 ^ 9000, r.read_4bytes());
+    uint16_t length = r.read_2bytes();
+    EXPECT_EQ(8, r.read_2bytes());
+    EXPECT_EQ(0xe000, (uint16_t)r.read_2bytes());
+
+    // Recover the packet 11 from others.
+    EXPECT_EQ(p1[1], (char)(byte1 ^ p0[1] ^ p2[1]));
+    EXPECT_EQ(n1 - 12, length ^ (n0 - 12) ^ (n2 - 12));
+
+    uint8_t payload[8];
+    memcpy(payload, fec + 14, 8);
+    uint8_t others[8];
+    memset(others, 0, 8);
+    memcpy(others, p0 + 12, n0 - 12);
+    srs_rtp_fec_xor(payload, others, 8);
+    memset(others, 0, 8);
+    memcpy(others, p2 + 12, n2 - 12);
+    srs_rtp_fec_xor(payload, others, 8);
+    EXPECT_EQ(0, memcmp(payload, "world!!!", 8));
+
+    // Start a new group if sequence out of mask.
+    HELPER_EXPECT_SUCCESS(enc.protect(20, p0, n0));
+    HELPER_EXPECT_SUCCESS(enc.protect(40, p1, n1));
+    EXPECT_EQ(1, enc.count());
+}
+
+VOID TEST(KernelRTCTest, FecSenderSequence)
+{
+    srs_error_t err;
+
+    SrsRtcFecSender sender(100, 101);
+
+    // Wrap in RED, but no FEC if no loss.
+    if (true) {
+        SrsRtpPacket* pkt = mock_history_packet(100, 10, 9000, "hello");
+        SrsAutoFree(SrsRtpPacket, pkt);
+        sender.on_media(pkt);
+        EXPECT_EQ(100, pkt->header.get_payload_type());
+        EXPECT_EQ(10, pkt->header.get_sequence());
+        EXPECT_TRUE(dynamic_cast<SrsRtpRedPayload*>(pkt->payload()) != NULL);
+
+        SrsRtpPacket* fec = NULL;
+        HELPER_EXPECT_SUCCESS(sender.on_sent(pkt, &fec));
+        EXPECT_TRUE(fec == NULL);
+    }
+
+    // A FEC packet for 2 packets.
+    sender.on_loss(1.0);
+
+    if (true) {
+        SrsRtpPacket* pkt = mock_history_packet(100, 11, 9000, "hello");
+        SrsAutoFree(SrsRtpPacket, pkt);
+        sender.on_media(pkt);
+
+        SrsRtpPacket* fec = NULL;
+        HELPER_EXPECT_SUCCESS(sender.on_sent(pkt, &fec));
+        EXPECT_TRUE(fec == NULL);
+    }
+
+    if (true) {
+        SrsRtpPacket* pkt = mock_history_packet(100, 12, 9000, "world");
+        SrsAutoFree(SrsRtpPacket, pkt);
+        sender.on_media(pkt);
+
+        SrsRtpPacket* fec = NULL;
+        HELPER_EXPECT_SUCCESS(sender.on_sent(pkt, &fec));
+        SrsAutoFree(SrsRtpPacket, fec);
+        ASSERT_TRUE(fec != NULL);
+        EXPECT_EQ(13, fec->header.get_sequence());
+        EXPECT_EQ(100, fec->header.get_payload_type());
+        EXPECT_EQ(9000, (int)fec->header.get_timestamp());
+
+        SrsRtpRedPayload* red = dynamic_cast<SrsRtpRedPayload*>(fec->payload());
+        ASSERT_TRUE(red != NULL);
+        EXPECT_EQ(101, red->block_pt);
+        EXPECT_EQ(14 + 5, (int)red->block->nb_bytes());
+    }
+
+    // The sequence of media is shifted by FEC packet.
+    if (true) {
+        SrsRtpPacket* pkt = mock_history_packet(100, 13, 9000, "hello");
+        SrsAutoFree(SrsRtpPacket, pkt);
+        sender.on_media(pkt);
+        EXPECT_EQ(14, pkt->header.get_sequence());
+    }
+}
+
+SrsRtpPacket* mock_jitter_packet(uint16_t seq, uint32_t ts, bool start, bool end, SrsAvcNaluType type)
+{
+    static char data[] = "frame";
+
+    SrsRtpPacket* pkt = new SrsRtpPacket();
+    pkt->header.set_sequence(seq);
+    pkt->header.set_timestamp(ts);
+    pkt->header.set_marker(end);
+    pkt->frame_type = SrsFrameTypeVideo;
+    pkt->nalu_type = (SrsAvcNaluType)kFuA;
+
+    SrsRtpFUAPayload2* fua = new SrsRtpFUAPayload2();
+    fua->start = start;
+    fua->end = end;
+    fua->nalu_type = type;
+    fua->payload = data;
+    fua->size = 5;
+    pkt->set_payload(fua, SrsRtspPacketPayloadTypeFUA2);
+    return pkt;
+}
+
+int mock_jitter_pop(SrsRtpJitterBuffer& jitter, srs_utime_t now, vector<uint16_t>* seqs = NULL)
+{
+    int nn = 0;
+
+    vector<SrsRtpPacket*> frame;
+    while (jitter.pop(frame, now)) {
+        for (int i = 0; i < (int)frame.size(); i++) {
+            SrsRtpPacket* pkt = frame.at(i);
+            if (seqs) {
+                seqs->push_back(pkt->header.get_sequence());
+            }
+            srs_freep(pkt);
+        }
+        frame.clear();
+        nn++;
+    }
+
+    return nn;
+}
+
+VOID TEST(KernelRTCTest, JitterBufferReorder)
+{
+    SrsRtpJitterBuffer jitter(SRS_RTC_JITTER_CAPACITY);
+    jitter.set_delay(100 * SRS_UTIME_MILLISECONDS);
+
+    // The keyframe, out-of-order at start.
+    jitter.put(mock_jitter_packet(101, 1000, false, false, SrsAvcNaluTypeIDR));
+    EXPECT_EQ(0, mock_jitter_pop(jitter, 0));
+    jitter.put(mock_jitter_packet(100, 1000, true, false, SrsAvcNaluTypeIDR));
+    jitter.put(mock_jitter_packet(102, 1000, false, true, SrsAvcNaluTypeIDR));
+
+    vector<uint16_t> seqs;
+    EXPECT_EQ(1, mock_jitter_pop(jitter, 0, &seqs));
+    ASSERT_EQ(3, (int)seqs.size());
+    EXPECT_EQ(100, seqs.at(0));
+    EXPECT_EQ(102, seqs.at(2));
+
+    // The P frame, out-of-order.
+    jitter.put(mock_jitter_packet(104, 2000, false, true, SrsAvcNaluTypeNonIDR));
+    EXPECT_EQ(0, mock_jitter_pop(jitter, 0));
+    jitter.put(mock_jitter_packet(103, 2000, true, false, SrsAvcNaluTypeNonIDR));
+    EXPECT_EQ(1, mock_jitter_pop(jitter, 0));
+    EXPECT_EQ(0, jitter.size());
+
+    // The late and duplicated packets are dropped.
+    jitter.put(mock_jitter_packet(100, 1000, true, false, SrsAvcNaluTypeIDR));
+    EXPECT_EQ(0, jitter.size());
+    jitter.put(mock_jitter_packet(105, 3000, true, false, SrsAvcNaluTypeNonIDR));
+    jitter.put(mock_jitter_packet(105, 3000, true, false, SrsAvcNaluTypeNonIDR));
+    EXPECT_EQ(1, jitter.size());
+    EXPECT_EQ(0, jitter.nn_dropped());
+}
+
+VOID TEST(KernelRTCTest, JitterBufferLoss)
+{
+    SrsRtpJitterBuffer jitter(SRS_RTC_JITTER_CAPACITY);
+    jitter.set_delay(100 * SRS_UTIME_MILLISECONDS);
+
+    // The first frame is not a keyframe, drop it.
+    jitter.put(mock_jitter_packet(90, 500, true, true, SrsAvcNaluTypeNonIDR));
+    EXPECT_EQ(0, mock_jitter_pop(jitter, 0));
+    EXPECT_EQ(1, jitter.nn_dropped());
+
+    // The first packet of keyframe is missing.
+    jitter.put(mock_jitter_packet(92, 1000, false, true, SrsAvcNaluTypeIDR));
+    EXPECT_EQ(0, mock_jitter_pop(jitter, 0));
+    jitter.put(mock_jitter_packet(91, 1000, true, false, SrsAvcNaluTypeIDR));
+    EXPECT_EQ(1, mock_jitter_pop(jitter, 0));
+
+    // Lost the packet 93 of P frame, wait for it.
+    jitter.put(mock_jitter_packet(94, 2000, false, true, SrsAvcNaluTypeNonIDR));
+    jitter.put(mock_jitter_packet(95, 3000, true, true, SrsAvcNaluTypeNonIDR));
+    EXPECT_EQ(0, mock_jitter_pop(jitter, 10 * SRS_UTIME_MILLISECONDS));
+    EXPECT_EQ(0, mock_jitter_pop(jitter, 100 * SRS_UTIME_MILLISECONDS));
+    EXPECT_EQ(2, jitter.size());
+
+    // Timeout, drop the broken frame, and wait for keyframe.
+    EXPECT_EQ(0, mock_jitter_pop(jitter, 110 * SRS_UTIME_MILLISECONDS));
+    EXPECT_EQ(0, jitter.size());
+    EXPECT_EQ(3, jitter.nn_dropped());
+
+    // The keyframe.
+    jitter.put(mock_jitter_packet(96, 4000, true, true, SrsAvcNaluTypeIDR));
+    EXPECT_EQ(1, mock_jitter_pop(jitter, 110 * SRS_UTIME_MILLISECONDS));
+
+    // The sequence jumps, reset the jitter buffer.
+    jitter.put(mock_jitter_packet(30000, 5000, true, false, SrsAvcNaluTypeNonIDR));
+    EXPECT_EQ(0, mock_jitter_pop(jitter, 110 * SRS_UTIME_MILLISECONDS));
+    EXPECT_EQ(1, jitter.size());
+}
+
+VOID TEST(KernelRTCTest, JitterBufferLostMarker)
+{
+    SrsRtpJitterBuffer jitter(SRS_RTC_JITTER_CAPACITY);
+    jitter.set_delay(100 * SRS_UTIME_MILLISECONDS);
+
+    jitter.put(mock_jitter_packet(10, 500, true, true, SrsAvcNaluTypeIDR));
+    EXPECT_EQ(1, mock_jitter_pop(jitter, 0));
+
+    // The P frame, whose marker packet 12 is lost, then the keyframe follows.
+    jitter.put(mock_jitter_packet(11, 1000, true, false, SrsAvcNaluTypeNonIDR));
+    jitter.put(mock_jitter_packet(13, 2000, true, false, SrsAvcNaluTypeIDR));
+    jitter.put(mock_jitter_packet(14, 2000, false, false, SrsAvcNaluTypeIDR));
+    jitter.put(mock_jitter_packet(15, 2000, false, true, SrsAvcNaluTypeIDR));
+    EXPECT_EQ(0, mock_jitter_pop(jitter, 10 * SRS_UTIME_MILLISECONDS));
+
+    // Only drop the broken P frame, and the keyframe is kept.
+    vector<uint16_t> seqs;
+    EXPECT_EQ(1, mock_jitter_pop(jitter, 120 * SRS_UTIME_MILLISECONDS, &seqs));
+    ASSERT_EQ(3, (int)seqs.size());
+    EXPECT_EQ(13, seqs.at(0));
+    EXPECT_EQ(15, seqs.at(2));
+    EXPECT_EQ(0, jitter.size());
+    EXPECT_EQ(1, jitter.nn_dropped());
+}
+
+VOID TEST(KernelRTCTest, JitterBufferLargeFrame)
+{
+    SrsRtpJitterBuffer jitter(SRS_RTC_JITTER_CAPACITY);
+    jitter.set_delay(100 * SRS_UTIME_MILLISECONDS);
+
+    // The large keyframe, the scan resumes from the last checked packet.
+    for (int i = 0; i < 500; i++) {
+        if (i == 200) {
+            continue;
+        }
+        jitter.put(mock_jitter_packet(1000 + i, 1000, i == 0, false, SrsAvcNaluTypeIDR));
+        EXPECT_EQ(0, mock_jitter_pop(jitter, 0));
+        EXPECT_EQ((i < 200) ? i + 1 : 200, (int)jitter.scanned_);
+    }
+
+    // The lost packet is retransmitted, then the marker completes the frame.
+    jitter.put(mock_jitter_packet(1200, 1000, false, false, SrsAvcNaluTypeIDR));
+    EXPECT_EQ(0, mock_jitter_pop(jitter, 0));
+    EXPECT_EQ(500, (int)jitter.scanned_);
+
+    jitter.put(mock_jitter_packet(1500, 1000, false, true, SrsAvcNaluTypeIDR));
+    vector<uint16_t> seqs;
+    EXPECT_EQ(1, mock_jitter_pop(jitter, 0, &seqs));
+    ASSERT_EQ(501, (int)seqs.size());
+    for (int i = 0; i < (int)seqs.size(); i++) {
+        EXPECT_EQ(1000 + i, seqs.at(i));
+    }
+    EXPECT_EQ(0, (int)jitter.scanned_);
+    EXPECT_EQ(0, jitter.size());
+    EXPECT_EQ(0, jitter.nn_dropped());
+}
+
+VOID TEST(KernelRTCTest, DtlsAdmission)
+{
+    SrsDtlsAdmission admission;
+
+    // No limit by default.
+    for (int i = 0; i < 100; i++) {
+        EXPECT_TRUE(admission.admit(0));
+    }
+
+    // Limit the new handshakes in each second.
+    admission.set_rate(2);
+    srs_utime_t now = 10 * SRS_UTIME_SECONDS;
+    EXPECT_TRUE(admission.admit(now));
+    EXPECT_TRUE(admission.admit(now));
+    EXPECT_FALSE(admission.admit(now));
+    EXPECT_FALSE(admission.admit(now + 500 * SRS_UTIME_MILLISECONDS));
+
+    // Reset in the next window.
+    EXPECT_TRUE(admission.admit(now + SRS_UTIME_SECONDS));
+}
+
+VOID TEST(KernelRTCTest, DtlsSharedContext)
+{
+    srs_error_t err;
+
+    // The sessions share the context with the same version and role.
+    SrsDtlsServerImpl s0(NULL), s1(NULL);
+    HELPER_EXPECT_SUCCESS(s0.initialize("auto", "passive"));
+    HELPER_EXPECT_SUCCESS(s1.initialize("auto", "passive"));
+    EXPECT_TRUE(s0.dtls_ctx == s1.dtls_ctx);
+
+    SrsDtlsServerImpl s2(NULL);
+    HELPER_EXPECT_SUCCESS(s2.initialize("dtls1.2", "passive"));
+    EXPECT_TRUE(s0.dtls_ctx != s2.dtls_ctx);
+}
+
+class MockDtlsCallback : public ISrsDtlsCallback
+{
+public:
+    bool done;
+    std::vector<std::string> outs;
+public:
+    MockDtlsCallback() {
+        done = false;
+    }
+    virtual ~MockDtlsCallback() {
+    }
+public:
+    virtual srs_error_t on_dtls_handshake_done() {
+        done = true;
+        return srs_success;
+    }
+    virtual srs_error_t on_dtls_application_data(const char* data, const int len) {
+        return srs_success;
+    }
+    virtual srs_error_t write_dtls_data(void* data, int size) {
+        outs.push_back(std::string((char*)data, size));
+        return srs_success;
+    }
+    virtual srs_error_t on_dtls_alert(std::string type, std::string desc) {
+        return srs_success;
+    }
+};
+
+srs_error_t mock_dtls_deliver(MockDtlsCallback* from, SrsDtls* to)
+{
+    srs_error_t err = srs_success;
+
+    std::vector<std::string> outs;
+    outs.swap(from->outs);
+    for (int i = 0; i < (int)outs.size(); i++) {
+        std::string& v = outs.at(i);
+        if ((err = to->on_dtls((char*)v.data(), (int)v.length())) != srs_success) {
+            return err;
+        }
+    }
+
+    return err;
+}
+
+VOID TEST(KernelRTCTest, DtlsHandshakeSharedContext)
+{
+    srs_error_t err;
+
+    // Handshake twice, the server sessions share the same context.
+    for (int i = 0; i < 2; i++) {
+        MockDtlsCallback ccb, scb;
+        SrsDtls client(&ccb), server(&scb);
+        HELPER_EXPECT_SUCCESS(client.initialize("active", "auto"));
+        HELPER_EXPECT_SUCCESS(server.initialize("passive", "auto"));
+
+        HELPER_EXPECT_SUCCESS(client.start_active_handshake());
+        for (int j = 0; j < 10 && (!ccb.done || !scb.done); j++) {
+            HELPER_EXPECT_SUCCESS(mock_dtls_deliver(&ccb, &server));
+            HELPER_EXPECT_SUCCESS(mock_dtls_deliver(&scb, &client));
+        }
+        EXPECT_TRUE(ccb.done);
+        EXPECT_TRUE(scb.done);
+
+        std::string recv_key, send_key;
+        HELPER_EXPECT_SUCCESS(server.get_srtp_key(recv_key, send_key));
+        EXPECT_FALSE(recv_key.empty());
+    }
+}
+
+#ifdef SRS_FFMPEG_FIT
+VOID TEST(KernelRTCTest, AudioTranscoderPool)
+{
+    srs_error_t err;
+
+    SrsAudioTranscoderPool pool;
+    EXPECT_EQ(0, pool.size());
+
+    SrsAudioTranscoder* t0 = NULL;
+    HELPER_EXPECT_SUCCESS(pool.fetch(SrsAudioCodecIdOpus, SrsAudioCodecIdAAC, 2, 48000, 48000, &t0));
+    EXPECT_TRUE(t0 != NULL);
+    EXPECT_TRUE(t0->match(SrsAudioCodecIdOpus, SrsAudioCodecIdAAC, 2, 48000, 48000));
+    EXPECT_FALSE(t0->match(SrsAudioCodecIdOpus, SrsAudioCodecIdAAC, 2, 44100, 48000));
+
+    // Reuse the recycled transcoder with the same parameters, the encoder is freed because it might
+    // keep the samples of previous stream, and opened again when reuse.
+    pool.recycle(t0);
+    EXPECT_EQ(1, pool.size());
+    EXPECT_TRUE(t0->enc_ == NULL);
+    EXPECT_TRUE(t0->dec_ != NULL);
+
+    SrsAudioTranscoder* t1 = NULL;
+    HELPER_EXPECT_SUCCESS(pool.fetch(SrsAudioCodecIdOpus, SrsAudioCodecIdAAC, 2, 48000, 48000, &t1));
+    EXPECT_TRUE(t0 == t1);
+    EXPECT_TRUE(t1->enc_ != NULL);
+    EXPECT_EQ(0, pool.size());
+
+    uint8_t* header = NULL;
+    int len = 0;
+    t1->aac_codec_header(&header, &len);
+    EXPECT_TRUE(header != NULL);
+    EXPECT_GT(len, 0);
+
+    // Create a new one for different parameters.
+    pool.recycle(t1);
+    SrsAudioTranscoder* t2 = NULL;
+    HELPER_EXPECT_SUCCESS(pool.fetch(SrsAudioCodecIdOpus, SrsAudioCodecIdAAC, 2, 48000, 64000, &t2));
+    EXPECT_TRUE(t1 != t2);
+    EXPECT_EQ(1, pool.size());
+
+    pool.recycle(t2);
+    EXPECT_EQ(2, pool.size());
+}
+
+VOID TEST(KernelRTCTest, AudioTranscoderAsync)
+{
+    srs_error_t err;
+
+    // Without worker, the transcoder works in current thread.
+    SrsAsyncAudioTranscoder* t = new SrsAsyncAudioTranscoder();
+    HELPER_EXPECT_SUCCESS(t->initialize(SrsAudioCodecIdOpus, SrsAudioCodecIdAAC, 2, 48000, 48000));
+    EXPECT_TRUE(t->worker_ == NULL);
+
+    uint8_t* header = NULL;
+    int len = 0;
+    t->aac_codec_header(&header, &len);
+    EXPECT_TRUE(header != NULL);
+    EXPECT_GT(len, 0);
+
+    // The input frame is copied, and the invalid frame is ignored.
+    char data[] = {0x00, 0x01, 0x02};
+    SrsAudioFrame frame;
+    frame.add_sample(data, sizeof(data));
+    frame.dts = 100;
+    HELPER_EXPECT_SUCCESS(t->transcode(&frame));
+
+    vector<SrsAudioFrame*> outs;
+    t->fetch(outs);
+    t->free_frames(outs);
+
+    // The codec is recycled to pool, when disposed.
+    int nn = _srs_audio_transcoders->size();
+    SrsAsyncAudioTranscoder::dispose(t);
+    EXPECT_EQ(nn + 1, _srs_audio_transcoders->size());
+}
+SrsSharedPtrMessage* mock_bridge_message(bool video, uint8_t b0, uint8_t b1)
+{
+    SrsMessageHeader h;
+    if (video) {
+        h.initialize_video(4, 0, 1);
+    } else {
+        h.initialize_audio(4, 0, 1);
+    }
+
+    char* p = new char[4];
+    p[0] = (char)b0; p[1] = (char)b1; p[2] = p[3] = 0;
+
+    SrsSharedPtrMessage* msg = new SrsSharedPtrMessage();
+    srs_error_t err = msg->create(&h, p, 4);
+    srs_freep(err);
+    return msg;
+}
+
+VOID TEST(KernelRTCTest, BridgeLazyFromRtmp)
+{
+    srs_error_t err;
+
+    SrsRtcSource source;
+    SrsRtcFromRtmpBridge bridge(&source);
+    HELPER_EXPECT_SUCCESS(bridge.format->initialize());
+    bridge.rtmp_to_rtc = true;
+    bridge.lazy_ = true;
+
+    // Ignore the frames before keyframe, without any RTC player.
+    SrsSharedPtrMessage* msg = mock_bridge_message(true, 0x27, 0x01);
+    SrsAutoFree(SrsSharedPtrMessage, msg);
+    HELPER_EXPECT_SUCCESS(bridge.on_video(msg));
+    EXPECT_FALSE(bridge.active_);
+    EXPECT_EQ(0, (int)bridge.gop_.size());
+
+    // Cache the GOP from keyframe.
+    SrsSharedPtrMessage* key = mock_bridge_message(true, 0x17, 0x01);
+    SrsAutoFree(SrsSharedPtrMessage, key);
+    HELPER_EXPECT_SUCCESS(bridge.on_video(key));
+    HELPER_EXPECT_SUCCESS(bridge.on_video(msg));
+    EXPECT_FALSE(bridge.active_);
+    EXPECT_EQ(2, (int)bridge.gop_.size());
+
+    // A new GOP.
+    HELPER_EXPECT_SUCCESS(bridge.on_video(key));
+    EXPECT_EQ(1, (int)bridge.gop_.size());
+
+    // The MP3 audio is ignored by bridge, but cached in GOP.
+    SrsSharedPtrMessage* mp3 = mock_bridge_message(false, 0x2f, 0xff);
+    SrsAutoFree(SrsSharedPtrMessage, mp3);
+    HELPER_EXPECT_SUCCESS(bridge.on_audio(mp3));
+    EXPECT_EQ(2, (int)bridge.gop_.size());
+
+    // Deactivate if no RTC player for a while.
+    bridge.active_ = true;
+    HELPER_EXPECT_SUCCESS(bridge.on_audio(mp3));
+    EXPECT_TRUE(bridge.active_);
+    EXPECT_GT(bridge.idle_at_, 0);
+
+    bridge.idle_at_ -= 31 * SRS_UTIME_SECONDS;
+    HELPER_EXPECT_SUCCESS(bridge.on_audio(mp3));
+    EXPECT_FALSE(bridge.active_);
+    EXPECT_EQ(4, (int)bridge.gop_.size());
+}
+#endif
+
+VOID TEST(KernelRTCTest, StunBindingResponder)
+{
+    srs_error_t err;
+
+    SrsStunBindingResponder responder;
+    HELPER_EXPECT_SUCCESS(responder.initialize("ufrag0:ufrag1", "pwd-of-ice"));
+
+    const char* tids[] = {"0123456789ab", "ba9876543210"};
+    for (int i = 0; i < 2; i++) {
+        // The response by packet, as the username of request is local:remote.
+        SrsStunPacket pkt;
+        pkt.set_message_type(BindingResponse);
+        pkt.set_local_ufrag("ufrag1");
+        pkt.set_remote_ufrag("ufrag0");
+        pkt.set_transcation_id(tids[i]);
+        pkt.set_mapped_address(0x7f000001 + i);
+        pkt.set_mapped_port(8000 + i);
+
+        char expect[1460];
+        SrsBuffer b0(expect, sizeof(expect));
+        HELPER_EXPECT_SUCCESS(pkt.encode("pwd-of-ice", &b0));
+
+        // Reuse the responder, which should be identical to the packet.
+        char actual[1460];
+        SrsBuffer b1(actual, sizeof(actual));
+        HELPER_EXPECT_SUCCESS(responder.encode(tids[i], 0x7f000001 + i, 8000 + i, &b1));
+
+        EXPECT_EQ(b0.pos(), b1.pos());
+        EXPECT_EQ(0, memcmp(expect, actual, b0.pos()));
+
+        // Decode the response, without username.
+        SrsStunPacket r;
+        HELPER_EXPECT_SUCCESS(r.decode_fast(actual, b1.pos()));
+        EXPECT_TRUE(r.is_binding_response());
+        EXPECT_STREQ(tids[i], r.get_transcation_id().c_str());
+        EXPECT_TRUE(r.get_username().empty());
+
+        // Decode the response, with username.
+        SrsStunPacket r2;
+        HELPER_EXPECT_SUCCESS(r2.decode(actual, b1.pos()));
+        EXPECT_STREQ("ufrag0:ufrag1", r2.get_username().c_str());
+        EXPECT_STREQ(tids[i], r2.get_transcation_id().c_str());
+    }
+
+    // Fail if no space.
+    if (true) {
+        char buf[32];
+        SrsBuffer b(buf, sizeof(buf));
+        HELPER_EXPECT_FAILED(responder.encode(tids[0], 0x7f000001, 8000, &b));
+    }
+}
@@ -22,6 +22,7 @@ using namespace std;
 #include <srs_protocol_http_client.hpp>
 #include <srs_protocol_rtmp_conn.hpp>
 #include <srs_protocol_conn.hpp>
+#include <srs_kernel_file.hpp>
 #include <sys/socket.h>
 #include <netdb.h>
 #include <st.h>
@@ -471,6 +472,108 @@ VOID TEST(TCPServerTest, WritevIOVC)
 	}
 }
 
+VOID TEST(TCPServerTest, SendFile)
+{
+	srs_error_t err;
+
+	string path = _srs_tmp_file_prefix + "sendfile.txt";
+	if (true) {
+		SrsFileWriter fw;
+		HELPER_EXPECT_SUCCESS(fw.open(path));
+		HELPER_EXPECT_SUCCESS(fw.write((void*)"Hello, world!", 13, NULL));
+	}
+
+	SrsFileReader fr;
+	HELPER_EXPECT_SUCCESS(fr.open(path));
+	EXPECT_TRUE(fr.get_fd() >= 0);
+
+	// Send part of file, the file offset is not changed.
+	if (true) {
+		MockTcpHandler h;
+		SrsTcpListener l(&h, _srs_tmp_host, _srs_tmp_port);
+		HELPER_EXPECT_SUCCESS(l.listen());
+
+		SrsTcpClient c(_srs_tmp_host, _srs_tmp_port, _srs_tmp_timeout);
+		HELPER_EXPECT_SUCCESS(c.connect());
+
+		SrsStSocket skt;
+		srs_usleep(30 * SRS_UTIME_MILLISECONDS);
+#ifdef SRS_OSX
+		ASSERT_TRUE(h.fd != NULL);
+#endif
+		HELPER_EXPECT_SUCCESS(skt.initialize(h.fd));
+
+		ssize_t nwrite = 0;
+		HELPER_EXPECT_SUCCESS(skt.sendfile(fr.get_fd(), 7, 5, &nwrite));
+		EXPECT_EQ(5, nwrite);
+		EXPECT_EQ(5, skt.get_send_bytes());
+		EXPECT_EQ(0, fr.tellg());
+
+		char buf[16] = {0};
+		HELPER_EXPECT_SUCCESS(c.read_fully(buf, 5, NULL));
+		EXPECT_STREQ(buf, "world");
+	}
+
+	// Send file in HTTP response with content length.
+	if (true) {
+		MockTcpHandler h;
+		SrsTcpListener l(&h, _srs_tmp_host, _srs_tmp_port);
+		HELPER_EXPECT_SUCCESS(l.listen());
+
+		SrsTcpClient c(_srs_tmp_host, _srs_tmp_port, _srs_tmp_timeout);
+		HELPER_EXPECT_SUCCESS(c.connect());
+
+		SrsStSocket skt;
+		srs_usleep(30 * SRS_UTIME_MILLISECONDS);
+#ifdef SRS_OSX
+		ASSERT_TRUE(h.fd != NULL);
+#endif
+		HELPER_EXPECT_SUCCESS(skt.initialize(h.fd));
+
+		SrsHttpResponseWriter w(&skt);
+		w.header()->set_content_length(13);
+		w.header()->set_content_type("text/plain");
+
+		// Not sent before header is written.
+		bool sent = true;
+		HELPER_EXPECT_SUCCESS(w.sendfile(fr.get_fd(), 0, 13, &sent));
+		EXPECT_FALSE(sent);
+
+		w.write_header(SRS_CONSTS_HTTP_OK);
+		HELPER_EXPECT_SUCCESS(w.sendfile(fr.get_fd(), 0, 13, &sent));
+		EXPECT_TRUE(sent);
+
+		// Overflow the content length.
+		HELPER_EXPECT_FAILED(w.sendfile(fr.get_fd(), 0, 1, &sent));
+
+		char buf[1024] = {0};
+		ssize_t nread = 0;
+		string res;
+		while (res.find("Hello, world!") == string::npos) {
+			HELPER_ASSERT_SUCCESS(c.read(buf, sizeof(buf), &nread));
+			res.append(buf, nread);
+		}
+		EXPECT_TRUE(res.find("HTTP/1.1 200 OK") == 0);
+		EXPECT_TRUE(res.find("Content-Length: 13") != string::npos);
+	}
+
+	// Not sent for the io without sendfile, for example, TLS.
+	if (true) {
+		MockBufferIO io;
+		SrsHttpResponseWriter w(&io);
+		w.header()->set_content_length(13);
+		w.write_header(SRS_CONSTS_HTTP_OK);
+
+		bool sent = true;
+		HELPER_EXPECT_SUCCESS(w.sendfile(fr.get_fd(), 0, 13, &sent));
+		EXPECT_FALSE(sent);
+		EXPECT_EQ(0, io.out_buffer.length());
+	}
+
+	fr.close();
+	::unlink(path.c_str());
+}
+
 VOID TEST(HTTPServerTest, MessageConnection)
 {
     srs_error_t err;